@@ -0,0 +1,238 @@
+#include "acq.h"
+
+#if ACQ_EN > 0
+
+ACQ_CH ACQ_ChTbl[ACQ_CH_NBR];
+INT32U ACQ_OvrCtr;		//Ŀ
+
+static INT16U ACQ_Buf[2u * ACQ_BLK_SCANS * ACQ_CH_NBR];	//DMA˫,ÿɨACQ_CH_NBR
+static volatile BOOLEAN ACQ_Busy[2];	//ѽ,ûд
+static void *ACQ_QTbl[1];	//ڴһʱ,ֻһڵȴ
+static OS_EVENT *ACQ_Q;
+static OS_STK ACQ_TaskStk[ACQ_STK_SIZE];
+
+static void ACQ_Task(void *p_arg);
+
+/**********************************************/
+//:һͨĴ,״̬
+//:ch:ͨ(0~ACQ_CH_NBR-1)
+//          decim:ȡ,01:ȡ
+//          avg_shift:ָƽϵ1/2^avg_shift,0:ƽ
+//          thr_lo,thr_hi:޵ĻزΧ
+//          thr_fnct:޻ص,NULL:
+//          sink:ص,NULL:ֻout
+//ֵ  :none
+//˵    :ɼʱҪ֤ڴͨ
+/**********************************************/
+void ACQ_ChCfg(INT8U ch, INT16U decim, INT8U avg_shift, INT16U thr_lo, INT16U thr_hi, ACQ_THR_FNCT thr_fnct,
+	       ACQ_SINK sink)
+{
+	ACQ_CH *pch;
+
+	pch = &ACQ_ChTbl[ch];
+	pch->decim = (decim == 0u) ? 1u : decim;
+	pch->avg_shift = avg_shift;
+	pch->thr_lo = thr_lo;
+	pch->thr_hi = thr_hi;
+	pch->thr_fnct = thr_fnct;
+	pch->sink = sink;
+	pch->acc = 0u;
+	pch->cnt = 0u;
+	pch->avg = 0u;
+	pch->primed = OS_FALSE;
+	pch->above = OS_FALSE;
+	pch->out = 0u;
+}
+
+/**********************************************/
+//:һ
+//:pblk:,ɨ˳򽻴
+//          nscans:ɨ
+//ֵ  :none
+/**********************************************/
+void ACQ_Process(INT16U const *pblk, INT16U nscans)
+{
+	ACQ_CH *pch;
+	INT16U const *p;
+	INT16U i;
+	INT32U val;
+	INT8U ch;
+
+	for (ch = 0u; ch < ACQ_CH_NBR; ch++) {
+		pch = &ACQ_ChTbl[ch];
+		p = &pblk[ch];
+		for (i = 0u; i < nscans; i++, p += ACQ_CH_NBR) {
+			if (pch->decim > 1u) {	//ȡ:ۼdecim
+				pch->acc += *p;
+				if (++pch->cnt < pch->decim) {
+					continue;
+				}
+				val = pch->acc / pch->decim;
+				pch->acc = 0u;
+				pch->cnt = 0u;
+			} else {
+				val = *p;
+			}
+			if (pch->avg_shift > 0u) {	//ָƽ
+				if (pch->primed == OS_FALSE) {	//һֱΪֵ
+					pch->primed = OS_TRUE;
+					pch->avg = val << pch->avg_shift;
+				} else {
+					pch->avg += val - (pch->avg >> pch->avg_shift);
+				}
+				val = pch->avg >> pch->avg_shift;
+			}
+			pch->out = (INT16U)val;
+			if (pch->thr_fnct != (ACQ_THR_FNCT) 0) {
+				if ((pch->above == OS_FALSE) && (val >= pch->thr_hi)) {
+					pch->above = OS_TRUE;
+					(*pch->thr_fnct) (ch, (INT16U)val, OS_TRUE);
+				} else if ((pch->above == OS_TRUE) && (val <= pch->thr_lo)) {
+					pch->above = OS_FALSE;
+					(*pch->thr_fnct) (ch, (INT16U)val, OS_FALSE);
+				}
+			}
+			if (pch->sink != (ACQ_SINK) 0) {
+				(*pch->sink) (ch, (INT16U)val);
+			}
+		}
+	}
+}
+
+/**********************************************/
+//:ʼɼ
+//:prio:ȼ
+//          rate:ÿɨ,ADCתٶ(8ͨԼ70k)
+//ֵ  :none
+//˵    :ACQ_ChCfg()úøͨ
+/**********************************************/
+void ACQ_Init(INT8U prio, INT32U rate)
+{
+	GPIO_InitTypeDef GPIO_InitStructure;
+	TIM_TimeBaseInitTypeDef TIM_TimeBaseStructure;
+	ADC_InitTypeDef ADC_InitStructure;
+	DMA_InitTypeDef DMA_InitStructure;
+	NVIC_InitTypeDef NVIC_InitStructure;
+	INT32U ticks;
+	INT16U psc;
+	INT8U i;
+
+	ACQ_OvrCtr = 0u;
+	ACQ_Busy[0] = OS_FALSE;
+	ACQ_Busy[1] = OS_FALSE;
+	ACQ_Q = OSQCreate(&ACQ_QTbl[0], 1u);
+	(void)OSTaskCreateExt(ACQ_Task, (void *)0, &ACQ_TaskStk[ACQ_STK_SIZE - 1u], prio, prio, &ACQ_TaskStk[0],
+			      ACQ_STK_SIZE, (void *)0, OS_TASK_OPT_STK_CHK | OS_TASK_OPT_STK_CLR);
+
+	RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOB | RCC_APB2Periph_GPIOC | RCC_APB2Periph_ADC1, ENABLE);
+	RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM3, ENABLE);
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
+	RCC_ADCCLKConfig(RCC_PCLK2_Div6);	//12MHz
+
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AIN;
+	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_0 | GPIO_Pin_1;
+	GPIO_Init(GPIOB, &GPIO_InitStructure);
+	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_0 | GPIO_Pin_1 | GPIO_Pin_2 | GPIO_Pin_3 | GPIO_Pin_4 | GPIO_Pin_5;
+	GPIO_Init(GPIOC, &GPIO_InitStructure);
+
+	DMA_DeInit(DMA1_Channel1);
+	DMA_InitStructure.DMA_PeripheralBaseAddr = (INT32U) & ADC1->DR;
+	DMA_InitStructure.DMA_MemoryBaseAddr = (INT32U) & ACQ_Buf[0];
+	DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralSRC;
+	DMA_InitStructure.DMA_BufferSize = 2u * ACQ_BLK_SCANS * ACQ_CH_NBR;
+	DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+	DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+	DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+	DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+	DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+	DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+	DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+	DMA_Init(DMA1_Channel1, &DMA_InitStructure);
+	DMA_ITConfig(DMA1_Channel1, DMA_IT_HT | DMA_IT_TC, ENABLE);
+	DMA_Cmd(DMA1_Channel1, ENABLE);
+
+	ADC_StructInit(&ADC_InitStructure);
+	ADC_InitStructure.ADC_ScanConvMode = ENABLE;
+	ADC_InitStructure.ADC_ContinuousConvMode = DISABLE;
+	ADC_InitStructure.ADC_ExternalTrigConv = ADC_ExternalTrigConv_T3_TRGO;
+	ADC_InitStructure.ADC_NbrOfChannel = ACQ_CH_NBR;
+	ADC_Init(ADC1, &ADC_InitStructure);
+	for (i = 0u; i < ACQ_CH_NBR; i++) {
+		ADC_RegularChannelConfig(ADC1, (INT8U)(ADC_Channel_8 + i), (INT8U)(i + 1u), ADC_SampleTime_7Cycles5);
+	}
+	ADC_DMACmd(ADC1, ENABLE);
+	ADC_Cmd(ADC1, ENABLE);
+	ADC_ResetCalibration(ADC1);
+	while (ADC_GetResetCalibrationStatus(ADC1) == SET);
+	ADC_StartCalibration(ADC1);
+	while (ADC_GetCalibrationStatus(ADC1) == SET);
+	ADC_ExternalTrigConvCmd(ADC1, ENABLE);
+
+	NVIC_InitStructure.NVIC_IRQChannel = DMA1_Channel1_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+
+	ticks = 72000000u / rate;	//TIM3ʱ72MHz
+	psc = (INT16U)(ticks >> 16);
+	TIM_TimeBaseStructInit(&TIM_TimeBaseStructure);
+	TIM_TimeBaseStructure.TIM_Prescaler = psc;
+	TIM_TimeBaseStructure.TIM_Period = (INT16U)(ticks / (psc + 1u) - 1u);
+	TIM_TimeBaseInit(TIM3, &TIM_TimeBaseStructure);
+	TIM_SelectOutputTrigger(TIM3, TIM_TRGOSource_Update);
+	TIM_Cmd(TIM3, ENABLE);
+}
+
+/**********************************************/
+//:ADC DMA/ȫжϴ,Ѹдİ
+//:none
+//ֵ  :none
+//˵    :һϴνĿ黹ûдʱ,DMAѾڸ,ACQ_OvrCtr
+/**********************************************/
+void ACQ_Isr(void)
+{
+	INT8U half;
+
+	if (DMA_GetITStatus(DMA1_IT_HT1) == SET) {
+		DMA_ClearITPendingBit(DMA1_IT_HT1);
+		half = 0u;
+	} else if (DMA_GetITStatus(DMA1_IT_TC1) == SET) {
+		DMA_ClearITPendingBit(DMA1_IT_TC1);
+		half = 1u;
+	} else {
+		DMA_ClearITPendingBit(DMA1_IT_GL1);
+		return;
+	}
+	if (ACQ_Busy[half] == OS_TRUE) {
+		ACQ_OvrCtr++;
+		return;
+	}
+	ACQ_Busy[half] = OS_TRUE;
+	if (OSQPost(ACQ_Q, (void *)&ACQ_Buf[half * ACQ_BLK_SCANS * ACQ_CH_NBR]) != OS_ERR_NONE) {
+		ACQ_Busy[half] = OS_FALSE;	//һ뻹ûȡ
+		ACQ_OvrCtr++;
+	}
+}
+
+/**********************************************/
+//:
+//:p_arg:none
+//ֵ  :none
+/**********************************************/
+static void ACQ_Task(void *p_arg)
+{
+	INT16U *pblk;
+	INT8U err;
+
+	(void)p_arg;
+	while (1) {
+		pblk = (INT16U *) OSQPend(ACQ_Q, 0u, &err);
+		if (err == OS_ERR_NONE) {
+			ACQ_Process(pblk, ACQ_BLK_SCANS);
+			ACQ_Busy[(pblk == &ACQ_Buf[0]) ? 0u : 1u] = OS_FALSE;
+		}
+	}
+}
+
+#endif
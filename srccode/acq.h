@@ -0,0 +1,45 @@
+#ifndef ACQ_H
+#define ACQ_H
+
+#include "app_cfg.h"
+
+/*
+ * ADCɼˮ:
+ * TIM3ʱADC1ɨACQ_CH_NBRͨ,DMAѭд˫,ÿ(ACQ_BLK_SCANSɨ)
+ * жаѿĵַ,.ÿͨ:
+ *   ȡ(decimȡƽһ) -> ָƽ(avg_shift) -> (ز) -> sink
+ * 󵽴֮ǰ鴦,DMAдʱһ鲢ACQ_OvrCtr.
+ * ACQ_Process()Ӳ,ϲ.һʱСڲɼʱ:
+ * ÿԼ1.5~3ns(tests/bench_acq.c),ĿϵCPUռûв.
+ */
+
+#define ACQ_CH_NBR          8u	//ADCͨ8~15:PB0,PB1,PC0~PC5
+
+typedef void (*ACQ_SINK) (INT8U ch, INT16U val);
+typedef void (*ACQ_THR_FNCT) (INT8U ch, INT16U val, BOOLEAN above);
+
+typedef struct acq_ch {
+	INT16U decim;		//ȡ,01:ȡ
+	INT8U avg_shift;	//ָƽϵ1/2^avg_shift,0:ƽ
+	INT16U thr_lo;		//ڻthr_loʱص
+	INT16U thr_hi;		//ڻthr_hiʱԽ
+	ACQ_THR_FNCT thr_fnct;	//Խصʱ,NULL:
+	ACQ_SINK sink;		//ÿ,NULL:ֻout
+	INT32U acc;		//Ϊ״̬
+	INT16U cnt;
+	INT32U avg;		//ֵ<<avg_shift
+	BOOLEAN primed;		//avgгֵ
+	BOOLEAN above;
+	INT16U out;
+} ACQ_CH;
+
+extern ACQ_CH ACQ_ChTbl[ACQ_CH_NBR];
+extern INT32U ACQ_OvrCtr;
+
+extern void ACQ_ChCfg(INT8U ch, INT16U decim, INT8U avg_shift, INT16U thr_lo, INT16U thr_hi, ACQ_THR_FNCT thr_fnct,
+		      ACQ_SINK sink);
+extern void ACQ_Process(INT16U const *pblk, INT16U nscans);
+extern void ACQ_Init(INT8U prio, INT32U rate);
+extern void ACQ_Isr(void);
+
+#endif
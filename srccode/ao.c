@@ -0,0 +1,272 @@
+#include "ao.h"
+
+#if AO_EN > 0
+
+#if (OS_JOB_EN == 0u) || (OS_MEM_EN == 0u)
+#error "AO_ENҪOS_JOB_ENOS_MEM_EN"
+#endif
+
+#if AO_MAX > 32
+#error "AO_MAXܴ32"
+#endif
+
+static AO_EVT const AO_InitEvt = { AO_SIG_INIT, 0u, 0u };
+
+static OS_MEM *AO_Pool[AO_POOL_MAX];	//¼ڴ,С
+static INT32U AO_PoolBlkSize[AO_POOL_MAX];
+static INT8U AO_PoolNbr;
+
+static AO *AO_Tbl[AO_MAX];
+static INT8U AO_Nbr;
+static INT32U AO_SubscrTbl[AO_SIG_MAX];	//ÿźŵĶλͼ
+
+static void AO_Dispatch(void *p_arg, void *pmsg);
+
+/**********************************************/
+//:ʼactive object
+//:none
+//ֵ  :none
+//˵    :OSInit()֮,ڴغAO֮ǰ
+/**********************************************/
+void AO_Init(void)
+{
+	INT16U i;
+
+	AO_PoolNbr = 0u;
+	AO_Nbr = 0u;
+	for (i = 0u; i < AO_SIG_MAX; i++) {
+		AO_SubscrTbl[i] = 0u;
+	}
+}
+
+/**********************************************/
+//:һ¼ڴ
+//:pstorage:ڴصĴ洢
+//          nblks:
+//          blksize:С(ֽ),밴˳ڴ
+//ֵ  :OS_ERR_NONEOSMemCreate()Ĵ
+/**********************************************/
+INT8U AO_PoolInit(void *pstorage, INT32U nblks, INT32U blksize)
+{
+	OS_MEM *pmem;
+	INT8U err;
+
+	if (AO_PoolNbr >= AO_POOL_MAX) {
+		return (OS_ERR_MEM_INVALID_PART);
+	}
+	if ((AO_PoolNbr > 0u) && (blksize <= AO_PoolBlkSize[AO_PoolNbr - 1u])) {
+		return (OS_ERR_MEM_INVALID_SIZE);
+	}
+	pmem = OSMemCreate(pstorage, nblks, blksize, &err);
+	if (err != OS_ERR_NONE) {
+		return (err);
+	}
+	AO_Pool[AO_PoolNbr] = pmem;
+	AO_PoolBlkSize[AO_PoolNbr] = blksize;
+	AO_PoolNbr++;
+	return (OS_ERR_NONE);
+}
+
+/**********************************************/
+//:һȼĵ
+//:pdisp:
+//          prio:ȼ,ȼAO
+//          pstk:ջ͵ַ
+//          stk_size:ջС(OS_STKĸ)
+//          pq:¼еĴ洢,ɸȼAO
+//          q_size:¼г
+//ֵ  :OS_ERR_NONEOSJobLvlCreate()Ĵ
+/**********************************************/
+INT8U AO_DispCreate(AO_DISP * pdisp, INT8U prio, OS_STK * pstk, INT32U stk_size, OS_JOB_MSG * pq, INT16U q_size)
+{
+	return (OSJobLvlCreate(pdisp, prio, pstk, stk_size, pq, q_size));
+}
+
+/**********************************************/
+//:һAO
+//:me:AO
+//          pdisp:иAOĵ
+//          initial:ʼ״̬,յAO_SIG_INIT¼
+//ֵ  :OS_ERR_NONE,OS_ERR_ID_INVALID(AOAO_MAX)OS_ERR_Q_FULL(¼)
+/**********************************************/
+INT8U AO_Start(AO * me, AO_DISP * pdisp, AO_HANDLER initial)
+{
+	if (AO_Nbr >= AO_MAX) {
+		return (OS_ERR_ID_INVALID);
+	}
+	me->state = initial;
+	me->id = AO_Nbr;
+	(void)OSJobCreate(&me->job, pdisp, AO_Dispatch, (void *)me);
+	AO_Tbl[AO_Nbr] = me;
+	AO_Nbr++;
+	return (AO_Post(me, (AO_EVT *)&AO_InitEvt));
+}
+
+/**********************************************/
+//:ڴطһ¼
+//:sig:ź
+//          size:¼С(ֽ,AO_EVT)
+//ֵ  :¼ָ,û㹻ĿпʱΪNULL
+//˵    :же
+/**********************************************/
+AO_EVT *AO_EvtNew(AO_SIG sig, INT32U size)
+{
+	AO_EVT *e;
+	INT8U i;
+	INT8U err;
+
+	for (i = 0u; i < AO_PoolNbr; i++) {
+		if (size <= AO_PoolBlkSize[i]) {
+			e = (AO_EVT *)OSMemGet(AO_Pool[i], &err);
+			if (err == OS_ERR_NONE) {
+				e->sig = sig;
+				e->pool_id = (INT8U)(i + 1u);
+				e->ref_ctr = 0u;
+				return (e);
+			}
+		}
+	}
+	return ((AO_EVT *)0);
+}
+
+/**********************************************/
+//:¼ü,Ϊ0ʱ¼ڴ
+//:e:¼
+//ֵ  :none
+/**********************************************/
+void AO_EvtGc(AO_EVT * e)
+{
+#if OS_CRITICAL_METHOD == 3u
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+	if (e->pool_id == 0u) {	//̬¼
+		return;
+	}
+	OS_ENTER_CRITICAL();
+	if (e->ref_ctr > 1u) {
+		e->ref_ctr--;
+		OS_EXIT_CRITICAL();
+		return;
+	}
+	e->ref_ctr = 0u;
+	OS_EXIT_CRITICAL();
+	(void)OSMemPut(AO_Pool[e->pool_id - 1u], (void *)e);
+}
+
+/**********************************************/
+//:¼͸һAO
+//:me:AO
+//          e:¼
+//ֵ  :OS_ERR_NONEOS_ERR_Q_FULL(¼)
+//˵    :же,ʧʱ̬¼
+/**********************************************/
+INT8U AO_Post(AO * me, AO_EVT * e)
+{
+	INT8U err;
+#if OS_CRITICAL_METHOD == 3u
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+	if (e->pool_id != 0u) {
+		OS_ENTER_CRITICAL();
+		e->ref_ctr++;
+		OS_EXIT_CRITICAL();
+	}
+	err = OSJobPost(&me->job, (void *)e);
+	if (err != OS_ERR_NONE) {
+		AO_EvtGc(e);
+	}
+	return (err);
+}
+
+/**********************************************/
+//:¼͸˸źŵAO
+//:e:¼
+//ֵ  :none
+//˵    :же,ûжʱ̬¼
+/**********************************************/
+void AO_Publish(AO_EVT * e)
+{
+	INT32U subscr;
+	INT8U i;
+#if OS_CRITICAL_METHOD == 3u
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+	if (e->sig >= AO_SIG_MAX) {
+		AO_EvtGc(e);
+		return;
+	}
+	OS_ENTER_CRITICAL();
+	if (e->pool_id != 0u) {	//ֹ¼ڷ͸ඩ֮ǰ
+		e->ref_ctr++;
+	}
+	subscr = AO_SubscrTbl[e->sig];
+	OS_EXIT_CRITICAL();
+	for (i = 0u; subscr != 0u; i++) {
+		if ((subscr & 1u) != 0u) {
+			(void)AO_Post(AO_Tbl[i], e);
+		}
+		subscr >>= 1;
+	}
+	AO_EvtGc(e);
+}
+
+/**********************************************/
+//:ź
+//:me:AO
+//          sig:ź
+//ֵ  :none
+/**********************************************/
+void AO_Subscribe(AO * me, AO_SIG sig)
+{
+#if OS_CRITICAL_METHOD == 3u
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+	if (sig < AO_SIG_MAX) {
+		OS_ENTER_CRITICAL();
+		AO_SubscrTbl[sig] |= (INT32U)1u << me->id;
+		OS_EXIT_CRITICAL();
+	}
+}
+
+/**********************************************/
+//:ȡź
+//:me:AO
+//          sig:ź
+//ֵ  :none
+/**********************************************/
+void AO_Unsubscribe(AO * me, AO_SIG sig)
+{
+#if OS_CRITICAL_METHOD == 3u
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+	if (sig < AO_SIG_MAX) {
+		OS_ENTER_CRITICAL();
+		AO_SubscrTbl[sig] &= ~((INT32U)1u << me->id);
+		OS_EXIT_CRITICAL();
+	}
+}
+
+/**********************************************/
+//:AOҵ,¼AOĵǰ״̬
+//:p_arg:AO
+//          pmsg:¼
+//ֵ  :none
+//˵    :ڵа¼͵˳
+/**********************************************/
+static void AO_Dispatch(void *p_arg, void *pmsg)
+{
+	AO *me;
+	AO_EVT *e;
+
+	me = (AO *) p_arg;
+	e = (AO_EVT *) pmsg;
+	(*me->state) (me, e);	//ִ꼴
+	AO_EvtGc(e);
+}
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef AO_H
+#define AO_H
+
+#include "app_cfg.h"
+
+/*
+ * Active object:
+ * ÿactive object(AO)ӵһ״̬,OS_JOBҵ֮:ÿAOһҵ,ͬһȼ
+ * AOͬһҵ(AO_DISP),,ջ¼,¼͵˳.¼
+ * ָ봫(㿽),̬¼OSMemڴط䲢ü.ִ꼴,ܵ
+ * ķ.
+ */
+
+#define AO_SIG_INIT         0u	//AOʱյĵһ¼
+#define AO_SIG_USER         1u	//ûźŴӴ˿ʼ
+
+typedef INT16U AO_SIG;
+
+typedef struct ao_evt {		//¼,û¼ΪһԱ
+	AO_SIG sig;
+	INT8U pool_id;		//0:̬¼,
+	INT8U ref_ctr;		//δĶ
+} AO_EVT;
+
+typedef struct ao AO;
+
+typedef void (*AO_HANDLER) (AO * me, AO_EVT const *e);
+
+typedef OS_JOB_LVL AO_DISP;	//һȼĵ¼
+
+struct ao {
+	AO_HANDLER state;	//ǰ״̬
+	OS_JOB job;		//¼stateҵ
+	INT8U id;		//λͼеλ
+};
+
+#define AO_TRAN(me, target)	((me)->state = (AO_HANDLER)(target))
+
+extern void AO_Init(void);
+extern INT8U AO_PoolInit(void *pstorage, INT32U nblks, INT32U blksize);
+extern INT8U AO_DispCreate(AO_DISP * pdisp, INT8U prio, OS_STK * pstk, INT32U stk_size, OS_JOB_MSG * pq,
+			   INT16U q_size);
+extern INT8U AO_Start(AO * me, AO_DISP * pdisp, AO_HANDLER initial);
+extern AO_EVT *AO_EvtNew(AO_SIG sig, INT32U size);
+extern void AO_EvtGc(AO_EVT * e);
+extern INT8U AO_Post(AO * me, AO_EVT * e);
+extern void AO_Publish(AO_EVT * e);
+extern void AO_Subscribe(AO * me, AO_SIG sig);
+extern void AO_Unsubscribe(AO * me, AO_SIG sig);
+
+#endif
@@ -5,7 +5,58 @@
 #include "stm32f10x_conf.h"
 #include "ucos_ii.h"
 
-#define TASKSTACK                   512
+#define TASKSTACK                   (128 + OS_TASK_STK_GUARD_SIZE)	//userroot.cڵջС
+
+#define DEV_CON_BUF_SIZE            512	//ڷͻС(2)
+#ifndef DEV_CON_BLOCK_EN
+#define DEV_CON_BLOCK_EN            1	//ʱ,1:ȴDMAڳռ 0:
+#endif
+#define DEV_RX_BUF_SIZE             256	//ڽջС(2)
+
+#ifndef SPI_EN
+#define SPI_EN                      0	//1:DMA SPI(spi.c)DMA1ͨ2ж
+#endif
+
+#ifndef I2C_EN
+#define I2C_EN                      0	//1:DMA I2C(i2c.c),I2C1¼/жϺDMA1ͨ7ж
+#endif
+
+#ifndef ACQ_EN
+#define ACQ_EN                      0	//1:ADCɼ(acq.c,ACQ_Bufʹջ)DMA1ͨ1ж
+#endif
+#define ACQ_BLK_SCANS               64	//ADC˫ÿɨ
+#define ACQ_STK_SIZE                (128 + OS_TASK_STK_GUARD_SIZE)	//ADCջС
+
+#ifndef CAN_EN
+#define CAN_EN                      0	//1:CAN(can.c,շ֡غ߽ṹ)CAN14ж
+#endif
+#define CAN_RX_FRAMES               32	//CAN֡(FIFO͸߶й)
+#define CAN_TX_FRAMES               16	//CAN֡
+
+#ifndef ISOTP_EN
+#define ISOTP_EN                    0	//1:ISO-TPֶδ(isotp.c),ҪCAN_ENOS_MEM_EN
+#endif
+#define ISOTP_BLK_SIZE              256	//ڴС(ֽ,4ı)
+#ifndef ISOTP_BLK_NBR
+#define ISOTP_BLK_NBR               16	//ڴ,ܽյϢ
+#endif
+#define ISOTP_Q_SIZE                32	//֡г
+#define ISOTP_STK_SIZE              (128 + OS_TASK_STK_GUARD_SIZE)	//ջС
+#define ISOTP_TIMEOUT_MS            1000	//ȴ֡ĳʱ(ms)
+#define ISOTP_WFT_MAX               8	//ԷҪȴĴ
+
+#define FMT_LINE_MAX                96	//FMT_Printf()һַ+1
+
+#define LOG_EN                      1	//1:־(log.c,tools/logdec.py) 0:LOGn()ֱFMT_Printf()
+#define LOG_BUF_SIZE                256	//־С(,2)
+#define LOG_STK_SIZE                (128 + OS_TASK_STK_GUARD_SIZE)	//־ջС
+#define LOG_TASK_PRIO               10	//־ȼ
+#define LOG_DRAIN_DLY               10	//û־ʱ߽
+
+#define AO_EN                       1	//1:active object(ao.c),ҪOS_JOB_ENOS_MEM_EN
+#define AO_MAX                      16	//AO(<=32)
+#define AO_SIG_MAX                  32	//źŵĸ
+#define AO_POOL_MAX                 3	//¼ڴص
 
 extern void DEV_HardwareInit(void);
 
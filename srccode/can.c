@@ -0,0 +1,552 @@
+#include "can.h"
+
+#if CAN_EN > 0
+
+#define CAN_FLT_STD_LIST    0u	//÷,˳
+#define CAN_FLT_STD_MASK    1u
+#define CAN_FLT_EXT_LIST    2u
+#define CAN_FLT_EXT_MASK    3u
+
+CAN_BUS CAN_Bus1;
+
+static INT8U const CAN_FltSlots[4] = { 4u, 2u, 2u, 1u };	//ÿɵĶ
+
+static INT8U CAN_FltType(CAN_SUB const *psub);
+static void CAN_FltBank(CAN_BUS * pbus, INT8U type, CAN_SUB * const *slots, INT8U n, INT8U * nfmi);
+static void CAN_FltApply(CAN_BUS * pbus);
+static INT32U CAN_TxKey(INT32U id);
+static void CAN_TxLoad(CAN_BUS * pbus);
+
+/**********************************************/
+//:ʼһCANߵ
+//:pbus:
+//          can:CANĴ,ɵúòģʽ
+//          pframes:nrx+ntx֡
+//          nrx:֡
+//          ntx:֡
+//ֵ  :none
+/**********************************************/
+void CAN_BusInit(CAN_BUS * pbus, CAN_TypeDef * can, CAN_FRAME * pframes, INT16U nrx, INT16U ntx)
+{
+	INT16U i;
+
+	pbus->can = can;
+	pbus->rx_free = (CAN_FRAME *) 0;
+	pbus->tx_free = (CAN_FRAME *) 0;
+	for (i = 0u; i < nrx + ntx; i++) {
+		if (i < nrx) {
+			pframes[i].pool = 0u;
+			pframes[i].next = pbus->rx_free;
+			pbus->rx_free = &pframes[i];
+		} else {
+			pframes[i].pool = 1u;
+			pframes[i].next = pbus->tx_free;
+			pbus->tx_free = &pframes[i];
+		}
+	}
+	pbus->tx_sem = OSSemCreate(ntx);
+	pbus->txq = (CAN_FRAME *) 0;
+	pbus->txq_tail = (CAN_FRAME *) 0;
+	for (i = 0u; i < 3u; i++) {
+		pbus->txmb[i] = (CAN_FRAME *) 0;
+	}
+	pbus->subs = (CAN_SUB *) 0;
+	pbus->banks = 0u;
+	pbus->tx_ctr = 0u;
+	pbus->tx_err_ctr = 0u;
+	pbus->ovr_ctr[0] = 0u;
+	pbus->ovr_ctr[1] = 0u;
+	pbus->nomem_ctr = 0u;
+	pbus->boff_ctr = 0u;
+	CAN_FltApply(pbus);	//ûжʱ
+	can->TSR = CAN_TSR_RQCP0 | CAN_TSR_RQCP1 | CAN_TSR_RQCP2;
+	can->IER = CAN_IER_TMEIE | CAN_IER_FMPIE0 | CAN_IER_FOVIE0 | CAN_IER_FMPIE1 | CAN_IER_FOVIE1
+	    | CAN_IER_BOFIE | CAN_IER_ERRIE;
+}
+
+/**********************************************/
+//:ʼCAN1(PA11:RX,PA12:TX)CAN_Bus1
+//:bitrate:,PCLK1/18Լ,1000000,500000,250000,125000
+//ֵ  :none
+//˵    :78%,Զ߻ָ,Զط
+/**********************************************/
+void CAN_Can1Init(INT32U bitrate)
+{
+	static CAN_FRAME frames[CAN_RX_FRAMES + CAN_TX_FRAMES];
+	GPIO_InitTypeDef GPIO_InitStructure;
+	CAN_InitTypeDef CAN_InitStructure;
+	NVIC_InitTypeDef NVIC_InitStructure;
+	RCC_ClocksTypeDef clocks;
+
+	RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOA | RCC_APB2Periph_AFIO, ENABLE);
+	RCC_APB1PeriphClockCmd(RCC_APB1Periph_CAN1, ENABLE);
+
+	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_11;
+	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IPU;
+	GPIO_Init(GPIOA, &GPIO_InitStructure);
+	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_12;
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_PP;
+	GPIO_Init(GPIOA, &GPIO_InitStructure);
+
+	RCC_GetClocksFreq(&clocks);
+	CAN_DeInit(CAN1);
+	CAN_StructInit(&CAN_InitStructure);
+	CAN_InitStructure.CAN_ABOM = ENABLE;
+	CAN_InitStructure.CAN_TXFP = ENABLE;
+	CAN_InitStructure.CAN_Mode = CAN_Mode_Normal;
+	CAN_InitStructure.CAN_SJW = CAN_SJW_1tq;
+	CAN_InitStructure.CAN_BS1 = CAN_BS1_13tq;
+	CAN_InitStructure.CAN_BS2 = CAN_BS2_4tq;
+	CAN_InitStructure.CAN_Prescaler = (INT16U)(clocks.PCLK1_Frequency / (18u * bitrate));
+	(void)CAN_Init(CAN1, &CAN_InitStructure);
+
+	CAN_BusInit(&CAN_Bus1, CAN1, frames, CAN_RX_FRAMES, CAN_TX_FRAMES);
+
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_InitStructure.NVIC_IRQChannel = USB_HP_CAN1_TX_IRQn;
+	NVIC_Init(&NVIC_InitStructure);
+	NVIC_InitStructure.NVIC_IRQChannel = USB_LP_CAN1_RX0_IRQn;
+	NVIC_Init(&NVIC_InitStructure);
+	NVIC_InitStructure.NVIC_IRQChannel = CAN1_RX1_IRQn;
+	NVIC_Init(&NVIC_InitStructure);
+	NVIC_InitStructure.NVIC_IRQChannel = CAN1_SCE_IRQn;
+	NVIC_Init(&NVIC_InitStructure);
+}
+
+/**********************************************/
+//:ҪĹ÷
+//:psub:
+//ֵ  :CAN_FLT_xxx
+/**********************************************/
+static INT8U CAN_FltType(CAN_SUB const *psub)
+{
+	if ((psub->id & CAN_FRAME_EXT) == 0u) {
+		return (((psub->mask & CAN_ID_MASK_STD) == CAN_ID_MASK_STD) ? CAN_FLT_STD_LIST : CAN_FLT_STD_MASK);
+	}
+	return (((psub->mask & CAN_ID_MASK_EXT) == CAN_ID_MASK_EXT) ? CAN_FLT_EXT_LIST : CAN_FLT_EXT_MASK);
+}
+
+/**********************************************/
+//:һ,дű
+//:pbus:
+//          type:CAN_FLT_xxx
+//          slots:
+//          n:߸,1~CAN_FltSlots[type],ʱظһ
+//          nfmi:FIFOѷĹ
+//ֵ  :none
+//˵    :ڹʼģʽµ.ΪżķָFIFO0,ķָFIFO1
+/**********************************************/
+static void CAN_FltBank(CAN_BUS * pbus, INT8U type, CAN_SUB * const *slots, INT8U n, INT8U * nfmi)
+{
+	CAN_TypeDef *can;
+	CAN_SUB *psub;
+	INT32U r[4];
+	INT32U bit;
+	INT8U fifo;
+	INT8U i;
+
+	can = pbus->can;
+	bit = 1uL << pbus->banks;
+	fifo = pbus->banks & 1u;
+	for (i = 0u; i < CAN_FltSlots[type]; i++) {
+		psub = slots[(i < n) ? i : (n - 1u)];
+		pbus->fmi[fifo][nfmi[fifo] + i] = psub;
+		switch (type) {	//RTRIDEλҪƥ
+		case CAN_FLT_STD_LIST:
+			r[i] = (psub->id & CAN_ID_MASK_STD) << 5;
+			break;
+		case CAN_FLT_STD_MASK:
+			r[i] = ((psub->id & CAN_ID_MASK_STD) << 5) | ((((psub->mask & CAN_ID_MASK_STD) << 5) | 0x18u) << 16);
+			break;
+		case CAN_FLT_EXT_LIST:
+			r[i] = ((psub->id & CAN_ID_MASK_EXT) << 3) | CAN_TI0R_IDE;
+			break;
+		default:
+			r[0] = ((psub->id & CAN_ID_MASK_EXT) << 3) | CAN_TI0R_IDE;
+			r[1] = ((psub->mask & CAN_ID_MASK_EXT) << 3) | CAN_TI0R_IDE | CAN_TI0R_RTR;
+			break;
+		}
+	}
+	if (type == CAN_FLT_STD_LIST) {
+		r[0] |= r[1] << 16;
+		r[1] = r[2] | (r[3] << 16);
+	}
+	can->sFilterRegister[pbus->banks].FR1 = r[0];
+	can->sFilterRegister[pbus->banks].FR2 = r[1];
+	can->FM1R = ((type == CAN_FLT_STD_LIST) || (type == CAN_FLT_EXT_LIST)) ? (can->FM1R | bit) : (can->FM1R & ~bit);
+	can->FS1R = (type >= CAN_FLT_EXT_LIST) ? (can->FS1R | bit) : (can->FS1R & ~bit);
+	can->FFA1R = (fifo != 0u) ? (can->FFA1R | bit) : (can->FFA1R & ~bit);
+	can->FA1R |= bit;
+	nfmi[fifo] += CAN_FltSlots[type];
+	pbus->banks++;
+}
+
+/**********************************************/
+//:ıȫ
+//:pbus:
+//ֵ  :none
+//˵    :ٽڵ,ڼղ֡
+/**********************************************/
+static void CAN_FltApply(CAN_BUS * pbus)
+{
+	CAN_SUB *slots[4];
+	CAN_SUB *psub;
+	INT8U nfmi[2];
+	INT8U type;
+	INT8U n;
+
+	nfmi[0] = 0u;
+	nfmi[1] = 0u;
+	pbus->can->FMR |= CAN_FMR_FINIT;
+	pbus->can->FA1R = 0u;
+	pbus->banks = 0u;
+	for (type = CAN_FLT_STD_LIST; type <= CAN_FLT_EXT_MASK; type++) {
+		n = 0u;
+		for (psub = pbus->subs; psub != (CAN_SUB *) 0; psub = psub->next) {
+			if (CAN_FltType(psub) == type) {
+				slots[n++] = psub;
+				if (n == CAN_FltSlots[type]) {
+					CAN_FltBank(pbus, type, slots, n, nfmi);
+					n = 0u;
+				}
+			}
+		}
+		if (n != 0u) {
+			CAN_FltBank(pbus, type, slots, n, nfmi);
+		}
+	}
+	pbus->can->FMR &= ~CAN_FMR_FINIT;
+}
+
+/**********************************************/
+//:Ӷ,ɹ
+//:pbus:
+//          psub:,id,maskq
+//ֵ  :OS_FALSE:鲻,ûж
+/**********************************************/
+BOOLEAN CAN_Subscribe(CAN_BUS * pbus, CAN_SUB * psub)
+{
+	CAN_SUB *p;
+	INT8U cnt[4];
+	INT8U banks;
+	INT8U i;
+#if OS_CRITICAL_METHOD == 3u
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+	psub->rx_ctr = 0u;
+	psub->drop_ctr = 0u;
+	OS_ENTER_CRITICAL();
+	for (i = 0u; i < 4u; i++) {
+		cnt[i] = 0u;
+	}
+	cnt[CAN_FltType(psub)]++;
+	for (p = pbus->subs; p != (CAN_SUB *) 0; p = p->next) {
+		cnt[CAN_FltType(p)]++;
+	}
+	banks = 0u;
+	for (i = 0u; i < 4u; i++) {
+		banks += (cnt[i] + CAN_FltSlots[i] - 1u) / CAN_FltSlots[i];
+	}
+	if (banks > CAN_FLT_BANKS) {
+		OS_EXIT_CRITICAL();
+		return (OS_FALSE);
+	}
+	psub->next = pbus->subs;
+	pbus->subs = psub;
+	CAN_FltApply(pbus);
+	OS_EXIT_CRITICAL();
+	return (OS_TRUE);
+}
+
+/**********************************************/
+//:ȡһз֡
+//:pbus:
+//          timeout:ȴʱӽ,0:һֱȴ
+//          perr:OSSemPend()Ĵ
+//ֵ  :֡,ʱΪNULL
+/**********************************************/
+CAN_FRAME *CAN_FrameGet(CAN_BUS * pbus, INT32U timeout, INT8U * perr)
+{
+	CAN_FRAME *pframe;
+#if OS_CRITICAL_METHOD == 3u
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+	OSSemPend(pbus->tx_sem, timeout, perr);
+	if (*perr != OS_ERR_NONE) {
+		return ((CAN_FRAME *) 0);
+	}
+	OS_ENTER_CRITICAL();
+	pframe = pbus->tx_free;
+	pbus->tx_free = pframe->next;
+	OS_EXIT_CRITICAL();
+	return (pframe);
+}
+
+/**********************************************/
+//:黹֡
+//:pbus:
+//          pframe:յ֡ûз͵֡
+//ֵ  :none
+//˵    :же
+/**********************************************/
+void CAN_FrameFree(CAN_BUS * pbus, CAN_FRAME * pframe)
+{
+#if OS_CRITICAL_METHOD == 3u
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+	OS_ENTER_CRITICAL();
+	if (pframe->pool == 0u) {
+		pframe->next = pbus->rx_free;
+		pbus->rx_free = pframe;
+		OS_EXIT_CRITICAL();
+	} else {
+		pframe->next = pbus->tx_free;
+		pbus->tx_free = pframe;
+		OS_EXIT_CRITICAL();
+		(void)OSSemPost(pbus->tx_sem);
+	}
+}
+
+/**********************************************/
+//:֡IDٲȼ,ԽСԽ
+//:id:֡ID
+//ֵ  :ȼ
+/**********************************************/
+static INT32U CAN_TxKey(INT32U id)
+{
+	if ((id & CAN_FRAME_EXT) != 0u) {
+		return (id & CAN_ID_MASK_EXT);
+	}
+	return ((id & CAN_ID_MASK_STD) << 18);
+}
+
+/**********************************************/
+//:÷Ͷ
+//:pbus:
+//ֵ  :none
+//˵    :ٽڵ
+/**********************************************/
+static void CAN_TxLoad(CAN_BUS * pbus)
+{
+	CAN_TxMailBox_TypeDef *mb;
+	CAN_FRAME *pframe;
+	INT32U tsr;
+	INT8U i;
+
+	tsr = pbus->can->TSR;
+	for (i = 0u; (i < 3u) && (pbus->txq != (CAN_FRAME *) 0); i++) {
+		if ((tsr & (CAN_TSR_TME0 << i)) == 0u) {
+			continue;
+		}
+		pframe = pbus->txq;
+		pbus->txq = pframe->next;
+		if (pbus->txq == (CAN_FRAME *) 0) {
+			pbus->txq_tail = (CAN_FRAME *) 0;
+		}
+		pbus->txmb[i] = pframe;
+		mb = &pbus->can->sTxMailBox[i];
+		mb->TDTR = pframe->dlc;
+		mb->TDLR = pframe->data[0] | ((INT32U)pframe->data[1] << 8) | ((INT32U)pframe->data[2] << 16)
+		    | ((INT32U)pframe->data[3] << 24);
+		mb->TDHR = pframe->data[4] | ((INT32U)pframe->data[5] << 8) | ((INT32U)pframe->data[6] << 16)
+		    | ((INT32U)pframe->data[7] << 24);
+		if ((pframe->id & CAN_FRAME_EXT) != 0u) {
+			mb->TIR = ((pframe->id & CAN_ID_MASK_EXT) << 3) | CAN_TI0R_IDE | CAN_TI0R_TXRQ;
+		} else {
+			mb->TIR = ((pframe->id & CAN_ID_MASK_STD) << 21) | CAN_TI0R_TXRQ;
+		}
+	}
+}
+
+/**********************************************/
+//:֡IDȼ뷢Ͷ,пʱ
+//:pbus:
+//          pframe:CAN_FrameGet()õ֡,id,dlcdata,ͺԶ黹
+//ֵ  :none
+//˵    :ͬһID֡˳
+/**********************************************/
+void CAN_Post(CAN_BUS * pbus, CAN_FRAME * pframe)
+{
+	CAN_FRAME **pp;
+	INT32U key;
+#if OS_CRITICAL_METHOD == 3u
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+	key = CAN_TxKey(pframe->id);
+	OS_ENTER_CRITICAL();
+	if ((pbus->txq_tail == (CAN_FRAME *) 0) || (CAN_TxKey(pbus->txq_tail->id) <= key)) {
+		pframe->next = (CAN_FRAME *) 0;
+		if (pbus->txq_tail == (CAN_FRAME *) 0) {
+			pbus->txq = pframe;
+		} else {
+			pbus->txq_tail->next = pframe;
+		}
+		pbus->txq_tail = pframe;
+	} else {
+		pp = &pbus->txq;
+		while (CAN_TxKey((*pp)->id) <= key) {
+			pp = &(*pp)->next;
+		}
+		pframe->next = *pp;
+		*pp = pframe;
+	}
+	CAN_TxLoad(pbus);
+	OS_EXIT_CRITICAL();
+}
+
+/**********************************************/
+//:һ֡
+//:pbus:
+//          id:11λCAN_FRAME_EXT|29λ
+//          pdata:
+//          len:0~8
+//          timeout:ȴ֡ʱӽ,0:һֱȴ
+//ֵ  :OS_ERR_NONECAN_FrameGet()Ĵ
+/**********************************************/
+INT8U CAN_Write(CAN_BUS * pbus, INT32U id, INT8U const *pdata, INT8U len, INT32U timeout)
+{
+	CAN_FRAME *pframe;
+	INT8U err;
+	INT8U i;
+
+	pframe = CAN_FrameGet(pbus, timeout, &err);
+	if (pframe == (CAN_FRAME *) 0) {
+		return (err);
+	}
+	pframe->id = id;
+	pframe->dlc = (len > 8u) ? 8u : len;
+	for (i = 0u; i < pframe->dlc; i++) {
+		pframe->data[i] = pdata[i];
+	}
+	CAN_Post(pbus, pframe);
+	return (OS_ERR_NONE);
+}
+
+/**********************************************/
+//:ж,FIFOе֡ߵĶ
+//:pbus:
+//          fifo:01
+//ֵ  :none
+/**********************************************/
+void CAN_RxIsr(CAN_BUS * pbus, INT8U fifo)
+{
+	CAN_FIFOMailBox_TypeDef *mb;
+	volatile INT32U *rfr;
+	CAN_FRAME *pframe;
+	CAN_SUB *psub;
+	INT32U rir;
+	INT32U rdtr;
+	INT32U d;
+	INT8U fmi;
+	INT8U n;
+#if OS_CRITICAL_METHOD == 3u
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+	mb = &pbus->can->sFIFOMailBox[fifo];
+	rfr = (fifo == 0u) ? &pbus->can->RF0R : &pbus->can->RF1R;
+	for (n = (INT8U)(*rfr & CAN_RF0R_FMP0); n > 0u; n--) {	//жϷغµ֡ٴδ
+		rir = mb->RIR;
+		rdtr = mb->RDTR;
+		fmi = (INT8U)(rdtr >> 8);
+		psub = (fmi < CAN_FLT_BANKS * 4u) ? pbus->fmi[fifo][fmi] : (CAN_SUB *) 0;
+		if (psub != (CAN_SUB *) 0) {
+			OS_ENTER_CRITICAL();
+			pframe = pbus->rx_free;
+			if (pframe != (CAN_FRAME *) 0) {
+				pbus->rx_free = pframe->next;
+			}
+			OS_EXIT_CRITICAL();
+			if (pframe == (CAN_FRAME *) 0) {
+				pbus->nomem_ctr++;
+				psub->drop_ctr++;
+			} else {
+				if ((rir & CAN_RI0R_IDE) != 0u) {
+					pframe->id = (rir >> 3) | CAN_FRAME_EXT;
+				} else {
+					pframe->id = rir >> 21;
+				}
+				pframe->dlc = (INT8U)(rdtr & 0x0Fu);
+				d = mb->RDLR;
+				pframe->data[0] = (INT8U)d;
+				pframe->data[1] = (INT8U)(d >> 8);
+				pframe->data[2] = (INT8U)(d >> 16);
+				pframe->data[3] = (INT8U)(d >> 24);
+				d = mb->RDHR;
+				pframe->data[4] = (INT8U)d;
+				pframe->data[5] = (INT8U)(d >> 8);
+				pframe->data[6] = (INT8U)(d >> 16);
+				pframe->data[7] = (INT8U)(d >> 24);
+				if (OSQPost(psub->q, (void *)pframe) == OS_ERR_NONE) {
+					psub->rx_ctr++;
+				} else {
+					CAN_FrameFree(pbus, pframe);
+					psub->drop_ctr++;
+				}
+			}
+		}
+		*rfr = CAN_RF0R_RFOM0;
+	}
+	if ((*rfr & CAN_RF0R_FOVR0) != 0u) {
+		pbus->ovr_ctr[fifo]++;
+		*rfr = CAN_RF0R_FOVR0;
+	}
+}
+
+/**********************************************/
+//:ж,黹֡,
+//:pbus:
+//ֵ  :none
+/**********************************************/
+void CAN_TxIsr(CAN_BUS * pbus)
+{
+	CAN_FRAME *pframe;
+	INT32U tsr;
+	INT8U i;
+#if OS_CRITICAL_METHOD == 3u
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+	tsr = pbus->can->TSR;
+	for (i = 0u; i < 3u; i++) {
+		if ((tsr & (CAN_TSR_RQCP0 << (8u * i))) != 0u) {
+			pbus->can->TSR = CAN_TSR_RQCP0 << (8u * i);	//ͬʱTXOK,ALST,TERR
+			if ((tsr & (CAN_TSR_TXOK0 << (8u * i))) != 0u) {
+				pbus->tx_ctr++;
+			} else {
+				pbus->tx_err_ctr++;
+			}
+			pframe = pbus->txmb[i];
+			pbus->txmb[i] = (CAN_FRAME *) 0;
+			if (pframe != (CAN_FRAME *) 0) {
+				CAN_FrameFree(pbus, pframe);
+			}
+		}
+	}
+	OS_ENTER_CRITICAL();
+	CAN_TxLoad(pbus);
+	OS_EXIT_CRITICAL();
+}
+
+/**********************************************/
+//:״̬仯ʹж
+//:pbus:
+//ֵ  :none
+//˵    :ߺӲԶָ,ֻ
+/**********************************************/
+void CAN_SceIsr(CAN_BUS * pbus)
+{
+	if ((pbus->can->ESR & CAN_ESR_BOFF) != 0u) {
+		pbus->boff_ctr++;
+	}
+	pbus->can->MSR = CAN_MSR_ERRI;
+}
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef CAN_H
+#define CAN_H
+
+#include "app_cfg.h"
+
+/*
+ * жCAN:
+ * :ıԶӲ(ȷı׼ID 4һ16λб,ı׼ID 2һ,
+ * չID 32λб2һ,չIDÿһ),齻FIFO0FIFO1.
+ * жϰ(FMI)ֱӲ鵽,֡,ָ֡뷢ߵOS_Q,
+ * ֻһ;ߴCAN_FrameFree().ֻ֡.
+ * :֡IDȼ,˾Ӷв.䰴˳(TXFP),
+ * ͬһID֡,ȼ֡.
+ * ĴͨCAN_BUSеָ,ʱָڴе.
+ */
+
+#define CAN_FRAME_EXT       0x80000000uL	//idеչ֡־
+#define CAN_ID_MASK_STD     0x000007FFuL
+#define CAN_ID_MASK_EXT     0x1FFFFFFFuL
+#define CAN_FLT_BANKS       14u	//CAN1Ĺ
+
+typedef struct can_frame CAN_FRAME;
+typedef struct can_sub CAN_SUB;
+
+struct can_frame {
+	CAN_FRAME *next;	//Ͷ
+	INT32U id;		//11λCAN_FRAME_EXT|29λ
+	INT8U dlc;
+	INT8U pool;		//0:֡ 1:֡
+	INT8U data[8];
+};
+
+struct can_sub {
+	INT32U id;		//11λCAN_FRAME_EXT|29λ
+	INT32U mask;		//Ϊ1λidͬ,ȫ1:ȷƥ
+	OS_EVENT *q;		//ն,յCAN_FRAME *
+	INT32U rx_ctr;		//е֡
+	INT32U drop_ctr;	//ûп֡֡
+	CAN_SUB *next;
+};
+
+typedef struct can_bus {
+	CAN_TypeDef *can;
+	CAN_FRAME *rx_free;
+	CAN_FRAME *tx_free;
+	OS_EVENT *tx_sem;	//з֡ĸ
+	CAN_FRAME *txq;		//Ͷ,ID
+	CAN_FRAME *txq_tail;
+	CAN_FRAME *txmb[3];	//е֡
+	CAN_SUB *subs;
+	CAN_SUB *fmi[2][CAN_FLT_BANKS * 4u];	//FIFO͹ŶӦĶ
+	INT8U banks;		//õĹ
+	INT32U tx_ctr;		//ͳ
+	INT32U tx_err_ctr;
+	INT32U ovr_ctr[2];
+	INT32U nomem_ctr;
+	INT32U boff_ctr;
+} CAN_BUS;
+
+extern CAN_BUS CAN_Bus1;
+
+extern void CAN_BusInit(CAN_BUS * pbus, CAN_TypeDef * can, CAN_FRAME * pframes, INT16U nrx, INT16U ntx);
+extern void CAN_Can1Init(INT32U bitrate);
+extern BOOLEAN CAN_Subscribe(CAN_BUS * pbus, CAN_SUB * psub);
+extern CAN_FRAME *CAN_FrameGet(CAN_BUS * pbus, INT32U timeout, INT8U * perr);
+extern void CAN_FrameFree(CAN_BUS * pbus, CAN_FRAME * pframe);
+extern void CAN_Post(CAN_BUS * pbus, CAN_FRAME * pframe);
+extern INT8U CAN_Write(CAN_BUS * pbus, INT32U id, INT8U const *pdata, INT8U len, INT32U timeout);
+extern void CAN_RxIsr(CAN_BUS * pbus, INT8U fifo);
+extern void CAN_TxIsr(CAN_BUS * pbus);
+extern void CAN_SceIsr(CAN_BUS * pbus);
+
+#endif
@@ -3,6 +3,25 @@
 #include <stdarg.h>
 #include <string.h>
 
+static INT8U DEV_ConBuf[DEV_CON_BUF_SIZE];	//ڷͻλ
+static volatile INT16U DEV_ConHead;	//дλ(ɼ)
+static volatile INT16U DEV_ConTail;	//DMAѷλ(ɼ)
+static volatile INT16U DEV_ConDmaLen;	//DMAڷ͵ֽ,0:DMA
+static OS_EVENT *DEV_ConSem;	//DMAÿһͷһ
+static OS_EVENT *DEV_ConLock;	//DEV_WriteAll()Ļź
+INT32U DEV_ConDropCtr;		//򻺳ֽ
+
+static INT8U DEV_RxBuf[DEV_RX_BUF_SIZE];	//ڽջλ,DMAѭģʽд
+static INT16U DEV_RxPos;	//һοDMAдλ
+static volatile INT16U DEV_RxHead;	//յλ(ɼ)
+static volatile INT16U DEV_RxTail;	//Ѷߵλ(ɼ)
+static OS_EVENT *DEV_RxSem;	//ÿͷһ
+INT32U DEV_RxOvfCtr;		//̫DMAǵĴ
+
+static void DEV_ConKick(void);
+static BOOLEAN DEV_ConPend(void);
+static void DEV_RxSync(void);
+
 /**********************************************/
 //:ʼӲ
 //:none
@@ -36,9 +55,168 @@ void DEV_UartInit(void)
 	GPIO_Init(GPIOA, &GPIO_InitStructure);
 
 	USART_StructInit(&USART_InitStructure);
-	USART_Init(USART1, &USART_InitStructure);
-	USART_Cmd(USART1, ENABLE);
+	USART_Init(DEV_CON_USART, &USART_InitStructure);
+	USART_Cmd(DEV_CON_USART, ENABLE);
+
+	DEV_ConDmaInit();
+	DEV_RxDmaInit();
+}
+
+/**********************************************/
+//:ʼڷDMA
+//:none
+//ֵ  :none
+//˵    :ҪOSInit()֮
+/**********************************************/
+void DEV_ConDmaInit(void)
+{
+	DMA_InitTypeDef DMA_InitStructure;
+	NVIC_InitTypeDef NVIC_InitStructure;
+
+	DEV_ConHead = 0u;
+	DEV_ConTail = 0u;
+	DEV_ConDmaLen = 0u;
+	DEV_ConDropCtr = 0u;
+	DEV_ConSem = OSSemCreate(0u);
+	DEV_ConLock = OSSemCreate(1u);
+
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
 
+	DMA_DeInit(DEV_CON_DMA_CH);
+	DMA_InitStructure.DMA_PeripheralBaseAddr = (INT32U) & DEV_CON_USART->DR;
+	DMA_InitStructure.DMA_MemoryBaseAddr = (INT32U) & DEV_ConBuf[0];
+	DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;
+	DMA_InitStructure.DMA_BufferSize = 1u;
+	DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+	DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+	DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+	DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+	DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+	DMA_InitStructure.DMA_Priority = DMA_Priority_Low;
+	DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+	DMA_Init(DEV_CON_DMA_CH, &DMA_InitStructure);
+	DMA_ITConfig(DEV_CON_DMA_CH, DMA_IT_TC, ENABLE);
+	USART_DMACmd(DEV_CON_USART, USART_DMAReq_Tx, ENABLE);
+
+	NVIC_InitStructure.NVIC_IRQChannel = DEV_CON_DMA_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+}
+
+/**********************************************/
+//:DMAʱ,ѻһνDMA
+//:none
+//ֵ  :none
+//˵    :ٽڵ
+/**********************************************/
+static void DEV_ConKick(void)
+{
+	INT16U pos;
+	INT16U len;
+
+	if ((DEV_ConDmaLen != 0u) || (DEV_ConHead == DEV_ConTail)) {
+		return;
+	}
+	pos = DEV_ConTail & (DEV_CON_BUF_SIZE - 1u);
+	len = (INT16U)(DEV_ConHead - DEV_ConTail);
+	if (len > DEV_CON_BUF_SIZE - pos) {	//Խĩβ,Ʋһη
+		len = DEV_CON_BUF_SIZE - pos;
+	}
+	DEV_ConDmaLen = len;
+	DEV_CON_DMA_CH->CMAR = (INT32U) & DEV_ConBuf[pos];
+	DMA_SetCurrDataCounter(DEV_CON_DMA_CH, len);
+	DMA_Cmd(DEV_CON_DMA_CH, ENABLE);
+}
+
+/**********************************************/
+//:ȴDMAһ
+//:none
+//ֵ  :OS_FALSE:ж,ܵȴ
+//˵    :OSStart()֮ǰʱæ,DMAжڳռ
+/**********************************************/
+static BOOLEAN DEV_ConPend(void)
+{
+	INT8U err;
+
+	if (OSIntNesting > 0u) {
+		return (OS_FALSE);
+	}
+	if ((OSRunning == OS_TRUE) && (OSLockNesting == 0u)) {
+		OSSemPend(DEV_ConSem, 0u, &err);
+	}
+	return (OS_TRUE);
+}
+
+/**********************************************/
+//:д봮ڷͻ,
+//:pbuf:
+//          len:ֽ
+//ֵ  :дֽ,Ҳܵȴʱֽڱ
+/**********************************************/
+INT16U DEV_Write(INT8U const *pbuf, INT16U len)
+{
+	INT16U n;
+	INT16U free;
+	INT16U i;
+#if OS_CRITICAL_METHOD == 3u
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+	n = 0u;
+	while (n < len) {
+		OS_ENTER_CRITICAL();
+		free = (INT16U)(DEV_CON_BUF_SIZE - (INT16U)(DEV_ConHead - DEV_ConTail));
+		if (free != 0u) {
+			if (free > len - n) {
+				free = len - n;
+			}
+			if (free > 16u) {	//ƹжϵʱ
+				free = 16u;
+			}
+			for (i = 0u; i < free; i++) {
+				DEV_ConBuf[(INT16U)(DEV_ConHead + i) & (DEV_CON_BUF_SIZE - 1u)] = pbuf[n + i];
+			}
+			DEV_ConHead += free;
+			n += free;
+			DEV_ConKick();
+			OS_EXIT_CRITICAL();
+			continue;
+		}
+		OS_EXIT_CRITICAL();
+#if DEV_CON_BLOCK_EN > 0
+		if (DEV_ConPend() == OS_FALSE)
+#endif
+		{
+			OS_ENTER_CRITICAL();
+			DEV_ConDropCtr += len - n;
+			OS_EXIT_CRITICAL();
+			break;
+		}
+	}
+	return (n);
+}
+
+/**********************************************/
+//:һд봮ڷͻ,DEV_WriteAll()
+//:pbuf:
+//          len:ֽ
+//ֵ  :дֽ
+//˵    :жлOSStart()֮ǰ
+/**********************************************/
+INT16U DEV_WriteAll(INT8U const *pbuf, INT16U len)
+{
+	INT16U n;
+	INT8U err;
+
+	if ((OSIntNesting > 0u) || (OSRunning == OS_FALSE)) {
+		return (DEV_Write(pbuf, len));
+	}
+	OSSemPend(DEV_ConLock, 0u, &err);
+	n = DEV_Write(pbuf, len);
+	(void)OSSemPost(DEV_ConLock);
+	return (n);
 }
 
 /**********************************************/
@@ -48,6 +226,231 @@ void DEV_UartInit(void)
 /**********************************************/
 void DEV_PutChar(INT8U ucChar)
 {
-	while (USART_GetFlagStatus(USART1, USART_FLAG_TXE) == RESET);
-	USART_SendData(USART1, ucChar);
+	(void)DEV_Write(&ucChar, 1u);
+}
+
+/**********************************************/
+//:ȴеȫ
+//:none
+//ֵ  :none
+//˵    :жеʱ
+/**********************************************/
+void DEV_Flush(void)
+{
+	while (DEV_ConHead != DEV_ConTail) {
+		if (DEV_ConPend() == OS_FALSE) {
+			return;
+		}
+	}
+	while (USART_GetFlagStatus(DEV_CON_USART, USART_FLAG_TC) == RESET);	//һַƳ
+}
+
+/**********************************************/
+//:ڷDMAжϴ
+//:none
+//ֵ  :none
+/**********************************************/
+void DEV_ConDmaIsr(void)
+{
+#if OS_CRITICAL_METHOD == 3u
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+	if (DMA_GetITStatus(DEV_CON_DMA_IT_TC) == RESET) {
+		return;
+	}
+	DMA_ClearITPendingBit(DEV_CON_DMA_IT_TC);
+	OS_ENTER_CRITICAL();
+	DMA_Cmd(DEV_CON_DMA_CH, DISABLE);
+	DEV_ConTail += DEV_ConDmaLen;
+	DEV_ConDmaLen = 0u;
+	DEV_ConKick();
+	OS_EXIT_CRITICAL();
+	if (DEV_ConSem->OSEventCnt == 0u) {	//ֻҪһλ,ȴ߻¼
+		(void)OSSemPost(DEV_ConSem);
+	}
+}
+
+/**********************************************/
+//:ʼڽDMA(ѭģʽ)Ϳж
+//:none
+//ֵ  :none
+//˵    :ҪOSInit()֮
+/**********************************************/
+void DEV_RxDmaInit(void)
+{
+	DMA_InitTypeDef DMA_InitStructure;
+	NVIC_InitTypeDef NVIC_InitStructure;
+
+	DEV_RxPos = 0u;
+	DEV_RxHead = 0u;
+	DEV_RxTail = 0u;
+	DEV_RxOvfCtr = 0u;
+	DEV_RxSem = OSSemCreate(0u);
+
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
+
+	DMA_DeInit(DEV_RX_DMA_CH);
+	DMA_InitStructure.DMA_PeripheralBaseAddr = (INT32U) & DEV_CON_USART->DR;
+	DMA_InitStructure.DMA_MemoryBaseAddr = (INT32U) & DEV_RxBuf[0];
+	DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralSRC;
+	DMA_InitStructure.DMA_BufferSize = DEV_RX_BUF_SIZE;
+	DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+	DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+	DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+	DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+	DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+	DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+	DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+	DMA_Init(DEV_RX_DMA_CH, &DMA_InitStructure);
+	DMA_ITConfig(DEV_RX_DMA_CH, DMA_IT_HT | DMA_IT_TC, ENABLE);	//֪ͨһ
+	DMA_Cmd(DEV_RX_DMA_CH, ENABLE);
+	USART_DMACmd(DEV_CON_USART, USART_DMAReq_Rx, ENABLE);
+	USART_ITConfig(DEV_CON_USART, USART_IT_IDLE, ENABLE);	//һݽ
+
+	NVIC_InitStructure.NVIC_IRQChannel = DEV_RX_DMA_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+	NVIC_InitStructure.NVIC_IRQChannel = DEV_CON_IRQn;
+	NVIC_Init(&NVIC_InitStructure);
+}
+
+/**********************************************/
+//:DMAʣյλ
+//:none
+//ֵ  :none
+//˵    :ٽڵ
+/**********************************************/
+static void DEV_RxSync(void)
+{
+	INT16U pos;
+
+	pos = (INT16U)(DEV_RX_BUF_SIZE - DMA_GetCurrDataCounter(DEV_RX_DMA_CH)) & (DEV_RX_BUF_SIZE - 1u);
+	DEV_RxHead += (INT16U)(pos - DEV_RxPos) & (DEV_RX_BUF_SIZE - 1u);
+	DEV_RxPos = pos;
+	if ((INT16U)(DEV_RxHead - DEV_RxTail) > DEV_RX_BUF_SIZE) {	//δѱ
+		DEV_RxTail = DEV_RxHead - DEV_RX_BUF_SIZE;
+		DEV_RxOvfCtr++;
+	}
+}
+
+/**********************************************/
+//:ڽ֪ͨ,ɿжϺDMA/ȫжϵ
+//:none
+//ֵ  :none
+/**********************************************/
+void DEV_RxIsr(void)
+{
+	INT16U head;
+#if OS_CRITICAL_METHOD == 3u
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+	OS_ENTER_CRITICAL();
+	head = DEV_RxHead;
+	DEV_RxSync();
+	if ((DEV_RxHead != head) && (DEV_RxSem->OSEventCnt == 0u)) {	//ÿֻһ
+		OS_EXIT_CRITICAL();
+		(void)OSSemPost(DEV_RxSem);
+		return;
+	}
+	OS_EXIT_CRITICAL();
+}
+
+/**********************************************/
+//:ȡýջһδ,
+//:pp:ݵĵַ
+//ֵ  :ֽ,ݻʱ²һȡ
+//˵    :ֻһ,DEV_RxConsume()
+/**********************************************/
+INT16U DEV_RxPeek(INT8U ** pp)
+{
+	INT16U avail;
+	INT16U pos;
+#if OS_CRITICAL_METHOD == 3u
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+	OS_ENTER_CRITICAL();
+	DEV_RxSync();		//ûджϵ
+	avail = (INT16U)(DEV_RxHead - DEV_RxTail);
+	pos = DEV_RxTail & (DEV_RX_BUF_SIZE - 1u);
+	OS_EXIT_CRITICAL();
+	if (avail > DEV_RX_BUF_SIZE - pos) {
+		avail = DEV_RX_BUF_SIZE - pos;
+	}
+	*pp = &DEV_RxBuf[pos];
+	return (avail);
+}
+
+/**********************************************/
+//:ͷDEV_RxPeek()ȡõ
+//:len:ֽ
+//ֵ  :none
+/**********************************************/
+void DEV_RxConsume(INT16U len)
+{
+#if OS_CRITICAL_METHOD == 3u
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+	OS_ENTER_CRITICAL();
+	if (len > (INT16U)(DEV_RxHead - DEV_RxTail)) {
+		len = (INT16U)(DEV_RxHead - DEV_RxTail);
+	}
+	DEV_RxTail += len;
+	OS_EXIT_CRITICAL();
+}
+
+/**********************************************/
+//:Ӵڶ,ûʱȴ
+//:pbuf:
+//          len:ֽ
+//          timeout:ȴʱӽ,0:һֱȴ
+//          perr:OS_ERR_NONEOSSemPend()Ĵ
+//ֵ  :ֽ,ʱ
+//˵    :źܱѾߵݻ,ٴεȴʱֻʣµĽ
+/**********************************************/
+INT16U DEV_Read(INT8U * pbuf, INT16U len, INT32U timeout, INT8U * perr)
+{
+	INT8U *p;
+	INT16U n;
+	INT16U span;
+	INT32U start;
+	INT32U dly;
+
+	n = 0u;
+	start = OSTimeGet();
+	while (n < len) {
+		span = DEV_RxPeek(&p);
+		if (span == 0u) {
+			if (n != 0u) {
+				break;
+			}
+			dly = 0u;
+			if (timeout != 0u) {
+				dly = OSTimeGet() - start;
+				if (dly >= timeout) {
+					*perr = OS_ERR_TIMEOUT;
+					return (0u);
+				}
+				dly = timeout - dly;	//ʣµĽ
+			}
+			OSSemPend(DEV_RxSem, dly, perr);
+			if (*perr != OS_ERR_NONE) {
+				return (0u);
+			}
+			continue;
+		}
+		if (span > len - n) {
+			span = len - n;
+		}
+		memcpy(&pbuf[n], p, span);
+		DEV_RxConsume(span);
+		n += span;
+	}
+	*perr = OS_ERR_NONE;
+	return (n);
 }
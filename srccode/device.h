@@ -3,7 +3,30 @@
 
 #include "app_cfg.h"
 
+#ifndef DEV_CON_USART		//ʱ滻ڴеļĴ
+#define DEV_CON_USART               USART1
+#define DEV_CON_DMA_CH              DMA1_Channel4	//USART1_TX
+#define DEV_CON_DMA_IT_TC           DMA1_IT_TC4
+#define DEV_CON_DMA_IRQn            DMA1_Channel4_IRQn
+#define DEV_CON_IRQn                USART1_IRQn
+#define DEV_RX_DMA_CH               DMA1_Channel5	//USART1_RX
+#define DEV_RX_DMA_IRQn             DMA1_Channel5_IRQn
+#endif
+
+extern INT32U DEV_ConDropCtr;
+extern INT32U DEV_RxOvfCtr;
+
 extern void DEV_UartInit(void);
+extern void DEV_ConDmaInit(void);
+extern INT16U DEV_Write(INT8U const *pbuf, INT16U len);
+extern INT16U DEV_WriteAll(INT8U const *pbuf, INT16U len);
 extern void DEV_PutChar(INT8U ucChar);
+extern void DEV_Flush(void);
+extern void DEV_ConDmaIsr(void);
+extern void DEV_RxDmaInit(void);
+extern void DEV_RxIsr(void);
+extern INT16U DEV_RxPeek(INT8U ** pp);
+extern void DEV_RxConsume(INT16U len);
+extern INT16U DEV_Read(INT8U * pbuf, INT16U len, INT32U timeout, INT8U * perr);
 
 #endif
@@ -0,0 +1,439 @@
+#include "dsp.h"
+#include <math.h>
+
+#define DSP_SAT16(x)        ((x) > 32767 ? (Q15)32767 : ((x) < -32768 ? (Q15)-32768 : (Q15)(x)))
+#define DSP_SAT32(x)        ((x) > 2147483647LL ? (Q31)2147483647 : ((x) < -2147483647LL - 1 ? (Q31)(-2147483647 - 1) : (Q31)(x)))
+
+/**********************************************/
+//:ʼQ15 FIR
+//:pfir:˲
+//          coef:ϵh[0]~h[ntaps-1]
+//          ntaps:+1
+//          state:2*ntapsQ15
+//ֵ  :none
+/**********************************************/
+void DSP_FirQ15Init(DSP_FIR_Q15 * pfir, Q15 const *coef, INT16U ntaps, Q15 * state)
+{
+	INT16U i;
+
+	pfir->coef = coef;
+	pfir->state = state;
+	pfir->ntaps = ntaps;
+	pfir->pos = 0u;
+	for (i = 0u; i < 2u * ntaps; i++) {
+		state[i] = 0;
+	}
+}
+
+/**********************************************/
+//:һQ15 FIRӳ,һ
+//:pfir:˲
+//          x:
+//          calc:OS_FALSE:ֻ(ȡʱ)
+//ֵ  :
+/**********************************************/
+static Q15 DSP_FirQ15Step(DSP_FIR_Q15 * pfir, Q15 x, BOOLEAN calc)
+{
+	Q15 const *c;
+	Q15 const *p;
+	DSP_ACC acc;
+	INT16U k;
+
+	pfir->pos = (pfir->pos == 0u) ? (INT16U)(pfir->ntaps - 1u) : (INT16U)(pfir->pos - 1u);
+	pfir->state[pfir->pos] = x;	//x[n-k]pos+k
+	pfir->state[pfir->pos + pfir->ntaps] = x;
+	if (calc == OS_FALSE) {
+		return (0);
+	}
+	c = pfir->coef;
+	p = &pfir->state[pfir->pos];
+	acc = 0;
+	for (k = pfir->ntaps >> 2; k > 0u; k--) {	//չ4
+		acc += (INT32S)c[0] * p[0];
+		acc += (INT32S)c[1] * p[1];
+		acc += (INT32S)c[2] * p[2];
+		acc += (INT32S)c[3] * p[3];
+		c += 4;
+		p += 4;
+	}
+	for (k = pfir->ntaps & 3u; k > 0u; k--) {
+		acc += (INT32S)*c++ * *p++;
+	}
+	acc >>= 15;
+	return (DSP_SAT16(acc));
+}
+
+/**********************************************/
+//:Q15 FIR
+//:pfir:˲
+//          pin:
+//          pout:,pinͬ
+//          n:
+//ֵ  :none
+/**********************************************/
+void DSP_FirQ15(DSP_FIR_Q15 * pfir, Q15 const *pin, Q15 * pout, INT16U n)
+{
+	while (n > 0u) {
+		*pout++ = DSP_FirQ15Step(pfir, *pin++, OS_TRUE);
+		n--;
+	}
+}
+
+/**********************************************/
+//:ʼQ31 FIR
+//:pfir:˲
+//          coef:ϵh[0]~h[ntaps-1]
+//          ntaps:+1
+//          state:2*ntapsQ31
+//ֵ  :none
+/**********************************************/
+void DSP_FirQ31Init(DSP_FIR_Q31 * pfir, Q31 const *coef, INT16U ntaps, Q31 * state)
+{
+	INT16U i;
+
+	pfir->coef = coef;
+	pfir->state = state;
+	pfir->ntaps = ntaps;
+	pfir->pos = 0u;
+	for (i = 0u; i < 2u * ntaps; i++) {
+		state[i] = 0;
+	}
+}
+
+/**********************************************/
+//:Q31 FIR
+//:pfir:˲
+//          pin:
+//          pout:,pinͬ
+//          n:
+//ֵ  :none
+/**********************************************/
+void DSP_FirQ31(DSP_FIR_Q31 * pfir, Q31 const *pin, Q31 * pout, INT16U n)
+{
+	Q31 const *c;
+	Q31 const *p;
+	DSP_ACC acc;
+	INT16U k;
+
+	while (n > 0u) {
+		pfir->pos = (pfir->pos == 0u) ? (INT16U)(pfir->ntaps - 1u) : (INT16U)(pfir->pos - 1u);
+		pfir->state[pfir->pos] = *pin;
+		pfir->state[pfir->pos + pfir->ntaps] = *pin++;
+		c = pfir->coef;
+		p = &pfir->state[pfir->pos];
+		acc = 0;
+		for (k = pfir->ntaps >> 2; k > 0u; k--) {	//SMLAL,չ4
+			acc += (DSP_ACC) c[0] * p[0];
+			acc += (DSP_ACC) c[1] * p[1];
+			acc += (DSP_ACC) c[2] * p[2];
+			acc += (DSP_ACC) c[3] * p[3];
+			c += 4;
+			p += 4;
+		}
+		for (k = pfir->ntaps & 3u; k > 0u; k--) {
+			acc += (DSP_ACC) * c++ * *p++;
+		}
+		acc >>= 31;
+		*pout++ = DSP_SAT32(acc);
+		n--;
+	}
+}
+
+/**********************************************/
+//:ʼQ15ȡFIR
+//:pdec:˲
+//          coef:ϵ,ӦǽֹƵʵο˹Ƶʵĵͨ
+//          ntaps:+1
+//          m:ȡ
+//          state:2*ntapsQ15
+//ֵ  :none
+/**********************************************/
+void DSP_FirDecimQ15Init(DSP_FIR_DECIM_Q15 * pdec, Q15 const *coef, INT16U ntaps, INT16U m, Q15 * state)
+{
+	DSP_FirQ15Init(&pdec->fir, coef, ntaps, state);
+	pdec->m = m;
+	pdec->phase = 0u;
+}
+
+/**********************************************/
+//:Q15ȡFIR,ֻ㱣
+//:pdec:˲
+//          pin:
+//          pout:,n/m+1
+//          n:
+//ֵ  :
+/**********************************************/
+INT16U DSP_FirDecimQ15(DSP_FIR_DECIM_Q15 * pdec, Q15 const *pin, Q15 * pout, INT16U n)
+{
+	INT16U nout;
+
+	nout = 0u;
+	while (n > 0u) {
+		if (++pdec->phase >= pdec->m) {
+			pdec->phase = 0u;
+			pout[nout++] = DSP_FirQ15Step(&pdec->fir, *pin++, OS_TRUE);
+		} else {
+			(void)DSP_FirQ15Step(&pdec->fir, *pin++, OS_FALSE);
+		}
+		n--;
+	}
+	return (nout);
+}
+
+/**********************************************/
+//:ʼQ15׽ڼ
+//:pbq:˲
+//          coef:ÿ5ϵ,DSP_BIQUAD_Q15
+//          nstages:
+//          shift:ϵλ
+//          state:4*nstagesQ15
+//ֵ  :none
+/**********************************************/
+void DSP_BiquadQ15Init(DSP_BIQUAD_Q15 * pbq, Q15 const *coef, INT8U nstages, INT8U shift, Q15 * state)
+{
+	INT16U i;
+
+	pbq->coef = coef;
+	pbq->state = state;
+	pbq->nstages = nstages;
+	pbq->shift = shift;
+	for (i = 0u; i < 4u * nstages; i++) {
+		state[i] = 0;
+	}
+}
+
+/**********************************************/
+//:Q15׽ڼ
+//:pbq:˲
+//          pin:
+//          pout:,pinͬ
+//          n:
+//ֵ  :none
+/**********************************************/
+void DSP_BiquadQ15(DSP_BIQUAD_Q15 * pbq, Q15 const *pin, Q15 * pout, INT16U n)
+{
+	Q15 const *c;
+	Q15 *s;
+	DSP_ACC acc;
+	Q15 x;
+	Q15 y;
+	INT16U i;
+	INT8U k;
+
+	for (i = 0u; i < n; i++) {
+		x = pin[i];
+		c = pbq->coef;
+		s = pbq->state;
+		for (k = pbq->nstages; k > 0u; k--) {
+			acc = (INT32S)c[0] * x;
+			acc += (INT32S)c[1] * s[0];
+			acc += (INT32S)c[2] * s[1];
+			acc += (INT32S)c[3] * s[2];
+			acc += (INT32S)c[4] * s[3];
+			acc >>= 15 - pbq->shift;
+			y = DSP_SAT16(acc);
+			s[1] = s[0];
+			s[0] = x;
+			s[3] = s[2];
+			s[2] = y;
+			x = y;
+			c += 5;
+			s += 4;
+		}
+		pout[i] = x;
+	}
+}
+
+/**********************************************/
+//:ʼQ31׽ڼ
+//:pbq:˲
+//          coef:ÿ5ϵ,DSP_BIQUAD_Q15
+//          nstages:
+//          shift:ϵλ
+//          state:4*nstagesQ31
+//ֵ  :none
+/**********************************************/
+void DSP_BiquadQ31Init(DSP_BIQUAD_Q31 * pbq, Q31 const *coef, INT8U nstages, INT8U shift, Q31 * state)
+{
+	INT16U i;
+
+	pbq->coef = coef;
+	pbq->state = state;
+	pbq->nstages = nstages;
+	pbq->shift = shift;
+	for (i = 0u; i < 4u * nstages; i++) {
+		state[i] = 0;
+	}
+}
+
+/**********************************************/
+//:Q31׽ڼ
+//:pbq:˲
+//          pin:
+//          pout:,pinͬ
+//          n:
+//ֵ  :none
+/**********************************************/
+void DSP_BiquadQ31(DSP_BIQUAD_Q31 * pbq, Q31 const *pin, Q31 * pout, INT16U n)
+{
+	Q31 const *c;
+	Q31 *s;
+	DSP_ACC acc;
+	Q31 x;
+	Q31 y;
+	INT16U i;
+	INT8U k;
+
+	for (i = 0u; i < n; i++) {
+		x = pin[i];
+		c = pbq->coef;
+		s = pbq->state;
+		for (k = pbq->nstages; k > 0u; k--) {
+			acc = (DSP_ACC) c[0] * x;
+			acc += (DSP_ACC) c[1] * s[0];
+			acc += (DSP_ACC) c[2] * s[1];
+			acc += (DSP_ACC) c[3] * s[2];
+			acc += (DSP_ACC) c[4] * s[3];
+			acc >>= 31 - pbq->shift;
+			y = DSP_SAT32(acc);
+			s[1] = s[0];
+			s[0] = x;
+			s[3] = s[2];
+			s[2] = y;
+			x = y;
+			c += 5;
+			s += 4;
+		}
+		pout[i] = x;
+	}
+}
+
+/**********************************************/
+//:ʼQ15ƽ
+//:pavg:˲
+//          len:ڳ
+//          state:lenQ15
+//ֵ  :none
+/**********************************************/
+void DSP_MavgQ15Init(DSP_MAVG_Q15 * pavg, INT16U len, Q15 * state)
+{
+	INT16U i;
+
+	pavg->state = state;
+	pavg->len = len;
+	pavg->pos = 0u;
+	pavg->sum = 0;
+	for (i = 0u; i < len; i++) {
+		state[i] = 0;
+	}
+}
+
+/**********************************************/
+//:Q15ƽ,ÿһμӼ
+//:pavg:˲
+//          pin:
+//          pout:,pinͬ
+//          n:
+//ֵ  :none
+/**********************************************/
+void DSP_MavgQ15(DSP_MAVG_Q15 * pavg, Q15 const *pin, Q15 * pout, INT16U n)
+{
+	Q15 x;
+
+	while (n > 0u) {
+		x = *pin++;
+		pavg->sum += x - pavg->state[pavg->pos];
+		pavg->state[pavg->pos] = x;
+		if (++pavg->pos >= pavg->len) {
+			pavg->pos = 0u;
+		}
+		*pout++ = (Q15)(pavg->sum / (INT32S)pavg->len);
+		n--;
+	}
+}
+
+/**********************************************/
+//:ʼQ15 FFT,ת
+//:pfft:FFT
+//          n:,2,4~4096
+//          twiddle:nQ15
+//ֵ  :OS_FALSE:nϷ
+//˵    :ֻڳʼʱø
+/**********************************************/
+BOOLEAN DSP_FftQ15Init(DSP_FFT_Q15 * pfft, INT16U n, Q15 * twiddle)
+{
+	INT16U k;
+	FP64 a;
+
+	if ((n < 4u) || (n > 4096u) || ((n & (n - 1u)) != 0u)) {
+		return (OS_FALSE);
+	}
+	for (k = 0u; k < n / 2u; k++) {
+		a = 6.283185307179586 * k / n;
+		twiddle[2u * k] = DSP_Q15(cos(a));
+		twiddle[2u * k + 1u] = DSP_Q15(-sin(a));
+	}
+	pfft->twiddle = twiddle;
+	pfft->n = n;
+	return (OS_TRUE);
+}
+
+/**********************************************/
+//:Q15FFT,ԭλ
+//:pfft:FFT
+//          pbuf:n,ʵ鲿
+//ֵ  :none
+//˵    :ÿ2ֹ,ΪDFT/n
+/**********************************************/
+void DSP_FftQ15(DSP_FFT_Q15 const *pfft, Q15 * pbuf)
+{
+	Q15 const *w;
+	INT16U n;
+	INT16U i;
+	INT16U j;
+	INT16U k;
+	INT16U len;
+	INT16U half;
+	INT16U step;
+	INT32S tr;
+	INT32S ti;
+	INT32S ar;
+	INT32S ai;
+	Q15 t;
+
+	n = pfft->n;
+	for (i = 1u, j = 0u; i < n; i++) {	//λ
+		k = n >> 1;
+		while ((j & k) != 0u) {
+			j ^= k;
+			k >>= 1;
+		}
+		j |= k;
+		if (i < j) {
+			t = pbuf[2u * i];
+			pbuf[2u * i] = pbuf[2u * j];
+			pbuf[2u * j] = t;
+			t = pbuf[2u * i + 1u];
+			pbuf[2u * i + 1u] = pbuf[2u * j + 1u];
+			pbuf[2u * j + 1u] = t;
+		}
+	}
+	for (len = 2u; len <= n; len <<= 1) {
+		half = len >> 1;
+		step = n / len;
+		for (j = 0u; j < half; j++) {
+			w = &pfft->twiddle[2u * j * step];
+			for (i = j; i < n; i += len) {
+				k = i + half;
+				tr = ((INT32S)pbuf[2u * k] * w[0] - (INT32S)pbuf[2u * k + 1u] * w[1]) >> 15;
+				ti = ((INT32S)pbuf[2u * k] * w[1] + (INT32S)pbuf[2u * k + 1u] * w[0]) >> 15;
+				ar = pbuf[2u * i];
+				ai = pbuf[2u * i + 1u];
+				pbuf[2u * i] = (Q15)((ar + tr) >> 1);
+				pbuf[2u * i + 1u] = (Q15)((ai + ti) >> 1);
+				pbuf[2u * k] = (Q15)((ar - tr) >> 1);
+				pbuf[2u * k + 1u] = (Q15)((ai - ti) >> 1);
+			}
+		}
+	}
+}
@@ -0,0 +1,84 @@
+#ifndef DSP_H
+#define DSP_H
+
+#include "app_cfg.h"
+
+/*
+ * źŴ:
+ * Q15INT16S,Q31INT32S,ۼ64λۼ(SMULL/SMLAL),.
+ * 鴦,ֱڴжһ;ÿ˲״̬ɵ߷.
+ */
+
+typedef INT16S Q15;
+typedef INT32S Q31;
+typedef signed long long DSP_ACC;	//64λۼ
+
+//ʵתQ15/Q31,,[-1,1)ʱ;x,Ӧǳʽ
+#define DSP_Q15(x)          ((Q15)((x) * 32768.0 >= 32766.5 ? 32767.0 :                                    \
+                                   ((x) * 32768.0 <= -32768.0 ? -32768.0 : (x) * 32768.0 + ((x) < 0.0 ? -0.5 : 0.5))))
+#define DSP_Q31(x)          ((Q31)((x) * 2147483648.0 >= 2147483646.5 ? 2147483647.0 :                    \
+                                   ((x) * 2147483648.0 <= -2147483648.0 ? -2147483648.0 :               \
+                                    (x) * 2147483648.0 + ((x) < 0.0 ? -0.5 : 0.5))))
+
+typedef struct dsp_fir_q15 {	//FIR,ϵֵ֮С1ʱ
+	Q15 const *coef;	//h[0]~h[ntaps-1]
+	Q15 *state;		//2*ntaps,ӳߴȡģ
+	INT16U ntaps;
+	INT16U pos;
+} DSP_FIR_Q15;
+
+typedef struct dsp_fir_q31 {
+	Q31 const *coef;
+	Q31 *state;		//2*ntaps
+	INT16U ntaps;
+	INT16U pos;
+} DSP_FIR_Q31;
+
+typedef struct dsp_fir_decim_q15 {	//ȡFIR,ÿmһ
+	DSP_FIR_Q15 fir;
+	INT16U m;
+	INT16U phase;
+} DSP_FIR_DECIM_Q15;
+
+typedef struct dsp_biquad_q15 {	//׽ڼ,ֱI
+	Q15 const *coef;	//ÿb0,b1,b2,a1,a2,a1a2ȡ,2^-shift
+	Q15 *state;		//ÿx[n-1],x[n-2],y[n-1],y[n-2]
+	INT8U nstages;
+	INT8U shift;		//ϵλ,ʹ|ϵ|<1
+} DSP_BIQUAD_Q15;
+
+typedef struct dsp_biquad_q31 {
+	Q31 const *coef;
+	Q31 *state;
+	INT8U nstages;
+	INT8U shift;
+} DSP_BIQUAD_Q31;
+
+typedef struct dsp_mavg_q15 {	//ƽ
+	Q15 *state;		//len
+	INT16U len;
+	INT16U pos;
+	INT32S sum;
+} DSP_MAVG_Q15;
+
+typedef struct dsp_fft_q15 {	//2FFT,ÿ2,ΪDFT/n
+	Q15 const *twiddle;	//n/2cos,-sin
+	INT16U n;
+} DSP_FFT_Q15;
+
+extern void DSP_FirQ15Init(DSP_FIR_Q15 * pfir, Q15 const *coef, INT16U ntaps, Q15 * state);
+extern void DSP_FirQ15(DSP_FIR_Q15 * pfir, Q15 const *pin, Q15 * pout, INT16U n);
+extern void DSP_FirQ31Init(DSP_FIR_Q31 * pfir, Q31 const *coef, INT16U ntaps, Q31 * state);
+extern void DSP_FirQ31(DSP_FIR_Q31 * pfir, Q31 const *pin, Q31 * pout, INT16U n);
+extern void DSP_FirDecimQ15Init(DSP_FIR_DECIM_Q15 * pdec, Q15 const *coef, INT16U ntaps, INT16U m, Q15 * state);
+extern INT16U DSP_FirDecimQ15(DSP_FIR_DECIM_Q15 * pdec, Q15 const *pin, Q15 * pout, INT16U n);
+extern void DSP_BiquadQ15Init(DSP_BIQUAD_Q15 * pbq, Q15 const *coef, INT8U nstages, INT8U shift, Q15 * state);
+extern void DSP_BiquadQ15(DSP_BIQUAD_Q15 * pbq, Q15 const *pin, Q15 * pout, INT16U n);
+extern void DSP_BiquadQ31Init(DSP_BIQUAD_Q31 * pbq, Q31 const *coef, INT8U nstages, INT8U shift, Q31 * state);
+extern void DSP_BiquadQ31(DSP_BIQUAD_Q31 * pbq, Q31 const *pin, Q31 * pout, INT16U n);
+extern void DSP_MavgQ15Init(DSP_MAVG_Q15 * pavg, INT16U len, Q15 * state);
+extern void DSP_MavgQ15(DSP_MAVG_Q15 * pavg, Q15 const *pin, Q15 * pout, INT16U n);
+extern BOOLEAN DSP_FftQ15Init(DSP_FFT_Q15 * pfft, INT16U n, Q15 * twiddle);
+extern void DSP_FftQ15(DSP_FFT_Q15 const *pfft, Q15 * pbuf);
+
+#endif
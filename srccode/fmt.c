@@ -0,0 +1,269 @@
+#include "fmt.h"
+#include "device.h"
+#include <string.h>
+
+#define FMT_LEFT    0x01u	//'-'
+#define FMT_ZERO    0x02u	//'0'0
+#define FMT_UPPER   0x04u	//дʮ
+
+typedef struct fmt_out {	//λ,ÿεһ,ջ
+	char *buf;
+	INT16U size;
+	INT16U len;
+} FMT_OUT;
+
+/**********************************************/
+//:һַ,ʱ(β'\0')
+//:pout:λ
+//          c:ַ
+//ֵ  :none
+/**********************************************/
+static void FMT_Put(FMT_OUT * pout, char c)
+{
+	if (pout->len + 1u < pout->size) {
+		pout->buf[pout->len++] = c;
+	}
+}
+
+/**********************************************/
+//:ȺͶ뷽ʽһַ
+//:pout:λ
+//          pre:Żǰ׺,Ϊ
+//          s:ַ
+//          len:ַ
+//          width:С
+//          flags:FMT_LEFT,FMT_ZERO
+//ֵ  :none
+/**********************************************/
+static void FMT_Pad(FMT_OUT * pout, char const *pre, char const *s, INT16U len, INT16U width, INT8U flags)
+{
+	INT16U n;
+	INT16U pad;
+
+	n = len;
+	if (pre != (char const *)0) {
+		n += (INT16U)strlen(pre);
+	}
+	pad = (width > n) ? (INT16U)(width - n) : 0u;
+	if ((flags & (FMT_LEFT | FMT_ZERO)) == 0u) {
+		while (pad > 0u) {
+			FMT_Put(pout, ' ');
+			pad--;
+		}
+	}
+	if (pre != (char const *)0) {
+		while (*pre != '\0') {
+			FMT_Put(pout, *pre++);
+		}
+	}
+	if ((flags & FMT_LEFT) == 0u) {	//'0'ڷ֮
+		while (pad > 0u) {
+			FMT_Put(pout, '0');
+			pad--;
+		}
+	}
+	while (len > 0u) {
+		FMT_Put(pout, *s++);
+		len--;
+	}
+	while (pad > 0u) {
+		FMT_Put(pout, ' ');
+		pad--;
+	}
+}
+
+/**********************************************/
+//:޷תַ,ӻĩβǰд
+//:pend:ĩβ
+//          val:
+//          base:1016
+//          frac:Сλ(),0:
+//          flags:FMT_UPPER
+//ֵ  :һַλ
+/**********************************************/
+static char *FMT_Utoa(char *pend, INT32U val, INT8U base, INT8U frac, INT8U flags)
+{
+	char const *digits;
+
+	digits = ((flags & FMT_UPPER) != 0u) ? "0123456789ABCDEF" : "0123456789abcdef";
+	do {
+		if (base == 16u) {	//,óָ
+			*--pend = digits[val & 0x0Fu];
+			val >>= 4;
+		} else {
+			*--pend = digits[val % 10u];
+			val /= 10u;
+		}
+		if (frac > 0u) {
+			frac--;
+			if (frac == 0u) {
+				*--pend = '.';
+				if (val == 0u) {	//һλ
+					*--pend = '0';
+				}
+			}
+		}
+	} while ((val != 0u) || (frac > 0u));
+	return (pend);
+}
+
+/**********************************************/
+//:ʽ
+//:pbuf:
+//          size:С,β'\0'
+//          fmt:ʽ
+//          ap:
+//ֵ  :дַ,'\0',Ĳֱص
+/**********************************************/
+INT16U FMT_VFormat(char *pbuf, INT16U size, char const *fmt, va_list ap)
+{
+	FMT_OUT out;
+	char num[16];		//32λСǰ0
+	char *p;
+	char const *s;
+	char const *pre;
+	INT32U val;
+	INT32S star;
+	INT16U width;
+	INT16U prec;
+	INT16U n;
+	INT8U flags;
+	BOOLEAN has_prec;
+
+	out.buf = pbuf;
+	out.size = size;
+	out.len = 0u;
+	while (*fmt != '\0') {
+		if (*fmt != '%') {
+			FMT_Put(&out, *fmt++);
+			continue;
+		}
+		fmt++;
+		flags = 0u;
+		for (;; fmt++) {
+			if (*fmt == '-') {
+				flags |= FMT_LEFT;
+			} else if (*fmt == '0') {
+				flags |= FMT_ZERO;
+			} else {
+				break;
+			}
+		}
+		width = 0u;
+		if (*fmt == '*') {
+			star = (INT32S)va_arg(ap, int);
+			if (star < 0) {	//Ŀȱʾ
+				flags |= FMT_LEFT;
+				star = -star;
+			}
+			width = (INT16U)star;
+			fmt++;
+		}
+		while ((*fmt >= '0') && (*fmt <= '9')) {
+			width = (INT16U)(width * 10u + (INT16U)(*fmt++ - '0'));
+		}
+		prec = 0u;
+		has_prec = OS_FALSE;
+		if (*fmt == '.') {
+			has_prec = OS_TRUE;
+			fmt++;
+			while ((*fmt >= '0') && (*fmt <= '9')) {
+				prec = (INT16U)(prec * 10u + (INT16U)(*fmt++ - '0'));
+			}
+		}
+		while ((*fmt == 'l') || (*fmt == 'h')) {
+			fmt++;
+		}
+		pre = (char const *)0;
+		p = &num[sizeof(num)];
+		switch (*fmt) {
+		case 'd':
+		case 'i':
+		case 'q':
+			val = (INT32U)va_arg(ap, INT32S);
+			if ((INT32S)val < 0) {
+				pre = "-";
+				val = 0u - val;
+			}
+			if ((*fmt == 'q') && (prec > 9u)) {
+				prec = 9u;
+			}
+			p = FMT_Utoa(p, val, 10u, (INT8U)((*fmt == 'q') ? prec : 0u), 0u);
+			break;
+		case 'u':
+			p = FMT_Utoa(p, va_arg(ap, INT32U), 10u, 0u, 0u);
+			break;
+		case 'X':
+			flags |= FMT_UPPER;	//ִ'x'
+		case 'x':
+			p = FMT_Utoa(p, va_arg(ap, INT32U), 16u, 0u, flags);
+			break;
+		case 'p':
+			pre = "0x";
+			flags |= FMT_ZERO;
+			width = 10u;
+			p = FMT_Utoa(p, (INT32U)va_arg(ap, void *), 16u, 0u, 0u);
+			break;
+		case 'c':
+			*--p = (char)va_arg(ap, int);
+			break;
+		case 's':
+			s = va_arg(ap, char const *);
+			if (s == (char const *)0) {
+				s = "(null)";
+			}
+			for (n = 0u; (s[n] != '\0') && ((has_prec == OS_FALSE) || (n < prec)); n++) {
+			}
+			FMT_Pad(&out, (char const *)0, s, n, width, (INT8U)(flags & FMT_LEFT));
+			fmt++;
+			continue;
+		case '\0':
+			continue;
+		default:	//'%'
+			*--p = *fmt;
+			break;
+		}
+		FMT_Pad(&out, pre, p, (INT16U)(&num[sizeof(num)] - p), width, flags);
+		fmt++;
+	}
+	if (size > 0u) {
+		pbuf[out.len] = '\0';
+	}
+	return (out.len);
+}
+
+/**********************************************/
+//:ʽ
+//:pbuf:
+//          size:С,β'\0'
+//          fmt:ʽ
+//ֵ  :дַ,'\0'
+/**********************************************/
+INT16U FMT_Format(char *pbuf, INT16U size, char const *fmt, ...)
+{
+	va_list ap;
+	INT16U len;
+
+	va_start(ap, fmt);
+	len = FMT_VFormat(pbuf, size, fmt, ap);
+	va_end(ap);
+	return (len);
+}
+
+/**********************************************/
+//:ʽд봮,
+//:fmt:ʽ
+//ֵ  :none
+//˵    :FMT_LINE_MAX-1ַ
+/**********************************************/
+void FMT_Printf(char const *fmt, ...)
+{
+	char line[FMT_LINE_MAX];
+	va_list ap;
+	INT16U len;
+
+	va_start(ap, fmt);
+	len = FMT_VFormat(line, FMT_LINE_MAX, fmt, ap);
+	va_end(ap);
+	(void)DEV_WriteAll((INT8U *) line, len);
+}
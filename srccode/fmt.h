@@ -0,0 +1,18 @@
+#ifndef FMT_H
+#define FMT_H
+
+#include "app_cfg.h"
+#include <stdarg.h>
+
+/*
+ * ʽ,,öѺstdio:
+ *   %d %i %u %x %X %c %s %p %%,֧'-' '0'־,,'*''l'(32λ,)
+ *   %.Nq:,10^-NΪλ,("%.2q", 1234)"12.34"
+ *   %.Ns:Nַ
+ */
+
+extern INT16U FMT_VFormat(char *pbuf, INT16U size, char const *fmt, va_list ap);
+extern INT16U FMT_Format(char *pbuf, INT16U size, char const *fmt, ...);
+extern void FMT_Printf(char const *fmt, ...);
+
+#endif
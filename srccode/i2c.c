@@ -0,0 +1,401 @@
+#include "i2c.h"
+
+#if I2C_EN > 0
+
+#define I2C_SR1_ERR         (I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_AF | I2C_SR1_OVR | I2C_SR1_TIMEOUT)
+#define I2C_STOP_WAIT       1000u	//ȴSTOPѭ
+
+I2C_BUS I2C_Bus1;
+
+static void I2C_Start(I2C_BUS * pbus, I2C_XFER * pxfer);
+static I2C_XFER *I2C_Done(I2C_BUS * pbus, INT8U stat);
+static void I2C_Reset(I2C_BUS * pbus);
+static void I2C_I2c1Unstick(void);
+static void I2C_Signal(I2C_XFER * pxfer);
+
+/**********************************************/
+//:ʼһI2Cߵ
+//:pbus:
+//          i2c:I2CĴ,ɵú
+//          dma:DMAĴ
+//          tx_ch,rx_ch:ͺͽDMAͨ
+//          rx_ch_nbr:ͨ(1~7)
+//ֵ  :none
+/**********************************************/
+void I2C_BusInit(I2C_BUS * pbus, I2C_TypeDef * i2c, DMA_TypeDef * dma, DMA_Channel_TypeDef * tx_ch,
+		 DMA_Channel_TypeDef * rx_ch, INT8U rx_ch_nbr)
+{
+	pbus->i2c = i2c;
+	pbus->dma = dma;
+	pbus->tx_ch = tx_ch;
+	pbus->rx_ch = rx_ch;
+	pbus->rx_shift = (INT8U)((rx_ch_nbr - 1u) * 4u);
+	pbus->cr2 = i2c->CR2 & I2C_CR2_FREQ;
+	pbus->ccr = i2c->CCR;
+	pbus->trise = i2c->TRISE;
+	pbus->unstick = (void (*)(void))0;
+	pbus->cur = (I2C_XFER *) 0;
+	pbus->head = (I2C_XFER *) 0;
+	tx_ch->CCR = 0u;
+	rx_ch->CCR = 0u;
+	tx_ch->CPAR = (INT32U) & i2c->DR;
+	rx_ch->CPAR = (INT32U) & i2c->DR;
+	i2c->CR2 = pbus->cr2 | I2C_CR2_ITERREN;
+}
+
+/**********************************************/
+//:ʼI2C1(PB6:SCL,PB7:SDA)I2C_Bus1
+//:speed:ʱƵ(Hz),400000
+//ֵ  :none
+/**********************************************/
+void I2C_I2c1Init(INT32U speed)
+{
+	GPIO_InitTypeDef GPIO_InitStructure;
+	I2C_InitTypeDef I2C_InitStructure;
+	NVIC_InitTypeDef NVIC_InitStructure;
+
+	RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOB, ENABLE);
+	RCC_APB1PeriphClockCmd(RCC_APB1Periph_I2C1, ENABLE);
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
+
+	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_6 | GPIO_Pin_7;
+	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_OD;
+	GPIO_Init(GPIOB, &GPIO_InitStructure);
+
+	I2C_StructInit(&I2C_InitStructure);
+	I2C_InitStructure.I2C_ClockSpeed = speed;
+	I2C_InitStructure.I2C_Ack = I2C_Ack_Enable;
+	I2C_Init(I2C1, &I2C_InitStructure);
+	I2C_Cmd(I2C1, ENABLE);
+
+	I2C_BusInit(&I2C_Bus1, I2C1, DMA1, DMA1_Channel6, DMA1_Channel7, 7u);
+	I2C_Bus1.unstick = I2C_I2c1Unstick;
+
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_InitStructure.NVIC_IRQChannel = I2C1_EV_IRQn;
+	NVIC_Init(&NVIC_InitStructure);
+	NVIC_InitStructure.NVIC_IRQChannel = I2C1_ER_IRQn;
+	NVIC_Init(&NVIC_InitStructure);
+	NVIC_InitStructure.NVIC_IRQChannel = DMA1_Channel7_IRQn;
+	NVIC_Init(&NVIC_InitStructure);
+}
+
+/**********************************************/
+//:SCL9ʱ,סSDAĴӻʣµֽ
+//:none
+//ֵ  :none
+/**********************************************/
+static void I2C_I2c1Unstick(void)
+{
+	GPIO_InitTypeDef GPIO_InitStructure;
+	INT8U i;
+	volatile INT16U dly;
+
+	GPIO_SetBits(GPIOB, GPIO_Pin_6 | GPIO_Pin_7);
+	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_6 | GPIO_Pin_7;
+	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_OD;
+	GPIO_Init(GPIOB, &GPIO_InitStructure);
+	for (i = 0u; i < 9u; i++) {	//Լ100kHz
+		GPIO_ResetBits(GPIOB, GPIO_Pin_6);
+		for (dly = 0u; dly < 100u; dly++) {
+		}
+		GPIO_SetBits(GPIOB, GPIO_Pin_6);
+		for (dly = 0u; dly < 100u; dly++) {
+		}
+	}
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_OD;
+	GPIO_Init(GPIOB, &GPIO_InitStructure);
+}
+
+/**********************************************/
+//:λI2C貢ָ
+//:pbus:
+//ֵ  :none
+//˵    :ٽڵ
+/**********************************************/
+static void I2C_Reset(I2C_BUS * pbus)
+{
+	pbus->tx_ch->CCR = 0u;
+	pbus->rx_ch->CCR = 0u;
+	pbus->i2c->CR1 = I2C_CR1_SWRST;
+	pbus->i2c->CR1 = 0u;
+	pbus->i2c->CR2 = pbus->cr2 | I2C_CR2_ITERREN;
+	pbus->i2c->CCR = pbus->ccr;
+	pbus->i2c->TRISE = pbus->trise;
+	pbus->i2c->CR1 = I2C_CR1_PE | I2C_CR1_ACK;
+}
+
+/**********************************************/
+//:ʼһ,ʼ
+//:pbus:
+//          pxfer:
+//ֵ  :none
+//˵    :ٽڵ
+/**********************************************/
+static void I2C_Start(I2C_BUS * pbus, I2C_XFER * pxfer)
+{
+	pbus->cur = pxfer;
+	pbus->rd = ((pxfer->wlen == 0u) && (pxfer->rlen != 0u)) ? 1u : 0u;
+	pxfer->stat = I2C_STAT_ACTIVE;
+	pbus->i2c->CR2 = pbus->cr2 | I2C_CR2_ITERREN | I2C_CR2_ITEVTEN;
+	pbus->i2c->CR1 |= I2C_CR1_ACK | I2C_CR1_START;
+}
+
+/**********************************************/
+//:ǰ,ʼеһ
+//:pbus:
+//          stat:ǰĽ
+//ֵ  :Ĵ
+//˵    :ٽڵ,ٽͷź
+/**********************************************/
+static I2C_XFER *I2C_Done(I2C_BUS * pbus, INT8U stat)
+{
+	I2C_XFER *pxfer;
+	INT16U i;
+
+	pbus->tx_ch->CCR = 0u;
+	pbus->rx_ch->CCR = 0u;
+	pbus->i2c->CR2 = pbus->cr2 | I2C_CR2_ITERREN;
+	pxfer = pbus->cur;
+	pxfer->stat = stat;
+	pbus->cur = (I2C_XFER *) 0;
+	if (pbus->head != (I2C_XFER *) 0) {
+		for (i = 0u; ((pbus->i2c->CR1 & I2C_CR1_STOP) != 0u) && (i < I2C_STOP_WAIT); i++) {
+		}		//STOPʼ
+		I2C_Start(pbus, pbus->head);
+		pbus->head = pbus->head->next;
+	}
+	return (pxfer);
+}
+
+/**********************************************/
+//:ͷŴź
+//:pxfer:ѽĴ
+//ֵ  :none
+/**********************************************/
+static void I2C_Signal(I2C_XFER * pxfer)
+{
+	if (pxfer->sem != (OS_EVENT *) 0) {
+		(void)OSSemPost(pxfer->sem);
+	}
+}
+
+/**********************************************/
+//:Ѵ䰴ȼ߶,߿ʱʼ
+//:pbus:
+//          pxfer:,ǰ޸
+//ֵ  :none
+/**********************************************/
+void I2C_Submit(I2C_BUS * pbus, I2C_XFER * pxfer)
+{
+	I2C_XFER **pp;
+#if OS_CRITICAL_METHOD == 3u
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+	OS_ENTER_CRITICAL();
+	if (pbus->cur == (I2C_XFER *) 0) {
+		I2C_Start(pbus, pxfer);
+	} else {
+		pxfer->stat = I2C_STAT_QUEUED;
+		pp = &pbus->head;
+		while ((*pp != (I2C_XFER *) 0) && ((*pp)->prio <= pxfer->prio)) {
+			pp = &(*pp)->next;
+		}
+		pxfer->next = *pp;
+		*pp = pxfer;
+	}
+	OS_EXIT_CRITICAL();
+}
+
+/**********************************************/
+//:䲢ȴ
+//:pbus:
+//          pxfer:,semΪNULL
+//          timeout:ȴʱӽ,0:һֱȴ
+//ֵ  :OS_ERR_NONE,OS_ERR_PEVENT_NULL,OS_ERR_TIMEOUTOS_ERR_PEND_ABORT(pxfer->stat)
+//˵    :ʱ䱻ȡ,ڽеĴʹ߸λ
+/**********************************************/
+INT8U I2C_Transfer(I2C_BUS * pbus, I2C_XFER * pxfer, INT32U timeout)
+{
+	I2C_XFER **pp;
+	INT8U err;
+#if OS_CRITICAL_METHOD == 3u
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+	if (pxfer->sem == (OS_EVENT *) 0) {
+		return (OS_ERR_PEVENT_NULL);
+	}
+	I2C_Submit(pbus, pxfer);
+	OSSemPend(pxfer->sem, timeout, &err);
+	if (err == OS_ERR_TIMEOUT) {
+		OS_ENTER_CRITICAL();
+		if (pxfer->stat == I2C_STAT_QUEUED) {
+			for (pp = &pbus->head; *pp != pxfer; pp = &(*pp)->next) {
+			}
+			*pp = pxfer->next;
+			pxfer->stat = I2C_STAT_TIMEOUT;
+		} else if (pxfer->stat == I2C_STAT_ACTIVE) {
+			pbus->tx_ch->CCR = 0u;
+			pbus->rx_ch->CCR = 0u;
+			pbus->i2c->CR1 = 0u;	//ر,ٲж
+			if (pbus->unstick != (void (*)(void))0) {
+				OS_EXIT_CRITICAL();
+				(*pbus->unstick) ();
+				OS_ENTER_CRITICAL();
+			}
+			I2C_Reset(pbus);
+			(void)I2C_Done(pbus, I2C_STAT_TIMEOUT);
+		} else {	//ʱͬʱ
+			(void)OSSemAccept(pxfer->sem);
+			err = OS_ERR_NONE;
+		}
+		OS_EXIT_CRITICAL();
+	}
+	if ((err == OS_ERR_NONE) && (pxfer->stat != I2C_STAT_DONE)) {
+		err = OS_ERR_PEND_ABORT;
+	}
+	return (err);
+}
+
+/**********************************************/
+//:I2C¼жϴ,״̬
+//:pbus:
+//ֵ  :none
+/**********************************************/
+void I2C_EvIsr(I2C_BUS * pbus)
+{
+	I2C_TypeDef *i2c;
+	I2C_XFER *pxfer;
+	INT16U sr1;
+#if OS_CRITICAL_METHOD == 3u
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+	OS_ENTER_CRITICAL();
+	i2c = pbus->i2c;
+	pxfer = pbus->cur;
+	sr1 = i2c->SR1;
+	if (pxfer == (I2C_XFER *) 0) {
+		i2c->CR2 = pbus->cr2 | I2C_CR2_ITERREN;
+		OS_EXIT_CRITICAL();
+		return;
+	}
+	if ((sr1 & I2C_SR1_SB) != 0u) {	//ʼѷ,дַ
+		i2c->DR = (INT16U)((pxfer->addr << 1) | pbus->rd);
+	} else if ((sr1 & I2C_SR1_ADDR) != 0u) {	//ַӦ,SR2ADDR
+		if ((pbus->rd == 0u) && (pxfer->wlen == 0u)) {	//ַֻ̽
+			(void)i2c->SR2;
+			i2c->CR1 |= I2C_CR1_STOP;
+			pxfer = I2C_Done(pbus, I2C_STAT_DONE);
+			OS_EXIT_CRITICAL();
+			I2C_Signal(pxfer);
+			return;
+		} else if (pbus->rd == 0u) {
+			pbus->tx_ch->CMAR = (INT32U) pxfer->pwr;
+			pbus->tx_ch->CNDTR = pxfer->wlen;
+			pbus->tx_ch->CCR = DMA_CCR1_DIR | DMA_CCR1_MINC | DMA_CCR1_EN;
+			i2c->CR2 |= I2C_CR2_DMAEN;
+			(void)i2c->SR2;
+		} else if (pxfer->rlen == 1u) {	//ֽڲDMA:ȹACK,ADDRSTOP
+			i2c->CR1 &= ~I2C_CR1_ACK;
+			(void)i2c->SR2;
+			i2c->CR1 |= I2C_CR1_STOP;
+			i2c->CR2 |= I2C_CR2_ITBUFEN;
+		} else {	//LAST:DMAһֽʱNACK
+			pbus->rx_ch->CMAR = (INT32U) pxfer->prd;
+			pbus->rx_ch->CNDTR = pxfer->rlen;
+			pbus->rx_ch->CCR = DMA_CCR1_MINC | DMA_CCR1_TCIE | DMA_CCR1_EN;
+			i2c->CR2 |= I2C_CR2_DMAEN | I2C_CR2_LAST;
+			(void)i2c->SR2;
+		}
+	} else if (((sr1 & I2C_SR1_BTF) != 0u) && (pbus->rd == 0u) && (pbus->tx_ch->CNDTR == 0u)) {
+		pbus->tx_ch->CCR = 0u;	//һֽѷ
+		i2c->CR2 &= ~I2C_CR2_DMAEN;
+		if (pxfer->rlen != 0u) {
+			pbus->rd = 1u;
+			i2c->CR1 |= I2C_CR1_START;	//ظʼ
+		} else {
+			i2c->CR1 |= I2C_CR1_STOP;
+			pxfer = I2C_Done(pbus, I2C_STAT_DONE);
+			OS_EXIT_CRITICAL();
+			I2C_Signal(pxfer);
+			return;
+		}
+	} else if (((sr1 & I2C_SR1_RXNE) != 0u) && (pbus->rd != 0u) && (pxfer->rlen == 1u)) {
+		pxfer->prd[0] = (INT8U)i2c->DR;
+		pxfer = I2C_Done(pbus, I2C_STAT_DONE);
+		OS_EXIT_CRITICAL();
+		I2C_Signal(pxfer);
+		return;
+	}
+	OS_EXIT_CRITICAL();
+}
+
+/**********************************************/
+//:I2CDMAжϴ
+//:pbus:
+//ֵ  :none
+/**********************************************/
+void I2C_DmaIsr(I2C_BUS * pbus)
+{
+	I2C_XFER *pxfer;
+#if OS_CRITICAL_METHOD == 3u
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+	OS_ENTER_CRITICAL();
+	pbus->dma->IFCR = (INT32U)0x0Fu << pbus->rx_shift;
+	if ((pbus->cur == (I2C_XFER *) 0) || (pbus->rd == 0u)) {
+		OS_EXIT_CRITICAL();
+		return;
+	}
+	pbus->i2c->CR1 |= I2C_CR1_STOP;
+	pxfer = I2C_Done(pbus, I2C_STAT_DONE);
+	OS_EXIT_CRITICAL();
+	I2C_Signal(pxfer);
+}
+
+/**********************************************/
+//:I2Cжϴ
+//:pbus:
+//ֵ  :none
+//˵    :ûӦʱSTOP;ߴٲöʧʱλ
+/**********************************************/
+void I2C_ErIsr(I2C_BUS * pbus)
+{
+	I2C_XFER *pxfer;
+	INT16U sr1;
+	INT8U stat;
+#if OS_CRITICAL_METHOD == 3u
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+	OS_ENTER_CRITICAL();
+	sr1 = pbus->i2c->SR1;
+	pbus->i2c->SR1 = (INT16U)(sr1 & ~I2C_SR1_ERR);	//д0
+	if ((sr1 & (I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_TIMEOUT)) != 0u) {
+		I2C_Reset(pbus);
+		stat = I2C_STAT_BUS_ERR;
+	} else if ((sr1 & I2C_SR1_AF) != 0u) {
+		pbus->i2c->CR1 |= I2C_CR1_STOP;
+		stat = I2C_STAT_NACK;
+	} else {		//OVR:DMA,ߴ
+		pbus->i2c->CR1 |= I2C_CR1_STOP;
+		stat = I2C_STAT_BUS_ERR;
+	}
+	if (pbus->cur == (I2C_XFER *) 0) {
+		OS_EXIT_CRITICAL();
+		return;
+	}
+	pxfer = I2C_Done(pbus, stat);
+	OS_EXIT_CRITICAL();
+	I2C_Signal(pxfer);
+}
+
+#endif
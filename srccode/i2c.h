@@ -0,0 +1,61 @@
+#ifndef I2C_H
+#define I2C_H
+
+#include "app_cfg.h"
+
+/*
+ * ж+DMAI2C:
+ * I2C_XFERȼ߶,¼жϵ״ִ̬,
+ * д׶κͶֽڶ׶DMA,ɺʼһ,ͷź.
+ * Ĵ鶼ͨI2C_BUSеָ,ʱָڴе.
+ */
+
+#define I2C_STAT_IDLE       0u
+#define I2C_STAT_QUEUED     1u
+#define I2C_STAT_ACTIVE     2u
+#define I2C_STAT_DONE       3u
+#define I2C_STAT_NACK       4u	//ӻûӦ
+#define I2C_STAT_BUS_ERR    5u	//ߴٲöʧ,Ѹλ
+#define I2C_STAT_TIMEOUT    6u	//ʱ,Ѹλ
+
+typedef struct i2c_xfer I2C_XFER;
+
+struct i2c_xfer {
+	INT8U addr;		//7λӻַ
+	INT8U prio;		//0,ͬȼȽȳ
+	volatile INT8U stat;	//I2C_STAT_xxx
+	INT8U const *pwr;	//д
+	INT16U wlen;		//0:ֻ
+	INT8U *prd;		//ٶ(ظʼ)
+	INT16U rlen;		//0:ֻд
+	OS_EVENT *sem;		//ʱͷ
+	I2C_XFER *next;
+};
+
+typedef struct i2c_bus {
+	I2C_TypeDef *i2c;
+	DMA_TypeDef *dma;
+	DMA_Channel_TypeDef *tx_ch;
+	DMA_Channel_TypeDef *rx_ch;
+	INT8U rx_shift;		//ͨDMA_ISRеλ,(ͨ-1)*4
+	INT8U rd;		//0:д׶ 1:׶
+	INT16U cr2;		//λָļĴ
+	INT16U ccr;
+	INT16U trise;
+	void (*unstick) (void);	//ʱͷűӻ͵SDA,ΪNULL
+	I2C_XFER *cur;
+	I2C_XFER *head;
+} I2C_BUS;
+
+extern I2C_BUS I2C_Bus1;
+
+extern void I2C_BusInit(I2C_BUS * pbus, I2C_TypeDef * i2c, DMA_TypeDef * dma, DMA_Channel_TypeDef * tx_ch,
+			DMA_Channel_TypeDef * rx_ch, INT8U rx_ch_nbr);
+extern void I2C_I2c1Init(INT32U speed);
+extern void I2C_Submit(I2C_BUS * pbus, I2C_XFER * pxfer);
+extern INT8U I2C_Transfer(I2C_BUS * pbus, I2C_XFER * pxfer, INT32U timeout);
+extern void I2C_EvIsr(I2C_BUS * pbus);
+extern void I2C_ErIsr(I2C_BUS * pbus);
+extern void I2C_DmaIsr(I2C_BUS * pbus);
+
+#endif
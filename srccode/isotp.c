@@ -0,0 +1,529 @@
+#include "isotp.h"
+
+#if ISOTP_EN > 0
+
+#if CAN_EN == 0
+#error "ISOTP_ENҪCAN_EN"
+#endif
+#if (OS_Q_EN == 0u) || (OS_MEM_EN == 0u) || (OS_SEM_EN == 0u) || (OS_SEM_ACCEPT_EN == 0u)
+#error "ISOTP_ENҪOS_Q_EN,OS_MEM_EN,OS_SEM_ENOS_SEM_ACCEPT_EN"
+#endif
+
+#define ISOTP_PCI_SF        0x00u	//֡
+#define ISOTP_PCI_FF        0x10u	//֡
+#define ISOTP_PCI_CF        0x20u	//֡
+#define ISOTP_PCI_FC        0x30u	//֡
+#define ISOTP_FS_CTS        0u
+#define ISOTP_FS_WAIT       1u
+#define ISOTP_FS_OVFLW      2u
+#define ISOTP_TIMEOUT       (ISOTP_TIMEOUT_MS * OS_TICKS_PER_SEC / 1000u)
+
+static OS_STK ISOTP_TaskStk[ISOTP_STK_SIZE];
+static INT32U ISOTP_BlkTbl[ISOTP_BLK_NBR][ISOTP_BLK_SIZE / 4u];
+static void *ISOTP_QTbl[ISOTP_Q_SIZE];
+static OS_MEM *ISOTP_Mem;
+static OS_EVENT *ISOTP_Q;
+static ISOTP_LINK *ISOTP_LinkList;
+
+static void ISOTP_Task(void *p_arg);
+static void ISOTP_RxFrame(ISOTP_LINK * plink, CAN_FRAME const *pframe);
+static void ISOTP_RxAbort(ISOTP_LINK * plink);
+static void ISOTP_RxCopy(ISOTP_LINK * plink, INT8U const *pdata, INT32U n);
+static BOOLEAN ISOTP_RxAlloc(ISOTP_LINK * plink, INT32U len);
+static void ISOTP_SendFc(ISOTP_LINK * plink, INT8U fs);
+static INT8U ISOTP_WaitFc(ISOTP_LINK * plink, INT32U timeout);
+static INT16U ISOTP_StTicks(INT8U st);
+
+/**********************************************/
+//:ʼISO-TP,ڴغ
+//:prio:ȼ,ӦڷϢ
+//ֵ  :none
+//˵    :OSInit()֮,ISOTP_LinkAdd()֮ǰ
+/**********************************************/
+void ISOTP_Init(INT8U prio)
+{
+	INT8U err;
+
+	ISOTP_Mem = OSMemCreate(&ISOTP_BlkTbl[0][0], ISOTP_BLK_NBR, ISOTP_BLK_SIZE, &err);
+	ISOTP_Q = OSQCreate(&ISOTP_QTbl[0], ISOTP_Q_SIZE);
+	ISOTP_LinkList = (ISOTP_LINK *) 0;
+	(void)OSTaskCreateExt(ISOTP_Task, (void *)0, &ISOTP_TaskStk[ISOTP_STK_SIZE - 1u], prio, prio, &ISOTP_TaskStk[0],
+			      ISOTP_STK_SIZE, (void *)0, OS_TASK_OPT_STK_CHK | OS_TASK_OPT_STK_CLR);
+}
+
+/**********************************************/
+//:һỰ
+//:plink:Ự
+//          pbus:CAN
+//          rx_id:ԷID
+//          tx_id:ԷID
+//          bs:֡еĿС,0:֡ٷ֡
+//          stmin:֡еSTmin,0:֡Ա
+//          rx_q:ϢĶ
+//ֵ  :OS_FALSE:ûźCAN鲻
+/**********************************************/
+BOOLEAN ISOTP_LinkAdd(ISOTP_LINK * plink, CAN_BUS * pbus, INT32U rx_id, INT32U tx_id, INT8U bs, INT8U stmin,
+		      OS_EVENT * rx_q)
+{
+	ISOTP_LINK **pp;
+#if OS_CRITICAL_METHOD == 3u
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+	plink->pbus = pbus;
+	plink->tx_id = tx_id;
+	plink->bs = bs;
+	plink->stmin = stmin;
+	plink->rx_q = rx_q;
+	plink->rx_head = (ISOTP_BUF *) 0;
+	plink->rx_left = 0u;
+	plink->tx_busy = OS_FALSE;
+	plink->fc_wait = OS_FALSE;
+	plink->rx_msg_ctr = 0u;
+	plink->rx_err_ctr = 0u;
+	plink->tx_msg_ctr = 0u;
+	plink->fc_sem = OSSemCreate(0u);
+	if (plink->fc_sem == (OS_EVENT *) 0) {
+		return (OS_FALSE);
+	}
+	OS_ENTER_CRITICAL();
+	plink->next = ISOTP_LinkList;	//ȼỰ,ĺյ֡ҵỰ
+	ISOTP_LinkList = plink;
+	OS_EXIT_CRITICAL();
+	plink->sub.id = rx_id;
+	plink->sub.mask = ((rx_id & CAN_FRAME_EXT) != 0u) ? CAN_ID_MASK_EXT : CAN_ID_MASK_STD;
+	plink->sub.q = ISOTP_Q;
+	if (CAN_Subscribe(pbus, &plink->sub) == OS_FALSE) {
+		OS_ENTER_CRITICAL();
+		for (pp = &ISOTP_LinkList; *pp != plink; pp = &(*pp)->next) {
+		}
+		*pp = plink->next;
+		OS_EXIT_CRITICAL();
+		return (OS_FALSE);
+	}
+	return (OS_TRUE);
+}
+
+/**********************************************/
+//:,лỰյ֡ͽճʱ
+//:p_arg:δ
+//ֵ  :none
+/**********************************************/
+static void ISOTP_Task(void *p_arg)
+{
+	ISOTP_LINK *plink;
+	CAN_FRAME *pframe;
+	INT8U err;
+
+	(void)p_arg;
+	for (;;) {
+		pframe = (CAN_FRAME *) OSQPend(ISOTP_Q, ISOTP_TIMEOUT, &err);
+		for (plink = ISOTP_LinkList; plink != (ISOTP_LINK *) 0; plink = plink->next) {
+			if ((pframe != (CAN_FRAME *) 0) && (pframe->id == plink->sub.id)) {
+				ISOTP_RxFrame(plink, pframe);
+				CAN_FrameFree(plink->pbus, pframe);
+				pframe = (CAN_FRAME *) 0;
+			}
+			if ((plink->rx_head != (ISOTP_BUF *) 0) && (OSTimeGet() - plink->rx_tick >= ISOTP_TIMEOUT)) {
+				plink->rx_err_ctr++;
+				ISOTP_RxAbort(plink);	//N_Crʱ
+			}
+		}
+	}
+}
+
+/**********************************************/
+//:Ựյһ֡
+//:plink:Ự
+//          pframe:֡
+//ֵ  :none
+/**********************************************/
+static void ISOTP_RxFrame(ISOTP_LINK * plink, CAN_FRAME const *pframe)
+{
+	INT8U const *d;
+	ISOTP_BUF *pbuf;
+	INT32U len;
+
+	d = pframe->data;
+	if (pframe->dlc == 0u) {
+		return;
+	}
+	switch (d[0] & 0xF0u) {
+	case ISOTP_PCI_SF:
+		len = d[0] & 0x0Fu;
+		if ((len == 0u) || (len + 1u > pframe->dlc)) {
+			return;
+		}
+		ISOTP_RxAbort(plink);	//ϢϢ
+		if (ISOTP_RxAlloc(plink, len) == OS_FALSE) {
+			plink->rx_err_ctr++;
+			return;
+		}
+		ISOTP_RxCopy(plink, &d[1], len);
+		break;
+
+	case ISOTP_PCI_FF:
+		if (pframe->dlc < 8u) {
+			return;
+		}
+		ISOTP_RxAbort(plink);
+		len = ((INT32U)(d[0] & 0x0Fu) << 8) | d[1];
+		if (len == 0u) {	//32λ
+			len = ((INT32U)d[2] << 24) | ((INT32U)d[3] << 16) | ((INT32U)d[4] << 8) | d[5];
+			d += 6;
+		} else {
+			d += 2;
+		}
+		if (len <= (INT32U)(pframe->data + 8 - d)) {
+			return;
+		}
+		if (ISOTP_RxAlloc(plink, len) == OS_FALSE) {
+			plink->rx_err_ctr++;
+			ISOTP_SendFc(plink, ISOTP_FS_OVFLW);
+			return;
+		}
+		ISOTP_RxCopy(plink, d, (INT32U)(pframe->data + 8 - d));
+		plink->rx_sn = 1u;
+		plink->rx_bs_cnt = plink->bs;
+		ISOTP_SendFc(plink, ISOTP_FS_CTS);
+		return;
+
+	case ISOTP_PCI_CF:
+		if (plink->rx_head == (ISOTP_BUF *) 0) {
+			return;
+		}
+		if ((d[0] & 0x0Fu) != plink->rx_sn) {
+			plink->rx_err_ctr++;
+			ISOTP_RxAbort(plink);
+			return;
+		}
+		len = (plink->rx_left < 7u) ? plink->rx_left : 7u;
+		if (len + 1u > pframe->dlc) {
+			return;
+		}
+		ISOTP_RxCopy(plink, &d[1], len);
+		plink->rx_sn = (plink->rx_sn + 1u) & 0x0Fu;
+		if ((plink->rx_left != 0u) && (plink->bs != 0u) && (--plink->rx_bs_cnt == 0u)) {
+			plink->rx_bs_cnt = plink->bs;
+			ISOTP_SendFc(plink, ISOTP_FS_CTS);
+		}
+		break;
+
+	case ISOTP_PCI_FC:
+		if ((plink->fc_wait == OS_FALSE) || (pframe->dlc < 3u)) {
+			return;
+		}
+		plink->fc_fs = d[0] & 0x0Fu;
+		plink->fc_bs = d[1];
+		plink->fc_st = d[2];
+		if (plink->fc_fs != ISOTP_FS_WAIT) {
+			plink->fc_wait = OS_FALSE;
+		}
+		(void)OSSemPost(plink->fc_sem);
+		return;
+
+	default:
+		return;
+	}
+	if ((plink->rx_head != (ISOTP_BUF *) 0) && (plink->rx_left == 0u)) {	//Ϣ
+		pbuf = plink->rx_head;
+		plink->rx_head = (ISOTP_BUF *) 0;
+		if (OSQPost(plink->rx_q, (void *)pbuf) == OS_ERR_NONE) {
+			plink->rx_msg_ctr++;
+		} else {
+			plink->rx_err_ctr++;
+			ISOTP_BufFree(pbuf);
+		}
+	}
+}
+
+/**********************************************/
+//:Ϣ
+//:plink:Ự
+//ֵ  :none
+/**********************************************/
+static void ISOTP_RxAbort(ISOTP_LINK * plink)
+{
+	if (plink->rx_head != (ISOTP_BUF *) 0) {
+		ISOTP_BufFree(plink->rx_head);
+		plink->rx_head = (ISOTP_BUF *) 0;
+	}
+}
+
+/**********************************************/
+//:ΪϢ
+//:plink:Ự
+//          len:Ϣ
+//ֵ  :OS_FALSE:鲻
+/**********************************************/
+static BOOLEAN ISOTP_RxAlloc(ISOTP_LINK * plink, INT32U len)
+{
+	ISOTP_BUF *pbuf;
+	INT32U n;
+	INT8U err;
+
+	plink->rx_head = (ISOTP_BUF *) 0;
+	for (n = (len + ISOTP_BUF_CAP - 1u) / ISOTP_BUF_CAP; n > 0u; n--) {
+		pbuf = (ISOTP_BUF *) OSMemGet(ISOTP_Mem, &err);
+		if (pbuf == (ISOTP_BUF *) 0) {
+			ISOTP_RxAbort(plink);
+			return (OS_FALSE);
+		}
+		pbuf->len = 0u;
+		pbuf->next = plink->rx_head;
+		plink->rx_head = pbuf;
+	}
+	plink->rx_cur = plink->rx_head;
+	plink->rx_left = len;
+	plink->rx_tick = OSTimeGet();
+	return (OS_TRUE);
+}
+
+/**********************************************/
+//:֡еݸƵĩβ
+//:plink:Ự
+//          pdata:
+//          n:ֽ,rx_left
+//ֵ  :none
+/**********************************************/
+static void ISOTP_RxCopy(ISOTP_LINK * plink, INT8U const *pdata, INT32U n)
+{
+	ISOTP_BUF *pbuf;
+	INT8U *p;
+
+	plink->rx_left -= n;
+	plink->rx_tick = OSTimeGet();
+	pbuf = plink->rx_cur;
+	while (n > 0u) {
+		if (pbuf->len == ISOTP_BUF_CAP) {
+			pbuf = pbuf->next;
+		}
+		p = ISOTP_BUF_DATA(pbuf) + pbuf->len;
+		do {
+			*p++ = *pdata++;
+			pbuf->len++;
+			n--;
+		} while ((n > 0u) && (pbuf->len < ISOTP_BUF_CAP));
+	}
+	plink->rx_cur = pbuf;
+}
+
+/**********************************************/
+//:֡
+//:plink:Ự
+//          fs:ISOTP_FS_xxx
+//ֵ  :none
+//˵    :ûпCAN֡ʱϢ
+/**********************************************/
+static void ISOTP_SendFc(ISOTP_LINK * plink, INT8U fs)
+{
+	CAN_FRAME *pframe;
+	INT8U err;
+
+	pframe = CAN_FrameGet(plink->pbus, ISOTP_TIMEOUT, &err);
+	if (pframe == (CAN_FRAME *) 0) {
+		plink->rx_err_ctr++;
+		ISOTP_RxAbort(plink);
+		return;
+	}
+	pframe->id = plink->tx_id;
+	pframe->dlc = 3u;
+	pframe->data[0] = ISOTP_PCI_FC | fs;
+	pframe->data[1] = plink->bs;
+	pframe->data[2] = plink->stmin;
+	CAN_Post(plink->pbus, pframe);
+}
+
+/**********************************************/
+//:STminӦʱӽ
+//:st:֡еSTmin
+//ֵ  :֮֡ҪʱĽ
+//˵    :100~900us1ms,ֵ127ms;һ,֤СSTmin
+/**********************************************/
+static INT16U ISOTP_StTicks(INT8U st)
+{
+	INT32U ms;
+
+	if (st == 0u) {
+		return (0u);
+	}
+	if (st <= 0x7Fu) {
+		ms = st;
+	} else if ((st >= 0xF1u) && (st <= 0xF9u)) {
+		ms = 1u;
+	} else {
+		ms = 0x7Fu;
+	}
+	return ((INT16U)((ms * OS_TICKS_PER_SEC + 999u) / 1000u + 1u));
+}
+
+/**********************************************/
+//:ȴԷ֡
+//:plink:Ự,֮֡֡ǰλfc_wait
+//          timeout:ȴʱӽ,0:һֱȴ
+//ֵ  :ISOTP_ERR_NONE(Լ),ISOTP_ERR_TIMEOUT,ISOTP_ERR_OVFLWISOTP_ERR_WFT
+/**********************************************/
+static INT8U ISOTP_WaitFc(ISOTP_LINK * plink, INT32U timeout)
+{
+	INT8U wft;
+	INT8U err;
+
+	for (wft = 0u;; wft++) {
+		OSSemPend(plink->fc_sem, timeout, &err);
+		if (err != OS_ERR_NONE) {
+			plink->fc_wait = OS_FALSE;
+			return (ISOTP_ERR_TIMEOUT);
+		}
+		if (plink->fc_fs != ISOTP_FS_WAIT) {
+			break;
+		}
+		if (wft >= ISOTP_WFT_MAX) {
+			plink->fc_wait = OS_FALSE;
+			return (ISOTP_ERR_WFT);
+		}
+	}
+	while (OSSemAccept(plink->fc_sem) > 0u) {	//ǵĵȴ֡
+	}
+	return ((plink->fc_fs == ISOTP_FS_CTS) ? ISOTP_ERR_NONE : ISOTP_ERR_OVFLW);
+}
+
+/**********************************************/
+//:һϢ,󷵻
+//:plink:Ự
+//          pdata:,ǰ޸
+//          len:
+//          timeout:ȴ֡ͿCAN֡ʱӽ,0:һֱȴ
+//ֵ  :ISOTP_ERR_xxx
+//˵    :ͬĻỰڲͬͬʱ
+/**********************************************/
+INT8U ISOTP_Send(ISOTP_LINK * plink, INT8U const *pdata, INT32U len, INT32U timeout)
+{
+	CAN_FRAME *pframe;
+	INT32U off;
+	INT16U st;
+	BOOLEAN last;
+	INT8U bs;
+	INT8U sn;
+	INT8U n;
+	INT8U i;
+	INT8U err;
+#if OS_CRITICAL_METHOD == 3u
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+	if (len == 0u) {
+		return (ISOTP_ERR_LEN);
+	}
+	OS_ENTER_CRITICAL();
+	if (plink->tx_busy != OS_FALSE) {
+		OS_EXIT_CRITICAL();
+		return (ISOTP_ERR_BUSY);
+	}
+	plink->tx_busy = OS_TRUE;
+	OS_EXIT_CRITICAL();
+	pframe = CAN_FrameGet(plink->pbus, timeout, &err);
+	if (pframe == (CAN_FRAME *) 0) {
+		plink->tx_busy = OS_FALSE;
+		return (ISOTP_ERR_TIMEOUT);
+	}
+	pframe->id = plink->tx_id;
+	if (len <= 7u) {
+		pframe->data[0] = ISOTP_PCI_SF | (INT8U)len;
+		off = 1u;
+	} else if (len <= 0xFFFu) {
+		pframe->data[0] = ISOTP_PCI_FF | (INT8U)(len >> 8);
+		pframe->data[1] = (INT8U)len;
+		off = 2u;
+	} else {
+		pframe->data[0] = ISOTP_PCI_FF;
+		pframe->data[1] = 0u;
+		pframe->data[2] = (INT8U)(len >> 24);
+		pframe->data[3] = (INT8U)(len >> 16);
+		pframe->data[4] = (INT8U)(len >> 8);
+		pframe->data[5] = (INT8U)len;
+		off = 6u;
+	}
+	n = (INT8U)((len <= 7u) ? len : 8u - off);
+	for (i = 0u; i < n; i++) {
+		pframe->data[off + i] = pdata[i];
+	}
+	pframe->dlc = (INT8U)(off + n);
+	off = n;
+	plink->fc_wait = (len > 7u) ? OS_TRUE : OS_FALSE;
+	CAN_Post(plink->pbus, pframe);
+	err = ISOTP_ERR_NONE;
+	sn = 1u;
+	while (off < len) {
+		err = ISOTP_WaitFc(plink, timeout);
+		if (err != ISOTP_ERR_NONE) {
+			break;
+		}
+		bs = plink->fc_bs;
+		st = ISOTP_StTicks(plink->fc_st);
+		do {
+			pframe = CAN_FrameGet(plink->pbus, timeout, &err);
+			if (pframe == (CAN_FRAME *) 0) {
+				err = ISOTP_ERR_TIMEOUT;
+				break;
+			}
+			n = (INT8U)((len - off < 7u) ? (len - off) : 7u);
+			pframe->id = plink->tx_id;
+			pframe->dlc = n + 1u;
+			pframe->data[0] = ISOTP_PCI_CF | sn;
+			for (i = 0u; i < n; i++) {
+				pframe->data[1u + i] = pdata[off + i];
+			}
+			off += n;
+			sn = (sn + 1u) & 0x0Fu;
+			last = ((bs != 0u) && (--bs == 0u) && (off < len)) ? OS_TRUE : OS_FALSE;
+			if (last != OS_FALSE) {
+				plink->fc_wait = OS_TRUE;	//һ֡
+			}
+			CAN_Post(plink->pbus, pframe);
+			if ((st != 0u) && (off < len) && (last == OS_FALSE)) {
+				OSTimeDly(st);
+			}
+		} while ((off < len) && (last == OS_FALSE));
+		if (pframe == (CAN_FRAME *) 0) {
+			break;
+		}
+	}
+	if (err == ISOTP_ERR_NONE) {
+		plink->tx_msg_ctr++;
+	}
+	plink->tx_busy = OS_FALSE;
+	return (err);
+}
+
+/**********************************************/
+//:Ϣܳ
+//:pbuf:rx_qյĿ
+//ֵ  :ֽ
+/**********************************************/
+INT32U ISOTP_BufLen(ISOTP_BUF const *pbuf)
+{
+	INT32U len;
+
+	for (len = 0u; pbuf != (ISOTP_BUF *) 0; pbuf = pbuf->next) {
+		len += pbuf->len;
+	}
+	return (len);
+}
+
+/**********************************************/
+//:黹ϢĿ
+//:pbuf:rx_qյĿ
+//ֵ  :none
+/**********************************************/
+void ISOTP_BufFree(ISOTP_BUF * pbuf)
+{
+	ISOTP_BUF *pnext;
+
+	while (pbuf != (ISOTP_BUF *) 0) {
+		pnext = pbuf->next;
+		(void)OSMemPut(ISOTP_Mem, (void *)pbuf);
+		pbuf = pnext;
+	}
+}
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef ISOTP_H
+#define ISOTP_H
+
+#include "app_cfg.h"
+#include "can.h"
+
+/*
+ * ISO 15765-2(ISO-TP)ֶδ:
+ * ÿISOTP_LINKһCAN IDϵȫ˫Ự,ͬʱڶ.
+ * :лỰ֡ͬһ,ISOTP,CAN֡еֱӸƵOSMem
+ * (ֻһ),ɺѿĵһISOTP_BUFỰrx_q,ISOTP_BufFree()黹.
+ * ֡ʱһηϢҪĿ,ʱظ.
+ * :ISOTP_Send()ڵߵзֶ,ԷصBSSTmin֡;STminΪ0ʱ
+ * ֱ֡CANͶ,߱.ȴ4095ʱʹ32λȵ֡.
+ */
+
+#define ISOTP_ERR_NONE      0u
+#define ISOTP_ERR_LEN       1u	//Ϊ0
+#define ISOTP_ERR_BUSY      2u	//Ựڷ
+#define ISOTP_ERR_TIMEOUT   3u	//ȴ֡CAN֡ʱ
+#define ISOTP_ERR_OVFLW     4u	//Է
+#define ISOTP_ERR_WFT       5u	//ԷҪȴĴ
+
+typedef struct isotp_buf ISOTP_BUF;
+typedef struct isotp_link ISOTP_LINK;
+
+struct isotp_buf {		//OSMemͷ,ݽ
+	ISOTP_BUF *next;
+	INT32U len;		//еֽ
+};
+
+#define ISOTP_BUF_DATA(pbuf)    ((INT8U *)((pbuf) + 1))
+#define ISOTP_BUF_CAP           (ISOTP_BLK_SIZE - sizeof(ISOTP_BUF))
+
+struct isotp_link {
+	CAN_BUS *pbus;
+	INT32U tx_id;		//ԷID
+	INT8U bs;		//֡еĿС,0:ٷ֡
+	INT8U stmin;		//֡е֡С
+	OS_EVENT *rx_q;		//յϢ,ISOTP_BUF *
+	CAN_SUB sub;		//sub.id:ԷID
+	ISOTP_BUF *rx_head;	//Ϊ״̬
+	ISOTP_BUF *rx_cur;
+	INT32U rx_left;
+	INT32U rx_tick;
+	INT8U rx_sn;
+	INT8U rx_bs_cnt;
+	BOOLEAN tx_busy;	//Ϊ״̬
+	volatile BOOLEAN fc_wait;
+	INT8U fc_fs;
+	INT8U fc_bs;
+	INT8U fc_st;
+	OS_EVENT *fc_sem;
+	INT32U rx_msg_ctr;	//ͳ
+	INT32U rx_err_ctr;	//Ŵ,ʱ,ûпrx_q
+	INT32U tx_msg_ctr;
+	ISOTP_LINK *next;
+};
+
+extern void ISOTP_Init(INT8U prio);
+extern BOOLEAN ISOTP_LinkAdd(ISOTP_LINK * plink, CAN_BUS * pbus, INT32U rx_id, INT32U tx_id, INT8U bs, INT8U stmin,
+			     OS_EVENT * rx_q);
+extern INT8U ISOTP_Send(ISOTP_LINK * plink, INT8U const *pdata, INT32U len, INT32U timeout);
+extern INT32U ISOTP_BufLen(ISOTP_BUF const *pbuf);
+extern void ISOTP_BufFree(ISOTP_BUF * pbuf);
+
+#endif
@@ -0,0 +1,129 @@
+#include "log.h"
+#include "device.h"
+
+#if LOG_EN > 0
+
+/*
+ * ¼ڻλռ3+nargs:
+ *   [0] LOG_SYNC | ȼ<<8 | nargs   д,0ʾ¼
+ *   [1] ʽַ
+ *   [2] ʱ
+ *   [3...] 
+ * дLDREX/STREXԤռ,ж;ͺѼ¼0.
+ */
+
+static volatile INT32U LOG_Buf[LOG_BUF_SIZE];
+static volatile INT32U LOG_Head;	//Ԥλ(ɼ)
+static volatile INT32U LOG_Tail;	//ѷ͵λ(ɼ)
+static OS_STK LOG_TaskStk[LOG_STK_SIZE];
+INT32U LOG_DropCtr;		//򻺳ļ¼
+
+static void LOG_Task(void *p_arg);
+
+/**********************************************/
+//:ʼ־
+//:prio:ȼ,Ӧڲ־
+//ֵ  :none
+//˵    :ҪDEV_UartInit()֮
+/**********************************************/
+void LOG_Init(INT8U prio)
+{
+	LOG_Head = 0u;
+	LOG_Tail = 0u;
+	LOG_DropCtr = 0u;
+	OS_CPU_TS_Init();
+	(void)OSTaskCreateExt(LOG_Task, (void *)0, &LOG_TaskStk[LOG_STK_SIZE - 1u], prio, prio, &LOG_TaskStk[0],
+			      LOG_STK_SIZE, (void *)0, OS_TASK_OPT_STK_CHK | OS_TASK_OPT_STK_CLR);
+}
+
+/**********************************************/
+//:¼һ־,ʽ
+//:fmt:ʽ
+//          nargs:(<=LOG_ARG_MAX)
+//          a0~a3:
+//ֵ  :none
+//˵    :же,ʱ
+/**********************************************/
+void LOG_Put(char const *fmt, INT8U nargs, INT32U a0, INT32U a1, INT32U a2, INT32U a3)
+{
+	INT32U h;
+	INT32U n;
+#if OS_CPU_EXCL_EN > 0
+	INT32U d;
+#endif
+#if OS_CPU_EXCL_EN == 0
+#if OS_CRITICAL_METHOD == 3u
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+#endif
+
+	n = 3u + nargs;
+#if OS_CPU_EXCL_EN > 0
+	do {
+		h = OS_CPU_LDREX(&LOG_Head);
+		if (h + n - LOG_Tail > LOG_BUF_SIZE) {
+			OS_CPU_CLREX();
+			do {	//жҲᶪ,ͬҪռ
+				d = OS_CPU_LDREX(&LOG_DropCtr);
+			} while (OS_CPU_STREX(d + 1u, &LOG_DropCtr) != 0u);
+			return;
+		}
+	} while (OS_CPU_STREX(h + n, &LOG_Head) != 0u);
+#else
+	OS_ENTER_CRITICAL();
+	h = LOG_Head;
+	if (h + n - LOG_Tail > LOG_BUF_SIZE) {
+		LOG_DropCtr++;
+		OS_EXIT_CRITICAL();
+		return;
+	}
+	LOG_Head = h + n;
+	OS_EXIT_CRITICAL();
+#endif
+	LOG_Buf[(h + 1u) & (LOG_BUF_SIZE - 1u)] = (INT32U)fmt;
+	LOG_Buf[(h + 2u) & (LOG_BUF_SIZE - 1u)] = OS_CPU_TS_GET();
+	if (nargs > 0u) {
+		LOG_Buf[(h + 3u) & (LOG_BUF_SIZE - 1u)] = a0;
+		if (nargs > 1u) {
+			LOG_Buf[(h + 4u) & (LOG_BUF_SIZE - 1u)] = a1;
+			if (nargs > 2u) {
+				LOG_Buf[(h + 5u) & (LOG_BUF_SIZE - 1u)] = a2;
+				if (nargs > 3u) {
+					LOG_Buf[(h + 6u) & (LOG_BUF_SIZE - 1u)] = a3;
+				}
+			}
+		}
+	}
+	LOG_Buf[h & (LOG_BUF_SIZE - 1u)] = LOG_SYNC | ((INT32U)OSPrioCur << 8) | nargs;
+}
+
+/**********************************************/
+//:־,˳ļ¼͵
+//:p_arg:none
+//ֵ  :none
+/**********************************************/
+static void LOG_Task(void *p_arg)
+{
+	INT32U rec[3u + LOG_ARG_MAX];
+	INT32U hdr;
+	INT32U n;
+	INT32U i;
+
+	(void)p_arg;
+	while (1) {
+		hdr = LOG_Buf[LOG_Tail & (LOG_BUF_SIZE - 1u)];
+		if (hdr == 0u) {	//ûм¼,ļ¼ûд
+			OSTimeDly(LOG_DRAIN_DLY);
+			continue;
+		}
+		n = 3u + (hdr & 0xFFu);
+		for (i = 0u; i < n; i++) {
+			rec[i] = LOG_Buf[(LOG_Tail + i) & (LOG_BUF_SIZE - 1u)];
+			LOG_Buf[(LOG_Tail + i) & (LOG_BUF_SIZE - 1u)] = 0u;
+		}
+		LOG_Tail += n;
+		(void)DEV_WriteAll((INT8U *)rec, (INT16U)(n * 4u));	//С,¼
+	}
+}
+
+#endif
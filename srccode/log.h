@@ -0,0 +1,38 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include "app_cfg.h"
+#include "fmt.h"
+
+/*
+ * ־:
+ * ¼ʽĵַ,ʱ(DWT),ǰȼLOG_ARG_MAX32λ,
+ * ɵȼԶƷ͵,tools/logdec.py.axfеĸʽԭı.
+ * ʽַ;ַָָֻ(%s).
+ * LOG_ENΪ0ʱ,LOGn()ֱӵFMT_Printf().
+ * ¼ÿ12~28ֽ,̵ıʡò:userroot.cʾһֻһ(tests/bench_log.c).
+ */
+
+#define LOG_ARG_MAX         4u
+#define LOG_SYNC            0xA5000000u	//¼ͷֽͬ
+
+#if LOG_EN > 0
+#define LOG0(fmt)                   LOG_Put((fmt), 0u, 0u, 0u, 0u, 0u)
+#define LOG1(fmt, a)                LOG_Put((fmt), 1u, (INT32U)(a), 0u, 0u, 0u)
+#define LOG2(fmt, a, b)             LOG_Put((fmt), 2u, (INT32U)(a), (INT32U)(b), 0u, 0u)
+#define LOG3(fmt, a, b, c)          LOG_Put((fmt), 3u, (INT32U)(a), (INT32U)(b), (INT32U)(c), 0u)
+#define LOG4(fmt, a, b, c, d)       LOG_Put((fmt), 4u, (INT32U)(a), (INT32U)(b), (INT32U)(c), (INT32U)(d))
+#else
+#define LOG0(fmt)                   FMT_Printf(fmt)
+#define LOG1(fmt, a)                FMT_Printf((fmt), (a))
+#define LOG2(fmt, a, b)             FMT_Printf((fmt), (a), (b))
+#define LOG3(fmt, a, b, c)          FMT_Printf((fmt), (a), (b), (c))
+#define LOG4(fmt, a, b, c, d)       FMT_Printf((fmt), (a), (b), (c), (d))
+#endif
+
+extern INT32U LOG_DropCtr;
+
+extern void LOG_Init(INT8U prio);
+extern void LOG_Put(char const *fmt, INT8U nargs, INT32U a0, INT32U a1, INT32U a2, INT32U a3);
+
+#endif
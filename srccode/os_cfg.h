@@ -33,6 +33,10 @@
 
 #define OS_DEBUG_EN               0u	/* Enable(1) debug variables                                    */
 
+#define OS_EDF_EN                 0u	/* Enable (1) earliest-deadline-first scheduling in a prio band */
+#define OS_EDF_PRIO_HI           20u	/* Highest priority of the EDF band                             */
+#define OS_EDF_PRIO_LO           29u	/* Lowest  priority of the EDF band                             */
+
 #define OS_EVENT_MULTI_EN         0u	/* Include code for OSEventPendMulti()                          */
 #define OS_EVENT_NAME_EN          0u	/* Enable names for Sem, Mutex, Mbox and Q                      */
 
@@ -52,23 +56,32 @@
 
 
 				       /* --------------------- TASK STACK SIZE ---------------------- */
-#define OS_TASK_TMR_STK_SIZE    128u	/* Timer      task stack size (# of OS_STK wide entries)        */
-#define OS_TASK_STAT_STK_SIZE   128u	/* Statistics task stack size (# of OS_STK wide entries)        */
-#define OS_TASK_IDLE_STK_SIZE   128u	/* Idle       task stack size (# of OS_STK wide entries)        */
+#define OS_TASK_TMR_STK_SIZE    (128u + OS_TASK_STK_GUARD_SIZE)	/* Timer      task stack size (# of OS_STK wide entries)        */
+#define OS_TASK_STAT_STK_SIZE   (128u + OS_TASK_STK_GUARD_SIZE)	/* Statistics task stack size (# of OS_STK wide entries)        */
+#define OS_TASK_IDLE_STK_SIZE   (128u + OS_TASK_STK_GUARD_SIZE)	/* Idle       task stack size (# of OS_STK wide entries)        */
 
 
 				       /* --------------------- TASK MANAGEMENT ---------------------- */
+#define OS_TASK_BUDGET_EN         0u	/*     Enforce CPU budgets of tasks (see OS_TASK_OPT_BUDGET)    */
+#define OS_TASK_BUDGET_DFLT 3600000u	/*     Default budget per period (in OS_CPU_TS_GET() counts)    */
+#define OS_TASK_BUDGET_PERIOD   100u	/*     Default budget replenishment period (in ticks)           */
 #define OS_TASK_CHANGE_PRIO_EN    1u	/*     Include code for OSTaskChangePrio()                      */
 #define OS_TASK_CREATE_EN         1u	/*     Include code for OSTaskCreate()                          */
 #define OS_TASK_CREATE_EXT_EN     1u	/*     Include code for OSTaskCreateExt()                       */
 #define OS_TASK_DEL_EN            1u	/*     Include code for OSTaskDel()                             */
 #define OS_TASK_NAME_EN           1u	/*     Enable task names                                        */
+#define OS_TASK_PERIOD_EN         1u	/*     Include code for OSTaskPeriodSet() and periodic stats    */
 #define OS_TASK_PROFILE_EN        1u	/*     Include variables in OS_TCB for profiling                */
 #define OS_TASK_QUERY_EN          1u	/*     Include code for OSTaskQuery()                           */
 #define OS_TASK_REG_TBL_SIZE      1u	/*     Size of task variables array (#of INT32U entries)        */
+#define OS_TASK_RR_EN             0u	/*     Allow several tasks per priority, time sliced round-robin*/
+#define OS_TASK_RR_QUANTA        10u	/*     Default time slice of round-robin tasks (in ticks)       */
 #define OS_TASK_STAT_EN           1u	/*     Enable (1) or Disable(0) the statistics task             */
 #define OS_TASK_STAT_STK_CHK_EN   1u	/*     Check task stacks from statistic task                    */
+#define OS_TASK_STK_CHK_GUARD     0u	/*     Zero entries ending a stack check (0 = full stack scan)  */
+#define OS_TASK_STK_GUARD_EN      0u	/*     Trap task stack overflows at each switch (MPU or canary) */
 #define OS_TASK_SUSPEND_EN        1u	/*     Include code for OSTaskSuspend() and OSTaskResume()      */
+#define OS_TASK_THRESHOLD_EN      0u	/*     Enable preemption thresholds (see OSTaskThresholdSet())  */
 #define OS_TASK_SW_HOOK_EN        1u	/*     Include code for OSTaskSwHook()                          */
 
 
@@ -82,6 +95,15 @@
 #define OS_FLAGS_NBITS           16u	/* Size in #bits of OS_FLAGS data type (8, 16 or 32)            */
 
 
+				       /* ------------------ RUN-TO-COMPLETION JOBS ------------------ */
+#define OS_JOB_EN                 1u	/* Enable (1) or Disable (0) code generation for JOBS           */
+
+
+				       /* ------------------------ COROUTINES ------------------------ */
+#define OS_CO_EN                  0u	/* Enable (1) or Disable (0) code generation for COROUTINES     */
+#define OS_CO_PEND_MAX           16u	/*     Max. number of events pended on by a coroutine scheduler */
+
+
 				       /* -------------------- MESSAGE MAILBOXES --------------------- */
 #define OS_MBOX_EN                0u	/* Enable (1) or Disable (0) code generation for MAILBOXES      */
 #define OS_MBOX_ACCEPT_EN         1u	/*     Include code for OSMboxAccept()                          */
@@ -93,7 +115,7 @@
 
 
 				       /* --------------------- MEMORY MANAGEMENT -------------------- */
-#define OS_MEM_EN                 0u	/* Enable (1) or Disable (0) code generation for MEMORY MANAGER */
+#define OS_MEM_EN                 1u	/* Enable (1) or Disable (0) code generation for MEMORY MANAGER */
 #define OS_MEM_NAME_EN            1u	/*     Enable memory partition names                            */
 #define OS_MEM_QUERY_EN           1u	/*     Include code for OSMemQuery()                            */
 
@@ -102,6 +124,7 @@
 #define OS_MUTEX_EN               1u	/* Enable (1) or Disable (0) code generation for MUTEX          */
 #define OS_MUTEX_ACCEPT_EN        1u	/*     Include code for OSMutexAccept()                         */
 #define OS_MUTEX_DEL_EN           1u	/*     Include code for OSMutexDel()                            */
+#define OS_MUTEX_FAST_EN          0u	/*     Lock-free Pend/Post of an uncontended mutex              */
 #define OS_MUTEX_QUERY_EN         1u	/*     Include code for OSMutexQuery()                          */
 
 
@@ -121,6 +144,7 @@
 #define OS_SEM_EN                 1u	/* Enable (1) or Disable (0) code generation for SEMAPHORES     */
 #define OS_SEM_ACCEPT_EN          1u	/*    Include code for OSSemAccept()                            */
 #define OS_SEM_DEL_EN             1u	/*    Include code for OSSemDel()                               */
+#define OS_SEM_FAST_EN            0u	/*    Lock-free Pend/Post when no task must block or be readied */
 #define OS_SEM_PEND_ABORT_EN      1u	/*    Include code for OSSemPendAbort()                         */
 #define OS_SEM_QUERY_EN           1u	/*    Include code for OSSemQuery()                             */
 #define OS_SEM_SET_EN             1u	/*    Include code for OSSemSet()                               */
@@ -129,6 +153,7 @@
 				       /* --------------------- TIME MANAGEMENT ---------------------- */
 #define OS_TIME_DLY_HMSM_EN       1u	/*     Include code for OSTimeDlyHMSM()                         */
 #define OS_TIME_DLY_RESUME_EN     1u	/*     Include code for OSTimeDlyResume()                       */
+#define OS_TIME_DLY_UNTIL_EN      1u	/*     Include code for OSTimeDlyUntil()                        */
 #define OS_TIME_GET_SET_EN        1u	/*     Include code for OSTimeGet() and OSTimeSet()             */
 #define OS_TIME_TICK_HOOK_EN      1u	/*     Include code for OSTimeTickHook()                        */
 
@@ -0,0 +1,311 @@
+#include "spi.h"
+
+#if SPI_EN > 0
+
+#define SPI_DMA_IF_TC       0x02u	//DMA_ISRÿͨ4λ:GIF,TCIF,HTIF,TEIF
+#define SPI_DMA_IF_HT       0x04u
+#define SPI_DMA_IF_TE       0x08u
+
+SPI_BUS SPI_Bus1;
+
+static INT8U const SPI_DummyTx = 0xFFu;
+static INT8U SPI_DummyRx;
+
+static void SPI_Start(SPI_BUS * pbus, SPI_XFER * pxfer);
+static void SPI_Next(SPI_BUS * pbus);
+
+/**********************************************/
+//:ʼһSPIߵ
+//:pbus:
+//          spi:SPIĴ
+//          dma:DMAĴ
+//          rx_ch,tx_ch:պͷDMAͨ
+//          rx_ch_nbr:ͨ(1~7)
+//ֵ  :none
+//˵    :SPIɵú
+/**********************************************/
+void SPI_BusInit(SPI_BUS * pbus, SPI_TypeDef * spi, DMA_TypeDef * dma, DMA_Channel_TypeDef * rx_ch,
+		 DMA_Channel_TypeDef * tx_ch, INT8U rx_ch_nbr)
+{
+	pbus->spi = spi;
+	pbus->dma = dma;
+	pbus->rx_ch = rx_ch;
+	pbus->tx_ch = tx_ch;
+	pbus->rx_shift = (INT8U)((rx_ch_nbr - 1u) * 4u);
+	pbus->cur = (SPI_XFER *) 0;
+	pbus->head = (SPI_XFER *) 0;
+	pbus->tail = (SPI_XFER *) 0;
+	rx_ch->CCR = 0u;
+	tx_ch->CCR = 0u;
+	rx_ch->CPAR = (INT32U) & spi->DR;
+	tx_ch->CPAR = (INT32U) & spi->DR;
+	SPI_I2S_DMACmd(spi, SPI_I2S_DMAReq_Rx | SPI_I2S_DMAReq_Tx, ENABLE);
+}
+
+/**********************************************/
+//:ʼSPI1(PA5:SCK,PA6:MISO,PA7:MOSI,ģʽ0,)SPI_Bus1
+//:prescaler:SPI_BaudRatePrescaler_x
+//ֵ  :none
+//˵    :Ƭѡʹóø
+/**********************************************/
+void SPI_Spi1Init(INT16U prescaler)
+{
+	GPIO_InitTypeDef GPIO_InitStructure;
+	SPI_InitTypeDef SPI_InitStructure;
+	NVIC_InitTypeDef NVIC_InitStructure;
+
+	RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOA | RCC_APB2Periph_SPI1, ENABLE);
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
+
+	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_5 | GPIO_Pin_7;
+	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_PP;
+	GPIO_Init(GPIOA, &GPIO_InitStructure);
+
+	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_6;
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IN_FLOATING;
+	GPIO_Init(GPIOA, &GPIO_InitStructure);
+
+	SPI_StructInit(&SPI_InitStructure);
+	SPI_InitStructure.SPI_Mode = SPI_Mode_Master;
+	SPI_InitStructure.SPI_NSS = SPI_NSS_Soft;
+	SPI_InitStructure.SPI_BaudRatePrescaler = prescaler;
+	SPI_Init(SPI1, &SPI_InitStructure);
+	SPI_Cmd(SPI1, ENABLE);
+
+	SPI_BusInit(&SPI_Bus1, SPI1, DMA1, DMA1_Channel2, DMA1_Channel3, 2u);
+
+	NVIC_InitStructure.NVIC_IRQChannel = DMA1_Channel2_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+}
+
+/**********************************************/
+//:һ
+//:pbus:
+//          pxfer:
+//ֵ  :none
+//˵    :ٽڵ,ȿͨٿͨ
+/**********************************************/
+static void SPI_Start(SPI_BUS * pbus, SPI_XFER * pxfer)
+{
+	INT32U ccr;
+
+	pbus->cur = pxfer;
+	pxfer->stat = SPI_STAT_ACTIVE;
+	if (pxfer->cs_port != (GPIO_TypeDef *) 0) {
+		pxfer->cs_port->BRR = pxfer->cs_pin;
+	}
+	ccr = DMA_CCR1_PL_1 | DMA_CCR1_TCIE | DMA_CCR1_TEIE;
+	if ((pxfer->opt & SPI_OPT_STREAM) != 0u) {
+		ccr |= DMA_CCR1_CIRC | DMA_CCR1_HTIE;
+	}
+	pbus->rx_ch->CCR = 0u;
+	pbus->rx_ch->CNDTR = pxfer->len;
+	if (pxfer->prx != (INT8U *) 0) {
+		pbus->rx_ch->CMAR = (INT32U) pxfer->prx;
+		pbus->rx_ch->CCR = ccr | DMA_CCR1_MINC | DMA_CCR1_EN;
+	} else {
+		pbus->rx_ch->CMAR = (INT32U) & SPI_DummyRx;
+		pbus->rx_ch->CCR = ccr | DMA_CCR1_EN;
+	}
+	ccr = DMA_CCR1_DIR | ((pxfer->opt & SPI_OPT_STREAM) != 0u ? DMA_CCR1_CIRC : 0u);
+	pbus->tx_ch->CCR = 0u;
+	pbus->tx_ch->CNDTR = pxfer->len;
+	if (pxfer->ptx != (INT8U const *)0) {
+		pbus->tx_ch->CMAR = (INT32U) pxfer->ptx;
+		pbus->tx_ch->CCR = ccr | DMA_CCR1_MINC | DMA_CCR1_EN;
+	} else {
+		pbus->tx_ch->CMAR = (INT32U) & SPI_DummyTx;
+		pbus->tx_ch->CCR = ccr | DMA_CCR1_EN;
+	}
+}
+
+/**********************************************/
+//:ǰ,еһ
+//:pbus:
+//ֵ  :none
+//˵    :ٽڵ
+/**********************************************/
+static void SPI_Next(SPI_BUS * pbus)
+{
+	SPI_XFER *pxfer;
+
+	pbus->rx_ch->CCR = 0u;
+	pbus->tx_ch->CCR = 0u;
+	pxfer = pbus->cur;
+	if ((pxfer->cs_port != (GPIO_TypeDef *) 0) && ((pxfer->opt & SPI_OPT_CS_KEEP) == 0u)) {
+		while ((pbus->spi->SR & SPI_I2S_FLAG_BSY) != 0u) {	//һλѾյ,BSYܿ
+		}
+		pxfer->cs_port->BSRR = pxfer->cs_pin;
+	}
+	pbus->cur = (SPI_XFER *) 0;
+	if (pbus->head != (SPI_XFER *) 0) {
+		pxfer = pbus->head;
+		pbus->head = pxfer->next;
+		if (pbus->head == (SPI_XFER *) 0) {
+			pbus->tail = (SPI_XFER *) 0;
+		}
+		SPI_Start(pbus, pxfer);
+	}
+}
+
+/**********************************************/
+//:Ѵ߶,߿ʱʼ
+//:pbus:
+//          pxfer:,ǰ޸
+//ֵ  :none
+//˵    :ж(ص)е
+/**********************************************/
+void SPI_Submit(SPI_BUS * pbus, SPI_XFER * pxfer)
+{
+#if OS_CRITICAL_METHOD == 3u
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+	pxfer->next = (SPI_XFER *) 0;
+	OS_ENTER_CRITICAL();
+	if (pbus->cur == (SPI_XFER *) 0) {
+		SPI_Start(pbus, pxfer);
+	} else {
+		pxfer->stat = SPI_STAT_QUEUED;
+		if (pbus->tail == (SPI_XFER *) 0) {
+			pbus->head = pxfer;
+		} else {
+			pbus->tail->next = pxfer;
+		}
+		pbus->tail = pxfer;
+	}
+	OS_EXIT_CRITICAL();
+}
+
+/**********************************************/
+//:䲢ȴ
+//:pbus:
+//          pxfer:,semΪNULL
+//          timeout:ȴʱӽ,0:һֱȴ
+//ֵ  :OS_ERR_NONE,OS_ERR_PEVENT_NULL,OS_ERR_TIMEOUTOS_ERR_PEND_ABORT(DMA)
+//˵    :ʱ䱻ȡ:Ӷȡ,ֹͣDMA,ͷƬѡһ
+/**********************************************/
+INT8U SPI_Transfer(SPI_BUS * pbus, SPI_XFER * pxfer, INT32U timeout)
+{
+	SPI_XFER **pp;
+	SPI_XFER *prev;
+	INT8U err;
+#if OS_CRITICAL_METHOD == 3u
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+	if (pxfer->sem == (OS_EVENT *) 0) {
+		return (OS_ERR_PEVENT_NULL);
+	}
+	SPI_Submit(pbus, pxfer);
+	OSSemPend(pxfer->sem, timeout, &err);
+	if (err == OS_ERR_TIMEOUT) {
+		OS_ENTER_CRITICAL();
+		if (pxfer->stat == SPI_STAT_QUEUED) {
+			prev = (SPI_XFER *) 0;
+			for (pp = &pbus->head; *pp != pxfer; pp = &(*pp)->next) {
+				prev = *pp;
+			}
+			*pp = pxfer->next;
+			if (pbus->tail == pxfer) {
+				pbus->tail = prev;
+			}
+			pxfer->stat = SPI_STAT_TIMEOUT;
+		} else if (pxfer->stat == SPI_STAT_ACTIVE) {
+			pbus->rx_ch->CCR = 0u;
+			pbus->tx_ch->CCR = 0u;
+			pbus->dma->IFCR = 0x0Fu << pbus->rx_shift;	//ѹж,ᵱһ
+			pxfer->stat = SPI_STAT_TIMEOUT;
+			SPI_Next(pbus);
+			if (pxfer->cs_port != (GPIO_TypeDef *) 0) {	//SPI_OPT_CS_KEEPҲͷƬѡ
+				pxfer->cs_port->BSRR = pxfer->cs_pin;
+			}
+		}
+		(void)OSSemAccept(pxfer->sem);	//ʱͬʱ,DONEERR
+		OS_EXIT_CRITICAL();
+		if (pxfer->stat != SPI_STAT_TIMEOUT) {
+			err = OS_ERR_NONE;
+		}
+	}
+	if ((err == OS_ERR_NONE) && (pxfer->stat == SPI_STAT_ERR)) {
+		err = OS_ERR_PEND_ABORT;
+	}
+	return (err);
+}
+
+/**********************************************/
+//:ֹͣ,еһ
+//:pbus:
+//ֵ  :none
+/**********************************************/
+void SPI_StreamStop(SPI_BUS * pbus)
+{
+#if OS_CRITICAL_METHOD == 3u
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+	OS_ENTER_CRITICAL();
+	if ((pbus->cur != (SPI_XFER *) 0) && ((pbus->cur->opt & SPI_OPT_STREAM) != 0u)) {
+		pbus->cur->stat = SPI_STAT_DONE;
+		SPI_Next(pbus);
+	}
+	OS_EXIT_CRITICAL();
+}
+
+/**********************************************/
+//:SPIDMAжϴ
+//:pbus:
+//ֵ  :none
+/**********************************************/
+void SPI_Isr(SPI_BUS * pbus)
+{
+	SPI_XFER *pxfer;
+	INT32U flags;
+#if OS_CRITICAL_METHOD == 3u
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+	OS_ENTER_CRITICAL();
+	flags = (pbus->dma->ISR >> pbus->rx_shift) & 0x0Fu;
+	pbus->dma->IFCR = flags << pbus->rx_shift;
+	pxfer = pbus->cur;
+	if (pxfer == (SPI_XFER *) 0) {
+		OS_EXIT_CRITICAL();
+		return;
+	}
+	if (((pxfer->opt & SPI_OPT_STREAM) != 0u) && ((flags & SPI_DMA_IF_TE) == 0u)) {
+		OS_EXIT_CRITICAL();
+		if ((flags & SPI_DMA_IF_HT) != 0u) {	//ǰԴ,DMA
+			pxfer->half = 0u;
+			if (pxfer->callback != (SPI_CALLBACK) 0) {
+				(*pxfer->callback) (pxfer);
+			}
+		}
+		if ((flags & SPI_DMA_IF_TC) != 0u) {
+			pxfer->half = 1u;
+			if (pxfer->callback != (SPI_CALLBACK) 0) {
+				(*pxfer->callback) (pxfer);
+			}
+		}
+		return;
+	}
+	if ((flags & (SPI_DMA_IF_TC | SPI_DMA_IF_TE)) == 0u) {
+		OS_EXIT_CRITICAL();
+		return;
+	}
+	pxfer->stat = ((flags & SPI_DMA_IF_TE) != 0u) ? SPI_STAT_ERR : SPI_STAT_DONE;
+	SPI_Next(pbus);		//һ,߲ȴص
+	OS_EXIT_CRITICAL();
+	if (pxfer->sem != (OS_EVENT *) 0) {
+		(void)OSSemPost(pxfer->sem);
+	}
+	if (pxfer->callback != (SPI_CALLBACK) 0) {
+		(*pxfer->callback) (pxfer);
+	}
+}
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef SPI_H
+#define SPI_H
+
+#include "app_cfg.h"
+
+/*
+ * DMA SPI:
+ * ÿһSPI_BUS,Ĵ(SPI,DMAͨ)ͨSPI_BUSеָ,
+ * ʱָڴе.SPI_XFERߵĶDMAִ,
+ * ɺDMAжͷź/ûص,һ.
+ * SPI_OPT_STREAMĴѭDMAշ,ÿɰصһ,ֱSPI_StreamStop().
+ */
+
+#define SPI_OPT_CS_KEEP     0x01u	//ɺ󱣳Ƭѡ,ڶɵһβ
+#define SPI_OPT_STREAM      0x02u	//ѭDMA˫
+
+#define SPI_STAT_IDLE       0u
+#define SPI_STAT_QUEUED     1u
+#define SPI_STAT_ACTIVE     2u
+#define SPI_STAT_DONE       3u
+#define SPI_STAT_ERR        4u	//DMA
+#define SPI_STAT_TIMEOUT    5u	//SPI_Transfer()ʱ,ȡ
+
+typedef struct spi_xfer SPI_XFER;
+
+typedef void (*SPI_CALLBACK) (SPI_XFER * pxfer);
+
+struct spi_xfer {
+	INT8U const *ptx;	//,NULL:0xFF
+	INT8U *prx;		//,NULL:
+	INT16U len;		//ֽ,SPI_OPT_STREAMʱΪ뻺֮
+	INT8U opt;		//SPI_OPT_xxx
+	volatile INT8U stat;	//SPI_STAT_xxx
+	volatile INT8U half;	//SPI_OPT_STREAM:ɵİ,01
+	GPIO_TypeDef *cs_port;	//Ƭѡ,NULL:Ƭѡ
+	INT16U cs_pin;
+	OS_EVENT *sem;		//ʱͷ,ΪNULL
+	SPI_CALLBACK callback;	//ʱже,ΪNULL
+	void *parg;
+	SPI_XFER *next;
+};
+
+typedef struct spi_bus {
+	SPI_TypeDef *spi;
+	DMA_TypeDef *dma;
+	DMA_Channel_TypeDef *rx_ch;
+	DMA_Channel_TypeDef *tx_ch;
+	INT8U rx_shift;		//ͨDMA_ISRеλ,(ͨ-1)*4
+	SPI_XFER *cur;		//ڴ
+	SPI_XFER *head;		//ȴĴ
+	SPI_XFER *tail;
+} SPI_BUS;
+
+extern SPI_BUS SPI_Bus1;
+
+extern void SPI_BusInit(SPI_BUS * pbus, SPI_TypeDef * spi, DMA_TypeDef * dma, DMA_Channel_TypeDef * rx_ch,
+			DMA_Channel_TypeDef * tx_ch, INT8U rx_ch_nbr);
+extern void SPI_Spi1Init(INT16U prescaler);
+extern void SPI_Submit(SPI_BUS * pbus, SPI_XFER * pxfer);
+extern INT8U SPI_Transfer(SPI_BUS * pbus, SPI_XFER * pxfer, INT32U timeout);
+extern void SPI_StreamStop(SPI_BUS * pbus);
+extern void SPI_Isr(SPI_BUS * pbus);
+
+#endif
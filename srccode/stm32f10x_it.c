@@ -4,17 +4,110 @@
 #include "stm32f10x_rcc.h"
 #include "misc.h"
 #include "app_cfg.h"
+#include "device.h"
+#include "spi.h"
+#include "i2c.h"
+#include "acq.h"
+#include "can.h"
 
 void NMI_Handler(void)
 {
 }
 
+#if ACQ_EN > 0
+void DMA1_Channel1_IRQHandler(void)	//ADC1 DMA/ȫ
+{
+	OS_CPU_INT_ENTER();
+	ACQ_Isr();
+	OS_CPU_INT_EXIT();
+}
+#endif
+
+#if SPI_EN > 0
+void DMA1_Channel2_IRQHandler(void)	//SPI1DMA
+{
+	OS_CPU_INT_ENTER();
+	SPI_Isr(&SPI_Bus1);
+	OS_CPU_INT_EXIT();
+}
+#endif
+
+void DMA1_Channel4_IRQHandler(void)	//ڷDMA
+{
+	OS_CPU_INT_ENTER();
+	DEV_ConDmaIsr();
+	OS_CPU_INT_EXIT();
+}
+
+void DMA1_Channel5_IRQHandler(void)	//ڽDMA/ȫ
+{
+	OS_CPU_INT_ENTER();
+	DMA_ClearITPendingBit(DMA1_IT_GL5);
+	DEV_RxIsr();
+	OS_CPU_INT_EXIT();
+}
+
+#if I2C_EN > 0
+void DMA1_Channel7_IRQHandler(void)	//I2C1DMA
+{
+	OS_CPU_INT_ENTER();
+	I2C_DmaIsr(&I2C_Bus1);
+	OS_CPU_INT_EXIT();
+}
+
+void I2C1_EV_IRQHandler(void)
+{
+	OS_CPU_INT_ENTER();
+	I2C_EvIsr(&I2C_Bus1);
+	OS_CPU_INT_EXIT();
+}
+
+void I2C1_ER_IRQHandler(void)
+{
+	OS_CPU_INT_ENTER();
+	I2C_ErIsr(&I2C_Bus1);
+	OS_CPU_INT_EXIT();
+}
+#endif
+
+#if CAN_EN > 0
+void USB_HP_CAN1_TX_IRQHandler(void)
+{
+	OS_CPU_INT_ENTER();
+	CAN_TxIsr(&CAN_Bus1);
+	OS_CPU_INT_EXIT();
+}
+
+void USB_LP_CAN1_RX0_IRQHandler(void)
+{
+	OS_CPU_INT_ENTER();
+	CAN_RxIsr(&CAN_Bus1, 0u);
+	OS_CPU_INT_EXIT();
+}
+
+void CAN1_RX1_IRQHandler(void)
+{
+	OS_CPU_INT_ENTER();
+	CAN_RxIsr(&CAN_Bus1, 1u);
+	OS_CPU_INT_EXIT();
+}
+
+void CAN1_SCE_IRQHandler(void)
+{
+	OS_CPU_INT_ENTER();
+	CAN_SceIsr(&CAN_Bus1);
+	OS_CPU_INT_EXIT();
+}
+#endif
+
 void USART1_IRQHandler(void)
 {
-	if (USART_GetITStatus(USART1, USART_IT_RXNE) == SET) {
-		USART_SendData(USART1, USART_ReceiveData(USART1));
-		while (USART_GetFlagStatus(USART1, USART_FLAG_TXE) == RESET);	//жǷ
+	OS_CPU_INT_ENTER();
+	if (USART_GetITStatus(USART1, USART_IT_IDLE) == SET) {
+		(void)USART_ReceiveData(USART1);	//SRDR,IDLE
+		DEV_RxIsr();
 	}
+	OS_CPU_INT_EXIT();
 }
 
 
@@ -30,6 +123,8 @@ void HardFault_Handler(void)
 	}
 }
 
+volatile INT8U MemManage_Prio = OS_PRIO_SELF;	//MemManageȼ,OS_PRIO_SELFʾûз
+
 /**
   * @brief  This function handles Memory Manage exception.
   * @param  None
@@ -37,6 +132,10 @@ void HardFault_Handler(void)
   */
 void MemManage_Handler(void)
 {
+	MemManage_Prio = OSTCBCur->OSTCBPrio;	/* Left for the debugger, the loop below never returns */
+#if (OS_TASK_STK_GUARD_EN > 0u) && (OS_CPU_MPU_EN > 0)
+	OSTaskStkOvfHook(OSTCBCur);	/* The current task has hit its stack guard */
+#endif
 	/* Go to infinite loop when Memory Manage exception occurs */
 	while (1) {
 	}
@@ -100,9 +199,9 @@ void PendSV_Handler(void)
   */
 void SysTick_Handler(void)      //ʱӽжϷӳ
 {
-	OSIntEnter();
+	OS_CPU_INT_ENTER();
 	OSTimeTick();
-	OSIntExit();
+	OS_CPU_INT_EXIT();
 }
 
 /****************************************************************************
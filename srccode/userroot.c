@@ -1,124 +1,129 @@
 #include "userroot.h"
 
-INT8U  err;
-OS_EVENT* Str_Q;
-OS_EVENT* Node1_Semp;
-OS_EVENT* Node2_Semp;
-OS_EVENT* Node3_Semp;
+NODE Node[NODE_NBR];
+AO_DISP Node_Disp;
 
-
-void *MagGrp[N_MESSAGES];
-char *buf1;
-char *buf2;
-char *buf3;
-
-char *msg1="package type: To Node 1";
-char *msg2="package type: To Node 2";
-char *msg3="package type: To Node 3";
+char *msg[NODE_NBR]={"package type: To Node 1", "package type: To Node 2", "package type: To Node 3"};
 char *msg_broadcast="package type: Broadcast!";
 
+INT32U Gateway_Overrun;
 
-static OS_STK Node1_stack[TASKSTACK];
-static OS_STK Node2_stack[TASKSTACK];
-static OS_STK Node3_stack[TASKSTACK];
+
+static OS_STK Node_stack[TASKSTACK];
 static OS_STK Gateway_stack[TASKSTACK];
+static OS_JOB_MSG Node_queue[NODE_Q_SIZE];
+static NODE_EVT Node_evt[NODE_EVT_NBR];
 
 int main(void)
 {
-	DEV_HardwareInit();
-    OSInit();
+    INT8U i;
 
-    Str_Q=OSQCreate(&MagGrp[0], (INT16U)N_MESSAGES);
-    Node1_Semp=OSSemCreate(0);
-    Node2_Semp=OSSemCreate(0);
-    Node3_Semp=OSSemCreate(0);
+    OSInit();
+	DEV_HardwareInit();
+#if LOG_EN > 0
+	LOG_Init(LOG_TASK_PRIO);
+#endif
+
+    AO_Init();
+    AO_PoolInit(&Node_evt[0], NODE_EVT_NBR, sizeof(NODE_EVT));
+    AO_DispCreate(&Node_Disp, NODE_PRIO, &Node_stack[0], TASKSTACK, &Node_queue[0], NODE_Q_SIZE);
+    for (i = 0; i < NODE_NBR; i++)
+    {
+        Node[i].nbr = i + 1;
+        AO_Start(&Node[i].super, &Node_Disp, (AO_HANDLER)Node_Initial);
+    }
 
-	OSTaskCreate(Node1, (void*)NULL, &Node1_stack[TASKSTACK - 1], 3);
-    OSTaskCreate(Node2, (void*)NULL, &Node2_stack[TASKSTACK - 1], 4);
-    OSTaskCreate(Node3, (void*)NULL, &Node3_stack[TASKSTACK - 1], 5);
-	OSTaskCreate(Gateway, (void*)NULL, &Gateway_stack[TASKSTACK - 1], 6);
+	OSTaskCreateExt(Gateway, (void*)NULL, &Gateway_stack[TASKSTACK - 1], GATEWAY_PRIO, GATEWAY_PRIO,
+	                &Gateway_stack[0], TASKSTACK, (void*)NULL, OS_TASK_OPT_STK_CHK | OS_TASK_OPT_STK_CLR);
 
 	OSStart();
 
 	return 0;
 }
 
-void Node1(void* p_arg)
+void Node_Initial(NODE *me, AO_EVT const *e)
 {
-    while(1)
-    {
-        OSSemPend(Node1_Semp, 0, &err);
-        printf("\r\n Node 1 is active");
-        buf1=OSQPend(Str_Q, 0, &err);
-        printf("\r\n Node 1: get msg: %s",buf1);
-        printf("\r\n Node 1: Time is %5d", OSTimeGet());
-        printf("\r\n Node 1: sleeping");
-        OSTimeDly(4000);
-    }
+    AO_Subscribe(&me->super, SIG_BROADCAST);
+    AO_TRAN(&me->super, Node_Active);
 }
 
-void Node2(void* p_arg)
+void Node_Active(NODE *me, AO_EVT const *e)
 {
-    while(1)
+    switch (e->sig)
     {
-        OSSemPend(Node2_Semp, 0, &err);
-        printf("\r\n Node 2 is active");
-        buf2=OSQPend(Str_Q, 0, &err);
-        printf("\r\n Node 2: get msg: %s",buf2);
-        printf("\r\n Node 2: Time is %5d", OSTimeGet());
-        printf("\r\n Node 2: sleeping");
-        OSTimeDly(2000);
+    case SIG_MSG:
+    case SIG_BROADCAST:
+        LOG1("\r\n Node %u is active", me->nbr);
+        LOG2("\r\n Node %u: get msg: %s", me->nbr, ((NODE_EVT const *)e)->text);
+        LOG2("\r\n Node %u: Time is %5d", me->nbr, OSTimeGet());
+        LOG1("\r\n Node %u: done", me->nbr);
+        break;
+    default:
+        break;
     }
 }
 
-void Node3(void* p_arg)
+static void Gateway_Send(AO *me, AO_SIG sig, char *text)
 {
-    while(1)
+    NODE_EVT *e;
+
+    e = (NODE_EVT *)AO_EvtNew(sig, sizeof(NODE_EVT));
+    if (e == (NODE_EVT *)0)
+    {
+        LOG0("\r\n Master: out of events");
+        return;
+    }
+    e->text = text;
+    if (me == (AO *)0)
     {
-        OSSemPend(Node3_Semp, 0, &err);
-        printf("\r\n Node 3 is active");
-        buf3=OSQPend(Str_Q, 0, &err);
-        printf("\r\n Node 3: get msg: %s",buf3);
-        printf("\r\n Node 3: Time is %5d", OSTimeGet());
-        printf("\r\n Node 3: sleeping");
-        OSTimeDly(1000);
+        AO_Publish(&e->super);
+    }
+    else if (AO_Post(me, &e->super) != OS_ERR_NONE)
+    {
+        LOG0("\r\n Master: node queue full");
     }
 }
 
 void Gateway(void* p_arg)
 {
     static INT8U time;
+    INT32U next_wake;
+    INT8U i;
+
+    if (OSTaskPeriodSet(OS_PRIO_SELF, 8000) != OS_ERR_NONE)
+    {
+        LOG0("\r\n Master: not registered as periodic");
+    }
+    next_wake = OSTimeGet();
     while(1)
     {
-        printf("\r\n/*********************************/");
-				printf("\r\n Master is active.");
-        printf("\r\n Master:Wake up! Node 1.");
-        OSSemPost(Node1_Semp);
-        printf("\r\n Master:Wake up! Node 2.");
-        OSSemPost(Node2_Semp);
-        printf("\r\n Master:Wake up! Node 3.");
-        OSSemPost(Node3_Semp);
-
-        printf("\r\n Master is transporting msg...");
+        LOG0("\r\n/*********************************/");
+				LOG0("\r\n Master is active.");
+
+        LOG0("\r\n Master is transporting msg...");
         if(time==0)
         {
-            OSQPost(Str_Q, msg_broadcast);
-            OSQPost(Str_Q, msg_broadcast);
-            OSQPost(Str_Q, msg_broadcast);
+            Gateway_Send((AO *)0, SIG_BROADCAST, msg_broadcast);
             time++;
         }
         else
         {
-            OSQPost(Str_Q, msg1);
-            OSQPost(Str_Q, msg2);
-            OSQPost(Str_Q, msg3);
+            for (i = 0; i < NODE_NBR; i++)
+            {
+                Gateway_Send(&Node[i].super, SIG_MSG, msg[i]);
+            }
             time=0;
         }
 
-        printf("\r\n Master: sleeping");
-				printf("\r\n/*********************************/");
-				printf("\r\n");
-        OSTimeDly(8000);
+        LOG0("\r\n Master: sleeping");
+				LOG0("\r\n/*********************************/");
+				LOG0("\r\n");
+        if (OSTimeDlyUntil(&next_wake, 8000) == OS_ERR_TIME_OVERRUN)
+        {
+            Gateway_Overrun++;
+            LOG1("\r\n Master: missed a period, %u so far", Gateway_Overrun);
+        }
 
     }
 }
+
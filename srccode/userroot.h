@@ -1,15 +1,32 @@
-
 #ifndef __USERROOT_H__
 #define __USERROOT_H__
 
 #include "app_cfg.h"
+#include "log.h"
+#include "ao.h"
+
+#define NODE_NBR        3
+#define NODE_PRIO       3       //all the nodes run in one AO dispatcher
+#define NODE_Q_SIZE     8
+#define NODE_EVT_NBR    8
+#define GATEWAY_PRIO    6
+
+#define SIG_MSG         (AO_SIG_USER + 0)   //message to one node
+#define SIG_BROADCAST   (AO_SIG_USER + 1)   //message to every node
+
+typedef struct {
+    AO_EVT super;
+    char *text;
+} NODE_EVT;
 
-#define N_MESSAGES      128
+typedef struct {
+    AO super;
+    INT8U nbr;
+} NODE;
 
 
-void Node1(void *p_arg);
-void Node2(void *p_arg);
-void Node3(void *p_arg);
+void Node_Initial(NODE *me, AO_EVT const *e);
+void Node_Active(NODE *me, AO_EVT const *e);
 void Gateway(void *p_arg);
 
 #endif
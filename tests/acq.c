@@ -0,0 +1,271 @@
+/*
+ * ADC pipeline (srccode/acq.c): ACQ_Process() against sequences computed by hand (decimation by
+ * averaging, also across blocks, the exponential average from its first output, the threshold with
+ * hysteresis, the sink), and ACQ_Isr() handing out the halves of the DMA buffer: a half still owned by the
+ * processing task is dropped and counted, and a half is given back when the task is done with it.
+ *
+ * The library functions ACQ_Init() calls are stubs; DMA_GetITStatus() answers from DmaIt.
+ */
+
+#include <string.h>
+#include "host.h"
+#include "../srccode/acq.c"
+
+#define  MAIN_PRIO   10u
+#define  ACQ_PRIO    12u		/* Below MainTask: runs only when the test blocks */
+
+static OS_STK MainStk[256];
+static INT32U DmaIt;		/* DMA1_IT_HT1 or DMA1_IT_TC1         */
+static INT16U TimPsc, TimPeriod;
+
+static INT16U Blk[16 * ACQ_CH_NBR];
+static INT16U Out[2u * ACQ_BLK_SCANS];
+static INT8U OutCh[2u * ACQ_BLK_SCANS];
+static INT32U OutN;
+static INT16U ThrVal[8];
+static BOOLEAN ThrAbove[8];
+static INT32U ThrN;
+
+/* Standard peripheral library functions called by the driver */
+void RCC_APB1PeriphClockCmd(uint32_t periph, FunctionalState state)
+{
+}
+
+void RCC_APB2PeriphClockCmd(uint32_t periph, FunctionalState state)
+{
+}
+
+void RCC_AHBPeriphClockCmd(uint32_t periph, FunctionalState state)
+{
+}
+
+void RCC_ADCCLKConfig(uint32_t div)
+{
+}
+
+void GPIO_Init(GPIO_TypeDef * pgpio, GPIO_InitTypeDef * pinit)
+{
+}
+
+void NVIC_Init(NVIC_InitTypeDef * pinit)
+{
+}
+
+void DMA_DeInit(DMA_Channel_TypeDef * pch)
+{
+}
+
+void DMA_Init(DMA_Channel_TypeDef * pch, DMA_InitTypeDef * pinit)
+{
+}
+
+void DMA_ITConfig(DMA_Channel_TypeDef * pch, uint32_t it, FunctionalState state)
+{
+}
+
+void DMA_Cmd(DMA_Channel_TypeDef * pch, FunctionalState state)
+{
+}
+
+ITStatus DMA_GetITStatus(uint32_t it)
+{
+	return ((DmaIt == it) ? SET : RESET);
+}
+
+void DMA_ClearITPendingBit(uint32_t it)
+{
+	DmaIt = 0u;
+}
+
+void ADC_StructInit(ADC_InitTypeDef * pinit)
+{
+}
+
+void ADC_Init(ADC_TypeDef * padc, ADC_InitTypeDef * pinit)
+{
+}
+
+void ADC_RegularChannelConfig(ADC_TypeDef * padc, uint8_t ch, uint8_t rank, uint8_t time)
+{
+}
+
+void ADC_DMACmd(ADC_TypeDef * padc, FunctionalState state)
+{
+}
+
+void ADC_Cmd(ADC_TypeDef * padc, FunctionalState state)
+{
+}
+
+void ADC_ResetCalibration(ADC_TypeDef * padc)
+{
+}
+
+FlagStatus ADC_GetResetCalibrationStatus(ADC_TypeDef * padc)
+{
+	return (RESET);
+}
+
+void ADC_StartCalibration(ADC_TypeDef * padc)
+{
+}
+
+FlagStatus ADC_GetCalibrationStatus(ADC_TypeDef * padc)
+{
+	return (RESET);
+}
+
+void ADC_ExternalTrigConvCmd(ADC_TypeDef * padc, FunctionalState state)
+{
+}
+
+void TIM_TimeBaseStructInit(TIM_TimeBaseInitTypeDef * pinit)
+{
+}
+
+void TIM_TimeBaseInit(TIM_TypeDef * ptim, TIM_TimeBaseInitTypeDef * pinit)
+{
+	TimPsc = pinit->TIM_Prescaler;
+	TimPeriod = pinit->TIM_Period;
+}
+
+void TIM_SelectOutputTrigger(TIM_TypeDef * ptim, uint16_t src)
+{
+}
+
+void TIM_Cmd(TIM_TypeDef * ptim, FunctionalState state)
+{
+}
+
+static void Sink(INT8U ch, INT16U val)
+{
+	OutCh[OutN] = ch;
+	Out[OutN++] = val;
+}
+
+static void Thr(INT8U ch, INT16U val, BOOLEAN above)
+{
+	ThrVal[ThrN] = val;
+	ThrAbove[ThrN++] = above;
+}
+
+/* Raises the DMA interrupt of half 'it' */
+static void Isr(INT32U it)
+{
+	DmaIt = it;
+	OSIntEnter();
+	ACQ_Isr();
+	OSIntExit();
+}
+
+/* Runs 'n' scans of channel 0 through ACQ_Process(), the other channels at 0 */
+static void Feed(INT16U const *pval, INT16U n)
+{
+	INT16U i;
+
+	memset(Blk, 0, sizeof(Blk));
+	for (i = 0u; i < n; i++) {
+		Blk[i * ACQ_CH_NBR] = pval[i];
+	}
+	OutN = 0u;
+	ACQ_Process(Blk, n);
+}
+
+static void MainTask(void *p_arg)
+{
+	static INT16U const dec[] = { 10u, 20u, 30u, 41u, 100u, 100u, 100u, 100u, 7u, 9u };
+	static INT16U const step[] = { 0u, 0u, 100u, 100u, 100u, 100u, 100u };
+	static INT16U const thr[] = { 150u, 200u, 150u, 101u, 100u, 199u, 250u, 300u };
+	INT16U i;
+
+	/* TIM3 update rate: 72MHz / 10000 scans/s, no prescaler needed */
+	CHECK(TimPsc == 0u && TimPeriod == 7199u);
+
+	/* Decimation by 4: the mean of each 4 samples, truncated; the remainder carries to the next block */
+	ACQ_ChCfg(0u, 4u, 0u, 0u, 0u, (ACQ_THR_FNCT) 0, Sink);
+	Feed(dec, 10u);
+	CHECK(OutN == 2u && Out[0] == 25u && Out[1] == 100u && OutCh[0] == 0u);
+	CHECK(ACQ_ChTbl[0].cnt == 2u && ACQ_ChTbl[0].acc == 16u);
+	Feed(&dec[4], 2u);
+	CHECK(OutN == 1u && Out[0] == (7u + 9u + 100u + 100u) / 4u && ACQ_ChTbl[0].out == Out[0]);
+
+	/* ... 0 and 1 do not decimate */
+	ACQ_ChCfg(0u, 0u, 0u, 0u, 0u, (ACQ_THR_FNCT) 0, Sink);
+	Feed(dec, 3u);
+	CHECK(OutN == 3u && Out[2] == 30u && ACQ_ChTbl[0].decim == 1u);
+
+	/* Exponential average 1/4: the first output is taken as is, even 0, then avg += val - avg/4 */
+	ACQ_ChCfg(0u, 1u, 2u, 0u, 0u, (ACQ_THR_FNCT) 0, Sink);
+	Feed(step, 7u);
+	CHECK(OutN == 7u && Out[0] == 0u && Out[1] == 0u);
+	CHECK(Out[2] == 25u && Out[3] == 43u && Out[4] == 58u && Out[5] == 68u && Out[6] == 76u);
+
+	/* ... after decimation by 2 */
+	ACQ_ChCfg(0u, 2u, 1u, 0u, 0u, (ACQ_THR_FNCT) 0, Sink);
+	Feed(&dec[4], 6u);	/* Means 100, 100, 8 */
+	CHECK(OutN == 3u && Out[0] == 100u && Out[1] == 100u && Out[2] == 54u);
+
+	/* Threshold: above at thr_hi, back below only at thr_lo, once per crossing */
+	ACQ_ChCfg(0u, 1u, 0u, 100u, 200u, Thr, (ACQ_SINK) 0);
+	Feed(thr, 8u);
+	CHECK(OutN == 0u && ThrN == 3u);
+	CHECK(ThrAbove[0] == OS_TRUE && ThrVal[0] == 200u);
+	CHECK(ThrAbove[1] == OS_FALSE && ThrVal[1] == 100u);
+	CHECK(ThrAbove[2] == OS_TRUE && ThrVal[2] == 250u && ACQ_ChTbl[0].above == OS_TRUE);
+
+	/* Channels are interleaved in the block */
+	for (i = 0u; i < ACQ_CH_NBR; i++) {
+		ACQ_ChCfg((INT8U) i, 1u, 0u, 0u, 0u, (ACQ_THR_FNCT) 0, Sink);
+		Blk[i] = (INT16U) (i * 10u);
+		Blk[ACQ_CH_NBR + i] = (INT16U) (i * 10u + 1u);
+	}
+	OutN = 0u;
+	ACQ_Process(Blk, 2u);
+	CHECK(OutN == 2u * ACQ_CH_NBR && OutCh[2] == 1u && Out[2] == 10u && Out[3] == 11u);
+	CHECK(OutCh[15] == 7u && Out[15] == 71u);
+
+	/* Halves handed out in turn, processed by the task, no overrun */
+	for (i = 0u; i < ACQ_CH_NBR; i++) {
+		ACQ_ChCfg((INT8U) i, 1u, 0u, 0u, 0u, (ACQ_THR_FNCT) 0, (i == 0u) ? Sink : (ACQ_SINK) 0);
+	}
+	ACQ_Buf[0] = 1u;
+	ACQ_Buf[ACQ_BLK_SCANS * ACQ_CH_NBR] = 2u;
+	OutN = 0u;
+	Isr(DMA1_IT_HT1);
+	CHECK(ACQ_Busy[0] == OS_TRUE && OutN == 0u);
+	OSTimeDly(1u);
+	CHECK(ACQ_Busy[0] == OS_FALSE && OutN == ACQ_BLK_SCANS && Out[0] == 1u);
+	Isr(DMA1_IT_TC1);
+	OSTimeDly(1u);
+	CHECK(ACQ_Busy[1] == OS_FALSE && OutN == 2u * ACQ_BLK_SCANS && Out[ACQ_BLK_SCANS] == 2u);
+	CHECK(ACQ_OvrCtr == 0u);
+
+	/* The task is late: it has been given half 0 but not run, half 1 waits in the queue, and both come
+	   round again while still owned; dropped and counted, the blocks handed out are processed */
+	OutN = 0u;
+	Isr(DMA1_IT_HT1);
+	Isr(DMA1_IT_TC1);
+	CHECK(ACQ_Busy[0] == OS_TRUE && ACQ_Busy[1] == OS_TRUE && ACQ_OvrCtr == 0u);
+	CHECK(((OS_Q *) ACQ_Q->OSEventPtr)->OSQEntries == 1u);
+	Isr(DMA1_IT_HT1);
+	CHECK(ACQ_OvrCtr == 1u);
+	Isr(DMA1_IT_TC1);
+	CHECK(ACQ_OvrCtr == 2u && OutN == 0u);
+	OSTimeDly(1u);
+	CHECK(OutN == 2u * ACQ_BLK_SCANS && Out[0] == 1u && Out[ACQ_BLK_SCANS] == 2u);
+	CHECK(ACQ_Busy[0] == OS_FALSE && ACQ_Busy[1] == OS_FALSE);
+
+	/* Another DMA interrupt is acknowledged and ignored */
+	Isr(DMA1_IT_GL1);
+	CHECK(DmaIt == 0u && ACQ_OvrCtr == 2u && ACQ_Busy[0] == OS_FALSE);
+	HostDone("acq");
+}
+
+int main(void)
+{
+	OSInit();
+	OSTaskCreate(MainTask, (void *)0, &MainStk[255], MAIN_PRIO);
+	ACQ_Init(ACQ_PRIO, 10000u);
+	OSStart();
+	return (1);
+}
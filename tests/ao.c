@@ -0,0 +1,183 @@
+/*
+ * Active objects on run-to-completion jobs (ao.c, AO_EN): each AO gets AO_SIG_INIT first, events to the
+ * AOs of one dispatcher are handled one at a time in the order posted, an AO posting to an AO of its own
+ * dispatcher is not preempted by it but one of a higher dispatcher is, AO_Publish() reaches every
+ * subscriber, and a post to a full dispatcher queue fails and gives the event back to its pool, also
+ * when only some subscribers of a published event get it.
+ */
+
+#include "host.h"
+#include "../srccode/ao.c"
+
+#define  HI_PRIO      1u
+#define  MAIN_PRIO    2u
+#define  LO_PRIO      8u
+#define  Q_SIZE       4u
+#define  EVT_NBR      6u
+#define  TRACE_MAX   32u
+
+#define  SIG_A       (AO_SIG_USER + 0u)
+#define  SIG_FWD     (AO_SIG_USER + 1u)	/* Forward to B, then to C            */
+#define  SIG_PUB     (AO_SIG_USER + 2u)
+
+typedef struct {
+	AO_EVT super;
+	INT32U val;
+} TEVT;
+
+static OS_STK MainStk[256], HiStk[128], LoStk[128];
+static AO_DISP HiDisp, LoDisp;
+static OS_JOB_MSG HiQ[Q_SIZE], LoQ[Q_SIZE];
+static TEVT EvtPool[EVT_NBR];
+static AO AoA, AoB, AoC;
+static AO_EVT EvtA = { SIG_A, 0u, 0u };
+static AO_EVT EvtFwd = { SIG_FWD, 0u, 0u };
+static INT32U Trace[TRACE_MAX];		/* AO id * 1000 + signal * 100 + value */
+static INT32U TraceNbr;
+
+static void TraceAdd(AO * me, AO_EVT const *e, INT32U val)
+{
+	CHECK(TraceNbr < TRACE_MAX);
+	Trace[TraceNbr++] = me->id * 1000u + e->sig * 100u + val;
+}
+
+static BOOLEAN TraceIs(const INT32U * p, INT32U n)
+{
+	INT32U i;
+
+	if (TraceNbr != n) {
+		return (OS_FALSE);
+	}
+	for (i = 0u; i < n; i++) {
+		if (Trace[i] != p[i]) {
+			return (OS_FALSE);
+		}
+	}
+	TraceNbr = 0u;
+	return (OS_TRUE);
+}
+
+static void Active(AO * me, AO_EVT const *e)
+{
+	TraceAdd(me, e, (e->pool_id != 0u) ? ((TEVT const *)e)->val : 0u);
+	if (e->sig == SIG_FWD) {
+		CHECK(AO_Post(&AoB, &EvtA) == OS_ERR_NONE);	/* Same dispatcher: after this one */
+		CHECK(AO_Post(&AoC, &EvtA) == OS_ERR_NONE);	/* Higher: right away              */
+		TraceAdd(me, e, 99u);
+	}
+}
+
+static void Initial(AO * me, AO_EVT const *e)
+{
+	TraceAdd(me, e, 0u);
+	AO_TRAN(me, Active);
+}
+
+static INT32U EvtFree(void)		/* Number of free blocks in the pool  */
+{
+	AO_EVT *e[EVT_NBR + 1u];
+	INT32U n;
+	INT32U i;
+
+	for (n = 0u; n <= EVT_NBR; n++) {
+		e[n] = AO_EvtNew(SIG_A, sizeof(TEVT));
+		if (e[n] == (AO_EVT *) 0) {
+			break;
+		}
+	}
+	for (i = 0u; i < n; i++) {
+		AO_EvtGc(e[i]);
+	}
+	return (n);
+}
+
+static TEVT *EvtNew(AO_SIG sig, INT32U val)
+{
+	TEVT *e;
+
+	e = (TEVT *) AO_EvtNew(sig, sizeof(TEVT));
+	CHECK(e != (TEVT *) 0);
+	e->val = val;
+	return (e);
+}
+
+static void MainTask(void *p_arg)
+{
+	static const INT32U init[] = { 0000u, 1000u };
+	static const INT32U fifo[] = { 101u, 1101u, 102u };
+	static const INT32U rtc[] = { 200u, 2100u, 299u, 1100u };
+	static const INT32U pub[] = { 307u, 1307u, 308u, 1308u };
+	static const INT32U full[] = { 111u, 112u, 113u, 114u };
+	static const INT32U part[] = { 121u, 122u, 123u, 309u };
+	static INT32U pool2[4][4];
+	INT32U i;
+
+	(void)p_arg;
+	AO_Init();
+	CHECK(AO_PoolInit(&EvtPool[0], EVT_NBR, sizeof(TEVT)) == OS_ERR_NONE);
+	CHECK(AO_PoolInit(&pool2[0][0], 4u, sizeof(TEVT)) == OS_ERR_MEM_INVALID_SIZE);	/* Not larger */
+	CHECK(AO_DispCreate(&HiDisp, HI_PRIO, &HiStk[0], 128u, &HiQ[0], Q_SIZE) == OS_ERR_NONE);
+	CHECK(AO_DispCreate(&LoDisp, LO_PRIO, &LoStk[0], 128u, &LoQ[0], Q_SIZE) == OS_ERR_NONE);
+
+	/* AO_SIG_INIT first, the higher dispatcher's AO right away */
+	CHECK(AO_Start(&AoA, &LoDisp, Initial) == OS_ERR_NONE);
+	CHECK(AO_Start(&AoB, &LoDisp, Initial) == OS_ERR_NONE);
+	CHECK(TraceNbr == 0u);
+	CHECK(AO_Start(&AoC, &HiDisp, Initial) == OS_ERR_NONE);
+	CHECK(TraceNbr == 1u && Trace[0] == 2000u);
+	TraceNbr = 0u;
+	OSTimeDly(1u);
+	CHECK(TraceIs(init, 2u));
+
+	/* One dispatcher: in the order posted, across AOs */
+	CHECK(AO_Post(&AoA, &EvtNew(SIG_A, 1u)->super) == OS_ERR_NONE);
+	CHECK(AO_Post(&AoB, &EvtNew(SIG_A, 1u)->super) == OS_ERR_NONE);
+	CHECK(AO_Post(&AoA, &EvtNew(SIG_A, 2u)->super) == OS_ERR_NONE);
+	CHECK(TraceNbr == 0u && EvtFree() == EVT_NBR - 3u);
+	OSTimeDly(1u);
+	CHECK(TraceIs(fifo, 3u) && EvtFree() == EVT_NBR);
+
+	/* Run to completion: B waits for A to return, C (higher) does not */
+	CHECK(AO_Post(&AoA, &EvtFwd) == OS_ERR_NONE);
+	OSTimeDly(1u);
+	CHECK(TraceIs(rtc, 4u));
+
+	/* Publish: every subscriber, the event is freed after the last one */
+	AO_Subscribe(&AoA, SIG_PUB);
+	AO_Subscribe(&AoB, SIG_PUB);
+	AO_Publish(&EvtNew(SIG_PUB, 7u)->super);
+	AO_Publish(&EvtNew(SIG_PUB, 8u)->super);
+	CHECK(EvtFree() == EVT_NBR - 2u);
+	OSTimeDly(1u);
+	CHECK(TraceIs(pub, 4u) && EvtFree() == EVT_NBR);
+	AO_Unsubscribe(&AoB, SIG_PUB);
+
+	/* Full queue: the post fails and the event goes back to the pool */
+	for (i = 1u; i <= Q_SIZE; i++) {
+		CHECK(AO_Post(&AoA, &EvtNew(SIG_A, 10u + i)->super) == OS_ERR_NONE);
+	}
+	CHECK(AO_Post(&AoB, &EvtNew(SIG_A, 15u)->super) == OS_ERR_Q_FULL);
+	CHECK(AO_Post(&AoA, &EvtA) == OS_ERR_Q_FULL);	/* Static event: nothing to free */
+	CHECK(EvtFree() == EVT_NBR - Q_SIZE);
+	OSTimeDly(1u);
+	CHECK(TraceIs(full, 4u) && EvtFree() == EVT_NBR);
+
+	/* Published to a full queue: B misses it, A still gets it, freed once */
+	AO_Subscribe(&AoB, SIG_PUB);
+	for (i = 1u; i < Q_SIZE; i++) {
+		CHECK(AO_Post(&AoA, &EvtNew(SIG_A, 20u + i)->super) == OS_ERR_NONE);
+	}
+	AO_Publish(&EvtNew(SIG_PUB, 9u)->super);
+	CHECK(LoDisp.OSJobLvlEntries == Q_SIZE && EvtFree() == EVT_NBR - Q_SIZE);
+	OSTimeDly(1u);
+	CHECK(TraceIs(part, 4u) && EvtFree() == EVT_NBR);
+	HostDone("ao");
+}
+
+int main(void)
+{
+	OSInit();
+	OSTaskCreate(MainTask, (void *)0, &MainStk[255], MAIN_PRIO);
+	OSStart();
+	return (1);
+}
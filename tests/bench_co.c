@@ -0,0 +1,153 @@
+/*
+ * Coroutines (OS_CO_EN) against tasks: activities per KB of RAM, and the cost of waking one activity by a
+ * semaphore post (post, switch, run, wait again, switch back) as the number of activities grows.  The
+ * scheduler walks its list to hand an event over and to rebuild its pend list, so a coroutine wake grows
+ * with the number of coroutines, while a task wake doesn't grow with the number of tasks.  Times are host
+ * nanoseconds (OS_CPU_TS_GET()).
+ */
+
+#include "host.h"
+
+#define  MAIN_PRIO   60u
+#define  SCHED_PRIO   1u		/* Schedulers 1..4, above the tasks   */
+#define  TASK_PRIO    5u		/* Tasks 5..52                        */
+#define  N_SCHED      4u
+#define  N_TASKS     48u
+#define  N_WAKES   1000u
+#define  N_RUNS      20u
+#define  TASK_STK   128u		/* Smallest task stack of the app     */
+
+typedef struct bench_co {
+	OS_CO Co;
+	OS_EVENT *Sem;
+	INT32U Ctr;
+} BENCH_CO;
+
+static const INT16U CoNbrTbl[N_SCHED] = { 1u, 10u, 100u, 1000u };
+static const INT8U TaskNbrTbl[4] = { 1u, 8u, 32u, N_TASKS };
+
+static OS_STK MainStk[256], SchedStk[N_SCHED][256], TaskStk[N_TASKS][TASK_STK];
+static OS_CO_SCHED SchedTbl[N_SCHED];
+static BENCH_CO CoTbl[1u + 10u + 100u + 1000u];
+static OS_EVENT *CoSem[N_SCHED], *TaskSem[N_TASKS];
+static INT32U TaskCtr[N_TASKS];
+static INT8U TaskIx[N_TASKS];
+
+static void CoWaiter(OS_CO * pco)
+{
+	BENCH_CO *pb = (BENCH_CO *) pco;
+
+	OS_CO_BEGIN(pco);
+	for (;;) {
+		OS_CO_PEND(pco, pb->Sem, 0u);
+		pb->Ctr++;
+	}
+	OS_CO_END(pco);
+}
+
+static void CoSleeper(OS_CO * pco)
+{
+	OS_CO_BEGIN(pco);
+	for (;;) {
+		OS_CO_DLY(pco, OS_CO_DLY_MAX);
+	}
+	OS_CO_END(pco);
+}
+
+static void Task(void *p_arg)
+{
+	INT8U ix;
+	INT8U err;
+
+	ix = *(INT8U *) p_arg;
+	for (;;) {
+		OSSemPend(TaskSem[ix], 0u, &err);
+		TaskCtr[ix]++;
+	}
+}
+
+static void Wake(const char *name, INT32U nbr, OS_EVENT * psem, INT32U * pctr)
+{
+	INT32U best;
+	INT32U crit;
+	INT32U ctr;
+	INT32U ts;
+	INT32U i;
+	INT8U run;
+
+	best = 0xFFFFFFFFuL;
+	crit = 0u;
+	for (run = 0u; run < N_RUNS; run++) {
+		ctr = *pctr;
+		crit = HostCritCtr;
+		ts = OS_CPU_TS_GET();
+		for (i = 0u; i < N_WAKES; i++) {
+			OSSemPost(psem);
+		}
+		ts = OS_CPU_TS_GET() - ts;
+		crit = HostCritCtr - crit;
+		CHECK(*pctr - ctr == N_WAKES);	/* Each post ran the activity once    */
+		if (ts < best) {
+			best = ts;
+		}
+	}
+	printf("bench_co: wake one of %4lu %-11s %5.1f critical sections, %7.1f per wake\n",
+	       (unsigned long)nbr, name, (double)crit / N_WAKES, (double)best / N_WAKES);
+}
+
+static void MainTask(void *p_arg)
+{
+	BENCH_CO *ptbl;
+	INT32U co_m3;
+	INT32U task_m3;
+	INT16U i;
+	INT8U k;
+	INT8U n;
+
+	(void)p_arg;
+
+	/* RAM per activity: an OS_CO holds three pointers (4 bytes each on a Cortex-M3), a task a TCB and a stack */
+	co_m3 = sizeof(OS_CO) - 3u * (sizeof(void *) - 4u);
+	task_m3 = TASK_STK * sizeof(OS_STK);
+	CHECK(co_m3 == 20u);
+	printf("bench_co: OS_CO %lu bytes (%lu on the host), %lu coroutines per KB\n",
+	       (unsigned long)co_m3, (unsigned long)sizeof(OS_CO), 1024uL / co_m3);
+	printf("bench_co: task %lu bytes of stack + OS_TCB (%lu bytes on the host), under %lu tasks per KB\n",
+	       (unsigned long)task_m3, (unsigned long)sizeof(OS_TCB), 1024uL / task_m3);
+
+	/* One waiter at the tail of each list, behind the sleepers */
+	ptbl = &CoTbl[0];
+	for (k = 0u; k < N_SCHED; k++) {
+		CoSem[k] = OSSemCreate(0u);
+		CHECK(OSCoSchedCreate(&SchedTbl[k], SCHED_PRIO + k, &SchedStk[k][0], 256u, ptbl, CoNbrTbl[k],
+				      sizeof(BENCH_CO)) == OS_ERR_NONE);
+		ptbl[0].Sem = CoSem[k];
+		CHECK(OSCoCreate(&SchedTbl[k], &ptbl[0].Co, CoWaiter) == OS_ERR_NONE);
+		for (i = 1u; i < CoNbrTbl[k]; i++) {
+			CHECK(OSCoCreate(&SchedTbl[k], &ptbl[i].Co, CoSleeper) == OS_ERR_NONE);
+		}
+		CHECK(ptbl[0].Co.OSCoStat == OS_CO_STAT_PEND);
+		Wake("coroutines:", CoNbrTbl[k], CoSem[k], &ptbl[0].Ctr);
+		ptbl += CoNbrTbl[k];
+	}
+
+	n = 0u;
+	for (k = 0u; k < 4u; k++) {
+		while (n < TaskNbrTbl[k]) {
+			TaskIx[n] = n;
+			TaskSem[n] = OSSemCreate(0u);
+			OSTaskCreate(Task, (void *)&TaskIx[n], &TaskStk[n][TASK_STK - 1u], TASK_PRIO + n);
+			n++;
+		}
+		Wake("tasks:", n, TaskSem[n - 1u], &TaskCtr[n - 1u]);
+	}
+	HostDone("bench_co");
+}
+
+int main(void)
+{
+	OSInit();
+	OSTaskCreate(MainTask, (void *)0, &MainStk[255], MAIN_PRIO);
+	OSStart();
+	return (1);
+}
@@ -0,0 +1,10 @@
+#undef  OS_CO_EN
+#define OS_CO_EN                  1u
+#undef  OS_EVENT_MULTI_EN
+#define OS_EVENT_MULTI_EN         1u
+#undef  OS_TASK_STAT_EN
+#define OS_TASK_STAT_EN           0u
+#undef  OS_MAX_TASKS
+#define OS_MAX_TASKS             60u
+#undef  OS_MAX_EVENTS
+#define OS_MAX_EVENTS            64u
@@ -0,0 +1,135 @@
+/*
+ * Fixed-point DSP (srccode/dsp.c): OS_CPU_TS_GET() counts (host nanoseconds) per output sample of the FIRs,
+ * the decimating FIR, the biquad cascades and the moving average over blocks of N_BLK samples, and per
+ * transform of the FFT, best of N_RUNS.  Nothing here is measured on the Cortex-M3.
+ */
+
+#include <math.h>
+#include "host.h"
+#include "../srccode/dsp.c"
+
+#define  MAIN_PRIO   10u
+#define  N_BLK      256u
+#define  N_RUNS    2000u
+#define  N_TAPS      32u
+
+static OS_STK MainStk[256];
+
+static Q15 In15[N_BLK], Out15[N_BLK];
+static Q31 In31[N_BLK], Out31[N_BLK];
+static Q15 Coef15[N_TAPS], State15[2u * N_TAPS];
+static Q31 Coef31[N_TAPS], State31[2u * N_TAPS];
+static Q15 Fft[2u * 1024u], Twiddle[1024u];
+
+/* 4th-order Butterworth low pass as two sections, as in tests/dsp.c */
+static double const Bq[10] = {
+	0.0048243433, 0.0096486866, 0.0048243433, -1.0485995764, 0.2961403576,
+	1.0, 2.0, 1.0, -1.3209134308, 0.6327387929
+};
+static Q15 Bq15[10];
+static Q31 Bq31[10];
+
+static DSP_FIR_Q15 Fir15;
+static DSP_FIR_Q31 Fir31;
+static DSP_FIR_DECIM_Q15 Dec;
+static DSP_BIQUAD_Q15 Bqd15;
+static DSP_BIQUAD_Q31 Bqd31;
+static DSP_MAVG_Q15 Avg;
+static DSP_FFT_Q15 Fft15;
+
+/* Best of N_RUNS calls of kernel 'how' over one block, divided by 'per' */
+static void Bench(const char *name, INT8U how, INT32U per)
+{
+	INT32U best;
+	INT32U ts;
+	INT32U run;
+
+	best = 0xFFFFFFFFuL;
+	for (run = 0u; run < N_RUNS; run++) {
+		ts = OS_CPU_TS_GET();
+		switch (how) {
+		case 0u:
+			DSP_FirQ15(&Fir15, In15, Out15, N_BLK);
+			break;
+		case 1u:
+			DSP_FirQ31(&Fir31, In31, Out31, N_BLK);
+			break;
+		case 2u:
+			(void)DSP_FirDecimQ15(&Dec, In15, Out15, N_BLK);
+			break;
+		case 3u:
+			DSP_BiquadQ15(&Bqd15, In15, Out15, N_BLK);
+			break;
+		case 4u:
+			DSP_BiquadQ31(&Bqd31, In31, Out31, N_BLK);
+			break;
+		case 5u:
+			DSP_MavgQ15(&Avg, In15, Out15, N_BLK);
+			break;
+		default:
+			DSP_FftQ15(&Fft15, Fft);
+			break;
+		}
+		ts = OS_CPU_TS_GET() - ts;
+		if (ts < best) {
+			best = ts;
+		}
+	}
+	printf("bench_dsp: %-34s %8.2f\n", name, (double)best / per);
+}
+
+static void MainTask(void *p_arg)
+{
+	INT16U i;
+
+	(void)p_arg;
+	for (i = 0u; i < N_BLK; i++) {
+		In15[i] = DSP_Q15(0.5 * sin(6.283185307179586 * i / 40.0));
+		In31[i] = (Q31) In15[i] << 16;
+	}
+	for (i = 0u; i < N_TAPS; i++) {
+		Coef15[i] = DSP_Q15(0.9 / N_TAPS);
+		Coef31[i] = DSP_Q31(0.9 / N_TAPS);
+	}
+	for (i = 0u; i < 10u; i++) {
+		Bq15[i] = DSP_Q15(((i % 5u) < 3u ? Bq[i] : -Bq[i]) / 2.0);	/* shift 1 */
+		Bq31[i] = DSP_Q31(((i % 5u) < 3u ? Bq[i] : -Bq[i]) / 2.0);
+	}
+	DSP_FirQ31Init(&Fir31, Coef31, N_TAPS, State31);
+	DSP_BiquadQ31Init(&Bqd31, Bq31, 2u, 1u, State31);
+	DSP_MavgQ15Init(&Avg, 16u, State15);
+
+	/* A DC block through the moving average settles on its input */
+	for (i = 0u; i < N_BLK; i++) {
+		Out15[i] = 8192;
+	}
+	DSP_MavgQ15(&Avg, Out15, Out15, N_BLK);
+	CHECK(Out15[N_BLK - 1u] == 8192);
+
+	printf("bench_dsp: per output sample, block of %u\n", N_BLK);
+	DSP_FirQ15Init(&Fir15, Coef15, N_TAPS, State15);
+	Bench("FIR Q15, 32 taps:", 0u, N_BLK);
+	Bench("FIR Q31, 32 taps:", 1u, N_BLK);
+	DSP_FirDecimQ15Init(&Dec, Coef15, N_TAPS, 4u, State15);
+	Bench("decimating FIR Q15, 32 taps, m=4:", 2u, N_BLK / 4u);
+	DSP_BiquadQ15Init(&Bqd15, Bq15, 2u, 1u, State15);
+	Bench("biquad Q15, 2 sections:", 3u, N_BLK);
+	Bench("biquad Q31, 2 sections:", 4u, N_BLK);
+	DSP_MavgQ15Init(&Avg, 16u, State15);
+	Bench("moving average Q15, 16:", 5u, N_BLK);
+
+	printf("bench_dsp: per transform (FFT scales by 1/2 per stage, so repeated runs stay in range)\n");
+	CHECK(DSP_FftQ15Init(&Fft15, 256u, Twiddle) == OS_TRUE);
+	Bench("FFT Q15, 256 points:", 6u, 1u);
+	CHECK(DSP_FftQ15Init(&Fft15, 1024u, Twiddle) == OS_TRUE);
+	Bench("FFT Q15, 1024 points:", 6u, 1u);
+	HostDone("bench_dsp");
+}
+
+int main(void)
+{
+	OSInit();
+	OSTaskCreate(MainTask, (void *)0, &MainStk[255], MAIN_PRIO);
+	OSStart();
+	return (1);
+}
@@ -0,0 +1,97 @@
+/*
+ * FMT_Format() against the host's snprintf(): OS_CPU_TS_GET() counts (host nanoseconds) per call for a
+ * few conversions.  %.2q is compared with the "%d.%02d" snprintf() needs for the same text.
+ */
+
+#include <string.h>
+#include "host.h"
+#include "../srccode/fmt.c"
+
+#define  MAIN_PRIO   10u
+#define  N_CALLS   1000u
+#define  N_RUNS     500u
+
+static OS_STK MainStk[256];
+static char Buf[FMT_LINE_MAX];
+static volatile INT32S Val = -123456;	/* Not folded by the compiler        */
+
+INT16U DEV_WriteAll(INT8U const *pbuf, INT16U len)
+{
+	return (len);
+}
+
+static void Bench(const char *name, INT8U how)
+{
+	INT32U best[2];
+	INT32U ts;
+	INT32U run;
+	INT32U i;
+	INT8U lib;
+
+	for (lib = 0u; lib < 2u; lib++) {
+		best[lib] = 0xFFFFFFFFuL;
+		for (run = 0u; run < N_RUNS; run++) {
+			ts = OS_CPU_TS_GET();
+			for (i = 0u; i < N_CALLS; i++) {
+				switch (how + (lib == 0u ? 0u : 10u)) {
+				case 0u:
+					(void)FMT_Format(Buf, sizeof(Buf), "%d", Val);
+					break;
+				case 10u:
+					(void)snprintf(Buf, sizeof(Buf), "%d", (int)Val);
+					break;
+				case 1u:
+					(void)FMT_Format(Buf, sizeof(Buf), "%08X", Val);
+					break;
+				case 11u:
+					(void)snprintf(Buf, sizeof(Buf), "%08X", (unsigned)Val);
+					break;
+				case 2u:
+					(void)FMT_Format(Buf, sizeof(Buf), "[%-12s]", "abc");
+					break;
+				case 12u:
+					(void)snprintf(Buf, sizeof(Buf), "[%-12s]", "abc");
+					break;
+				case 3u:
+					(void)FMT_Format(Buf, sizeof(Buf), "%.2q", Val);
+					break;
+				case 13u:
+					(void)snprintf(Buf, sizeof(Buf), "-%d.%02d", (int)(-Val / 100), (int)(-Val % 100));
+					break;
+				case 4u:
+					(void)FMT_Format(Buf, sizeof(Buf), "\r\n Node %d: Time is %5d, %s", 1, Val, "ok");
+					break;
+				default:
+					(void)snprintf(Buf, sizeof(Buf), "\r\n Node %d: Time is %5d, %s", 1, (int)Val, "ok");
+					break;
+				}
+			}
+			ts = OS_CPU_TS_GET() - ts;
+			if (ts < best[lib]) {
+				best[lib] = ts;
+			}
+		}
+	}
+	printf("bench_fmt: %-12s FMT_Format() %6.1f, snprintf() %6.1f per call\n",
+	       name, (double)best[0] / N_CALLS, (double)best[1] / N_CALLS);
+}
+
+static void MainTask(void *p_arg)
+{
+	(void)p_arg;
+	CHECK(FMT_Format(Buf, sizeof(Buf), "%.2q", Val) == 8u && strcmp(Buf, "-1234.56") == 0);
+	Bench("%d", 0u);
+	Bench("%08X", 1u);
+	Bench("[%-12s]", 2u);
+	Bench("%.2q", 3u);
+	Bench("line", 4u);
+	HostDone("bench_fmt");
+}
+
+int main(void)
+{
+	OSInit();
+	OSTaskCreate(MainTask, (void *)0, &MainStk[255], MAIN_PRIO);
+	OSStart();
+	return (1);
+}
@@ -0,0 +1,112 @@
+/*
+ * OS_CPU_INT_ENTER()/OS_CPU_INT_EXIT() against OSIntEnter()/OSIntExit(): critical sections entered and
+ * OS_CPU_TS_GET() counts (host nanoseconds) per ISR, and the switch to a task readied by the ISR.
+ */
+
+#include "host.h"
+
+#define  HIGH_PRIO    4u
+#define  MAIN_PRIO   10u
+#define  N_CALLS 1000000uL
+#define  N_RUNS       5u
+
+static OS_STK MainStk[128], HighStk[128];
+static OS_EVENT *GoHigh;
+static INT32U HighCtr;
+
+static void HighTask(void *p_arg)
+{
+	INT8U err;
+
+	(void)p_arg;
+	for (;;) {
+		OSSemPend(GoHigh, 0u, &err);
+		HighCtr++;
+	}
+}
+
+static void IsrCall(void)
+{
+	OSIntEnter();
+	OSIntExit();
+}
+
+static void IsrMacro(void)
+{
+	OS_CPU_INT_ENTER();
+	OS_CPU_INT_EXIT();
+}
+
+static void IsrTickCall(void)
+{
+	OSIntEnter();
+	OSTimeTick();
+	OSIntExit();
+}
+
+static void IsrTickMacro(void)
+{
+	OS_CPU_INT_ENTER();
+	OSTimeTick();
+	OS_CPU_INT_EXIT();
+}
+
+static void Bench(const char *name, void (*fnct)(void))
+{
+	INT32U best;
+	INT32U crit;
+	INT32U ts;
+	INT32U i;
+	INT8U run;
+
+	best = 0xFFFFFFFFuL;
+	crit = HostCritCtr;
+	fnct();
+	crit = HostCritCtr - crit;
+	for (run = 0u; run < N_RUNS; run++) {
+		ts = OS_CPU_TS_GET();
+		for (i = 0u; i < N_CALLS; i++) {
+			fnct();
+		}
+		ts = OS_CPU_TS_GET() - ts;
+		if (ts < best) {
+			best = ts;
+		}
+	}
+	printf("bench_isr: %-34s %lu critical sections, %6.1f per ISR\n", name, (unsigned long)crit,
+	       (double)best / N_CALLS);
+}
+
+static void MainTask(void *p_arg)
+{
+	INT32U sw;
+
+	(void)p_arg;
+	GoHigh = OSSemCreate(0u);
+	OSTaskCreate(HighTask, (void *)0, &HighStk[127], HIGH_PRIO);
+
+	/* A task readied by the ISR runs on the outermost exit only */
+	sw = HostSwCtr;
+	OS_CPU_INT_ENTER();
+	OS_CPU_INT_ENTER();
+	CHECK(OSIntNesting == 2u);
+	OSSemPost(GoHigh);
+	OS_CPU_INT_EXIT();
+	CHECK(OSIntNesting == 1u && HighCtr == 0u);
+	OS_CPU_INT_EXIT();
+	CHECK(OSIntNesting == 0u && HighCtr == 1u && HostSwCtr == sw + 2u);
+
+	Bench("OSIntEnter()/OSIntExit(), empty", IsrCall);
+	Bench("OS_CPU_INT_ENTER()/EXIT(), empty", IsrMacro);
+	Bench("OSIntEnter()/OSIntExit(), tick", IsrTickCall);
+	Bench("OS_CPU_INT_ENTER()/EXIT(), tick", IsrTickMacro);
+	HostDone("bench_isr");
+}
+
+int main(void)
+{
+	OSInit();
+	OSTaskCreate(MainTask, (void *)0, &MainStk[127], MAIN_PRIO);
+	OSStart();
+	return (1);
+}
@@ -0,0 +1,139 @@
+/*
+ * Binary log (srccode/log.c) against formatted text: UART bytes for one round of the demo in userroot.c,
+ * and OS_CPU_TS_GET() counts (host nanoseconds) per LOG1() against FMT_Format() and snprintf() of the
+ * same line.  LOG1() reads the timestamp once, so the cost of OS_CPU_TS_GET() (a clock_gettime() call on
+ * the host, a DWT register read on the target) is printed too.
+ */
+
+#include <string.h>
+#include "host.h"
+#include "../srccode/log.c"
+#include "../srccode/fmt.c"
+
+#define  MAIN_PRIO   10u
+#define  N_CALLS     60u		/* 4 words each, fit in the ring      */
+#define  N_RUNS   20000u
+
+typedef struct log_line {
+	char const *fmt;
+	INT8U nargs;
+	char const *str;		/* Argument of %s                     */
+	INT32U val;			/* Argument of %d                     */
+} LOG_LINE;
+
+static OS_STK MainStk[256];
+static char const Msg[] = "package type: To Node 1";
+static LOG_LINE const Round[] = {	/* A Gateway() pass and the Node() passes */
+	{"\r\n/*********************************/", 0u, 0, 0u},
+	{"\r\n Master is active.", 0u, 0, 0u},
+	{"\r\n Master:Wake up! Node 1.", 0u, 0, 0u},
+	{"\r\n Master:Wake up! Node 2.", 0u, 0, 0u},
+	{"\r\n Master:Wake up! Node 3.", 0u, 0, 0u},
+	{"\r\n Master is transporting msg...", 0u, 0, 0u},
+	{"\r\n Master: sleeping", 0u, 0, 0u},
+	{"\r\n/*********************************/", 0u, 0, 0u},
+	{"\r\n", 0u, 0, 0u},
+	{"\r\n Node 1 is active", 0u, 0, 0u},
+	{"\r\n Node 1: get msg: %s", 1u, Msg, 0u},
+	{"\r\n Node 1: Time is %5d", 1u, 0, 16000u},
+	{"\r\n Node 1: sleeping", 0u, 0, 0u},
+	{"\r\n Node 2 is active", 0u, 0, 0u},
+	{"\r\n Node 2: get msg: %s", 1u, Msg, 0u},
+	{"\r\n Node 2: Time is %5d", 1u, 0, 16000u},
+	{"\r\n Node 2: sleeping", 0u, 0, 0u},
+	{"\r\n Node 3 is active", 0u, 0, 0u},
+	{"\r\n Node 3: get msg: %s", 1u, Msg, 0u},
+	{"\r\n Node 3: Time is %5d", 1u, 0, 16000u},
+	{"\r\n Node 3: sleeping", 0u, 0, 0u},
+};
+
+INT16U DEV_Write(INT8U const *pbuf, INT16U len)
+{
+	return (len);
+}
+
+INT16U DEV_WriteAll(INT8U const *pbuf, INT16U len)
+{
+	return (len);
+}
+
+static void Bench(const char *name, INT8U how)
+{
+	static volatile char line[FMT_LINE_MAX];
+	INT32U best;
+	INT32U ts;
+	INT32U run;
+	INT32U i;
+
+	best = 0xFFFFFFFFuL;
+	for (run = 0u; run < N_RUNS; run++) {
+		LOG_Head = 0u;
+		LOG_Tail = 0u;
+		memset((void *)LOG_Buf, 0, sizeof(LOG_Buf));
+		ts = OS_CPU_TS_GET();
+		for (i = 0u; i < N_CALLS; i++) {
+			switch (how) {
+			case 0u:
+				LOG1("\r\n Node 1: Time is %5d", i);
+				break;
+
+			case 1u:
+				(void)FMT_Format((char *)line, sizeof(line), "\r\n Node 1: Time is %5d", i);
+				break;
+
+			case 2u:
+				(void)snprintf((char *)line, sizeof(line), "\r\n Node 1: Time is %5d", (int)i);
+				break;
+
+			default:
+				line[0] = (char)OS_CPU_TS_GET();
+				break;
+			}
+		}
+		ts = OS_CPU_TS_GET() - ts;
+		if (ts < best) {
+			best = ts;
+		}
+	}
+	printf("bench_log: %-16s %6.1f per call\n", name, (double)best / N_CALLS);
+}
+
+static void MainTask(void *p_arg)
+{
+	char line[FMT_LINE_MAX];
+	INT32U text;
+	INT32U bin;
+	INT8U i;
+
+	(void)p_arg;
+
+	/* UART bytes: the text of each line against its record (3 + nargs words) */
+	text = 0u;
+	bin = 0u;
+	for (i = 0u; i < sizeof(Round) / sizeof(Round[0]); i++) {
+		if (Round[i].str != (char const *)0) {
+			text += FMT_Format(line, sizeof(line), Round[i].fmt, Round[i].str);
+		} else {
+			text += FMT_Format(line, sizeof(line), Round[i].fmt, Round[i].val);
+		}
+		bin += 4u * (3u + Round[i].nargs);
+	}
+	CHECK(bin == 4u * (3u * 21u + 6u));
+	printf("bench_log: one round of the demo, %lu bytes of text, %lu bytes of records (%.1fx less)\n",
+	       (unsigned long)text, (unsigned long)bin, (double)text / bin);
+
+	Bench("LOG1():", 0u);
+	CHECK(LOG_DropCtr == 0u && LOG_Head == N_CALLS * 4u);
+	Bench("FMT_Format():", 1u);
+	Bench("snprintf():", 2u);
+	Bench("OS_CPU_TS_GET():", 3u);
+	HostDone("bench_log");
+}
+
+int main(void)
+{
+	OSInit();
+	OSTaskCreate(MainTask, (void *)0, &MainStk[255], MAIN_PRIO);
+	OSStart();
+	return (1);
+}
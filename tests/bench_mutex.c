@@ -0,0 +1,95 @@
+/*
+ * OSMutexPend()/OSMutexPost() with and without the LDREX/STREX fast path (OS_MUTEX_FAST_EN, the "-lock"
+ * variant turns it off): priority inheritance and hand-over through the slow path, then critical
+ * sections entered and OS_CPU_TS_GET() counts (host nanoseconds) per uncontended Pend/Post pair.
+ */
+
+#include "host.h"
+
+#define  PIP          3u
+#define  HIGH_PRIO    5u
+#define  MAIN_PRIO   10u
+#define  N_PAIRS 1000000uL
+#define  N_RUNS       5u
+
+static OS_STK MainStk[128], HighStk[128];
+static OS_EVENT *Mtx, *GoHigh;
+static INT32U HighCtr;
+static INT8U HighErr;
+
+static void HighTask(void *p_arg)
+{
+	INT8U err;
+
+	(void)p_arg;
+	for (;;) {
+		OSSemPend(GoHigh, 0u, &err);
+		OSMutexPend(Mtx, 0u, &HighErr);
+		HighCtr++;
+		OSMutexPost(Mtx);
+	}
+}
+
+static void MainTask(void *p_arg)
+{
+	OS_EVENT *mtx_low;
+	INT32U best;
+	INT32U crit;
+	INT32U ts;
+	INT32U i;
+	INT8U run;
+	INT8U err;
+
+	(void)p_arg;
+	Mtx = OSMutexCreate(PIP, &err);
+	GoHigh = OSSemCreate(0u);
+	OSTaskCreate(HighTask, (void *)0, &HighStk[127], HIGH_PRIO);
+
+	/* Uncontended claim, then a waiter raises the owner to the PIP and is handed the mutex */
+	OSMutexPend(Mtx, 0u, &err);
+	CHECK(err == OS_ERR_NONE && Mtx->OSEventPtr == (void *)OSTCBCur);
+	CHECK((Mtx->OSEventCnt & 0x00FFu) == MAIN_PRIO);
+	OSSemPost(GoHigh);
+	CHECK(HighCtr == 0u && OSTCBCur->OSTCBPrio == PIP);
+	OSMutexPost(Mtx);
+	CHECK(HighCtr == 1u && HighErr == OS_ERR_NONE && OSTCBCur->OSTCBPrio == MAIN_PRIO);
+	CHECK(Mtx->OSEventPtr == (void *)0);
+	CHECK((Mtx->OSEventCnt & 0x00FFu) == 0x00FFu);	/* Available          */
+	CHECK(OSMutexPost(Mtx) == OS_ERR_NOT_MUTEX_OWNER);
+
+	/* A PIP below the caller's priority is reported on either path */
+	mtx_low = OSMutexCreate(MAIN_PRIO + 2u, &err);
+	OSMutexPend(mtx_low, 0u, &err);
+	CHECK(err == OS_ERR_PIP_LOWER);
+	CHECK(OSMutexPost(mtx_low) == OS_ERR_NONE);
+	CHECK(mtx_low->OSEventPtr == (void *)0);
+
+	/* Uncontended Pend/Post pairs */
+	best = 0xFFFFFFFFuL;
+	crit = 0u;
+	for (run = 0u; run < N_RUNS; run++) {
+		crit = HostCritCtr;
+		ts = OS_CPU_TS_GET();
+		for (i = 0u; i < N_PAIRS; i++) {
+			OSMutexPend(Mtx, 0u, &err);
+			OSMutexPost(Mtx);
+		}
+		ts = OS_CPU_TS_GET() - ts;
+		crit = HostCritCtr - crit;
+		if (ts < best) {
+			best = ts;
+		}
+	}
+	CHECK(Mtx->OSEventPtr == (void *)0);
+	printf("bench_mutex: OS_MUTEX_FAST_EN %u, Pend/Post pair: %4.2f critical sections, %5.1f per pair\n",
+	       (unsigned)OS_MUTEX_FAST_EN, (double)crit / N_PAIRS, (double)best / N_PAIRS);
+	HostDone("bench_mutex");
+}
+
+int main(void)
+{
+	OSInit();
+	OSTaskCreate(MainTask, (void *)0, &MainStk[127], MAIN_PRIO);
+	OSStart();
+	return (1);
+}
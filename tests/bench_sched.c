@@ -0,0 +1,108 @@
+/*
+ * Cost of OSIntExit() and OS_Sched() when the ready list did not change, with the OSSchedReq skip and
+ * with the search forced as before it (OSSchedReq set on every call).  Times are OS_CPU_TS_GET() counts,
+ * i.e. host nanoseconds, per call.
+ */
+
+#include "host.h"
+
+#define  MAIN_PRIO    4u
+#define  N_TASKS      8u
+#define  N_CALLS 1000000uL
+#define  N_RUNS       5u
+
+static OS_STK MainStk[128], WaitStk[N_TASKS][128];
+static OS_EVENT *Never;
+static BOOLEAN Force;
+
+static void WaitTask(void *p_arg)
+{
+	INT8U err;
+
+	(void)p_arg;
+	OSSemPend(Never, 0u, &err);
+}
+
+static void IsrEmpty(void)
+{
+	OSIntEnter();
+	if (Force == OS_TRUE) {
+		OSSchedReq = OS_TRUE;
+	}
+	OSIntExit();
+}
+
+static void IsrTick(void)
+{
+	OSIntEnter();
+	OSTimeTick();		/* Readies nobody: all tasks wait     */
+	if (Force == OS_TRUE) {
+		OSSchedReq = OS_TRUE;
+	}
+	OSIntExit();
+}
+
+static void TaskUnlock(void)
+{
+	OSSchedLock();
+	if (Force == OS_TRUE) {
+		OSSchedReq = OS_TRUE;
+	}
+	OSSchedUnlock();	/* Calls OS_Sched()                   */
+}
+
+static double Bench(void (*fnct)(void), BOOLEAN force)
+{
+	INT32U best;
+	INT32U ts;
+	INT32U i;
+	INT8U run;
+
+	Force = force;
+	best = 0xFFFFFFFFuL;
+	for (run = 0u; run < N_RUNS; run++) {
+		ts = OS_CPU_TS_GET();
+		for (i = 0u; i < N_CALLS; i++) {
+			fnct();
+		}
+		ts = OS_CPU_TS_GET() - ts;
+		if (ts < best) {
+			best = ts;
+		}
+	}
+	return ((double)best / N_CALLS);
+}
+
+static void Report(const char *name, void (*fnct)(void))
+{
+	double skip;
+	double search;
+
+	search = Bench(fnct, OS_TRUE);
+	skip = Bench(fnct, OS_FALSE);
+	printf("bench_sched: %-28s %6.1f with the search, %6.1f skipped\n", name, search, skip);
+}
+
+static void MainTask(void *p_arg)
+{
+	INT8U i;
+
+	(void)p_arg;
+	Never = OSSemCreate(0u);
+	for (i = 0u; i < N_TASKS; i++) {
+		OSTaskCreate(WaitTask, (void *)0, &WaitStk[i][127], MAIN_PRIO + 1u + i);
+	}
+	OSTimeDly(1u);
+	Report("OSIntExit(), empty ISR", IsrEmpty);
+	Report("OSIntExit(), OSTimeTick()", IsrTick);
+	Report("OS_Sched(), OSSchedUnlock()", TaskUnlock);
+	HostDone("bench_sched");
+}
+
+int main(void)
+{
+	OSInit();
+	OSTaskCreate(MainTask, (void *)0, &MainStk[127], MAIN_PRIO);
+	OSStart();
+	return (1);
+}
@@ -0,0 +1,100 @@
+/*
+ * OSSemPend()/OSSemPost() with and without the LDREX/STREX fast path (OS_SEM_FAST_EN, the "-lock" variant
+ * turns it off): critical sections entered and OS_CPU_TS_GET() counts (host nanoseconds) per call when
+ * no task blocks or is readied, and the slow path when one does.
+ */
+
+#include "host.h"
+
+#define  HIGH_PRIO    4u
+#define  MAIN_PRIO   10u
+#define  N_CALLS   60000uL		/* Fits the 16-bit count              */
+#define  N_RUNS      50u
+
+static OS_STK MainStk[128], HighStk[128];
+static OS_EVENT *Sem, *GoHigh;
+static INT32U HighCtr;
+
+static void HighTask(void *p_arg)
+{
+	INT8U err;
+
+	(void)p_arg;
+	for (;;) {
+		OSSemPend(GoHigh, 0u, &err);
+		HighCtr++;
+	}
+}
+
+static void Bench(const char *name, BOOLEAN pend)
+{
+	INT32U best;
+	INT32U crit;
+	INT32U ts;
+	INT32U i;
+	INT8U run;
+	INT8U err;
+
+	best = 0xFFFFFFFFuL;
+	crit = 0u;
+	for (run = 0u; run < N_RUNS; run++) {
+		OSSemSet(Sem, (pend == OS_TRUE) ? N_CALLS : 0u, &err);
+		crit = HostCritCtr;
+		ts = OS_CPU_TS_GET();
+		if (pend == OS_TRUE) {
+			for (i = 0u; i < N_CALLS; i++) {
+				OSSemPend(Sem, 0u, &err);
+			}
+		} else {
+			for (i = 0u; i < N_CALLS; i++) {
+				OSSemPost(Sem);
+			}
+		}
+		ts = OS_CPU_TS_GET() - ts;
+		crit = HostCritCtr - crit;
+		if (ts < best) {
+			best = ts;
+		}
+	}
+	printf("bench_sem: OS_SEM_FAST_EN %u, %-13s %4.2f critical sections, %5.1f per call\n",
+	       (unsigned)OS_SEM_FAST_EN, name, (double)crit / N_CALLS, (double)best / N_CALLS);
+}
+
+static void MainTask(void *p_arg)
+{
+	INT8U err;
+	INT8U i;
+
+	(void)p_arg;
+	Sem = OSSemCreate(0u);
+	GoHigh = OSSemCreate(0u);
+	OSTaskCreate(HighTask, (void *)0, &HighStk[127], HIGH_PRIO);
+
+	/* Counts, waiters and timeouts still go through the slow path when needed */
+	CHECK(OSSemPost(GoHigh) == OS_ERR_NONE && HighCtr == 1u);
+	for (i = 0u; i < 3u; i++) {
+		CHECK(OSSemPost(Sem) == OS_ERR_NONE);
+	}
+	CHECK(Sem->OSEventCnt == 3u);
+	for (i = 0u; i < 3u; i++) {
+		OSSemPend(Sem, 0u, &err);
+		CHECK(err == OS_ERR_NONE);
+	}
+	OSSemPend(Sem, 2u, &err);
+	CHECK(err == OS_ERR_TIMEOUT && Sem->OSEventCnt == 0u && Sem->OSEventGrp == 0u);
+	OSSemSet(Sem, 65535u, &err);
+	CHECK(OSSemPost(Sem) == OS_ERR_SEM_OVF);
+
+	/* Uncontended calls */
+	Bench("OSSemPost():", OS_FALSE);
+	Bench("OSSemPend():", OS_TRUE);
+	HostDone("bench_sem");
+}
+
+int main(void)
+{
+	OSInit();
+	OSTaskCreate(MainTask, (void *)0, &MainStk[127], MAIN_PRIO);
+	OSStart();
+	return (1);
+}
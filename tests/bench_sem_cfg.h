@@ -0,0 +1,8 @@
+#undef  OS_TASK_STAT_EN
+#define OS_TASK_STAT_EN           0u
+#undef  OS_SEM_FAST_EN
+#ifdef  TEST_SEM_FAST_EN
+#define OS_SEM_FAST_EN            TEST_SEM_FAST_EN
+#else
+#define OS_SEM_FAST_EN            1u
+#endif
@@ -0,0 +1,139 @@
+/*
+ * CPU budgets (OS_TASK_BUDGET_EN): a task that uses up its budget is held (OS_STAT_BUDGET) at the next
+ * tick, stays held while lower priority tasks run, is released when its period ends, and the overrun is
+ * counted in OSTCBBudgetOverrunCtr, read back through OSTaskQuery().  Also: time spent in higher priority
+ * tasks is not charged, a held task released by OSTaskBudgetSet(), and budget 0 turning enforcement off.
+ *
+ * OS_CPU_TS_GET() reads TsNow, which Work() advances by TS_PER_TICK for each tick a task computes.
+ */
+
+#include "host.h"
+
+#define  MAIN_PRIO    2u
+#define  HOG_PRIO     5u
+#define  B_PRIO      10u
+#define  L_PRIO      20u
+#define  TS_PER_TICK  1000u
+#define  PERIOD      10u
+
+static OS_STK MainStk[128], HogStk[128], BStk[128], LStk[128];
+static INT32U TsNow;
+static INT32U BTicks;			/* Ticks of CPU time B got          */
+static INT32U LTicks;
+
+static INT32U Ts(void)
+{
+	return (TsNow);
+}
+
+static void Work(INT32U ticks)
+{
+	INT32U i;
+
+	for (i = 0u; i < ticks; i++) {	/* Run for 'ticks' ticks of CPU time */
+		TsNow += TS_PER_TICK;
+		HostTick();
+	}
+}
+
+static void BTask(void *p_arg)
+{
+	(void)p_arg;
+	for (;;) {
+		BTicks++;
+		Work(1u);
+	}
+}
+
+static void LTask(void *p_arg)
+{
+	(void)p_arg;
+	for (;;) {
+		LTicks++;
+		Work(1u);
+	}
+}
+
+static void HogTask(void *p_arg)
+{
+	(void)p_arg;
+	Work(5u);
+	OSTaskSuspend(OS_PRIO_SELF);
+}
+
+static INT32U Overruns(void)
+{
+	OS_TCB tcb;
+
+	CHECK(OSTaskQuery(B_PRIO, &tcb) == OS_ERR_NONE);
+	return (tcb.OSTCBBudgetOverrunCtr);
+}
+
+static BOOLEAN Held(void)
+{
+	return (((OSTCBPrioTbl[B_PRIO]->OSTCBStat & OS_STAT_BUDGET) != 0u) ? OS_TRUE : OS_FALSE);
+}
+
+static void MainTask(void *p_arg)
+{
+	INT32U b;
+	INT32U l;
+
+	(void)p_arg;
+	CHECK(OSTaskBudgetSet(OS_TASK_IDLE_PRIO, 1000u, 0u) == OS_ERR_PRIO_INVALID);
+	CHECK(OSTaskBudgetSet(B_PRIO, 1000u, 0u) == OS_ERR_TASK_NOT_EXIST);
+	OSTaskCreateExt(BTask, (void *)0, &BStk[127], B_PRIO, B_PRIO, &BStk[0], 128u, (void *)0,
+			OS_TASK_OPT_BUDGET);
+	OSTaskCreate(LTask, (void *)0, &LStk[127], L_PRIO);
+	CHECK(OSTCBPrioTbl[B_PRIO]->OSTCBBudget == OS_TASK_BUDGET_DFLT);
+
+	/* 3.5 ticks per 10: held at the 4th tick, released at the 10th, once per period */
+	CHECK(OSTaskBudgetSet(B_PRIO, 3u * TS_PER_TICK + TS_PER_TICK / 2u, PERIOD) == OS_ERR_NONE);
+	BTicks = 0u;
+	LTicks = 0u;
+	OSTimeDly(4u);
+	CHECK(Held() == OS_TRUE && BTicks == 4u && Overruns() == 1u);
+	CHECK(OSTCBPrioTbl[B_PRIO]->OSTCBBudgetUsed >= 4u * TS_PER_TICK);
+	OSTimeDly(5u);
+	CHECK(Held() == OS_TRUE && BTicks == 4u && LTicks == 5u && Overruns() == 1u);
+	OSTimeDly(1u);			/* 10th tick: replenished             */
+	CHECK(Held() == OS_FALSE && OSTCBPrioTbl[B_PRIO]->OSTCBStat == OS_STAT_RDY);
+	OSTimeDly(1u);
+	CHECK(BTicks == 5u && LTicks == 6u);	/* L ran until the 10th tick         */
+	OSTimeDly(8u);
+	CHECK(Held() == OS_TRUE && BTicks == 8u && Overruns() == 2u);
+
+	/* Time a higher priority task runs is not charged to B */
+	OSTimeDly(1u);			/* 20th tick: replenished             */
+	CHECK(Held() == OS_FALSE);
+	b = BTicks;
+	OSTaskCreate(HogTask, (void *)0, &HogStk[127], HOG_PRIO);
+	OSTimeDly(8u);			/* Hog 5, then B 3 of its 3.5         */
+	CHECK(BTicks - b == 3u && Held() == OS_FALSE && Overruns() == 2u);
+	OSTimeDly(1u);
+	CHECK(Held() == OS_TRUE && Overruns() == 3u);
+
+	/* OSTaskBudgetSet() releases a held task and starts a new period */
+	CHECK(OSTaskBudgetSet(B_PRIO, 2u * TS_PER_TICK, PERIOD) == OS_ERR_NONE);
+	CHECK(Held() == OS_FALSE);
+	b = BTicks;
+	OSTimeDly(2u);
+	CHECK(Held() == OS_TRUE && BTicks - b == 2u && Overruns() == 4u);
+
+	/* Budget 0: no longer enforced */
+	CHECK(OSTaskBudgetSet(B_PRIO, 0u, PERIOD) == OS_ERR_NONE);
+	b = BTicks;
+	l = LTicks;
+	OSTimeDly(3u * PERIOD);
+	CHECK(BTicks - b == 3u * PERIOD && LTicks == l && Overruns() == 4u);
+	HostDone("budget");
+}
+
+int main(void)
+{
+	HostTsFnct = Ts;
+	OSInit();
+	OSTaskCreate(MainTask, (void *)0, &MainStk[127], MAIN_PRIO);
+	OSStart();
+	return (1);
+}
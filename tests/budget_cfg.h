@@ -0,0 +1,6 @@
+#undef  OS_TASK_STAT_EN
+#define OS_TASK_STAT_EN           0u
+#undef  OS_TASK_BUDGET_EN
+#define OS_TASK_BUDGET_EN         1u
+#undef  OS_ARG_CHK_EN
+#define OS_ARG_CHK_EN             1u
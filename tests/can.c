@@ -0,0 +1,270 @@
+/*
+ * CAN driver (srccode/can.c) receive filters on a RAM stand-in for CAN1: the banks CAN_Subscribe() builds
+ * for a mix of standard and extended, exact (list) and masked subscriptions, register by register (FR1,
+ * FR2, FM1R, FS1R, FFA1R, FA1R) and filter number by filter number (fmi[][]), the refusal when the banks
+ * run out, and frames routed through CAN_RxIsr() to the right subscriber.
+ *
+ * HwMatch() plays the filter hardware from the reference manual, independently of how the driver encodes
+ * the banks: the frame's 32- and 16-bit images against each active bank, filter numbers counted per FIFO
+ * over the banks in order, and the first match by scale (32 before 16 bits), mode (list before mask) and
+ * number.
+ */
+
+#include <string.h>
+#include "host.h"
+#include "../srccode/can.c"
+
+#define  MAIN_PRIO   10u
+#define  N_SUBS      11u
+#define  EXT         CAN_FRAME_EXT
+
+static CAN_TypeDef HostCan;
+
+static OS_STK MainStk[256];
+static CAN_FRAME Frames[8];
+static CAN_SUB Subs[N_SUBS], More[10];
+static void *QTbl[N_SUBS][2];
+
+static INT32U const SubId[N_SUBS] = {
+	0x100u, 0x101u, 0x102u, 0x103u, 0x104u,	/* Standard, exact: two 16-bit list banks   */
+	0x200u, 0x300u,			/* Standard, masked: one 16-bit mask bank   */
+	EXT | 0x1234567u, EXT | 0x0ABCDEFu, EXT | 0x1FFFFFFFu,	/* Extended, exact: two 32-bit lists */
+	EXT | 0x18DA0000u		/* Extended, masked: one 32-bit mask bank   */
+};
+static INT32U const SubMask[N_SUBS] = {
+	0x7FFu, 0x7FFu, 0x7FFu, 0x7FFu, 0x7FFu,
+	0x7F0u, 0x700u,
+	0x1FFFFFFFu, 0x1FFFFFFFu, 0x1FFFFFFFu,
+	0x1FFF0000u
+};
+
+/* Standard peripheral library functions called by the driver */
+void RCC_APB1PeriphClockCmd(uint32_t periph, FunctionalState state)
+{
+}
+
+void RCC_APB2PeriphClockCmd(uint32_t periph, FunctionalState state)
+{
+}
+
+void RCC_GetClocksFreq(RCC_ClocksTypeDef * pclocks)
+{
+	pclocks->PCLK1_Frequency = 36000000u;
+}
+
+void GPIO_Init(GPIO_TypeDef * pgpio, GPIO_InitTypeDef * pinit)
+{
+}
+
+void NVIC_Init(NVIC_InitTypeDef * pinit)
+{
+}
+
+void CAN_DeInit(CAN_TypeDef * pcan)
+{
+}
+
+void CAN_StructInit(CAN_InitTypeDef * pinit)
+{
+}
+
+uint8_t CAN_Init(CAN_TypeDef * pcan, CAN_InitTypeDef * pinit)
+{
+	return (CAN_InitStatus_Success);
+}
+
+/* Finds the filter that accepts frame 'id' (a remote frame if 'rtr'), as the hardware does */
+static BOOLEAN HwMatch(INT32U id, BOOLEAN rtr, INT8U * pfifo, INT8U * pfmi)
+{
+	INT32U i32, i16, r[2], v, m;
+	INT8U nfmi[2], b, k, cnt, fifo, list, wide, rank, best;
+
+	if ((id & EXT) != 0u) {	/* STID[10:0] EXID[17:0] IDE RTR 0 / STID[10:0] RTR IDE EXID[17:15] */
+		i32 = ((id & CAN_ID_MASK_EXT) << 3) | 0x4u;
+		i16 = (((id >> 18) & 0x7FFu) << 5) | 0x8u | ((id >> 15) & 0x7u);
+	} else {
+		i32 = (id & CAN_ID_MASK_STD) << 21;
+		i16 = (id & CAN_ID_MASK_STD) << 5;
+	}
+	if (rtr == OS_TRUE) {
+		i32 |= 0x2u;
+		i16 |= 0x10u;
+	}
+	nfmi[0] = 0u;
+	nfmi[1] = 0u;
+	best = 0u;
+	for (b = 0u; b < CAN_FLT_BANKS; b++) {
+		fifo = (INT8U) ((HostCan.FFA1R >> b) & 1u);
+		list = (INT8U) ((HostCan.FM1R >> b) & 1u);
+		wide = (INT8U) ((HostCan.FS1R >> b) & 1u);
+		cnt = (wide != 0u) ? ((list != 0u) ? 2u : 1u) : ((list != 0u) ? 4u : 2u);
+		r[0] = HostCan.sFilterRegister[b].FR1;
+		r[1] = HostCan.sFilterRegister[b].FR2;
+		for (k = 0u; (((HostCan.FA1R >> b) & 1u) != 0u) && (k < cnt); k++) {
+			if ((wide != 0u) && (list != 0u)) {	/* Two IDs */
+				m = (i32 == r[k]);
+			} else if (wide != 0u) {	/* ID in FR1, mask in FR2 */
+				m = (((i32 ^ r[0]) & r[1]) == 0u);
+			} else if (list != 0u) {	/* Four IDs, low half first */
+				v = (r[k >> 1] >> (16u * (k & 1u))) & 0xFFFFu;
+				m = (i16 == v);
+			} else {	/* ID in the low half, mask in the high half of each */
+				m = (((i16 ^ r[k]) & (r[k] >> 16)) & 0xFFFFu) == 0u;
+			}
+			rank = (INT8U) (1u + 2u * wide + list);
+			if ((m != 0u) && (rank > best)) {
+				best = rank;
+				*pfifo = fifo;
+				*pfmi = (INT8U) (nfmi[fifo] + k);
+			}
+		}
+		nfmi[fifo] += cnt;
+	}
+	return ((best != 0u) ? OS_TRUE : OS_FALSE);
+}
+
+/* Receives frame 'id' if a filter accepts it; returns the frame the subscriber got, or NULL */
+static CAN_FRAME *Rx(INT32U id, BOOLEAN rtr, INT8U ix)
+{
+	CAN_FIFOMailBox_TypeDef *mb;
+	CAN_FRAME *pframe;
+	INT8U fifo;
+	INT8U fmi;
+	INT8U err;
+
+	if (HwMatch(id, rtr, &fifo, &fmi) == OS_FALSE) {
+		return ((CAN_FRAME *) 0);
+	}
+	mb = &HostCan.sFIFOMailBox[fifo];
+	mb->RIR = ((id & EXT) != 0u) ? (((id & CAN_ID_MASK_EXT) << 3) | CAN_RI0R_IDE) : (id << 21);
+	mb->RDTR = 8u | ((INT32U) fmi << 8);
+	mb->RDLR = 0x04030201u + ix;
+	mb->RDHR = 0x08070605u;
+	if (fifo == 0u) {
+		HostCan.RF0R = 1u;
+	} else {
+		HostCan.RF1R = 1u;
+	}
+	OSIntEnter();
+	CAN_RxIsr(&CAN_Bus1, fifo);
+	OSIntExit();
+	pframe = (CAN_FRAME *) OSQAccept((ix < N_SUBS) ? Subs[ix].q : More[ix - N_SUBS].q, &err);
+	CHECK(pframe != (CAN_FRAME *) 0 && pframe->id == id && pframe->dlc == 8u);
+	CHECK(pframe->data[0] == 1u + ix && pframe->data[3] == 4u && pframe->data[7] == 8u);
+	CAN_FrameFree(&CAN_Bus1, pframe);
+	return (pframe);
+}
+
+static void Sub(CAN_SUB * psub, INT32U id, INT32U mask, void **pqtbl)
+{
+	psub->id = id;
+	psub->mask = mask;
+	psub->q = OSQCreate(pqtbl, 2u);
+}
+
+static void MainTask(void *p_arg)
+{
+	static void *more_q[10][2];
+	INT32U id;
+	INT8U fifo;
+	INT8U fmi;
+	INT8U i;
+
+	(void)p_arg;
+
+	/* No subscriber: no bank active, nothing received */
+	CHECK(HostCan.FA1R == 0u && (HostCan.FMR & CAN_FMR_FINIT) == 0u && CAN_Bus1.banks == 0u);
+	CHECK(HwMatch(0x100u, OS_FALSE, &fifo, &fmi) == OS_FALSE);
+
+	/* One exact standard ID fills a 16-bit list bank, repeated */
+	for (i = 0u; i < N_SUBS; i++) {
+		Sub(&Subs[i], SubId[i], SubMask[i], QTbl[i]);
+	}
+	CHECK(CAN_Subscribe(&CAN_Bus1, &Subs[0]) == OS_TRUE && CAN_Bus1.banks == 1u);
+	CHECK(HostCan.sFilterRegister[0].FR1 == 0x20002000u && HostCan.sFilterRegister[0].FR2 == 0x20002000u);
+	CHECK(HostCan.FM1R == 0x1u && HostCan.FS1R == 0u && HostCan.FFA1R == 0u && HostCan.FA1R == 0x1u);
+	CHECK(CAN_Bus1.fmi[0][0] == &Subs[0] && CAN_Bus1.fmi[0][3] == &Subs[0]);
+
+	/* The mix: std list, std mask, ext list, ext mask, banks alternating FIFO0/FIFO1; newest first */
+	for (i = 1u; i < N_SUBS; i++) {
+		CHECK(CAN_Subscribe(&CAN_Bus1, &Subs[i]) == OS_TRUE);
+	}
+	CHECK(CAN_Bus1.banks == 6u && (HostCan.FMR & CAN_FMR_FINIT) == 0u);
+	CHECK(HostCan.FA1R == 0x3Fu);
+	CHECK(HostCan.FM1R == 0x1Bu);	/* Banks 0, 1, 3, 4 in list mode    */
+	CHECK(HostCan.FS1R == 0x38u);	/* Banks 3, 4, 5 32-bit             */
+	CHECK(HostCan.FFA1R == 0x2Au);	/* Odd banks to FIFO1               */
+	CHECK(HostCan.sFilterRegister[0].FR1 == ((0x104u << 5) | (0x103u << 21)));
+	CHECK(HostCan.sFilterRegister[0].FR2 == ((0x102u << 5) | (0x101u << 21)));
+	CHECK(HostCan.sFilterRegister[1].FR1 == ((0x100u << 5) | (0x100u << 21)));
+	CHECK(HostCan.sFilterRegister[1].FR2 == HostCan.sFilterRegister[1].FR1);
+	CHECK(HostCan.sFilterRegister[2].FR1 == ((0x300u << 5) | (((0x700u << 5) | 0x18u) << 16)));
+	CHECK(HostCan.sFilterRegister[2].FR2 == ((0x200u << 5) | (((0x7F0u << 5) | 0x18u) << 16)));
+	CHECK(HostCan.sFilterRegister[3].FR1 == 0xFFFFFFFCu);
+	CHECK(HostCan.sFilterRegister[3].FR2 == ((0x0ABCDEFu << 3) | 0x4u));
+	CHECK(HostCan.sFilterRegister[4].FR1 == ((0x1234567u << 3) | 0x4u));
+	CHECK(HostCan.sFilterRegister[4].FR2 == HostCan.sFilterRegister[4].FR1);
+	CHECK(HostCan.sFilterRegister[5].FR1 == ((0x18DA0000u << 3) | 0x4u));
+	CHECK(HostCan.sFilterRegister[5].FR2 == ((0x1FFF0000u << 3) | 0x6u));
+
+	/* Filter numbers per FIFO: FIFO0 has banks 0, 2, 4 and FIFO1 banks 1, 3, 5 */
+	CHECK(CAN_Bus1.fmi[0][0] == &Subs[4] && CAN_Bus1.fmi[0][1] == &Subs[3]);
+	CHECK(CAN_Bus1.fmi[0][2] == &Subs[2] && CAN_Bus1.fmi[0][3] == &Subs[1]);
+	CHECK(CAN_Bus1.fmi[0][4] == &Subs[6] && CAN_Bus1.fmi[0][5] == &Subs[5]);
+	CHECK(CAN_Bus1.fmi[0][6] == &Subs[7] && CAN_Bus1.fmi[0][7] == &Subs[7]);
+	CHECK(CAN_Bus1.fmi[1][0] == &Subs[0] && CAN_Bus1.fmi[1][3] == &Subs[0]);
+	CHECK(CAN_Bus1.fmi[1][4] == &Subs[9] && CAN_Bus1.fmi[1][5] == &Subs[8]);
+	CHECK(CAN_Bus1.fmi[1][6] == &Subs[10]);
+
+	/* Every subscriber gets its frames, through the filter the hardware picks */
+	for (i = 0u; i < N_SUBS; i++) {
+		id = SubId[i];
+		id |= (i == 5u) ? 0x00Fu : ((i == 6u) ? 0x0A5u : ((i == 10u) ? 0x00F1u : 0u));
+		CHECK(Rx(id, OS_FALSE, i) != (CAN_FRAME *) 0 && Subs[i].rx_ctr == 1u);
+	}
+	CHECK(HwMatch(0x104u, OS_FALSE, &fifo, &fmi) == OS_TRUE && fifo == 0u && fmi == 0u);
+	CHECK(HwMatch(EXT | 0x18DA1234u, OS_FALSE, &fifo, &fmi) == OS_TRUE && fifo == 1u && fmi == 6u);
+
+	/* ... and nothing else: other IDs, an extended ID whose top 11 bits are a subscribed standard ID,
+	   remote frames */
+	CHECK(HwMatch(0x105u, OS_FALSE, &fifo, &fmi) == OS_FALSE);
+	CHECK(HwMatch(0x210u, OS_FALSE, &fifo, &fmi) == OS_FALSE);
+	CHECK(HwMatch(0x400u, OS_FALSE, &fifo, &fmi) == OS_FALSE);
+	CHECK(HwMatch(EXT | 0x1234566u, OS_FALSE, &fifo, &fmi) == OS_FALSE);
+	CHECK(HwMatch(EXT | 0x18DB0000u, OS_FALSE, &fifo, &fmi) == OS_FALSE);
+	CHECK(HwMatch(EXT | (0x100u << 18), OS_FALSE, &fifo, &fmi) == OS_FALSE);
+	CHECK(HwMatch(EXT | (0x205u << 18), OS_FALSE, &fifo, &fmi) == OS_FALSE);
+	CHECK(HwMatch(0x100u, OS_TRUE, &fifo, &fmi) == OS_FALSE);
+	CHECK(HwMatch(0x205u, OS_TRUE, &fifo, &fmi) == OS_FALSE);
+	CHECK(HwMatch(EXT | 0x1234567u, OS_TRUE, &fifo, &fmi) == OS_FALSE);
+	CHECK(HwMatch(EXT | 0x18DA0001u, OS_TRUE, &fifo, &fmi) == OS_FALSE);
+
+	/* Banks run out: eight more masked extended IDs take banks 6..13, the ninth is refused */
+	for (i = 0u; i < 9u; i++) {
+		Sub(&More[i], EXT | ((INT32U) (i + 1u) << 24), 0x1F000000u, more_q[i]);
+		CHECK(CAN_Subscribe(&CAN_Bus1, &More[i]) == ((i < 8u) ? OS_TRUE : OS_FALSE));
+	}
+	CHECK(CAN_Bus1.banks == CAN_FLT_BANKS && HostCan.FA1R == 0x3FFFu && CAN_Bus1.subs == &More[7]);
+	CHECK(Rx(EXT | 0x08ABCDEFu, OS_FALSE, N_SUBS + 7u) != (CAN_FRAME *) 0 && More[7].rx_ctr == 1u);
+	CHECK(HwMatch(EXT | 0x09000000u, OS_FALSE, &fifo, &fmi) == OS_FALSE);
+
+	/* ... but a sixth exact standard ID fits the two 16-bit list banks already there */
+	Sub(&More[9], 0x105u, 0x7FFu, more_q[9]);
+	CHECK(CAN_Subscribe(&CAN_Bus1, &More[9]) == OS_TRUE && CAN_Bus1.banks == CAN_FLT_BANKS);
+	CHECK(HostCan.sFilterRegister[0].FR1 == ((0x105u << 5) | (0x104u << 21)));
+	CHECK(HostCan.sFilterRegister[1].FR1 == ((0x101u << 5) | (0x100u << 21)));
+	CHECK(HostCan.sFilterRegister[1].FR2 == ((0x100u << 5) | (0x100u << 21)));
+	CHECK(CAN_Bus1.fmi[0][0] == &More[9] && CAN_Bus1.fmi[1][0] == &Subs[1] && CAN_Bus1.fmi[1][1] == &Subs[0]);
+	CHECK(Rx(0x105u, OS_FALSE, N_SUBS + 9u) != (CAN_FRAME *) 0 && More[9].rx_ctr == 1u);
+	CHECK(Rx(0x100u, OS_FALSE, 0u) != (CAN_FRAME *) 0 && Subs[0].rx_ctr == 2u);
+	HostDone("can");
+}
+
+int main(void)
+{
+	OSInit();
+	CAN_BusInit(&CAN_Bus1, &HostCan, Frames, 4u, 4u);
+	OSTaskCreate(MainTask, (void *)0, &MainStk[255], MAIN_PRIO);
+	OSStart();
+	return (1);
+}
@@ -0,0 +1,6 @@
+#undef  OS_TASK_STAT_EN
+#define OS_TASK_STAT_EN           0u
+#undef  OS_MAX_QS
+#define OS_MAX_QS                24u
+#undef  OS_MAX_EVENTS
+#define OS_MAX_EVENTS            32u
@@ -0,0 +1,191 @@
+/*
+ * Coroutines (OS_CO_EN): waits on a semaphore, a queue and event flags run by the scheduler task, delays
+ * and timeouts across the 16-bit wrap of OSCoDly, the OS_CO_DLY_MAX cut, the index-linked list of the
+ * scheduler and the checks of OSCoSchedCreate()/OSCoCreate().
+ */
+
+#include "host.h"
+
+#define  MAIN_PRIO   10u
+#define  CO_PRIO     20u		/* Runs whenever the main task waits  */
+#define  N_CO         6u
+
+typedef struct co_state {
+	OS_CO Co;			/* First member, see OSCoCreate()     */
+	INT32U Got;
+	INT32U Tmo;
+	INT32U Ts[4];
+	INT8U N;
+	void *Msg;
+} CO_STATE;
+
+static OS_STK MainStk[128], CoStk[256];
+static OS_CO_SCHED Sched;
+static CO_STATE CoTbl[N_CO], Other;
+static OS_EVENT *Sem, *Q;
+static OS_FLAG_GRP *Grp;
+static void *QTbl[4];
+static INT32U Msg1;
+
+static void CoSem(OS_CO * pco)
+{
+	CO_STATE *ps = (CO_STATE *) pco;
+
+	OS_CO_BEGIN(pco);
+	for (;;) {
+		OS_CO_PEND(pco, Sem, 5u);
+		if (pco->OSCoErr == OS_ERR_NONE) {
+			ps->Got++;
+		} else {
+			ps->Tmo++;
+		}
+	}
+	OS_CO_END(pco);
+}
+
+static void CoDly(OS_CO * pco)
+{
+	CO_STATE *ps = (CO_STATE *) pco;
+
+	OS_CO_BEGIN(pco);
+	while (ps->N < 3u) {
+		ps->Ts[ps->N++] = OSTime;
+		OS_CO_DLY(pco, 10u);
+	}
+	ps->Ts[3] = OSTime;
+	OS_CO_END(pco);
+}
+
+static void CoQ(OS_CO * pco)
+{
+	CO_STATE *ps = (CO_STATE *) pco;
+
+	OS_CO_BEGIN(pco);
+	for (;;) {
+		OS_CO_PEND(pco, Q, 0u);
+		ps->Msg = pco->OSCoMsg;
+		ps->Got++;
+	}
+	OS_CO_END(pco);
+}
+
+static void CoFlag(OS_CO * pco)
+{
+	CO_STATE *ps = (CO_STATE *) pco;
+
+	OS_CO_BEGIN(pco);
+	OS_CO_FLAG_PEND(pco, Grp, 0x0003u, OS_FLAG_WAIT_SET_ALL + OS_FLAG_CONSUME, 0u);
+	ps->Got = (INT32U) pco->OSCoMsg;
+	OS_CO_END(pco);
+}
+
+static void CoWrap(OS_CO * pco)
+{
+	CO_STATE *ps = (CO_STATE *) pco;
+
+	OS_CO_BEGIN(pco);
+	ps->Ts[0] = OSTime;
+	OS_CO_DLY(pco, 0x20u);
+	ps->Ts[1] = OSTime;
+	OS_CO_END(pco);
+}
+
+static void CoDlyMax(OS_CO * pco)
+{
+	CO_STATE *ps = (CO_STATE *) pco;
+
+	OS_CO_BEGIN(pco);
+	ps->Ts[0] = OSTime;
+	OS_CO_DLY(pco, 40000u);
+	OS_CO_END(pco);
+}
+
+static INT16U ListLen(void)
+{
+	INT16U ix;
+	INT16U n;
+
+	n = 0u;
+	for (ix = Sched.OSCoSchedList; ix != OS_CO_NONE; ix = CoTbl[ix].Co.OSCoNext) {
+		CHECK(ix < N_CO);
+		n++;
+	}
+	return (n);
+}
+
+static void MainTask(void *p_arg)
+{
+	INT8U err;
+
+	(void)p_arg;
+	CHECK(sizeof(OS_CO) == 3u * sizeof(void *) + 8u);	/* 20 bytes on a Cortex-M3            */
+	Sem = OSSemCreate(0u);
+	Q = OSQCreate(&QTbl[0], 4u);
+	Grp = OSFlagCreate(0u, &err);
+
+	/* Arguments */
+	CHECK(OSCoSchedCreate(&Sched, CO_PRIO, &CoStk[0], 256u, &CoTbl[0], N_CO, 4u) == OS_ERR_CO_INVALID_SIZE);
+	CHECK(OSCoSchedCreate(&Sched, CO_PRIO, &CoStk[0], 256u, &CoTbl[0], 0u, sizeof(CO_STATE)) ==
+	      OS_ERR_CO_INVALID_SIZE);
+	CHECK(OSCoSchedCreate(&Sched, CO_PRIO, &CoStk[0], 256u, (void *)0, N_CO, sizeof(CO_STATE)) ==
+	      OS_ERR_PDATA_NULL);
+	CHECK(OSCoSchedCreate(&Sched, CO_PRIO, &CoStk[0], 256u, &CoTbl[0], N_CO, sizeof(CO_STATE)) == OS_ERR_NONE);
+	CHECK(OSCoCreate(&Sched, &Other.Co, CoDly) == OS_ERR_CO_INVALID);
+	CHECK(OSCoCreate(&Sched, (OS_CO *) (void *)((INT8U *) & CoTbl[1] + 4), CoDly) == OS_ERR_CO_INVALID);
+	CHECK(Sched.OSCoSchedList == OS_CO_NONE);
+
+	/* Each coroutine runs up to its first wait */
+	CHECK(OSCoCreate(&Sched, &CoTbl[0].Co, CoSem) == OS_ERR_NONE);
+	CHECK(OSCoCreate(&Sched, &CoTbl[1].Co, CoDly) == OS_ERR_NONE);
+	CHECK(OSCoCreate(&Sched, &CoTbl[2].Co, CoQ) == OS_ERR_NONE);
+	CHECK(OSCoCreate(&Sched, &CoTbl[3].Co, CoFlag) == OS_ERR_NONE);
+	CHECK(Sched.OSCoSchedList == 3u && CoTbl[3].Co.OSCoNext == 2u && CoTbl[0].Co.OSCoNext == OS_CO_NONE);
+	OSTimeDly(1u);
+	CHECK(CoTbl[1].N == 1u);
+	CHECK(CoTbl[0].Co.OSCoStat == (OS_CO_STAT_PEND | OS_CO_STAT_DLY));
+	CHECK(CoTbl[2].Co.OSCoStat == OS_CO_STAT_PEND);
+	CHECK(CoTbl[3].Co.OSCoStat == OS_CO_STAT_PEND_FLAG);
+	CHECK(CoTbl[3].Co.OSCoErr == OS_FLAG_WAIT_SET_ALL + OS_FLAG_CONSUME);	/* Wait type kept in OSCoErr */
+
+	/* Events are handed over by OSEventPendMulti(), flags are polled */
+	OSSemPost(Sem);
+	OSQPost(Q, (void *)&Msg1);
+	OSTimeDly(1u);
+	CHECK(CoTbl[0].Got == 1u && CoTbl[0].Tmo == 0u);
+	CHECK(CoTbl[2].Got == 1u && CoTbl[2].Msg == (void *)&Msg1);
+	OSFlagPost(Grp, 0x0007u, OS_FLAG_SET, &err);
+	OSTimeDly(2u);
+	CHECK(CoTbl[3].Got == 0x0003u && CoTbl[3].Co.OSCoStat == OS_CO_STAT_DONE);
+	CHECK(Grp->OSFlagFlags == 0x0004u);
+	OSTimeDly(6u);
+	CHECK(CoTbl[0].Tmo >= 1u && CoTbl[0].Got == 1u);
+
+	/* Delays, and the list once coroutines ended */
+	OSTimeDly(40u);
+	CHECK(CoTbl[1].Co.OSCoStat == OS_CO_STAT_DONE);
+	CHECK(CoTbl[1].Ts[1] - CoTbl[1].Ts[0] == 10u);
+	CHECK(CoTbl[1].Ts[2] - CoTbl[1].Ts[1] == 10u);
+	CHECK(CoTbl[1].Ts[3] - CoTbl[1].Ts[2] == 10u);
+	CHECK(ListLen() == 2u);
+
+	/* An entry is reused once its coroutine ended; delays wrap with the low 16 bits of OSTime */
+	OSTimeSet(0x1FFF0uL);
+	CHECK(OSCoCreate(&Sched, &CoTbl[1].Co, CoWrap) == OS_ERR_NONE);
+	CHECK(OSCoCreate(&Sched, &CoTbl[4].Co, CoDlyMax) == OS_ERR_NONE);
+	OSTimeDly(0x30u);
+	CHECK(CoTbl[1].Co.OSCoStat == OS_CO_STAT_DONE);
+	CHECK(CoTbl[1].Ts[0] < 0x20000uL && CoTbl[1].Ts[1] > 0x20000uL);
+	CHECK(CoTbl[1].Ts[1] - CoTbl[1].Ts[0] == 0x20u);
+	CHECK(CoTbl[4].Co.OSCoStat == OS_CO_STAT_DLY);
+	CHECK((INT16U) (CoTbl[4].Co.OSCoDly - (INT16U) CoTbl[4].Ts[0]) == OS_CO_DLY_MAX);
+	CHECK(ListLen() == 3u);
+	HostDone("co");
+}
+
+int main(void)
+{
+	OSInit();
+	OSTaskCreate(MainTask, (void *)0, &MainStk[127], MAIN_PRIO);
+	OSStart();
+	return (1);
+}
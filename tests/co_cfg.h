@@ -0,0 +1,8 @@
+#undef  OS_CO_EN
+#define OS_CO_EN                  1u
+#undef  OS_EVENT_MULTI_EN
+#define OS_EVENT_MULTI_EN         1u
+#undef  OS_FLAG_EN
+#define OS_FLAG_EN                1u
+#undef  OS_ARG_CHK_EN
+#define OS_ARG_CHK_EN             1u
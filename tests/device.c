@@ -0,0 +1,339 @@
+/*
+ * Console driver (srccode/device.c) on RAM stand-ins for USART1 and its DMA channels: DEV_Write() split
+ * into runs at the end of the ring, 16 bytes per critical section, the full-buffer policy (block on the
+ * DMA, or drop and count, always drop in an ISR) and DEV_Flush().  The "-drop" variant builds the driver
+ * with DEV_CON_BLOCK_EN 0.  On the receive side: the head tracked from the DMA counter across the wrap,
+ * overruns, DEV_RxPeek()/DEV_RxConsume() spans and DEV_Read() with a timeout.
+ *
+ * A transfer completes when the test calls DmaTxDone(), or when the idle task runs: the writer blocked on
+ * the DMA then gets its space back as it would from the transfer-complete interrupt.  RxFeed() stores
+ * bytes where the circular RX DMA would and counts CNDTR down.
+ */
+
+#include <string.h>
+#include "host.h"
+
+static USART_TypeDef HostUsart;
+static DMA_Channel_TypeDef HostDmaTx, HostDmaRx;
+
+#define  DEV_CON_USART               (&HostUsart)
+#define  DEV_CON_DMA_CH              (&HostDmaTx)
+#define  DEV_CON_DMA_IT_TC           DMA1_IT_TC4
+#define  DEV_CON_DMA_IRQn            DMA1_Channel4_IRQn
+#define  DEV_CON_IRQn                USART1_IRQn
+#define  DEV_RX_DMA_CH               (&HostDmaRx)
+#define  DEV_RX_DMA_IRQn             DMA1_Channel5_IRQn
+
+#include "../srccode/device.c"
+
+#define  MAIN_PRIO   10u
+
+static OS_STK MainStk[256];
+static INT8U In[2048], Out[4096];
+static INT32U OutLen;
+static INT32U DmaTxCtr;
+static BOOLEAN DmaTxTc;
+static INT32U TcPolls;		/* USART_GetFlagStatus(TC) calls      */
+static INT32U TcBusy;		/* Polls to answer RESET              */
+static INT32U RxFed;		/* Bytes stored by the RX DMA         */
+static INT32U RxFeedAt;		/* Tick at which Idle() feeds 20 bytes */
+static INT32U RxStaleAt;		/* Tick at which Idle() posts no data */
+
+/* Standard peripheral library functions called by the driver */
+void RCC_APB2PeriphClockCmd(uint32_t periph, FunctionalState state)
+{
+}
+
+void RCC_AHBPeriphClockCmd(uint32_t periph, FunctionalState state)
+{
+}
+
+void GPIO_Init(GPIO_TypeDef * pgpio, GPIO_InitTypeDef * pinit)
+{
+}
+
+void NVIC_Init(NVIC_InitTypeDef * pinit)
+{
+}
+
+void USART_StructInit(USART_InitTypeDef * pinit)
+{
+}
+
+void USART_Init(USART_TypeDef * pusart, USART_InitTypeDef * pinit)
+{
+}
+
+void USART_Cmd(USART_TypeDef * pusart, FunctionalState state)
+{
+}
+
+void USART_DMACmd(USART_TypeDef * pusart, uint16_t req, FunctionalState state)
+{
+}
+
+void USART_ITConfig(USART_TypeDef * pusart, uint16_t it, FunctionalState state)
+{
+}
+
+FlagStatus USART_GetFlagStatus(USART_TypeDef * pusart, uint16_t flag)
+{
+	TcPolls++;
+	if (TcBusy > 0u) {
+		TcBusy--;
+		return (RESET);
+	}
+	return (SET);
+}
+
+void DMA_DeInit(DMA_Channel_TypeDef * pch)
+{
+	memset(pch, 0, sizeof(*pch));
+}
+
+void DMA_Init(DMA_Channel_TypeDef * pch, DMA_InitTypeDef * pinit)
+{
+	pch->CPAR = pinit->DMA_PeripheralBaseAddr;
+	pch->CMAR = pinit->DMA_MemoryBaseAddr;
+	pch->CNDTR = pinit->DMA_BufferSize;
+}
+
+void DMA_ITConfig(DMA_Channel_TypeDef * pch, uint32_t it, FunctionalState state)
+{
+}
+
+void DMA_Cmd(DMA_Channel_TypeDef * pch, FunctionalState state)
+{
+	if (state != DISABLE) {
+		pch->CCR |= DMA_CCR1_EN;
+	} else {
+		pch->CCR &= ~DMA_CCR1_EN;
+	}
+}
+
+void DMA_SetCurrDataCounter(DMA_Channel_TypeDef * pch, uint16_t n)
+{
+	pch->CNDTR = n;
+}
+
+uint16_t DMA_GetCurrDataCounter(DMA_Channel_TypeDef * pch)
+{
+	return ((uint16_t) pch->CNDTR);
+}
+
+ITStatus DMA_GetITStatus(uint32_t it)
+{
+	return ((DmaTxTc == OS_TRUE) ? SET : RESET);
+}
+
+void DMA_ClearITPendingBit(uint32_t it)
+{
+	DmaTxTc = OS_FALSE;
+}
+
+/* Sends the transfer in progress and runs the transfer-complete interrupt */
+static void DmaTxDone(void)
+{
+	CHECK((HostDmaTx.CCR & DMA_CCR1_EN) != 0u && HostDmaTx.CNDTR > 0u);
+	memcpy(&Out[OutLen], (void *)(uintptr_t) HostDmaTx.CMAR, HostDmaTx.CNDTR);
+	OutLen += HostDmaTx.CNDTR;
+	DmaTxCtr++;
+	DmaTxTc = OS_TRUE;
+	OSIntEnter();
+	DEV_ConDmaIsr();
+	OSIntExit();
+}
+
+/* Receives 'n' bytes of the stream, then raises the idle-line (or HT/TC) interrupt if 'isr' */
+static void RxFeed(INT16U n, BOOLEAN isr)
+{
+	while (n-- > 0u) {
+		DEV_RxBuf[DEV_RX_BUF_SIZE - HostDmaRx.CNDTR] = In[RxFed++ % sizeof(In)];
+		if (--HostDmaRx.CNDTR == 0u) {
+			HostDmaRx.CNDTR = DEV_RX_BUF_SIZE;
+		}
+	}
+	if (isr == OS_TRUE) {
+		OSIntEnter();
+		DEV_RxIsr();
+		OSIntExit();
+	}
+}
+
+/* Checks that the next 'n' bytes read are bytes 'from'.. of the stream */
+static BOOLEAN RxIs(INT8U const *p, INT32U from, INT16U n)
+{
+	while (n-- > 0u) {
+		if (*p++ != In[from++ % sizeof(In)]) {
+			return (OS_FALSE);
+		}
+	}
+	return (OS_TRUE);
+}
+
+static void Idle(void)
+{
+	if ((HostDmaTx.CCR & DMA_CCR1_EN) != 0u) {
+		DmaTxDone();
+	}
+	HostTick();
+	if (OSTime == RxFeedAt) {
+		RxFeed(20u, OS_TRUE);
+	}
+	if (OSTime == RxStaleAt) {	/* Wake-up for data already read      */
+		OSIntEnter();
+		(void)OSSemPost(DEV_RxSem);
+		OSIntExit();
+	}
+}
+
+static void Drain(void)
+{
+	while ((HostDmaTx.CCR & DMA_CCR1_EN) != 0u) {
+		DmaTxDone();
+	}
+}
+
+static void MainTask(void *p_arg)
+{
+	INT32U crit;
+	INT32U t;
+	INT16U i;
+	INT16U n;
+	INT8U *p;
+	INT8U buf[200];
+	INT8U err;
+
+	(void)p_arg;
+	for (i = 0u; i < sizeof(In); i++) {
+		In[i] = (INT8U) (i % 251u);
+	}
+
+	/* The first 16 bytes start the DMA, the rest is sent as one run when they are done */
+	crit = HostCritCtr;
+	CHECK(DEV_Write(&In[0], 300u) == 300u);
+	CHECK(HostCritCtr - crit == 19u);	/* 300 bytes, 16 per critical section */
+	CHECK(HostDmaTx.CNDTR == 16u && HostDmaTx.CMAR == (INT32U) & DEV_ConBuf[0]);
+	DmaTxDone();
+	CHECK(HostDmaTx.CNDTR == 284u && HostDmaTx.CMAR == (INT32U) & DEV_ConBuf[16]);
+	DmaTxDone();
+	CHECK((HostDmaTx.CCR & DMA_CCR1_EN) == 0u && OutLen == 300u);
+
+	/* A run stops at the end of the ring, the wrapped part follows */
+	CHECK(DEV_Write(&In[300], 400u) == 400u);
+	CHECK(HostDmaTx.CNDTR == 16u);
+	DmaTxDone();
+	CHECK(HostDmaTx.CNDTR == 196u && HostDmaTx.CMAR == (INT32U) & DEV_ConBuf[316]);
+	DmaTxDone();
+	CHECK(HostDmaTx.CNDTR == 188u && HostDmaTx.CMAR == (INT32U) & DEV_ConBuf[0]);
+	DmaTxDone();
+	CHECK(OutLen == 700u && memcmp(Out, In, 700u) == 0);
+	CHECK(DEV_ConDropCtr == 0u);
+
+	/* A writer in an ISR never waits: what doesn't fit is dropped and counted */
+	OSIntEnter();
+	CHECK(DEV_Write(&In[700], 600u) == DEV_CON_BUF_SIZE);
+	OSIntExit();
+	CHECK(DEV_ConDropCtr == 600u - DEV_CON_BUF_SIZE);
+	Drain();
+	CHECK(OutLen == 700u + DEV_CON_BUF_SIZE && memcmp(Out, In, OutLen) == 0);
+
+	/* A task waits for the DMA to make room, or drops too */
+	OutLen = 0u;
+	DEV_ConDropCtr = 0u;
+	DmaTxCtr = 0u;
+#if DEV_CON_BLOCK_EN > 0
+	CHECK(DEV_Write(&In[0], 1500u) == 1500u);
+	CHECK(DEV_ConDropCtr == 0u && DmaTxCtr >= 2u);
+	Drain();
+	CHECK(OutLen == 1500u && memcmp(Out, In, 1500u) == 0);
+#else
+	CHECK(DEV_Write(&In[0], 1500u) == DEV_CON_BUF_SIZE);
+	CHECK(DEV_ConDropCtr == 1500u - DEV_CON_BUF_SIZE && DmaTxCtr == 0u);
+	Drain();
+	CHECK(OutLen == DEV_CON_BUF_SIZE && memcmp(Out, In, OutLen) == 0);
+#endif
+
+	/* DEV_Flush() waits for the ring to drain, then for the last byte to shift out */
+	OutLen = 0u;
+	HostIdleFnct = Idle;
+	DEV_PutChar('A');
+	CHECK(DEV_Write(&In[0], 100u) == 100u);
+	TcPolls = 0u;
+	TcBusy = 3u;
+	DEV_Flush();
+	CHECK(DEV_ConHead == DEV_ConTail && (HostDmaTx.CCR & DMA_CCR1_EN) == 0u);
+	CHECK(OutLen == 101u && Out[0] == 'A' && memcmp(&Out[1], In, 100u) == 0);
+	CHECK(TcPolls == 4u);
+
+	/* ... but returns at once in an ISR */
+	CHECK(DEV_Write(&In[0], 10u) == 10u);
+	OSIntEnter();
+	TcPolls = 0u;
+	DEV_Flush();
+	OSIntExit();
+	CHECK(DEV_ConHead != DEV_ConTail && TcPolls == 0u);
+	DEV_Flush();
+	CHECK(DEV_ConHead == DEV_ConTail);
+
+	/* Receive: spans stop at the end of the ring, data not yet notified is seen too */
+	CHECK(HostDmaRx.CNDTR == DEV_RX_BUF_SIZE && (HostDmaRx.CCR & DMA_CCR1_EN) != 0u);
+	CHECK(DEV_RxPeek(&p) == 0u);
+	RxFeed(200u, OS_TRUE);
+	CHECK(DEV_RxHead == 200u && DEV_RxSem->OSEventCnt == 1u);
+	RxFeed(10u, OS_TRUE);
+	CHECK(DEV_RxSem->OSEventCnt == 1u);	/* One wake-up per batch              */
+	CHECK(DEV_RxPeek(&p) == 210u && p == &DEV_RxBuf[0] && RxIs(p, 0u, 210u));
+	DEV_RxConsume(150u);
+	RxFeed(90u, OS_FALSE);
+	CHECK(DEV_RxPeek(&p) == 106u && p == &DEV_RxBuf[150] && RxIs(p, 150u, 106u));
+	DEV_RxConsume(106u);
+	CHECK(DEV_RxPeek(&p) == 44u && p == &DEV_RxBuf[0] && RxIs(p, 256u, 44u));
+	DEV_RxConsume(1000u);	/* Cut to what was received           */
+	CHECK(DEV_RxHead == 300u && DEV_RxTail == 300u && DEV_RxOvfCtr == 0u);
+	CHECK(DEV_RxPeek(&p) == 0u);
+
+	/* Overrun: the HT/TC interrupts sync every half ring, the oldest half is lost */
+	RxFeed(DEV_RX_BUF_SIZE / 2u, OS_TRUE);
+	RxFeed(DEV_RX_BUF_SIZE / 2u, OS_TRUE);
+	CHECK(DEV_RxOvfCtr == 0u);
+	RxFeed(DEV_RX_BUF_SIZE / 2u, OS_TRUE);
+	CHECK(DEV_RxOvfCtr == 1u && (INT16U) (DEV_RxHead - DEV_RxTail) == DEV_RX_BUF_SIZE);
+	CHECK(DEV_RxTail == 300u + DEV_RX_BUF_SIZE / 2u);
+	n = DEV_RxPeek(&p);
+	CHECK(n == DEV_RX_BUF_SIZE - ((300u + DEV_RX_BUF_SIZE / 2u) & (DEV_RX_BUF_SIZE - 1u)));
+	CHECK(RxIs(p, 300u + DEV_RX_BUF_SIZE / 2u, n));
+
+	/* DEV_Read() copies both spans of the ring */
+	CHECK(DEV_Read(buf, sizeof(buf), 0u, &err) == sizeof(buf) && err == OS_ERR_NONE);
+	CHECK(RxIs(buf, 300u + DEV_RX_BUF_SIZE / 2u, sizeof(buf)));
+	n = DEV_Read(buf, sizeof(buf), 0u, &err);
+	CHECK(n == DEV_RX_BUF_SIZE - sizeof(buf) && err == OS_ERR_NONE);
+	CHECK(RxIs(buf, 300u + DEV_RX_BUF_SIZE / 2u + sizeof(buf), n));
+
+	/* ... times out when nothing comes, and returns what a batch brought */
+	t = OSTime;
+	CHECK(DEV_Read(buf, sizeof(buf), 10u, &err) == 0u && err == OS_ERR_TIMEOUT);
+	CHECK(OSTime - t == 10u);
+	RxFeedAt = OSTime + 3u;
+	CHECK(DEV_Read(buf, sizeof(buf), 10u, &err) == 20u && err == OS_ERR_NONE);
+	CHECK(OSTime == RxFeedAt && RxIs(buf, RxFed - 20u, 20u));
+
+	/* ... and a stale wake-up doesn't restart the timeout */
+	t = OSTime;
+	RxStaleAt = t + 4u;
+	CHECK(DEV_Read(buf, sizeof(buf), 10u, &err) == 0u && err == OS_ERR_TIMEOUT);
+	CHECK(OSTime - t == 10u);
+	HostDone("device");
+}
+
+int main(void)
+{
+	OSInit();
+	DEV_ConDmaInit();
+	DEV_RxDmaInit();
+	HostIdleFnct = Idle;
+	OSTaskCreate(MainTask, (void *)0, &MainStk[255], MAIN_PRIO);
+	OSStart();
+	return (1);
+}
@@ -0,0 +1,2 @@
+#undef  OS_TASK_STAT_EN
+#define OS_TASK_STAT_EN           0u
@@ -0,0 +1,355 @@
+/*
+ * Fixed-point DSP (srccode/dsp.c) against double-precision references: DSP_Q15()/DSP_Q31() rounding and
+ * saturation on both sides; the FIRs, the decimating FIR and the biquads bit for bit against the same
+ * arithmetic done in double (products summed exactly, shifted down by flooring, saturated), and against
+ * the ideal filter within the error their shifts allow; the moving average; and the FFT against DFT/n.
+ */
+
+#include <math.h>
+#include <string.h>
+#include "host.h"
+#include "../srccode/dsp.c"
+
+#define  MAIN_PRIO   10u
+#define  N           256u
+
+static OS_STK MainStk[256];
+static INT32U Seed = 1u;
+
+static Q15 In15[N], Out15[N], Out15b[N];
+static Q31 In31[N], Out31[N];
+static Q15 State15[128];
+static Q31 State31[128];
+static Q15 Fft[2u * 1024u], Twiddle[1024u];
+static double Ref[2u * 1024u];
+
+/* Pseudo-random numbers in [-1, 1) */
+static double Rnd(void)
+{
+	Seed = Seed * 1103515245u + 12345u;
+	return ((double)(INT32S) Seed / 2147483648.0);
+}
+
+static double Sat(double v, double lim)
+{
+	return ((v >= lim) ? lim - 1.0 : ((v < -lim) ? -lim : v));
+}
+
+/* y[i] = floor(sum h[k] x[i-k] / 2^shift), saturated to 'lim' */
+static double FirRef(double const *h, INT16U ntaps, Q31 const *x, INT16U i, INT8U shift, double lim)
+{
+	long double acc;
+	INT16U k;
+
+	acc = 0.0;
+	for (k = 0u; (k < ntaps) && (k <= i); k++) {
+		acc += (long double)h[k] * x[i - k];
+	}
+	return (Sat(floorl(acc / ldexpl(1.0, shift)), lim));
+}
+
+static void Fir15(INT16U ntaps, double gain, double amp)
+{
+	static Q15 coef[40];
+	double h[40];
+	DSP_FIR_Q15 fir;
+	Q31 x[N];
+	INT16U i;
+
+	for (i = 0u; i < ntaps; i++) {
+		coef[i] = DSP_Q15(Rnd() * gain / ntaps);
+		h[i] = coef[i];
+	}
+	for (i = 0u; i < N; i++) {
+		In15[i] = DSP_Q15(Rnd() * amp);
+		x[i] = In15[i];
+	}
+	DSP_FirQ15Init(&fir, coef, ntaps, State15);
+	DSP_FirQ15(&fir, In15, Out15, N / 2u);	/* Two blocks, the state carried */
+	DSP_FirQ15(&fir, &In15[N / 2u], &Out15[N / 2u], N / 2u);
+	for (i = 0u; i < N; i++) {
+		CHECK(Out15[i] == FirRef(h, ntaps, x, i, 15u, 32768.0));
+	}
+}
+
+static void Fir31(INT16U ntaps, double gain, double amp)
+{
+	static Q31 coef[40];
+	double h[40];
+	DSP_FIR_Q31 fir;
+	INT16U i;
+
+	for (i = 0u; i < ntaps; i++) {
+		coef[i] = DSP_Q31(Rnd() * gain / ntaps);
+		h[i] = coef[i];
+	}
+	for (i = 0u; i < N; i++) {
+		In31[i] = DSP_Q31(Rnd() * amp);
+	}
+	DSP_FirQ31Init(&fir, coef, ntaps, State31);
+	DSP_FirQ31(&fir, In31, Out31, N);
+	for (i = 0u; i < N; i++) {
+		CHECK(Out31[i] == FirRef(h, ntaps, In31, i, 31u, 2147483648.0));
+	}
+}
+
+/* Biquad with the stored coefficients b0,b1,b2,-a1,-a2 (times 2^-shift) run in double, stage by stage */
+static double BiquadRef(double const *c, double *s, INT8U nstages, INT8U shift, INT8U bits, double x)
+{
+	long double acc;
+	double y;
+	double lim;
+
+	lim = ldexp(1.0, bits);
+	while (nstages-- > 0u) {
+		acc = (long double)c[0] * x + (long double)c[1] * s[0] + (long double)c[2] * s[1] +
+		    (long double)c[3] * s[2] + (long double)c[4] * s[3];
+		y = Sat(floorl(acc / ldexpl(1.0, bits - shift)), lim);
+		s[1] = s[0];
+		s[0] = x;
+		s[3] = s[2];
+		s[2] = y;
+		x = y;
+		c += 5;
+		s += 4;
+	}
+	return (x);
+}
+
+/* The ideal filter in double, from the true coefficients */
+static double BiquadIdeal(double const *b, double *s, INT8U nstages, double x)
+{
+	double y;
+
+	while (nstages-- > 0u) {
+		y = b[0] * x + b[1] * s[0] + b[2] * s[1] - b[3] * s[2] - b[4] * s[3];
+		s[1] = s[0];
+		s[0] = x;
+		s[3] = s[2];
+		s[2] = y;
+		x = y;
+		b += 5;
+		s += 4;
+	}
+	return (x);
+}
+
+static void MainTask(void *p_arg)
+{
+	/* Two stage low-pass, Butterworth 4th order at fs/10, as b0,b1,b2,a1,a2 per stage; |a1| > 1, shift 1 */
+	static double const bq[10] = {
+		0.0048243433, 0.0096486866, 0.0048243433, -1.0485995764, 0.2961403576,
+		1.0, 2.0, 1.0, -1.3209134308, 0.6327387929
+	};
+	static Q15 bq15[10];
+	static Q31 bq31[10];
+	DSP_BIQUAD_Q15 bqd15;
+	DSP_BIQUAD_Q31 bqd31;
+	DSP_FIR_Q15 fir;
+	DSP_FIR_Q31 fir31;
+	DSP_FIR_DECIM_Q15 dec;
+	DSP_MAVG_Q15 avg;
+	DSP_FFT_Q15 fft;
+	double c[10], s[8], si[8];
+	double err, re, im, a;
+	INT16U n, i, k, nout;
+
+	(void)p_arg;
+
+	/* Conversions: rounded to nearest, saturated on both sides */
+	CHECK(DSP_Q15(0.5) == 16384 && DSP_Q15(-0.5) == -16384 && DSP_Q15(0.0) == 0);
+	CHECK(DSP_Q15(1.0) == 32767 && DSP_Q15(2.0) == 32767 && DSP_Q15(1e9) == 32767);
+	CHECK(DSP_Q15(-1.0) == -32768 && DSP_Q15(-2.0) == -32768 && DSP_Q15(-1e9) == -32768);
+	CHECK(DSP_Q15(0.4 / 32768.0) == 0 && DSP_Q15(0.6 / 32768.0) == 1 && DSP_Q15(-0.6 / 32768.0) == -1);
+	CHECK(DSP_Q15(32766.6 / 32768.0) == 32767 && DSP_Q15(-32767.6 / 32768.0) == -32768);
+	CHECK(DSP_Q31(0.5) == 1073741824 && DSP_Q31(-0.25) == -536870912);
+	CHECK(DSP_Q31(1.0) == 2147483647 && DSP_Q31(3.0) == 2147483647);
+	CHECK(DSP_Q31(-1.0) == -2147483647 - 1 && DSP_Q31(-3.0) == -2147483647 - 1);
+	CHECK(DSP_Q31(1.0 / 2147483648.0) == 1 && DSP_Q31(-1.0 / 2147483648.0) == -1);
+
+	/* FIR Q15, every tap count round the unrolled loop, within range and saturating */
+	for (n = 1u; n <= 9u; n++) {
+		Fir15(n, 0.9, 0.9);
+	}
+	Fir15(33u, 0.9, 1.0);
+	Fir15(8u, 6.0, 1.0);
+	CHECK(DSP_SAT16(40000) == 32767 && DSP_SAT16(-40000) == -32768);
+
+	/* ... a tap of 0.5 and full scale input: the shift floors, -1 * 0.5 is exact */
+	{
+		static Q15 const h[2] = { 16384, 16384 };
+		static Q15 const x[3] = { -32768, -32768, 1 };
+
+		DSP_FirQ15Init(&fir, h, 2u, State15);
+		DSP_FirQ15(&fir, x, Out15, 3u);
+		CHECK(Out15[0] == -16384 && Out15[1] == -32768 && Out15[2] == -16384);
+	}
+
+	/* FIR Q31 */
+	for (n = 1u; n <= 9u; n++) {
+		Fir31(n, 0.9, 0.9);
+	}
+	Fir31(32u, 0.9, 1.0);
+
+	/* ... saturating: taps summing to 1.8 on full scale runs; the 64-bit accumulator holds up to 2 */
+	{
+		static Q31 const h[4] = { DSP_Q31(0.45), DSP_Q31(0.45), DSP_Q31(0.45), DSP_Q31(0.45) };
+		double hd[4];
+
+		for (i = 0u; i < 4u; i++) {
+			hd[i] = h[i];
+		}
+		for (i = 0u; i < N; i++) {
+			In31[i] = ((i / 8u) % 2u == 0u) ? DSP_Q31(1.0) : DSP_Q31(-1.0);
+		}
+		DSP_FirQ31Init(&fir31, h, 4u, State31);
+		DSP_FirQ31(&fir31, In31, Out31, N);
+		n = 0u;
+		for (i = 0u; i < N; i++) {
+			CHECK(Out31[i] == FirRef(hd, 4u, In31, i, 31u, 2147483648.0));
+			n += ((Out31[i] == 2147483647) || (Out31[i] == -2147483647 - 1)) ? 1u : 0u;
+		}
+		CHECK(Out31[3] == 2147483647 && Out31[11] == -2147483647 - 1 && n > N / 2u);
+	}
+
+	/* Decimating FIR: every m-th output of the plain FIR, across blocks of any length */
+	{
+		static Q15 h[13];
+
+		for (i = 0u; i < 13u; i++) {
+			h[i] = DSP_Q15(Rnd() / 13.0);
+		}
+		DSP_FirQ15Init(&fir, h, 13u, State15);
+		DSP_FirQ15(&fir, In15, Out15, N);
+		DSP_FirDecimQ15Init(&dec, h, 13u, 3u, State15);
+		nout = DSP_FirDecimQ15(&dec, In15, Out15b, 100u);
+		nout += DSP_FirDecimQ15(&dec, &In15[100], &Out15b[nout], N - 100u);
+		CHECK(nout == N / 3u);
+		for (i = 0u; i < nout; i++) {
+			CHECK(Out15b[i] == Out15[3u * i + 2u]);
+		}
+	}
+
+	/* Biquad Q15 and Q31: bit for bit against the model, and close to the ideal filter */
+	for (i = 0u; i < 10u; i++) {
+		c[i] = ((i % 5u) < 3u ? bq[i] : -bq[i]) / 2.0;	/* shift 1 */
+		bq15[i] = DSP_Q15(c[i]);
+		bq31[i] = DSP_Q31(c[i]);
+	}
+	for (i = 0u; i < N; i++) {
+		In15[i] = DSP_Q15(0.5 * sin(6.283185307179586 * i / 40.0) + 0.3 * Rnd());
+		In31[i] = (Q31) In15[i] << 16;
+	}
+	DSP_BiquadQ15Init(&bqd15, bq15, 2u, 1u, State15);
+	DSP_BiquadQ15(&bqd15, In15, Out15, N);
+	DSP_BiquadQ31Init(&bqd31, bq31, 2u, 1u, State31);
+	DSP_BiquadQ31(&bqd31, In31, Out31, N);
+	for (k = 0u; k < 10u; k++) {
+		c[k] = bq15[k];
+	}
+	memset(s, 0, sizeof(s));
+	memset(si, 0, sizeof(si));
+	err = 0.0;
+	for (i = 0u; i < N; i++) {
+		CHECK(Out15[i] == BiquadRef(c, s, 2u, 1u, 15u, In15[i]));
+		a = fabs(Out15[i] / 32768.0 - BiquadIdeal(bq, si, 2u, In15[i] / 32768.0));
+		err = (a > err) ? a : err;
+	}
+	CHECK(err < 0.01);		/* Q15: b0 of 0.0048 keeps 7 bits */
+	for (k = 0u; k < 10u; k++) {
+		c[k] = bq31[k];
+	}
+	memset(s, 0, sizeof(s));
+	memset(si, 0, sizeof(si));
+	err = 0.0;
+	for (i = 0u; i < N; i++) {
+		CHECK(Out31[i] == BiquadRef(c, s, 2u, 1u, 31u, In31[i]));
+		a = fabs(Out31[i] / 2147483648.0 - BiquadIdeal(bq, si, 2u, In15[i] / 32768.0));
+		err = (a > err) ? a : err;
+	}
+	CHECK(err < 1e-6);		/* Q31: coefficient rounding only */
+
+	/* ... saturation: the step response of the second stage overshoots full scale */
+	for (i = 0u; i < N; i++) {
+		In15[i] = 32767;
+	}
+	DSP_BiquadQ15Init(&bqd15, &bq15[5], 1u, 1u, State15);
+	DSP_BiquadQ15(&bqd15, In15, Out15, N);
+	for (k = 0u; k < 5u; k++) {
+		c[k] = bq15[5u + k];
+	}
+	memset(s, 0, sizeof(s));
+	n = 0u;
+	for (i = 0u; i < N; i++) {
+		CHECK(Out15[i] == BiquadRef(c, s, 1u, 1u, 15u, In15[i]));
+		n += (Out15[i] == 32767) ? 1u : 0u;
+	}
+	CHECK(n > 0u);
+
+	/* Moving average: the sum over the window divided by its length, truncated */
+	DSP_MavgQ15Init(&avg, 5u, State15);
+	for (i = 0u; i < N; i++) {
+		In15[i] = DSP_Q15(Rnd());
+	}
+	DSP_MavgQ15(&avg, In15, Out15, N);
+	for (i = 0u; i < N; i++) {
+		a = 0.0;
+		for (k = 0u; (k < 5u) && (k <= i); k++) {
+			a += In15[i - k];
+		}
+		CHECK(Out15[i] == trunc(a / 5.0));
+	}
+
+	/* FFT: DFT/n, within one LSB of rounding per stage, on a tone with noise */
+	CHECK(DSP_FftQ15Init(&fft, 2u, Twiddle) == OS_FALSE && DSP_FftQ15Init(&fft, 24u, Twiddle) == OS_FALSE);
+	CHECK(DSP_FftQ15Init(&fft, 8192u, Twiddle) == OS_FALSE);
+	for (n = 4u; n <= 1024u; n <<= 1) {
+		CHECK(DSP_FftQ15Init(&fft, n, Twiddle) == OS_TRUE && Twiddle[0] == 32767 && Twiddle[1] == 0);
+		for (i = 0u; i < n; i++) {
+			Fft[2u * i] = DSP_Q15(0.5 * cos(6.283185307179586 * i / n) + 0.2 * Rnd());
+			Fft[2u * i + 1u] = DSP_Q15(0.2 * Rnd());
+		}
+		for (k = 0u; k < n; k++) {
+			re = 0.0;
+			im = 0.0;
+			for (i = 0u; i < n; i++) {
+				a = -6.283185307179586 * (double)((INT32U) i * k % n) / n;
+				re += Fft[2u * i] * cos(a) - Fft[2u * i + 1u] * sin(a);
+				im += Fft[2u * i] * sin(a) + Fft[2u * i + 1u] * cos(a);
+			}
+			Ref[2u * k] = re / n;
+			Ref[2u * k + 1u] = im / n;
+		}
+		DSP_FftQ15(&fft, Fft);
+		err = 0.0;
+		for (k = 0u; k < 2u * n; k++) {
+			a = fabs(Fft[k] - Ref[k]);
+			err = (a > err) ? a : err;
+		}
+		for (k = 0u, i = n; i > 1u; i >>= 1) {
+			k++;
+		}
+		CHECK(err <= k + 1.0);
+	}
+
+	/* ... scaling: DC of 0.25 and a cosine of 0.5 in bin 5 give 0.25 in bins 0, 5 and n-5 */
+	CHECK(DSP_FftQ15Init(&fft, 256u, Twiddle) == OS_TRUE);
+	for (i = 0u; i < 256u; i++) {
+		Fft[2u * i] = DSP_Q15(0.25 + 0.5 * cos(6.283185307179586 * 5.0 * i / 256.0));
+		Fft[2u * i + 1u] = 0;
+	}
+	DSP_FftQ15(&fft, Fft);
+	for (k = 0u; k < 256u; k++) {
+		re = ((k == 0u) || (k == 5u) || (k == 251u)) ? 8192.0 : 0.0;
+		CHECK(fabs(Fft[2u * k] - re) <= 9.0 && fabs(Fft[2u * k + 1u]) <= 9.0);
+	}
+	HostDone("dsp");
+}
+
+int main(void)
+{
+	OSInit();
+	OSTaskCreate(MainTask, (void *)0, &MainStk[255], MAIN_PRIO);
+	OSStart();
+	return (1);
+}
@@ -0,0 +1,159 @@
+/*
+ * Earliest-deadline-first band (OS_EDF_EN): the order of OSEdfRdyList, the OS_SchedNew() override within
+ * the band, the deadline miss count, and the misses of a periodic task set scheduled by EDF and by fixed
+ * priority.
+ */
+
+#include <string.h>
+#include "host.h"
+
+#define  MAIN_PRIO    2u
+#define  Y_PRIO      19u		/* Above the band                     */
+#define  A_PRIO      20u		/* A..E in the band                   */
+#define  Z_PRIO      25u
+#define  T1_PRIO     26u
+#define  T2_PRIO     27u
+#define  X_PRIO      30u		/* Below the band                     */
+
+#define  T1_PERIOD    5u		/* U = 2/5 + 4/7 = 0.97               */
+#define  T1_COST      2u
+#define  T2_PERIOD    7u
+#define  T2_COST      4u
+#define  RUN_TICKS  350u		/* 10 hyperperiods                    */
+
+typedef struct periodic {
+	INT32U period;
+	INT32U cost;
+	INT32U jobs;
+	INT32U misses;
+} PERIODIC;
+
+static OS_STK MainStk[128], LetterStk[8][128], T1Stk[128], T2Stk[128];
+static PERIODIC T1 = { T1_PERIOD, T1_COST }, T2 = { T2_PERIOD, T2_COST };
+static INT32U Start, End;
+static char Order[16];
+static INT8U OrderLen;
+
+static INT32U Work(INT32U ticks)
+{
+	INT32U t;
+	INT32U i;
+
+	t = OSTimeGet();
+	for (i = 0u; i < ticks; i++) {	/* Run for 'ticks' ticks of CPU time  */
+		t = OSTimeGet();
+		HostTick();
+	}
+	return (t + 1u);	/* End of the last tick this task ran */
+}
+
+static void LetterTask(void *p_arg)
+{
+	Order[OrderLen++] = *(char *)p_arg;
+	OSTaskSuspend(OS_PRIO_SELF);
+}
+
+static void ZTask(void *p_arg)
+{
+	(void)p_arg;
+	Work(4u);		/* Runs past its deadline of 2 ticks  */
+	OSTaskSuspend(OS_PRIO_SELF);
+}
+
+static void PeriodicTask(void *p_arg)
+{
+	PERIODIC *pt;
+	INT32U rel;
+
+	pt = (PERIODIC *) p_arg;
+	for (;;) {
+		OSTaskSuspend(OS_PRIO_SELF);
+		rel = Start;
+		while ((INT32S) (rel - End) < 0) {
+			if ((INT32S) (Work(pt->cost) - (rel + pt->period)) > 0) {
+				pt->misses++;
+			}
+			pt->jobs++;
+			OSTimeDlyUntil(&rel, pt->period);
+		}
+	}
+}
+
+static void Run(INT32U t1_deadline, INT32U t2_deadline)
+{
+	T1.jobs = T1.misses = 0u;
+	T2.jobs = T2.misses = 0u;
+	CHECK(OSTaskDeadlineSet(T1_PRIO, t1_deadline) == OS_ERR_NONE);
+	CHECK(OSTaskDeadlineSet(T2_PRIO, t2_deadline) == OS_ERR_NONE);
+	Start = OSTimeGet();
+	End = Start + RUN_TICKS;
+	OSTaskResume(T1_PRIO);
+	OSTaskResume(T2_PRIO);
+	OSTimeDly(RUN_TICKS + 2u * T2_PERIOD);
+	CHECK(T1.jobs >= RUN_TICKS / T1_PERIOD - 1u);
+}
+
+static void MainTask(void *p_arg)
+{
+	static char letters[] = "YABCDEX";
+	static const INT8U prios[] = { Y_PRIO, A_PRIO, A_PRIO + 1u, A_PRIO + 2u, A_PRIO + 3u, A_PRIO + 4u, X_PRIO };
+	static const INT32U deadlines[] = { 0u, 50u, 10u, 0u, 0u, 30u, 0u };
+	OS_TCB *ptcb;
+	INT32U miss_fp;
+	INT32U miss_edf;
+	INT8U i;
+
+	(void)p_arg;
+
+	/* Deadline order within the band, priority order outside it */
+	for (i = 0u; i < 7u; i++) {
+		OSTaskCreate(LetterTask, &letters[i], &LetterStk[i][127], prios[i]);
+	}
+	CHECK(OSTaskDeadlineSet(Y_PRIO, 10u) == OS_ERR_PRIO_INVALID);
+	CHECK(OSTaskDeadlineSet(X_PRIO, 10u) == OS_ERR_PRIO_INVALID);
+	for (i = 1u; i < 6u; i++) {
+		CHECK(OSTaskDeadlineSet(prios[i], deadlines[i]) == OS_ERR_NONE);
+	}
+	ptcb = OSEdfRdyList;	/* B 10, E 30, A 50, then C, D by priority */
+	CHECK(ptcb == OSTCBPrioTbl[A_PRIO + 1u]);
+	CHECK(ptcb->OSTCBEdfNext == OSTCBPrioTbl[A_PRIO + 4u]);
+	ptcb = ptcb->OSTCBEdfNext;
+	CHECK(ptcb->OSTCBEdfNext == OSTCBPrioTbl[A_PRIO]);
+	ptcb = ptcb->OSTCBEdfNext;
+	CHECK(ptcb->OSTCBEdfNext == OSTCBPrioTbl[A_PRIO + 2u]);
+	ptcb = ptcb->OSTCBEdfNext;
+	CHECK(ptcb->OSTCBEdfNext == OSTCBPrioTbl[A_PRIO + 3u]);
+	CHECK(ptcb->OSTCBEdfNext->OSTCBEdfNext == (OS_TCB *) 0);
+	OSTimeDly(1u);
+	CHECK(OrderLen == 7u && memcmp(Order, "YBEACDX", 7u) == 0);
+	CHECK(OSEdfRdyList == (OS_TCB *) 0);	/* Suspended tasks removed        */
+	CHECK(OSEdfMissCtr == 0u);
+
+	/* A job completed after its deadline is counted */
+	OSTaskCreate(ZTask, (void *)0, &LetterStk[7][127], Z_PRIO);
+	CHECK(OSTaskDeadlineSet(Z_PRIO, 2u) == OS_ERR_NONE);
+	OSTimeDly(10u);
+	CHECK(OSTCBPrioTbl[Z_PRIO]->OSTCBEdfMissCtr == 1u && OSEdfMissCtr == 1u);
+
+	/* Periodic task set, deadline = period: fixed priority (rate monotonic) vs EDF */
+	OSTaskCreate(PeriodicTask, &T1, &T1Stk[127], T1_PRIO);
+	OSTaskCreate(PeriodicTask, &T2, &T2Stk[127], T2_PRIO);
+	OSTimeDly(1u);		/* Both wait to be resumed by Run()   */
+	Run(0u, 0u);		/* No deadlines: priority order       */
+	miss_fp = T1.misses + T2.misses;
+	CHECK(T1.misses == 0u && T2.misses > 0u);
+	Run(T1_PERIOD, T2_PERIOD);
+	miss_edf = T1.misses + T2.misses;
+	CHECK(miss_edf == 0u && OSEdfMissCtr == 1u);
+	printf("edf: U = 0.97 over %u ticks: %lu deadline misses by fixed priority, %lu by EDF\n",
+	       RUN_TICKS, (unsigned long)miss_fp, (unsigned long)miss_edf);
+	HostDone("edf");
+}
+
+int main(void)
+{
+	OSInit();
+	OSTaskCreate(MainTask, (void *)0, &MainStk[127], MAIN_PRIO);
+	OSStart();
+	return (1);
+}
@@ -0,0 +1,2 @@
+#undef  OS_EDF_EN
+#define OS_EDF_EN                 1u
@@ -0,0 +1,119 @@
+/*
+ * Formatter (srccode/fmt.c): conversions, flags and widths against the host's snprintf(), truncation at
+ * every buffer size, %.Nq fixed point, %.Ns and a NULL %s, and the line limit of FMT_Printf().
+ */
+
+#include <string.h>
+#include <limits.h>
+#include "host.h"
+#include "../srccode/fmt.c"
+
+#define  MAIN_PRIO   10u
+
+static OS_STK MainStk[256];
+static char Line[256];
+static INT16U LineLen;
+
+INT16U DEV_WriteAll(INT8U const *pbuf, INT16U len)
+{
+	memcpy(Line, pbuf, len);
+	LineLen = len;
+	return (len);
+}
+
+/* Same text as snprintf() for every buffer size, and the length of what fits */
+#define  SAME(...)  do {                                                                               \
+                        char    a[64];                                                             \
+                        char    b[64];                                                             \
+                        INT16U  size;                                                              \
+                        INT16U  len;                                                               \
+                        int     full;                                                              \
+                                                                                                   \
+                        full = snprintf(b, sizeof(b), __VA_ARGS__);                                \
+                        for (size = 1u; size <= (INT16U)full + 1u; size++) {                       \
+                            memset(a, 'z', sizeof(a));                                             \
+                            len = FMT_Format(a, size, __VA_ARGS__);                                \
+                            snprintf(b, size, __VA_ARGS__);                                        \
+                            if ((strcmp(a, b) != 0) || (len != (size - 1u < (INT16U)full ?         \
+                                                                size - 1u : (INT16U)full))) {      \
+                                printf("size %u: \"%s\" (%u), snprintf \"%s\"\n",                  \
+                                       (unsigned)size, a, (unsigned)len, b);                       \
+                            }                                                                      \
+                            CHECK(strcmp(a, b) == 0 && a[size] == 'z');                            \
+                            CHECK(len == ((size - 1u < (INT16U)full) ? size - 1u : (INT16U)full)); \
+                        }                                                                          \
+                    } while (0)
+
+/* Text expected from FMT_Format() */
+#define  IS(s, ...) do {                                                                               \
+                        char    a[64];                                                             \
+                        INT16U  len;                                                               \
+                                                                                                   \
+                        len = FMT_Format(a, sizeof(a), __VA_ARGS__);                               \
+                        if (strcmp(a, (s)) != 0) {                                                 \
+                            printf("\"%s\", expected \"%s\"\n", a, (s));                           \
+                        }                                                                          \
+                        CHECK(strcmp(a, (s)) == 0 && len == strlen(s));                            \
+                    } while (0)
+
+static void MainTask(void *p_arg)
+{
+	char a[8];
+	char longline[200];
+
+	(void)p_arg;
+
+	/* Integers */
+	SAME("%d|%i", 0, -1);
+	SAME("%d %d", INT_MIN, INT_MAX);
+	SAME("%u", 4000000000u);
+	SAME("%x %X", 0xDEADBEEFu, 0xDEADBEEFu);
+	SAME("[%5d] [%-5d] [%05d]", 42, 42, -42);
+	IS("[-42  ]", "[%-05d]", -42);	/* '-' wins over '0'                  */
+	SAME("[%08x] [%-8X] [%2d]", 0xBEEFu, 0xBEEFu, 12345);
+	SAME("%ld %lu %lx", 7L, 7UL, 255UL);
+
+	/* '*' width, negative means '-' */
+	SAME("[%*d] [%-*d] [%*d] [%0*d]", 6, 42, 6, 42, -6, 42, 6, -42);
+
+	/* Characters and strings */
+	SAME("%c%c [%3c] [%-3c]", 'o', 'k', 'x', 'y');
+	SAME("[%s] [%8s] [%-8s] [%2s]", "abc", "abc", "abc", "abcdef");
+	SAME("[%.2s] [%5.2s] [%-5.2s] [%.0s] [%.9s]", "abc", "abc", "abc", "abc", "abc");
+	SAME("100%%");
+	IS("[(null)] [  (null)] [(nu]", "[%s] [%8s] [%.3s]", (char *)0, (char *)0, (char *)0);
+
+	/* %.Nq: the integer counts units of 10^-N, at least one digit before the point */
+	IS("12.34", "%.2q", 1234);
+	IS("0.05", "%.2q", 5);
+	IS("-0.05", "%.2q", -5);
+	IS("-1.23", "%.2q", -123);
+	IS("0.000", "%.3q", 0);
+	IS("10.0", "%.1q", 100);
+	IS("7 7", "%q %.0q", 7, 7);
+	IS("0.000000001", "%.12q", 1);	/* At most 9 places                   */
+	IS("-21474836.48", "%.2q", INT_MIN);
+	IS("[   -0.05] [-0000.05] [0.05    ]", "[%8.2q] [%08.2q] [%-8.2q]", -5, -5, 5);
+
+	/* Truncation keeps the '\0', size 0 writes nothing */
+	memset(a, 'z', sizeof(a));
+	CHECK(FMT_Format(a, 0u, "%d", 12345) == 0u && a[0] == 'z');
+	CHECK(FMT_Format(a, 4u, "%.2q", -123) == 3u && strcmp(a, "-1.") == 0);
+
+	/* FMT_Printf() sends one line of at most FMT_LINE_MAX - 1 characters */
+	FMT_Printf("%s=%d\r\n", "x", 3);
+	CHECK(LineLen == 5u && memcmp(Line, "x=3\r\n", 5u) == 0);
+	memset(longline, 'L', sizeof(longline) - 1u);
+	longline[sizeof(longline) - 1u] = '\0';
+	FMT_Printf("%s", longline);
+	CHECK(LineLen == FMT_LINE_MAX - 1u && Line[0] == 'L' && Line[LineLen - 1u] == 'L');
+	HostDone("fmt");
+}
+
+int main(void)
+{
+	OSInit();
+	OSTaskCreate(MainTask, (void *)0, &MainStk[255], MAIN_PRIO);
+	OSStart();
+	return (1);
+}
@@ -0,0 +1,373 @@
+/*
+ * I2C master (srccode/i2c.c) on RAM stand-ins for I2C1 and DMA1: the event sequences of a write, a
+ * one-byte read, an N-byte read and a write-then-read through I2C_EvIsr(), I2C_DmaIsr() and I2C_ErIsr(),
+ * a NACK, bus errors with the peripheral reset, the priority queue, and I2C_Transfer() cancelling a
+ * transfer that times out.
+ *
+ * The test plays the hardware: it sets SR1 to the event, runs the handler as an interrupt, and clears
+ * CR1.STOP/START as the peripheral does once the condition is on the bus.  When Auto is set, Idle() runs
+ * the whole sequence of the current transfer against a slave that acks and reads back SlaveData.
+ */
+
+#include <string.h>
+#include "host.h"
+#include "../srccode/i2c.c"
+
+#define  MAIN_PRIO   10u
+
+#define  FREQ        36u
+#define  CCR_VAL     180u
+#define  TRISE_VAL   37u
+#define  CR2_IDLE    (FREQ | I2C_CR2_ITERREN)
+#define  RX_FLAGS    (0x0Fu << 24)	/* Channel 7 in DMA_ISR/IFCR */
+
+static I2C_TypeDef HostI2c;
+static DMA_TypeDef HostDma;
+static DMA_Channel_TypeDef HostDmaTx, HostDmaRx;
+
+static OS_STK MainStk[256];
+static BOOLEAN Auto;		/* Idle() runs the current transfer      */
+static BOOLEAN Nack;		/* ... and the slave does not ack        */
+static INT32U Stops;		/* STOP conditions sent                  */
+static INT32U Unsticks;
+static INT32U SubmitAt;		/* Tick at which Idle() starts XferA and submits XferC */
+static INT8U SlaveData[8] = { 0x5Au, 0x11u, 0x22u, 0x33u, 0x44u, 0x55u, 0x66u, 0x77u };
+
+static INT8U Wr[4] = { 0x10u, 0x20u, 0x30u, 0x40u };
+static INT8U Rd[8];
+static I2C_XFER XferA, XferB, XferC;
+
+/* Standard peripheral library functions called by the driver */
+void RCC_APB1PeriphClockCmd(uint32_t periph, FunctionalState state)
+{
+}
+
+void RCC_APB2PeriphClockCmd(uint32_t periph, FunctionalState state)
+{
+}
+
+void RCC_AHBPeriphClockCmd(uint32_t periph, FunctionalState state)
+{
+}
+
+void GPIO_Init(GPIO_TypeDef * pgpio, GPIO_InitTypeDef * pinit)
+{
+}
+
+void GPIO_SetBits(GPIO_TypeDef * pgpio, uint16_t pins)
+{
+}
+
+void GPIO_ResetBits(GPIO_TypeDef * pgpio, uint16_t pins)
+{
+}
+
+void NVIC_Init(NVIC_InitTypeDef * pinit)
+{
+}
+
+void I2C_StructInit(I2C_InitTypeDef * pinit)
+{
+}
+
+void I2C_Init(I2C_TypeDef * pi2c, I2C_InitTypeDef * pinit)
+{
+}
+
+void I2C_Cmd(I2C_TypeDef * pi2c, FunctionalState state)
+{
+}
+
+static void Unstick(void)
+{
+	Unsticks++;
+}
+
+/* The peripheral sends the STOP it was asked for */
+static void Bus(void)
+{
+	if ((HostI2c.CR1 & I2C_CR1_STOP) != 0u) {
+		HostI2c.CR1 &= ~I2C_CR1_STOP;
+		Stops++;
+	}
+}
+
+/* Raises the event interrupt with SR1 = 'sr1' */
+static void Ev(INT16U sr1)
+{
+	if ((sr1 & I2C_SR1_SB) != 0u) {
+		HostI2c.CR1 &= ~I2C_CR1_START;
+	}
+	HostI2c.SR1 = sr1;
+	OSIntEnter();
+	I2C_EvIsr(&I2C_Bus1);
+	OSIntExit();
+	Bus();
+}
+
+/* Raises the error interrupt with SR1 = 'sr1' */
+static void Er(INT16U sr1)
+{
+	HostI2c.SR1 = sr1;
+	OSIntEnter();
+	I2C_ErIsr(&I2C_Bus1);
+	OSIntExit();
+	Bus();
+}
+
+/* Ends the receive DMA and raises its transfer complete interrupt */
+static void Dma(void)
+{
+	INT8U *p;
+
+	p = (INT8U *) (uintptr_t) HostDmaRx.CMAR;
+	memcpy(p, SlaveData, HostDmaRx.CNDTR);
+	HostDmaRx.CNDTR = 0u;
+	HostDma.ISR |= 0x02u << 24;
+	OSIntEnter();
+	I2C_DmaIsr(&I2C_Bus1);
+	HostDma.ISR &= ~HostDma.IFCR;
+	OSIntExit();
+	Bus();
+}
+
+/* Runs the sequence of the current transfer */
+static void Run(void)
+{
+	I2C_XFER *pxfer;
+
+	pxfer = I2C_Bus1.cur;
+	Ev(I2C_SR1_SB);
+	if (Nack == OS_TRUE) {
+		Er(I2C_SR1_AF);
+		return;
+	}
+	Ev(I2C_SR1_ADDR);
+	if (I2C_Bus1.rd == 0u) {
+		HostDmaTx.CNDTR = 0u;
+		Ev(I2C_SR1_BTF | I2C_SR1_TXE);
+		if (I2C_Bus1.cur != pxfer) {
+			return;
+		}
+		Ev(I2C_SR1_SB);
+		Ev(I2C_SR1_ADDR);
+	}
+	if (pxfer->rlen == 1u) {
+		HostI2c.DR = SlaveData[0];
+		Ev(I2C_SR1_RXNE);
+	} else {
+		Dma();
+	}
+}
+
+static void Idle(void)
+{
+	if ((Auto == OS_TRUE) && (I2C_Bus1.cur != (I2C_XFER *) 0)) {
+		Run();
+	}
+	HostTick();
+	if (OSTime == SubmitAt) {	/* The read under way, and a transfer submitted from an ISR */
+		Ev(I2C_SR1_SB);
+		Ev(I2C_SR1_ADDR);
+		OSIntEnter();
+		I2C_Submit(&I2C_Bus1, &XferC);
+		OSIntExit();
+	}
+}
+
+static void XferSet(I2C_XFER * pxfer, INT16U wlen, INT16U rlen, INT8U prio)
+{
+	memset(pxfer, 0, sizeof(*pxfer));
+	memset(Rd, 0, sizeof(Rd));
+	pxfer->addr = 0x50u;
+	pxfer->prio = prio;
+	pxfer->pwr = Wr;
+	pxfer->wlen = wlen;
+	pxfer->prd = Rd;
+	pxfer->rlen = rlen;
+}
+
+static void MainTask(void *p_arg)
+{
+	OS_EVENT *sem;
+	INT32U t;
+
+	sem = OSSemCreate(0u);
+	CHECK(HostI2c.CR2 == CR2_IDLE && HostDmaRx.CPAR == (INT32U) & HostI2c.DR && I2C_Bus1.rx_shift == 24u);
+
+	/* An event with no transfer only turns the event interrupt off */
+	HostI2c.CR2 |= I2C_CR2_ITEVTEN;
+	Ev(I2C_SR1_SB);
+	CHECK(HostI2c.CR2 == CR2_IDLE && HostI2c.DR == 0u);
+
+	/* Write: START, address, the bytes by DMA, STOP after the last byte has left (BTF) */
+	XferSet(&XferA, 3u, 0u, 0u);
+	I2C_Submit(&I2C_Bus1, &XferA);
+	CHECK(XferA.stat == I2C_STAT_ACTIVE && (HostI2c.CR1 & (I2C_CR1_START | I2C_CR1_ACK)) == (I2C_CR1_START | I2C_CR1_ACK));
+	CHECK(HostI2c.CR2 == (CR2_IDLE | I2C_CR2_ITEVTEN));
+	Ev(I2C_SR1_SB);
+	CHECK(HostI2c.DR == 0xA0u);
+	Ev(I2C_SR1_ADDR);
+	CHECK(HostDmaTx.CMAR == (INT32U) Wr && HostDmaTx.CNDTR == 3u);
+	CHECK(HostDmaTx.CCR == (DMA_CCR1_DIR | DMA_CCR1_MINC | DMA_CCR1_EN) && (HostI2c.CR2 & I2C_CR2_DMAEN) != 0u);
+	Ev(I2C_SR1_BTF | I2C_SR1_TXE);	/* BTF between two DMA bytes */
+	CHECK(XferA.stat == I2C_STAT_ACTIVE && Stops == 0u && HostDmaTx.CCR != 0u);
+	HostDmaTx.CNDTR = 0u;
+	Ev(I2C_SR1_BTF | I2C_SR1_TXE);
+	CHECK(XferA.stat == I2C_STAT_DONE && Stops == 1u && I2C_Bus1.cur == (I2C_XFER *) 0);
+	CHECK(HostDmaTx.CCR == 0u && HostI2c.CR2 == CR2_IDLE);
+
+	/* Read of one byte: no DMA, ACK off and STOP set before the byte comes in */
+	XferSet(&XferA, 0u, 1u, 0u);
+	I2C_Submit(&I2C_Bus1, &XferA);
+	Ev(I2C_SR1_SB);
+	CHECK(HostI2c.DR == 0xA1u);
+	Ev(I2C_SR1_ADDR);
+	CHECK((HostI2c.CR1 & I2C_CR1_ACK) == 0u && Stops == 2u && (HostI2c.CR2 & I2C_CR2_ITBUFEN) != 0u);
+	CHECK(HostDmaRx.CCR == 0u);
+	HostI2c.DR = 0x5Au;
+	Ev(I2C_SR1_RXNE);
+	CHECK(XferA.stat == I2C_STAT_DONE && Rd[0] == 0x5Au && Stops == 2u && HostI2c.CR2 == CR2_IDLE);
+
+	/* Read of N bytes: DMA with LAST (NACK on the last byte), STOP from the DMA interrupt */
+	XferSet(&XferA, 0u, 4u, 0u);
+	I2C_Submit(&I2C_Bus1, &XferA);
+	CHECK((HostI2c.CR1 & I2C_CR1_ACK) != 0u);
+	Ev(I2C_SR1_SB);
+	CHECK(HostI2c.DR == 0xA1u);
+	Ev(I2C_SR1_ADDR);
+	CHECK(HostDmaRx.CMAR == (INT32U) Rd && HostDmaRx.CNDTR == 4u);
+	CHECK(HostDmaRx.CCR == (DMA_CCR1_MINC | DMA_CCR1_TCIE | DMA_CCR1_EN));
+	CHECK((HostI2c.CR2 & (I2C_CR2_DMAEN | I2C_CR2_LAST)) == (I2C_CR2_DMAEN | I2C_CR2_LAST));
+	Dma();
+	CHECK(HostDma.IFCR == RX_FLAGS && (HostDma.ISR & RX_FLAGS) == 0u);
+	CHECK(XferA.stat == I2C_STAT_DONE && memcmp(Rd, SlaveData, 4u) == 0 && Rd[4] == 0u && Stops == 3u);
+	CHECK(HostDmaRx.CCR == 0u && HostI2c.CR2 == CR2_IDLE);
+
+	/* Write then read: repeated START after the write, then the address with the read bit */
+	XferSet(&XferA, 2u, 3u, 0u);
+	I2C_Submit(&I2C_Bus1, &XferA);
+	Ev(I2C_SR1_SB);
+	CHECK(HostI2c.DR == 0xA0u);
+	Ev(I2C_SR1_ADDR);
+	CHECK(HostDmaTx.CNDTR == 2u);
+	HostDma.IFCR = 0u;
+	OSIntEnter();		/* A stray receive DMA interrupt in the write phase */
+	I2C_DmaIsr(&I2C_Bus1);
+	OSIntExit();
+	CHECK(XferA.stat == I2C_STAT_ACTIVE && HostDma.IFCR == RX_FLAGS);
+	HostDmaTx.CNDTR = 0u;
+	Ev(I2C_SR1_BTF | I2C_SR1_TXE);
+	CHECK((HostI2c.CR1 & I2C_CR1_START) != 0u && Stops == 3u && XferA.stat == I2C_STAT_ACTIVE);
+	CHECK(HostDmaTx.CCR == 0u && (HostI2c.CR2 & I2C_CR2_DMAEN) == 0u && I2C_Bus1.rd == 1u);
+	Ev(I2C_SR1_SB);
+	CHECK(HostI2c.DR == 0xA1u);
+	Ev(I2C_SR1_ADDR);
+	CHECK(HostDmaRx.CNDTR == 3u && (HostI2c.CR2 & I2C_CR2_LAST) != 0u);
+	Dma();
+	CHECK(XferA.stat == I2C_STAT_DONE && memcmp(Rd, SlaveData, 3u) == 0 && Stops == 4u);
+
+	/* Queue: by priority, first in first out within one, the next started as one ends */
+	XferSet(&XferA, 1u, 0u, 1u);
+	XferSet(&XferB, 1u, 0u, 1u);
+	XferSet(&XferC, 1u, 0u, 0u);
+	I2C_Submit(&I2C_Bus1, &XferA);
+	I2C_Submit(&I2C_Bus1, &XferB);
+	I2C_Submit(&I2C_Bus1, &XferC);
+	CHECK(I2C_Bus1.cur == &XferA && I2C_Bus1.head == &XferC && XferC.next == &XferB);
+	CHECK(XferB.stat == I2C_STAT_QUEUED && XferC.stat == I2C_STAT_QUEUED);
+
+	/* NACK of the address: STOP, the error flag cleared, the next transfer started */
+	Ev(I2C_SR1_SB);
+	Er(I2C_SR1_AF);
+	CHECK(XferA.stat == I2C_STAT_NACK && Stops == 5u && (HostI2c.SR1 & I2C_SR1_AF) == 0u);
+	CHECK(I2C_Bus1.cur == &XferC && XferC.stat == I2C_STAT_ACTIVE && (HostI2c.CR1 & I2C_CR1_START) != 0u);
+
+	/* ... NACK of a data byte during the write DMA */
+	Ev(I2C_SR1_SB);
+	Ev(I2C_SR1_ADDR);
+	Er(I2C_SR1_AF | I2C_SR1_TXE);
+	CHECK(XferC.stat == I2C_STAT_NACK && HostDmaTx.CCR == 0u && HostI2c.SR1 == I2C_SR1_TXE);
+	CHECK(I2C_Bus1.cur == &XferB && I2C_Bus1.head == (I2C_XFER *) 0);
+
+	/* Bus error: the peripheral reset and its clock configuration restored */
+	Ev(I2C_SR1_SB);
+	Ev(I2C_SR1_ADDR);
+	HostI2c.CCR = 0u;
+	HostI2c.TRISE = 0u;
+	Er(I2C_SR1_BERR);
+	CHECK(XferB.stat == I2C_STAT_BUS_ERR && I2C_Bus1.cur == (I2C_XFER *) 0);
+	CHECK(HostI2c.CR1 == (I2C_CR1_PE | I2C_CR1_ACK) && HostI2c.CR2 == CR2_IDLE);
+	CHECK(HostI2c.CCR == CCR_VAL && HostI2c.TRISE == TRISE_VAL && HostDmaTx.CCR == 0u && HostDmaRx.CCR == 0u);
+
+	/* ... arbitration lost the same way, overrun with a STOP */
+	XferSet(&XferA, 0u, 4u, 0u);
+	I2C_Submit(&I2C_Bus1, &XferA);
+	Er(I2C_SR1_ARLO);
+	CHECK(XferA.stat == I2C_STAT_BUS_ERR && HostI2c.CR1 == (I2C_CR1_PE | I2C_CR1_ACK));
+	I2C_Submit(&I2C_Bus1, &XferA);
+	Ev(I2C_SR1_SB);
+	Ev(I2C_SR1_ADDR);
+	t = Stops;
+	Er(I2C_SR1_OVR);
+	CHECK(XferA.stat == I2C_STAT_BUS_ERR && Stops == t + 1u && HostDmaRx.CCR == 0u);
+	Er(I2C_SR1_AF);		/* An error with no transfer */
+	CHECK(I2C_Bus1.cur == (I2C_XFER *) 0 && (HostI2c.SR1 & I2C_SR1_AF) == 0u);
+
+	/* I2C_Transfer() through the whole sequence, and a NACK as OS_ERR_PEND_ABORT */
+	Auto = OS_TRUE;
+	XferSet(&XferA, 2u, 5u, 0u);
+	XferA.sem = sem;
+	CHECK(I2C_Transfer(&I2C_Bus1, &XferA, 10u) == OS_ERR_NONE && memcmp(Rd, SlaveData, 5u) == 0);
+	Nack = OS_TRUE;
+	CHECK(I2C_Transfer(&I2C_Bus1, &XferA, 10u) == OS_ERR_PEND_ABORT && XferA.stat == I2C_STAT_NACK);
+	Nack = OS_FALSE;
+	Auto = OS_FALSE;
+
+	/* Timeout while queued: taken out of the queue, the bus left alone */
+	XferSet(&XferB, 1u, 0u, 0u);
+	XferSet(&XferC, 1u, 0u, 0u);
+	I2C_Submit(&I2C_Bus1, &XferB);
+	I2C_Submit(&I2C_Bus1, &XferC);
+	XferA.prio = 0u;
+	t = OSTime;
+	CHECK(I2C_Transfer(&I2C_Bus1, &XferA, 5u) == OS_ERR_TIMEOUT && OSTime - t == 5u);
+	CHECK(XferA.stat == I2C_STAT_TIMEOUT && sem->OSEventCnt == 0u);
+	CHECK(I2C_Bus1.cur == &XferB && I2C_Bus1.head == &XferC && XferC.next == (I2C_XFER *) 0 && Unsticks == 0u);
+
+	/* Timeout while active: DMA stopped, the bus unstuck and reset, the next transfer started */
+	Auto = OS_TRUE;		/* Finishes XferB and XferC */
+	OSTimeDly(2u);
+	Auto = OS_FALSE;
+	CHECK(XferB.stat == I2C_STAT_DONE && XferC.stat == I2C_STAT_DONE && I2C_Bus1.cur == (I2C_XFER *) 0);
+	I2C_Bus1.unstick = Unstick;
+	XferSet(&XferA, 0u, 4u, 0u);
+	XferA.sem = sem;
+	XferSet(&XferC, 1u, 0u, 0u);
+	SubmitAt = OSTime + 2u;
+	HostI2c.CCR = 0u;
+	CHECK(I2C_Transfer(&I2C_Bus1, &XferA, 5u) == OS_ERR_TIMEOUT && XferA.stat == I2C_STAT_TIMEOUT);
+	CHECK(Unsticks == 1u && sem->OSEventCnt == 0u && HostDmaRx.CCR == 0u && HostI2c.CCR == CCR_VAL);
+	CHECK(I2C_Bus1.cur == &XferC && XferC.stat == I2C_STAT_ACTIVE && I2C_Bus1.head == (I2C_XFER *) 0);
+	CHECK(HostI2c.CR1 == (I2C_CR1_PE | I2C_CR1_ACK | I2C_CR1_START) && HostI2c.CR2 == (CR2_IDLE | I2C_CR2_ITEVTEN));
+	Auto = OS_TRUE;
+	OSTimeDly(2u);
+	CHECK(XferC.stat == I2C_STAT_DONE && I2C_Bus1.cur == (I2C_XFER *) 0);
+
+	/* The descriptor can be used again */
+	CHECK(I2C_Transfer(&I2C_Bus1, &XferA, 10u) == OS_ERR_NONE && memcmp(Rd, SlaveData, 4u) == 0);
+	HostDone("i2c");
+}
+
+int main(void)
+{
+	OSInit();
+	HostI2c.CR2 = FREQ;
+	HostI2c.CCR = CCR_VAL;
+	HostI2c.TRISE = TRISE_VAL;
+	I2C_BusInit(&I2C_Bus1, &HostI2c, &HostDma, &HostDmaTx, &HostDmaRx, 7u);
+	HostIdleFnct = Idle;
+	OSTaskCreate(MainTask, (void *)0, &MainStk[255], MAIN_PRIO);
+	OSStart();
+	return (1);
+}
@@ -0,0 +1,464 @@
+/*
+ * ISO-TP (srccode/isotp.c) over the CAN driver (srccode/can.c) on a RAM stand-in for CAN1 that hears its
+ * own frames: link A sends to link B on the same bus, and a scripted peer plays the node behind link C
+ * where a test needs flow control the driver never sends.  Covered: single frames, first and consecutive
+ * frames reassembled across blocks, the receiver's BS (a flow control frame after each block) and STmin
+ * (spacing on the bus), FC WAIT up to ISOTP_WFT_MAX and past it, FC OVFLW from the peer and from a
+ * receiver whose blocks run out, the 32-bit length first frame, no flow control at all, the N_Cr timeout
+ * and a wrong sequence number, with every block back in the pool afterwards.
+ *
+ * Wire() plays the bus at 500 kbit/s in bit times: a tick is 500 bits, a frame takes 47 + 8 * dlc bits
+ * (standard ID, no stuff bits), and the mailboxes go out in request order (TXFP).  The throughput lines
+ * compare the time a message took with the bits its frames need, so they show the bus time ISO-TP and
+ * the driver leave unused; interrupt latency and the M3's own processing time are not modelled.
+ */
+
+#include <string.h>
+#include "host.h"
+#include "../srccode/can.c"
+#include "../srccode/isotp.c"
+
+#define  MAIN_PRIO      10u
+#define  ISOTP_PRIO      5u
+#define  N_RX           16u
+#define  N_TX            8u
+#define  BITS_PER_TICK 500u		/* 500 kbit/s, 1 ms ticks               */
+#define  FRAME_BITS(dlc)  (47u + 8u * (dlc))
+#define  A_RX        0x7E8u		/* A sends on 0x7E0, B on 0x7E8         */
+#define  B_RX        0x7E0u
+#define  C_RX        0x7F8u		/* The peer sends on 0x7F8, C on 0x7F0  */
+#define  C_TX        0x7F0u
+#define  LOG_MAX      1024u
+
+typedef struct {
+	INT32U at;			/* Bit time at the start of the frame   */
+	INT32U id;
+	INT8U dlc;
+	INT8U data[8];
+} WIRE_LOG;
+
+static CAN_TypeDef HostCan;
+
+static OS_STK MainStk[256];
+static CAN_FRAME Frames[N_RX + N_TX];
+static ISOTP_LINK LinkA, LinkB, LinkC;
+static void *AQTbl[2], *BQTbl[2], *CQTbl[2];
+static OS_EVENT *AQ, *BQ, *CQ;
+
+static INT32U BusBits;			/* Bit times since the start            */
+static INT32U Seq[3], SeqCtr;		/* Request order of the mailboxes       */
+static WIRE_LOG Log[LOG_MAX];
+static INT32U LogN;
+
+static INT8U PeerFs[10];		/* Flow status the peer answers a first frame with, one per tick */
+static INT8U PeerN, PeerIx;
+static BOOLEAN PeerFf;			/* The peer got a first frame           */
+
+static INT8U Data[8192];
+
+/* Standard peripheral library functions called by the driver */
+void RCC_APB1PeriphClockCmd(uint32_t periph, FunctionalState state)
+{
+}
+
+void RCC_APB2PeriphClockCmd(uint32_t periph, FunctionalState state)
+{
+}
+
+void RCC_GetClocksFreq(RCC_ClocksTypeDef * pclocks)
+{
+	pclocks->PCLK1_Frequency = 36000000u;
+}
+
+void GPIO_Init(GPIO_TypeDef * pgpio, GPIO_InitTypeDef * pinit)
+{
+}
+
+void NVIC_Init(NVIC_InitTypeDef * pinit)
+{
+}
+
+void CAN_DeInit(CAN_TypeDef * pcan)
+{
+}
+
+void CAN_StructInit(CAN_InitTypeDef * pinit)
+{
+}
+
+uint8_t CAN_Init(CAN_TypeDef * pcan, CAN_InitTypeDef * pinit)
+{
+	return (CAN_InitStatus_Success);
+}
+
+/* TSR.TMEx as the hardware keeps them, for CAN_TxLoad(): a mailbox is empty when it has no request */
+static void TsrSet(void)
+{
+	INT32U tsr;
+	INT8U i;
+
+	tsr = HostCan.TSR & ~CAN_TSR_TME;
+	for (i = 0u; i < 3u; i++) {
+		if ((HostCan.sTxMailBox[i].TIR & CAN_TI0R_TXRQ) == 0u) {
+			tsr |= CAN_TSR_TME0 << i;
+		}
+	}
+	HostCan.TSR = tsr;
+}
+
+/* Receives a frame through the filter CAN_Subscribe() set up for its ID (see tests/can.c for the banks) */
+static void Rx(INT32U id, INT8U dlc, INT8U const *data)
+{
+	CAN_FIFOMailBox_TypeDef *mb;
+	INT8U fifo;
+	INT8U k;
+
+	for (fifo = 0u; fifo < 2u; fifo++) {
+		for (k = 0u; k < CAN_FLT_BANKS * 4u; k++) {
+			if ((CAN_Bus1.fmi[fifo][k] != (CAN_SUB *) 0) && (CAN_Bus1.fmi[fifo][k]->id == id)) {
+				mb = &HostCan.sFIFOMailBox[fifo];
+				mb->RIR = id << 21;
+				mb->RDTR = dlc | ((INT32U) k << 8);
+				mb->RDLR = data[0] | ((INT32U) data[1] << 8) | ((INT32U) data[2] << 16) | ((INT32U) data[3] << 24);
+				mb->RDHR = data[4] | ((INT32U) data[5] << 8) | ((INT32U) data[6] << 16) | ((INT32U) data[7] << 24);
+				if (fifo == 0u) {
+					HostCan.RF0R = 1u;
+				} else {
+					HostCan.RF1R = 1u;
+				}
+				OSIntEnter();
+				CAN_RxIsr(&CAN_Bus1, fifo);
+				OSIntExit();
+				return;
+			}
+		}
+	}
+}
+
+/* The peer's flow control frame */
+static void PeerFc(INT8U fs)
+{
+	INT8U d[8] = { 0u };
+
+	d[0] = ISOTP_PCI_FC | fs;
+	Rx(C_RX, 3u, d);
+}
+
+/* Sends the oldest requested mailbox: log, TX interrupt, then the frame to whoever listens */
+static BOOLEAN Wire(void)
+{
+	CAN_TxMailBox_TypeDef *mb;
+	WIRE_LOG *pl;
+	WIRE_LOG l;
+	INT8U i;
+	INT8U k;
+
+	k = 3u;
+	for (i = 0u; i < 3u; i++) {	/* One mailbox empties per frame, so a new one is the newest request */
+		if ((HostCan.sTxMailBox[i].TIR & CAN_TI0R_TXRQ) != 0u) {
+			if (Seq[i] == 0u) {
+				Seq[i] = ++SeqCtr;
+			}
+			if ((k == 3u) || (Seq[i] < Seq[k])) {
+				k = i;
+			}
+		}
+	}
+	if (k == 3u) {
+		return (OS_FALSE);
+	}
+	mb = &HostCan.sTxMailBox[k];
+	l.at = BusBits;
+	l.id = mb->TIR >> 21;
+	l.dlc = (INT8U) (mb->TDTR & 0x0Fu);
+	for (i = 0u; i < 4u; i++) {
+		l.data[i] = (INT8U) (mb->TDLR >> (8u * i));
+		l.data[4u + i] = (INT8U) (mb->TDHR >> (8u * i));
+	}
+	pl = (LogN < LOG_MAX) ? &Log[LogN] : &l;
+	*pl = l;
+	LogN++;
+	BusBits += FRAME_BITS(l.dlc);
+	mb->TIR &= ~CAN_TI0R_TXRQ;
+	Seq[k] = 0u;
+	OSIntEnter();
+	HostCan.TSR |= (CAN_TSR_RQCP0 | CAN_TSR_TXOK0) << (8u * k);
+	CAN_TxIsr(&CAN_Bus1);
+	HostCan.TSR &= CAN_TSR_TME;	/* What its write-1-to-clear would have left */
+	OSIntExit();
+	if ((l.id == C_TX) && ((l.data[0] & 0xF0u) == ISOTP_PCI_FF)) {
+		PeerFf = OS_TRUE;
+		PeerIx = 0u;
+	}
+	Rx(l.id, l.dlc, l.data);
+	return (OS_TRUE);
+}
+
+/* One tick of bus time, then the tick: the peer answers a first frame one flow control frame per tick */
+static void Idle(void)
+{
+	INT32U end;
+
+	end = (OSTime + 1u) * BITS_PER_TICK;
+	while ((BusBits < end) && (Wire() == OS_TRUE)) {
+	}
+	if (BusBits < end) {
+		BusBits = end;
+	}
+	if ((PeerFf == OS_TRUE) && (PeerIx < PeerN)) {
+		PeerFc(PeerFs[PeerIx++]);
+	}
+	HostTick();
+}
+
+static void Peer(INT8U const *fs, INT8U n)
+{
+	memcpy(PeerFs, fs, n);
+	PeerN = n;
+	PeerFf = OS_FALSE;
+}
+
+static INT16U MemFree(void)
+{
+	OS_MEM_DATA d;
+
+	(void)OSMemQuery(ISOTP_Mem, &d);
+	return ((INT16U) d.OSNFree);
+}
+
+/* The next message in 'q' is Data[0..len-1] */
+static void Recv(OS_EVENT * q, INT32U len)
+{
+	ISOTP_BUF *pbuf, *p;
+	INT32U off;
+	INT8U err;
+
+	pbuf = (ISOTP_BUF *) OSQPend(q, 100u, &err);
+	CHECK(pbuf != (ISOTP_BUF *) 0 && ISOTP_BufLen(pbuf) == len);
+	for (p = pbuf, off = 0u; p != (ISOTP_BUF *) 0; off += p->len, p = p->next) {
+		CHECK(p->len <= ISOTP_BUF_CAP && memcmp(ISOTP_BUF_DATA(p), &Data[off], p->len) == 0);
+	}
+	ISOTP_BufFree(pbuf);
+}
+
+static INT32U Count(INT32U id)
+{
+	INT32U i, n;
+
+	for (i = 0u, n = 0u; i < LogN; i++) {
+		n += (Log[i].id == id) ? 1u : 0u;
+	}
+	return (n);
+}
+
+/* Sends 'len' bytes from A to B and reports the throughput; returns the bus time taken */
+static INT32U Throughput(INT32U len, INT8U bs, INT8U st)
+{
+	INT32U t0, t, busy, i;
+
+	LinkB.bs = bs;
+	LinkB.stmin = st;
+	LogN = 0u;
+	t0 = BusBits;
+	CHECK(ISOTP_Send(&LinkA, Data, len, 100u) == ISOTP_ERR_NONE);
+	Recv(BQ, len);
+	t = BusBits - t0;
+	for (i = 0u, busy = 0u; i < LogN; i++) {
+		busy += FRAME_BITS(Log[i].dlc);
+	}
+	printf("isotp: %lu bytes, BS %u, STmin %u: %lu frames, %.1f ms, %.1f kB/s, bus %.1f%% busy\n",
+	       (unsigned long)len, bs, st, (unsigned long)LogN, t / (BITS_PER_TICK * 1.0), len / (t / 500.0),
+	       100.0 * busy / t);
+	LinkB.bs = 0u;
+	LinkB.stmin = 0u;
+	return (t);
+}
+
+static void MainTask(void *p_arg)
+{
+	static INT8U const wait2[] = { ISOTP_FS_WAIT, ISOTP_FS_WAIT, ISOTP_FS_CTS };
+	static INT8U const wait8[] = { 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, ISOTP_FS_CTS };
+	static INT8U const wait9[] = { 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, ISOTP_FS_CTS };
+	static INT8U const ovflw[] = { ISOTP_FS_OVFLW };
+	INT8U d[8];
+	INT32U t, n, i;
+
+	(void)p_arg;
+
+	/* Single frames; an empty message is refused */
+	CHECK(ISOTP_Send(&LinkA, Data, 0u, 100u) == ISOTP_ERR_LEN);
+	CHECK(ISOTP_Send(&LinkA, Data, 7u, 100u) == ISOTP_ERR_NONE);
+	Recv(BQ, 7u);
+	CHECK(LogN == 1u && Log[0].id == B_RX && Log[0].dlc == 8u && Log[0].data[0] == 0x07u);
+	CHECK(Log[0].data[1] == Data[0] && Log[0].data[7] == Data[6]);
+	CHECK(ISOTP_Send(&LinkB, Data, 3u, 100u) == ISOTP_ERR_NONE);
+	Recv(AQ, 3u);
+	CHECK(LogN == 2u && Log[1].id == A_RX && Log[1].dlc == 4u && Log[1].data[0] == 0x03u);
+
+	/* Eight bytes: first frame, flow control, one consecutive frame */
+	LogN = 0u;
+	CHECK(ISOTP_Send(&LinkA, Data, 8u, 100u) == ISOTP_ERR_NONE);
+	Recv(BQ, 8u);
+	CHECK(LogN == 3u);
+	CHECK(Log[0].id == B_RX && Log[0].dlc == 8u && Log[0].data[0] == 0x10u && Log[0].data[1] == 8u);
+	CHECK(Log[1].id == A_RX && Log[1].dlc == 3u && Log[1].data[0] == 0x30u && Log[1].data[1] == 0u);
+	CHECK(Log[2].id == B_RX && Log[2].dlc == 3u && Log[2].data[0] == 0x21u && Log[2].data[2] == Data[7]);
+
+	/* 1000 bytes over five blocks, sequence numbers wrapping 15 -> 0, no further flow control */
+	LogN = 0u;
+	CHECK(ISOTP_Send(&LinkA, Data, 1000u, 100u) == ISOTP_ERR_NONE);
+	Recv(BQ, 1000u);
+	n = (1000u - 6u + 6u) / 7u;
+	CHECK(LogN == 2u + n && Count(A_RX) == 1u);
+	for (i = 0u; i < n; i++) {
+		CHECK(Log[2u + i].data[0] == (0x20u | ((i + 1u) & 0x0Fu)));
+	}
+	CHECK(Log[LogN - 1u].dlc == 1u + (1000u - 6u) - 7u * (n - 1u));
+	CHECK(MemFree() == ISOTP_BLK_NBR && LinkB.rx_msg_ctr == 3u && LinkA.tx_msg_ctr == 3u);
+
+	/* Throughput with back-to-back frames: the bus never idles, each frame carries 7 of its 8 bytes */
+	t = Throughput(4095u, 0u, 0u);
+	CHECK(LogN == 1u + 1u + 585u);
+	CHECK(t == FRAME_BITS(8u) + FRAME_BITS(3u) + 584u * FRAME_BITS(8u) + FRAME_BITS(2u));
+
+	/* BS 8: the receiver asks for each block of eight, except after the last frame */
+	t = Throughput(4095u, 8u, 0u);
+	CHECK(LogN == 1u + 74u + 585u && Count(A_RX) == 74u);
+	for (i = 0u, n = 0u; i < LogN; i++) {
+		if (Log[i].id == A_RX) {
+			CHECK(i == 1u || n == 8u);
+			CHECK(Log[i].data[1] == 8u);
+			n = 0u;
+		} else if ((Log[i].data[0] & 0xF0u) == ISOTP_PCI_CF) {
+			n++;
+		}
+	}
+	CHECK(t == FRAME_BITS(8u) + 74u * FRAME_BITS(3u) + 584u * FRAME_BITS(8u) + FRAME_BITS(2u));
+
+	/* STmin 5 ms: consecutive frames at least 5 ms apart; STmin 1 ms over a long message */
+	LinkB.stmin = 5u;
+	LogN = 0u;
+	CHECK(ISOTP_Send(&LinkA, Data, 50u, 100u) == ISOTP_ERR_NONE);
+	Recv(BQ, 50u);
+	LinkB.stmin = 0u;
+	CHECK(LogN == 2u + 7u && Log[1].data[2] == 5u);
+	for (i = 3u; i < LogN; i++) {
+		CHECK(Log[i].at - Log[i - 1u].at >= 5u * BITS_PER_TICK);
+	}
+	t = Throughput(4095u, 0u, 1u);
+	for (i = 3u; i < LogN; i++) {
+		CHECK(Log[i].at - Log[i - 1u].at >= BITS_PER_TICK);
+	}
+	CHECK(t >= 584u * BITS_PER_TICK);
+
+	/* Longer than 4095 bytes: first frame with a 32-bit length */
+	LogN = 0u;
+	CHECK(ISOTP_Send(&LinkA, Data, 5000u, 100u) == ISOTP_ERR_NONE);
+	Recv(BQ, 5000u);
+	CHECK(Log[0].data[0] == 0x10u && Log[0].data[1] == 0u && Log[0].data[2] == 0u && Log[0].data[3] == 0u);
+	CHECK(Log[0].data[4] == (5000u >> 8) && Log[0].data[5] == (5000u & 0xFFu));
+	CHECK(Log[0].data[6] == Data[0] && Log[0].data[7] == Data[1]);
+	CHECK(Log[2].data[0] == 0x21u && Log[2].data[1] == Data[2]);
+	CHECK(LogN == 2u + (5000u - 2u + 6u) / 7u && MemFree() == ISOTP_BLK_NBR);
+
+	/* More than the receiver's blocks hold: it answers OVFLW and keeps nothing */
+	LogN = 0u;
+	CHECK(ISOTP_Send(&LinkA, Data, ISOTP_BLK_NBR * ISOTP_BUF_CAP + 1u, 100u) == ISOTP_ERR_OVFLW);
+	CHECK(LogN == 2u && Log[1].data[0] == 0x32u && LinkB.rx_err_ctr == 1u);
+	CHECK(MemFree() == ISOTP_BLK_NBR && LinkB.rx_head == (ISOTP_BUF *) 0 && LinkA.fc_wait == OS_FALSE);
+
+	/* The peer's FC WAIT: two, then clear to send */
+	Peer(wait2, sizeof(wait2));
+	LogN = 0u;
+	t = OSTimeGet();
+	CHECK(ISOTP_Send(&LinkC, Data, 20u, 100u) == ISOTP_ERR_NONE);
+	CHECK(OSTimeGet() - t >= 2u && LinkC.tx_msg_ctr == 1u);
+	OSTimeDly(2u);			/* ISOTP_Send() returns with the last frames queued */
+	CHECK(LogN == 1u + 2u && Log[1].data[0] == 0x21u && Log[2].data[0] == 0x22u && Log[2].dlc == 8u);
+
+	/* ISOTP_WFT_MAX WAITs are allowed, one more ends the message */
+	Peer(wait8, sizeof(wait8));
+	CHECK(ISOTP_Send(&LinkC, Data, 20u, 100u) == ISOTP_ERR_NONE);
+	Peer(wait9, sizeof(wait9));
+	CHECK(ISOTP_Send(&LinkC, Data, 20u, 100u) == ISOTP_ERR_WFT);
+	CHECK(LinkC.fc_wait == OS_FALSE && LinkC.tx_busy == OS_FALSE && LinkC.tx_msg_ctr == 2u);
+	OSTimeDly(2u);			/* The peer's late CTS is ignored        */
+
+	/* The peer's OVFLW, and no flow control at all */
+	Peer(ovflw, sizeof(ovflw));
+	LogN = 0u;
+	CHECK(ISOTP_Send(&LinkC, Data, 20u, 100u) == ISOTP_ERR_OVFLW && LogN == 1u);
+	Peer(ovflw, 0u);
+	t = OSTimeGet();
+	CHECK(ISOTP_Send(&LinkC, Data, 20u, 50u) == ISOTP_ERR_TIMEOUT && OSTimeGet() - t == 50u);
+	CHECK(LinkC.fc_wait == OS_FALSE && LinkC.tx_busy == OS_FALSE && LinkC.tx_msg_ctr == 2u);
+	PeerFc(ISOTP_FS_CTS);
+	CHECK(OSSemAccept(LinkC.fc_sem) == 0u);
+
+	/* N_Cr: the peer stops after one consecutive frame; C gives up ISOTP_TIMEOUT ticks later */
+	memset(d, 0, sizeof(d));
+	d[0] = 0x10u;
+	d[1] = 20u;
+	memcpy(&d[2], Data, 6u);
+	LogN = 0u;
+	Rx(C_RX, 8u, d);
+	CHECK(LinkC.rx_head != (ISOTP_BUF *) 0 && MemFree() == ISOTP_BLK_NBR - 1u);
+	d[0] = 0x21u;
+	memcpy(&d[1], &Data[6], 7u);
+	Rx(C_RX, 8u, d);
+	OSTimeDly(ISOTP_TIMEOUT - 1u);
+	CHECK(LogN == 1u && Log[0].id == C_TX && Log[0].data[0] == 0x30u);
+	CHECK(LinkC.rx_head != (ISOTP_BUF *) 0 && LinkC.rx_err_ctr == 0u);
+	OSTimeDly(1u);
+	CHECK(LinkC.rx_head == (ISOTP_BUF *) 0 && LinkC.rx_err_ctr == 1u && MemFree() == ISOTP_BLK_NBR);
+	d[0] = 0x22u;			/* The rest comes too late: ignored     */
+	Rx(C_RX, 8u, d);
+	CHECK(LinkC.rx_err_ctr == 1u && LinkC.rx_msg_ctr == 0u && MemFree() == ISOTP_BLK_NBR);
+
+	/* A wrong sequence number ends the message; the next one arrives whole */
+	d[0] = 0x10u;
+	d[1] = 20u;
+	memcpy(&d[2], Data, 6u);
+	Rx(C_RX, 8u, d);
+	d[0] = 0x22u;
+	Rx(C_RX, 8u, d);
+	CHECK(LinkC.rx_head == (ISOTP_BUF *) 0 && LinkC.rx_err_ctr == 2u && MemFree() == ISOTP_BLK_NBR);
+	d[0] = 0x10u;
+	d[1] = 20u;
+	memcpy(&d[2], Data, 6u);
+	Rx(C_RX, 8u, d);
+	for (i = 0u; i < 2u; i++) {
+		d[0] = (INT8U) (0x21u + i);
+		memcpy(&d[1], &Data[6u + 7u * i], 7u);
+		Rx(C_RX, 8u, d);
+	}
+	Recv(CQ, 20u);
+	CHECK(LinkC.rx_msg_ctr == 1u && LinkC.rx_err_ctr == 2u);
+
+	CHECK(MemFree() == ISOTP_BLK_NBR && CAN_Bus1.tx_err_ctr == 0u && CAN_Bus1.nomem_ctr == 0u);
+	HostDone("isotp");
+}
+
+int main(void)
+{
+	INT32U i;
+
+	for (i = 0u; i < sizeof(Data); i++) {
+		Data[i] = (INT8U) (i * 7u + (i >> 8));
+	}
+	OSInit();
+	CAN_BusInit(&CAN_Bus1, &HostCan, Frames, N_RX, N_TX);
+	HostCan.TSR = 0u;
+	HostCritFnct = TsrSet;
+	ISOTP_Init(ISOTP_PRIO);
+	AQ = OSQCreate(AQTbl, 2u);
+	BQ = OSQCreate(BQTbl, 2u);
+	CQ = OSQCreate(CQTbl, 2u);
+	(void)ISOTP_LinkAdd(&LinkA, &CAN_Bus1, A_RX, B_RX, 0u, 0u, AQ);
+	(void)ISOTP_LinkAdd(&LinkB, &CAN_Bus1, B_RX, A_RX, 0u, 0u, BQ);
+	(void)ISOTP_LinkAdd(&LinkC, &CAN_Bus1, C_RX, C_TX, 0u, 0u, CQ);
+	HostIdleFnct = Idle;
+	OSTaskCreate(MainTask, (void *)0, &MainStk[255], MAIN_PRIO);
+	OSStart();
+	return (1);
+}
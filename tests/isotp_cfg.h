@@ -0,0 +1,8 @@
+#undef  OS_TASK_STAT_EN
+#define OS_TASK_STAT_EN           0u
+#undef  OS_MEM_EN
+#define OS_MEM_EN                 1u
+#undef  OS_MAX_QS
+#define OS_MAX_QS                 8u
+#undef  OS_MAX_EVENTS
+#define OS_MAX_EVENTS            16u
@@ -0,0 +1,140 @@
+/*
+ * Run-to-completion jobs (OS_JOB_EN): messages to the jobs of a level are handled one at a time in the
+ * order posted, a higher level preempts a lower one (and the task posting to it) but never a job of
+ * its own level, OSJobPost() on a full queue fails without losing what is queued, and a post from an
+ * ISR runs the job only once the ISR exits.  Also the argument checks of OSJobLvlCreate().
+ */
+
+#include "host.h"
+
+#define  HI_PRIO      1u
+#define  MAIN_PRIO    2u
+#define  LO_PRIO      8u
+#define  LO_Q_SIZE    4u
+#define  TRACE_MAX   32u
+
+static OS_STK MainStk[256], HiStk[128], LoStk[128];
+static OS_JOB_LVL HiLvl, LoLvl;
+static OS_JOB_MSG HiQ[4], LoQ[LO_Q_SIZE];
+static OS_JOB JobA, JobB, JobC, JobD;
+static INT32U Trace[TRACE_MAX];		/* Job tag * 100 + message, in the order run */
+static INT32U TraceNbr;
+static INT32U DNbr;
+
+static void TraceAdd(INT32U tag, void *pmsg)
+{
+	CHECK(TraceNbr < TRACE_MAX);
+	Trace[TraceNbr++] = tag * 100u + (INT32U) (uintptr_t) pmsg;
+}
+
+static BOOLEAN TraceIs(const INT32U * p, INT32U n)
+{
+	INT32U i;
+
+	if (TraceNbr != n) {
+		return (OS_FALSE);
+	}
+	for (i = 0u; i < n; i++) {
+		if (Trace[i] != p[i]) {
+			return (OS_FALSE);
+		}
+	}
+	TraceNbr = 0u;
+	return (OS_TRUE);
+}
+
+static void JobFnct(void *p_arg, void *pmsg)
+{
+	TraceAdd((INT32U) (uintptr_t) p_arg, pmsg);
+}
+
+static void JobDFnct(void *p_arg, void *pmsg)	/* Posts to its own level, then to HI */
+{
+	(void)p_arg;
+	TraceAdd(4u, pmsg);
+	if (DNbr++ == 0u) {
+		CHECK(OSJobPost(&JobA, (void *)9) == OS_ERR_NONE);
+		CHECK(OSJobPost(&JobC, (void *)9) == OS_ERR_NONE);
+	}
+	TraceAdd(4u, (void *)99);		/* Still in this job after C          */
+}
+
+static void MainTask(void *p_arg)
+{
+	static const INT32U fifo[] = { 101u, 201u, 102u, 202u };
+	static const INT32U prio[] = { 301u, 101u };
+	static const INT32U nest[] = { 401u, 309u, 499u, 109u };
+	static const INT32U isr[] = { 305u };
+	static const INT32U full[] = { 111u, 112u, 113u, 114u, 115u };
+	static OS_JOB_LVL lvl;
+	static OS_JOB_MSG q[2];
+	static OS_STK stk[64];
+	INT32U i;
+
+	(void)p_arg;
+	CHECK(OSJobLvlCreate(&lvl, 20u, &stk[0], 64u, &q[0], 0u) == OS_ERR_JOB_INVALID_SIZE);
+	CHECK(OSJobLvlCreate(&lvl, 20u, &stk[0], 0u, &q[0], 2u) == OS_ERR_JOB_INVALID_SIZE);
+	CHECK(OSJobLvlCreate(&lvl, 20u, (OS_STK *) 0, 64u, &q[0], 2u) == OS_ERR_PDATA_NULL);
+	CHECK(OSJobLvlCreate(&lvl, MAIN_PRIO, &stk[0], 64u, &q[0], 2u) == OS_ERR_PRIO_EXIST);
+	OSIntEnter();
+	CHECK(OSJobLvlCreate(&lvl, 20u, &stk[0], 64u, &q[0], 2u) == OS_ERR_CREATE_ISR);
+	OSIntExit();
+	CHECK(OSJobCreate(&JobA, (OS_JOB_LVL *) 0, JobFnct, (void *)1) == OS_ERR_PDATA_NULL);
+	CHECK(OSJobPost((OS_JOB *) 0, (void *)0) == OS_ERR_PDATA_NULL);
+
+	CHECK(OSJobLvlCreate(&HiLvl, HI_PRIO, &HiStk[0], 128u, &HiQ[0], 4u) == OS_ERR_NONE);
+	CHECK(OSJobLvlCreate(&LoLvl, LO_PRIO, &LoStk[0], 128u, &LoQ[0], LO_Q_SIZE) == OS_ERR_NONE);
+	CHECK(OSJobCreate(&JobA, &LoLvl, JobFnct, (void *)1) == OS_ERR_NONE);
+	CHECK(OSJobCreate(&JobB, &LoLvl, JobFnct, (void *)2) == OS_ERR_NONE);
+	CHECK(OSJobCreate(&JobC, &HiLvl, JobFnct, (void *)3) == OS_ERR_NONE);
+	CHECK(OSJobCreate(&JobD, &LoLvl, JobDFnct, (void *)4) == OS_ERR_NONE);
+
+	/* FIFO within a level, across jobs */
+	CHECK(OSJobPost(&JobA, (void *)1) == OS_ERR_NONE);
+	CHECK(OSJobPost(&JobB, (void *)1) == OS_ERR_NONE);
+	CHECK(OSJobPost(&JobA, (void *)2) == OS_ERR_NONE);
+	CHECK(OSJobPost(&JobB, (void *)2) == OS_ERR_NONE);
+	CHECK(TraceNbr == 0u && LoLvl.OSJobLvlEntries == 4u);	/* LO is below Main   */
+	OSTimeDly(1u);
+	CHECK(TraceIs(fifo, 4u) && LoLvl.OSJobLvlEntries == 0u);
+
+	/* Between levels: HI preempts the task posting to it, LO waits */
+	CHECK(OSJobPost(&JobA, (void *)1) == OS_ERR_NONE);
+	CHECK(OSJobPost(&JobC, (void *)1) == OS_ERR_NONE);
+	CHECK(TraceNbr == 1u && Trace[0] == 301u);
+	OSTimeDly(1u);
+	CHECK(TraceIs(prio, 2u));
+
+	/* A job posting to its own level runs after it, one posting to HI is preempted by it */
+	CHECK(OSJobPost(&JobD, (void *)1) == OS_ERR_NONE);
+	OSTimeDly(1u);
+	CHECK(TraceIs(nest, 4u));
+
+	/* Posted from an ISR: runs on the way out of the ISR, not inside it */
+	OSIntEnter();
+	CHECK(OSJobPost(&JobC, (void *)5) == OS_ERR_NONE);
+	CHECK(TraceNbr == 0u && HiLvl.OSJobLvlEntries == 1u);
+	OSIntExit();
+	CHECK(TraceIs(isr, 1u));
+
+	/* Full queue: the post fails, nothing queued is lost */
+	for (i = 1u; i <= LO_Q_SIZE; i++) {
+		CHECK(OSJobPost(&JobA, (void *)(uintptr_t) (10u + i)) == OS_ERR_NONE);
+	}
+	CHECK(OSJobPost(&JobA, (void *)99) == OS_ERR_Q_FULL);
+	CHECK(OSJobPost(&JobB, (void *)99) == OS_ERR_Q_FULL);
+	CHECK(LoLvl.OSJobLvlEntries == LO_Q_SIZE && LoLvl.OSJobLvlEntriesMax == LO_Q_SIZE);
+	OSTimeDly(1u);
+	CHECK(OSJobPost(&JobA, (void *)15) == OS_ERR_NONE);	/* Room again        */
+	OSTimeDly(1u);
+	CHECK(TraceIs(full, 5u));
+	HostDone("job");
+}
+
+int main(void)
+{
+	OSInit();
+	OSTaskCreate(MainTask, (void *)0, &MainStk[255], MAIN_PRIO);
+	OSStart();
+	return (1);
+}
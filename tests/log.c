@@ -0,0 +1,137 @@
+/*
+ * Binary log (srccode/log.c): the record layout, the drain by the log task, records wrapping around the
+ * ring, drops when it is full, and the exclusive accesses of LOG_Put() when an interrupt logs between
+ * its LDREX and STREX, both while reserving space and while counting a drop.
+ *
+ * OS_CPU_STREX() is replaced so that a test can make one store fail after running an "interrupt", as
+ * the exception entry clears the exclusive monitor on the target.
+ */
+
+#include <string.h>
+#include "host.h"
+
+static volatile void *StrexFailAt;	/* Address of the store to fail       */
+static void (*StrexIsr) (void);	/* Runs before it fails               */
+static INT32U StrexFails;
+
+static INT32U HostStrex(volatile void *p)
+{
+	if (p != StrexFailAt) {
+		return (0u);
+	}
+	StrexFailAt = (void *)0;
+	StrexFails++;
+	OSIntEnter();
+	StrexIsr();
+	OSIntExit();
+	return (1u);
+}
+
+#undef   OS_CPU_STREX
+#define  OS_CPU_STREX(v, p)   ((HostStrex(p) != 0u) ? 1u : (*(p) = (__typeof__(*(p)))(v), 0u))
+
+#include "../srccode/log.c"
+
+#define  MAIN_PRIO    5u
+
+static OS_STK MainStk[256];
+static INT32U Out[1024];
+static INT32U OutLen;		/* Words sent                         */
+
+static char const FmtA[] = "a %d %d";
+static char const FmtIsr[] = "isr";
+static char const FmtFull[] = "%d %d %d %d";
+
+INT16U DEV_WriteAll(INT8U const *pbuf, INT16U len)	/* Only the locked write is linked in */
+{
+	CHECK((len & 3u) == 0u);
+	memcpy(&Out[OutLen], pbuf, len);
+	OutLen += len / 4u;
+	return (len);
+}
+
+static void IsrLog(void)
+{
+	LOG0(FmtIsr);
+}
+
+static void IsrLogFull(void)
+{
+	LOG4(FmtFull, 9u, 9u, 9u, 9u);
+}
+
+static BOOLEAN RingClear(void)
+{
+	INT32U i;
+
+	for (i = 0u; i < LOG_BUF_SIZE; i++) {
+		if (LOG_Buf[i] != 0u) {
+			return (OS_FALSE);
+		}
+	}
+	return (OS_TRUE);
+}
+
+static void MainTask(void *p_arg)
+{
+	INT32U i;
+	INT32U n;
+
+	(void)p_arg;
+	LOG_Init(LOG_TASK_PRIO);
+
+	/* Header (written last), format address, timestamp, arguments */
+	LOG2(FmtA, 1u, 0xFFFFFFFFuL);
+	CHECK(LOG_Head == 5u && LOG_Tail == 0u);
+	CHECK(LOG_Buf[0] == (LOG_SYNC | (MAIN_PRIO << 8) | 2u));
+	CHECK(LOG_Buf[1] == (INT32U) FmtA && LOG_Buf[3] == 1u && LOG_Buf[4] == 0xFFFFFFFFuL);
+	OSTimeDly(LOG_DRAIN_DLY + 1u);
+	CHECK(OutLen == 5u && Out[0] == (LOG_SYNC | (MAIN_PRIO << 8) | 2u) && Out[1] == (INT32U) FmtA);
+	CHECK(LOG_Tail == 5u && RingClear() == OS_TRUE);
+
+	/* An interrupt that logs between LDREX and STREX gets its record first, both are complete */
+	StrexFailAt = &LOG_Head;
+	StrexIsr = IsrLog;
+	LOG1(FmtA, 7u);
+	CHECK(StrexFails == 1u && LOG_Head == 5u + 3u + 4u);
+	CHECK(LOG_Buf[5] == (LOG_SYNC | (MAIN_PRIO << 8)) && LOG_Buf[6] == (INT32U) FmtIsr);
+	CHECK(LOG_Buf[8] == (LOG_SYNC | (MAIN_PRIO << 8) | 1u) && LOG_Buf[11] == 7u);
+	OSTimeDly(LOG_DRAIN_DLY + 1u);
+	CHECK(OutLen == 12u && Out[6] == (INT32U) FmtIsr && Out[9] == (INT32U) FmtA && Out[11] == 7u);
+	CHECK(RingClear() == OS_TRUE);
+
+	/* Full ring: 36 records of 7 words fit in 256 (the 35th wraps around the end), the 37th is dropped */
+	for (i = 0u; i < 37u; i++) {
+		LOG4(FmtFull, i, i, i, i);
+	}
+	CHECK(LOG_Tail + 34u * 7u == 250u);
+	CHECK(LOG_Head - LOG_Tail == 36u * 7u && LOG_DropCtr == 1u);
+
+	/* A drop counted in an interrupt between the LDREX and STREX of a task's drop isn't lost */
+	StrexFailAt = &LOG_DropCtr;
+	StrexIsr = IsrLogFull;
+	LOG4(FmtFull, 0u, 0u, 0u, 0u);
+	CHECK(StrexFails == 2u && LOG_DropCtr == 3u);
+	OSIntEnter();
+	LOG4(FmtFull, 0u, 0u, 0u, 0u);
+	OSIntExit();
+	CHECK(LOG_DropCtr == 4u);
+
+	/* Drain */
+	OutLen = 0u;
+	OSTimeDly(LOG_DRAIN_DLY + 1u);
+	CHECK(OutLen == 36u * 7u && RingClear() == OS_TRUE);
+	for (i = 0u, n = 0u; i < 36u; i++, n += 7u) {
+		CHECK(Out[n] == (LOG_SYNC | (MAIN_PRIO << 8) | 4u) && Out[n + 1u] == (INT32U) FmtFull);
+		CHECK(Out[n + 3u] == i && Out[n + 6u] == i);
+	}
+	HostDone("log");
+}
+
+int main(void)
+{
+	OSInit();
+	OSTaskCreate(MainTask, (void *)0, &MainStk[255], MAIN_PRIO);
+	OSStart();
+	return (1);
+}
@@ -0,0 +1,124 @@
+/*
+ * Periodic tasks (OSTimeDlyUntil(), OSTaskPeriodSet()): release points kept in phase by a job that runs
+ * past one or two of them, with OS_ERR_TIME_OVERRUN and the skipped count, a job that ends exactly on the
+ * next release point, and the statistics read back with OSTaskQuery(): jobs, overruns, the worst response
+ * time and the worst release jitter, caused by a higher priority task running when a job is released.
+ * Also the argument and state errors, and that OSTaskPeriodSet() clears the statistics or turns them off.
+ */
+
+#include "host.h"
+
+#define  MAIN_PRIO    2u
+#define  HOG_PRIO     5u
+#define  P_PRIO      10u
+#define  PERIOD      10u
+#define  N_JOBS       7u
+
+static OS_STK MainStk[128], HogStk[128], PStk[128];
+static INT32U T0;			/* Release point of the first job     */
+static INT8U Done;
+
+/* Cost, release point (from T0) of the next job and OSTimeDlyUntil()'s result, job by job */
+static INT32U const Cost[N_JOBS] = { 2u, 2u, 13u, 25u, 2u, 10u, 1u };
+static INT32U const Next[N_JOBS] = { 10u, 20u, 40u, 70u, 80u, 90u, 100u };
+static INT8U const Ret[N_JOBS] = {
+	OS_ERR_NONE, OS_ERR_NONE, OS_ERR_TIME_OVERRUN, OS_ERR_TIME_OVERRUN, OS_ERR_NONE, OS_ERR_NONE, OS_ERR_NONE
+};
+
+/* Expected statistics after each job */
+static INT32U const Overrun[N_JOBS] = { 0u, 0u, 1u, 3u, 3u, 3u, 3u };
+static INT32U const RespMax[N_JOBS] = { 2u, 2u, 13u, 25u, 25u, 25u, 25u };
+static INT32U const JitterMax[N_JOBS] = { 0u, 0u, 0u, 3u, 3u, 3u, 3u };
+
+static void Work(INT32U ticks)
+{
+	INT32U i;
+
+	for (i = 0u; i < ticks; i++) {	/* Run for 'ticks' ticks of CPU time  */
+		HostTick();
+	}
+}
+
+/* Runs when the fifth job is released (T0 + 70), and makes it 3 ticks late */
+static void HogTask(void *p_arg)
+{
+	(void)p_arg;
+	OSTimeDly(70u);
+	Work(3u);
+	OSTaskSuspend(OS_PRIO_SELF);
+}
+
+static void PTask(void *p_arg)
+{
+	OS_TCB tcb;
+	INT32U rel;
+	INT8U j;
+
+	(void)p_arg;
+	CHECK(OSTaskPeriodSet(OS_PRIO_SELF, PERIOD) == OS_ERR_NONE);
+	rel = OSTimeGet();
+	T0 = rel;
+	OSTaskCreate(HogTask, (void *)0, &HogStk[127], HOG_PRIO);
+	for (j = 0u; j < N_JOBS; j++) {
+		Work(Cost[j]);
+		CHECK(OSTimeDlyUntil(&rel, PERIOD) == Ret[j]);
+		CHECK(rel == T0 + Next[j]);
+		CHECK(OSTimeGet() == rel + ((j == 3u) ? 3u : 0u));
+		CHECK(OSTaskQuery(OS_PRIO_SELF, &tcb) == OS_ERR_NONE);
+		CHECK(tcb.OSTCBPeriod == PERIOD && tcb.OSTCBPeriodCtr == j + 1u);
+		CHECK(tcb.OSTCBPeriodOverrun == Overrun[j]);
+		CHECK(tcb.OSTCBPeriodRespMax == RespMax[j]);
+		CHECK(tcb.OSTCBPeriodJitterMax == JitterMax[j]);
+	}
+	Done = OS_TRUE;
+
+	/* Registered again: fresh statistics; period 0: none kept, the release points still kept */
+	CHECK(OSTaskPeriodSet(OS_PRIO_SELF, PERIOD) == OS_ERR_NONE);
+	CHECK(OSTaskQuery(OS_PRIO_SELF, &tcb) == OS_ERR_NONE);
+	CHECK(tcb.OSTCBPeriodCtr == 0u && tcb.OSTCBPeriodOverrun == 0u);
+	CHECK(tcb.OSTCBPeriodRespMax == 0u && tcb.OSTCBPeriodJitterMax == 0u);
+	CHECK(OSTaskPeriodSet(OS_PRIO_SELF, 0u) == OS_ERR_NONE);
+	Work(15u);
+	CHECK(OSTimeDlyUntil(&rel, PERIOD) == OS_ERR_TIME_OVERRUN && rel == T0 + 120u);
+	CHECK(OSTaskQuery(OS_PRIO_SELF, &tcb) == OS_ERR_NONE);
+	CHECK(tcb.OSTCBPeriodCtr == 0u && tcb.OSTCBPeriodOverrun == 0u && tcb.OSTCBPeriodRespMax == 0u);
+	OSTaskSuspend(OS_PRIO_SELF);
+}
+
+static void MainTask(void *p_arg)
+{
+	INT32U rel;
+
+	(void)p_arg;
+
+	/* Errors */
+	rel = OSTimeGet();
+	CHECK(OSTimeDlyUntil((INT32U *) 0, PERIOD) == OS_ERR_PDATA_NULL);
+	CHECK(OSTimeDlyUntil(&rel, 0u) == OS_ERR_TIME_ZERO_DLY);
+	OSSchedLock();
+	CHECK(OSTimeDlyUntil(&rel, PERIOD) == OS_ERR_SCHED_LOCKED);
+	OSSchedUnlock();
+	OSIntEnter();
+	CHECK(OSTimeDlyUntil(&rel, PERIOD) == OS_ERR_TIME_DLY_ISR);
+	OSIntExit();
+	CHECK(rel == OSTimeGet());
+	CHECK(OSTaskPeriodSet(OS_LOWEST_PRIO + 1u, PERIOD) == OS_ERR_PRIO_INVALID);
+	CHECK(OSTaskPeriodSet(P_PRIO, PERIOD) == OS_ERR_TASK_NOT_EXIST);
+
+	/* An unregistered task keeps its phase too, without statistics */
+	CHECK(OSTimeDlyUntil(&rel, PERIOD) == OS_ERR_NONE && OSTimeGet() == rel);
+	CHECK(OSTCBCur->OSTCBPeriodCtr == 0u);
+
+	OSTaskCreate(PTask, (void *)0, &PStk[127], P_PRIO);
+	OSTimeDly(150u);
+	CHECK(Done == OS_TRUE && OSTCBPrioTbl[P_PRIO]->OSTCBStat == OS_STAT_SUSPEND);
+	HostDone("period");
+}
+
+int main(void)
+{
+	OSInit();
+	OSTaskCreate(MainTask, (void *)0, &MainStk[127], MAIN_PRIO);
+	OSStart();
+	return (1);
+}
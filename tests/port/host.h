@@ -0,0 +1,41 @@
+/*
+*********************************************************************************************************
+*                                           HOST TEST SUPPORT
+*
+* Tasks of a host test run on ucontext stacks switched by OSCtxSw()/OSIntCtxSw().  The idle task plays
+* the tick interrupt: each pass through App_TaskIdleHook() calls HostTick() (or HostIdleFnct, when set),
+* so time only advances while every task is blocked.  A test ends by calling HostDone() from a task.
+*********************************************************************************************************
+*/
+
+#ifndef  HOST_H
+#define  HOST_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <ucos_ii.h>
+
+#define  CHECK(c)   do {                                                                              \
+                        HostChecks++;                                                                 \
+                        if (!(c)) {                                                                   \
+                            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #c);              \
+                            exit(1);                                                                  \
+                        }                                                                             \
+                    } while (0)
+
+extern INT32U   HostChecks;                       /* Number of CHECK()s passed                         */
+extern INT32U   HostTickLimit;                    /* OSTime at which a stuck test is failed            */
+extern INT32U   HostSwCtr;                        /* Number of context switches                        */
+extern INT32U   HostCritCtr;                      /* Number of critical sections entered               */
+extern INT32U   HostStkOvfCtr;                    /* Number of OSTaskStkOvfHook() calls                */
+extern OS_TCB  *HostStkOvfTcb;                    /* TCB passed to the last OSTaskStkOvfHook()         */
+
+extern void   (*HostIdleFnct)(void);              /* Replaces HostTick() in the idle task              */
+extern void   (*HostSwFnct)(void);                /* Called by OSTaskSwHook()                          */
+extern void   (*HostCritFnct)(void);              /* Called by OS_CPU_SR_Save()                        */
+extern INT32U (*HostTsFnct)(void);                /* Replaces the host clock in OS_CPU_TS_GET()        */
+
+void            HostTick(void);
+void            HostDone(const char *name);
+
+#endif
@@ -0,0 +1,23 @@
+/*
+*********************************************************************************************************
+*                                         HOST PORT OF OS_CFG.H
+*
+* The application configuration, with the application hooks turned on (the host port drives its tasks and
+* the tick from them).  A test changes further options in the header named by TEST_OS_CFG, which holds
+* #undef/#define pairs.
+*********************************************************************************************************
+*/
+
+#ifndef  HOST_OS_CFG_H
+#define  HOST_OS_CFG_H
+
+#include "../../srccode/os_cfg.h"
+
+#undef   OS_APP_HOOKS_EN
+#define  OS_APP_HOOKS_EN          1u
+
+#ifdef   TEST_OS_CFG
+#include TEST_OS_CFG
+#endif
+
+#endif
@@ -0,0 +1,66 @@
+/*
+*********************************************************************************************************
+*                                         HOST PORT OF OS_CPU.H
+*
+* The Cortex-M3 port header with the core registers it names (DWT, MPU, SCB) replaced by variables, so
+* the kernel and os_cpu_c.c run unchanged in a host process.  LDREX/STREX are emulated by plain loads and
+* stores: the host port runs one task at a time and never interrupts it, so a store always succeeds.
+*
+* OS_CPU_TS_GET() reads the host's monotonic clock in nanoseconds (see HostTsGet()), or the clock a test
+* installs in HostTsFnct.
+*
+* Define TEST_CPU_MPU_EN to 0 or 1 to select the stack guard flavor built from os_cpu_c.c.
+*********************************************************************************************************
+*/
+
+#ifndef  HOST_OS_CPU_H
+#define  HOST_OS_CPU_H
+
+#include <stdint.h>
+
+#define  OS_CPU_EXCL_EN       1
+
+#define  OS_CPU_LDREX(p)      (*(p))
+#define  OS_CPU_STREX(v, p)   (*(p) = (__typeof__(*(p)))(uintptr_t)(v), 0u)
+#define  OS_CPU_CLREX()       ((void)0)
+
+#include "../../ucos/os_cpu.h"
+
+extern volatile INT32U  HostRegDemCr;
+extern volatile INT32U  HostRegDwtCr;
+extern volatile INT32U  HostRegCycCnt;
+extern volatile INT32U  HostRegShcsr;
+extern volatile INT32U  HostRegMpuCtrl;
+extern volatile INT32U  HostRegMpuRnr;
+extern volatile INT32U  HostRegMpuRbar;
+extern volatile INT32U  HostRegMpuRasr;
+
+INT32U  HostTsGet(void);
+
+#undef   OS_CPU_TS_GET
+#define  OS_CPU_TS_GET()             HostTsGet()
+
+#undef   OS_CPU_CM3_DEM_CR
+#undef   OS_CPU_CM3_DWT_CR
+#undef   OS_CPU_CM3_DWT_CYCCNT
+#undef   OS_CPU_CM3_SCB_SHCSR
+#undef   OS_CPU_CM3_MPU_CTRL
+#undef   OS_CPU_CM3_MPU_RNR
+#undef   OS_CPU_CM3_MPU_RBAR
+#undef   OS_CPU_CM3_MPU_RASR
+
+#define  OS_CPU_CM3_DEM_CR           HostRegDemCr
+#define  OS_CPU_CM3_DWT_CR           HostRegDwtCr
+#define  OS_CPU_CM3_DWT_CYCCNT       HostRegCycCnt
+#define  OS_CPU_CM3_SCB_SHCSR        HostRegShcsr
+#define  OS_CPU_CM3_MPU_CTRL         HostRegMpuCtrl
+#define  OS_CPU_CM3_MPU_RNR          HostRegMpuRnr
+#define  OS_CPU_CM3_MPU_RBAR         HostRegMpuRbar
+#define  OS_CPU_CM3_MPU_RASR         HostRegMpuRasr
+
+#ifdef   TEST_CPU_MPU_EN
+#undef   OS_CPU_MPU_EN
+#define  OS_CPU_MPU_EN        TEST_CPU_MPU_EN
+#endif
+
+#endif
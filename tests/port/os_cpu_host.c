@@ -0,0 +1,230 @@
+/*
+*********************************************************************************************************
+*                                        HOST PORT OF OS_CPU_A.ASM
+*
+* Replaces the assembly part of the Cortex-M3 port for host tests: each task gets a ucontext and a host
+* stack, entered through the entry point and argument that OSTaskStkInit() left in the task's initial
+* frame.  Interrupts are never taken asynchronously, so the critical section functions only count; a test
+* raises an "interrupt" by calling OSIntEnter(), the handler and OSIntExit() from a task.  HostCritFnct lets
+* a test bring register stand-ins up to date before a driver reads them in a critical section.
+*
+* The kernel stores pointers in 32-bit OS_STK entries, so tests link with -no-pie and pass task arguments
+* that live in static storage.
+*********************************************************************************************************
+*/
+
+#include <stdint.h>
+#include <time.h>
+#include <ucontext.h>
+#include "host.h"
+
+#define  HOST_STK_SIZE        (128u * 1024u)
+
+typedef struct host_ctx {
+	ucontext_t uc;
+	char *stk;
+	BOOLEAN fresh;			/* TCB was (re)initialized, start the task anew       */
+} HOST_CTX;
+
+static HOST_CTX HostCtxTbl[OS_MAX_TASKS + OS_N_SYS_TASKS];
+static ucontext_t HostMainCtx;
+
+volatile INT32U HostRegDemCr;
+volatile INT32U HostRegDwtCr;
+volatile INT32U HostRegCycCnt;
+volatile INT32U HostRegShcsr;
+volatile INT32U HostRegMpuCtrl;
+volatile INT32U HostRegMpuRnr;
+volatile INT32U HostRegMpuRbar;
+volatile INT32U HostRegMpuRasr;
+
+INT32U HostChecks;
+INT32U HostTickLimit = 1000000uL;
+INT32U HostSwCtr;
+INT32U HostCritCtr;
+INT32U HostStkOvfCtr;
+OS_TCB *HostStkOvfTcb;
+
+void (*HostIdleFnct) (void);
+void (*HostSwFnct) (void);
+void (*HostCritFnct) (void);
+INT32U(*HostTsFnct) (void);
+
+static void HostTaskStart(int ix)
+{
+	OS_STK *stk;
+	void (*task) (void *p_arg);
+
+	stk = OSTCBTbl[ix].OSTCBStkPtr;	/* Initial frame, see OSTaskStkInit()                 */
+	task = (void (*)(void *))(uintptr_t) stk[14];	/* PC                                          */
+	task((void *)(uintptr_t) stk[8]);	/* R0                                                 */
+	OS_TaskReturn();
+}
+
+static ucontext_t *HostCtxGet(OS_TCB * ptcb)
+{
+	HOST_CTX *pctx;
+	int ix;
+
+	ix = (int)(ptcb - &OSTCBTbl[0]);
+	pctx = &HostCtxTbl[ix];
+	if (pctx->stk == (char *)0) {
+		pctx->stk = malloc(HOST_STK_SIZE);
+		pctx->fresh = OS_TRUE;
+	}
+	if (pctx->fresh == OS_TRUE) {
+		pctx->fresh = OS_FALSE;
+		getcontext(&pctx->uc);
+		pctx->uc.uc_stack.ss_sp = pctx->stk;
+		pctx->uc.uc_stack.ss_size = HOST_STK_SIZE;
+		pctx->uc.uc_link = (ucontext_t *) 0;
+		makecontext(&pctx->uc, (void (*)(void))HostTaskStart, 1, ix);
+	}
+	return (&pctx->uc);
+}
+
+static void HostCtxSw(void)
+{
+	OS_TCB *pold;
+
+	pold = OSTCBCur;
+#if OS_TASK_SW_HOOK_EN > 0u
+	OSTaskSwHook();
+#endif
+	OSPrioCur = OSPrioHighRdy;
+	OSTCBCur = OSTCBHighRdy;
+	HostSwCtr++;
+	if (OSTCBCur != pold) {
+		swapcontext(HostCtxGet(pold), HostCtxGet(OSTCBCur));
+	}
+}
+
+OS_CPU_SR OS_CPU_SR_Save(void)
+{
+	HostCritCtr++;
+	if (HostCritFnct != (void (*)(void))0) {
+		HostCritFnct();
+	}
+	return (0u);
+}
+
+void OS_CPU_SR_Restore(OS_CPU_SR cpu_sr)
+{
+	(void)cpu_sr;
+}
+
+void OSStartHighRdy(void)
+{
+	OSRunning = OS_TRUE;
+#if OS_TASK_SW_HOOK_EN > 0u
+	OSTaskSwHook();
+#endif
+	OSPrioCur = OSPrioHighRdy;
+	OSTCBCur = OSTCBHighRdy;
+	swapcontext(&HostMainCtx, HostCtxGet(OSTCBCur));
+}
+
+void OSCtxSw(void)
+{
+	HostCtxSw();
+}
+
+void OSIntCtxSw(void)
+{
+	HostCtxSw();
+}
+
+void OS_CPU_PendSVHandler(void)
+{
+}
+
+void HostTick(void)
+{
+	if (OSTime >= HostTickLimit) {
+		printf("tick limit %lu reached\n", (unsigned long)HostTickLimit);
+		exit(2);
+	}
+	OSIntEnter();
+	OSTimeTick();
+	OSIntExit();
+}
+
+INT32U HostTsGet(void)
+{
+	struct timespec ts;
+
+	if (HostTsFnct != (INT32U(*)(void))0) {
+		return (HostTsFnct());
+	}
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((INT32U) ((uint64_t) ts.tv_sec * 1000000000uLL + (uint64_t) ts.tv_nsec));
+}
+
+void HostDone(const char *name)
+{
+	printf("%s: %lu checks passed\n", name, (unsigned long)HostChecks);
+	exit(0);
+}
+
+#if OS_TASK_BUDGET_EN > 0u
+void App_TaskBudgetHook(OS_TCB * ptcb)
+{
+	(void)ptcb;
+}
+#endif
+
+void App_TaskCreateHook(OS_TCB * ptcb)
+{
+	HostCtxTbl[ptcb - &OSTCBTbl[0]].fresh = OS_TRUE;
+}
+
+void App_TaskDelHook(OS_TCB * ptcb)
+{
+	(void)ptcb;
+}
+
+void App_TaskIdleHook(void)
+{
+	if (HostIdleFnct != (void (*)(void))0) {
+		HostIdleFnct();
+	} else {
+		HostTick();
+	}
+}
+
+void App_TaskReturnHook(OS_TCB * ptcb)
+{
+	(void)ptcb;
+}
+
+void App_TaskStatHook(void)
+{
+}
+
+#if OS_TASK_STK_GUARD_EN > 0u
+void App_TaskStkOvfHook(OS_TCB * ptcb)
+{
+	HostStkOvfCtr++;
+	HostStkOvfTcb = ptcb;
+}
+#endif
+
+#if OS_TASK_SW_HOOK_EN > 0u
+void App_TaskSwHook(void)
+{
+	if (HostSwFnct != (void (*)(void))0) {
+		HostSwFnct();
+	}
+}
+#endif
+
+void App_TCBInitHook(OS_TCB * ptcb)
+{
+	(void)ptcb;
+}
+
+#if OS_TIME_TICK_HOOK_EN > 0u
+void App_TimeTickHook(void)
+{
+}
+#endif
@@ -0,0 +1,131 @@
+/*
+ * Round-robin tasks sharing a priority (OS_TASK_RR_EN): OSTaskChangePrio() of one waiter must leave the
+ * wait bit of its peer alone, and a mutex owner restored from the PIP must not take the head of its
+ * priority from a peer that is already ready.
+ */
+
+#include <string.h>
+#include "host.h"
+
+#define  M_PRIO    4u
+#define  H_PRIO    8u
+#define  PIP       6u
+#define  AB_PRIO  20u
+#define  CD_PRIO  30u
+
+static OS_STK MStk[128], AStk[128], BStk[128], CStk[128], DStk[128], HStk[128];
+static OS_TCB *TcbA, *TcbB, *TcbC, *TcbD;
+static OS_EVENT *Sem, *GoC, *GoD, *GoH, *Mtx;
+static char Order[16];
+static INT8U OrderLen;
+
+static void Log(char c)
+{
+	Order[OrderLen++] = c;
+}
+
+static void WaitTask(void *p_arg)
+{
+	INT8U err;
+
+	if (*(char *)p_arg == 'A') {
+		TcbA = OSTCBCur;
+	} else {
+		TcbB = OSTCBCur;
+	}
+	OSSemPend(Sem, 0u, &err);
+	Log(*(char *)p_arg);
+	OSTaskSuspend(OS_PRIO_SELF);
+}
+
+static void CTask(void *p_arg)
+{
+	INT8U err;
+
+	(void)p_arg;
+	TcbC = OSTCBCur;
+	OSMutexPend(Mtx, 0u, &err);
+	OSSemPend(GoC, 0u, &err);
+	CHECK(OSTCBCur->OSTCBPrio == PIP);
+	OSMutexPost(Mtx);
+	Log('C');
+	OSTaskSuspend(OS_PRIO_SELF);
+}
+
+static void DTask(void *p_arg)
+{
+	INT8U err;
+
+	(void)p_arg;
+	TcbD = OSTCBCur;
+	OSSemPend(GoD, 0u, &err);
+	Log('D');
+	OSTaskSuspend(OS_PRIO_SELF);
+}
+
+static void HTask(void *p_arg)
+{
+	INT8U err;
+
+	(void)p_arg;
+	OSSemPend(GoH, 0u, &err);
+	OSMutexPend(Mtx, 0u, &err);
+	Log('H');
+	OSMutexPost(Mtx);
+	OSTaskSuspend(OS_PRIO_SELF);
+}
+
+static void MTask(void *p_arg)
+{
+	static char a = 'A', b = 'B';
+	INT8U err;
+
+	(void)p_arg;
+	Sem = OSSemCreate(0u);
+
+	/* Change the priority of one of two tasks waiting at the same priority */
+	OSTaskCreate(WaitTask, &a, &AStk[127], AB_PRIO);
+	OSTaskCreate(WaitTask, &b, &BStk[127], AB_PRIO);
+	OSTimeDly(1u);
+	CHECK(OSTCBPrioTbl[AB_PRIO] == TcbB);	/* Head passed to B when A blocked   */
+	CHECK(OSTaskChangePrio(AB_PRIO, 25u) == OS_ERR_NONE);
+	CHECK(TcbB->OSTCBPrio == 25u && OSTCBPrioTbl[25] == TcbB);
+	CHECK(OSTCBPrioTbl[AB_PRIO] == TcbA && TcbA->OSTCBRRNext == TcbA);
+	CHECK((Sem->OSEventTbl[AB_PRIO >> 3] & (1u << (AB_PRIO & 7u))) != 0u);	/* A still waits */
+	CHECK((Sem->OSEventTbl[25u >> 3] & (1u << (25u & 7u))) != 0u);	/* B waits at 25 */
+	OSSemPost(Sem);
+	CHECK(TcbA->OSTCBStat == OS_STAT_RDY && TcbB->OSTCBStat == OS_STAT_SEM);
+	OSSemPost(Sem);
+	OSTimeDly(1u);
+	CHECK(OrderLen == 2u && memcmp(Order, "AB", 2u) == 0);
+
+	/* Restore a mutex owner from the PIP while a peer is ready at its priority */
+	OrderLen = 0u;
+	Mtx = OSMutexCreate(PIP, &err);
+	GoC = OSSemCreate(0u);
+	GoD = OSSemCreate(0u);
+	GoH = OSSemCreate(0u);
+	OSTaskCreate(CTask, (void *)0, &CStk[127], CD_PRIO);
+	OSTaskCreate(DTask, (void *)0, &DStk[127], CD_PRIO);
+	OSTaskCreate(HTask, (void *)0, &HStk[127], H_PRIO);
+	OSTimeDly(1u);		/* C owns the mutex, all three block      */
+	OSSemPost(GoD);		/* D ready first, then C                 */
+	OSSemPost(GoC);
+	OSSemPost(GoH);
+	CHECK(OSTCBPrioTbl[CD_PRIO] == TcbD);
+	OSTimeDly(1u);		/* H raises C, C hands the mutex to H    */
+	CHECK(OrderLen == 3u && memcmp(Order, "HDC", 3u) == 0);
+	CHECK(TcbC->OSTCBPrio == CD_PRIO && TcbC->OSTCBRRPrio == CD_PRIO);
+	CHECK(TcbC->OSTCBRRNext == TcbD && TcbD->OSTCBRRNext == TcbC);
+	CHECK(TcbC->OSTCBRRPrev == TcbD && TcbD->OSTCBRRPrev == TcbC);
+	CHECK(OSTCBPrioTbl[PIP] == OS_TCB_RESERVED);
+	HostDone("rr");
+}
+
+int main(void)
+{
+	OSInit();
+	OSTaskCreate(MTask, (void *)0, &MStk[127], M_PRIO);
+	OSStart();
+	return (1);
+}
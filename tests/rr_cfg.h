@@ -0,0 +1,2 @@
+#undef  OS_TASK_RR_EN
+#define OS_TASK_RR_EN             1u
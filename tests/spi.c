@@ -0,0 +1,249 @@
+/*
+ * DMA SPI driver (srccode/spi.c) on RAM stand-ins for SPI1, DMA1 and a chip select port: transfers run
+ * in order from the bus queue, chip select is taken and released around each one, SPI_Transfer() maps a
+ * DMA error to OS_ERR_PEND_ABORT, and a transfer that times out is cancelled, whether it is still queued
+ * (at the head, in the middle or at the tail) or already on the DMA.
+ *
+ * The DMA "runs" when the idle task does (unless Stall is set): the receive channel gets what the
+ * transmit channel sends, as with MOSI looped back to MISO, and SPI_Isr() sees the flag in IdleFlag.
+ */
+
+#include <string.h>
+#include "host.h"
+#include "../srccode/spi.c"
+
+#define  MAIN_PRIO   10u
+#define  AUX_PRIO     5u
+
+static SPI_TypeDef HostSpi;
+static DMA_TypeDef HostDma;
+static DMA_Channel_TypeDef HostDmaRx, HostDmaTx;
+static GPIO_TypeDef HostCs;
+
+static OS_STK MainStk[256], AuxStk[256];
+static OS_EVENT *AuxGo;
+static INT8U AuxErr;
+static BOOLEAN Stall;		/* The DMA does not run in Idle()        */
+static INT32U IdleFlag = SPI_DMA_IF_TC;
+static INT32U SubmitAt;		/* Tick at which Idle() submits XferX2   */
+
+static INT32U Ifcr;		/* DMA_IFCR written by the last SPI_Isr() */
+static INT8U Tx[4][16], Rx[4][16];
+static SPI_XFER XferA, XferB, XferC, XferX1, XferX2, XferX3;
+
+/* Standard peripheral library functions called by the driver */
+void RCC_APB2PeriphClockCmd(uint32_t periph, FunctionalState state)
+{
+}
+
+void RCC_AHBPeriphClockCmd(uint32_t periph, FunctionalState state)
+{
+}
+
+void GPIO_Init(GPIO_TypeDef * pgpio, GPIO_InitTypeDef * pinit)
+{
+}
+
+void NVIC_Init(NVIC_InitTypeDef * pinit)
+{
+}
+
+void SPI_StructInit(SPI_InitTypeDef * pinit)
+{
+}
+
+void SPI_Init(SPI_TypeDef * pspi, SPI_InitTypeDef * pinit)
+{
+}
+
+void SPI_Cmd(SPI_TypeDef * pspi, FunctionalState state)
+{
+}
+
+void SPI_I2S_DMACmd(SPI_TypeDef * pspi, uint16_t req, FunctionalState state)
+{
+	pspi->CR2 |= req;
+}
+
+/* Clears the DMA_ISR bits the driver wrote to DMA_IFCR, as the hardware does */
+static void DmaIfcr(void)
+{
+	Ifcr = HostDma.IFCR;
+	HostDma.ISR &= ~HostDma.IFCR;
+	HostDma.IFCR = 0u;
+}
+
+/* Runs the transfer on the DMA and raises the receive channel interrupt with 'flag' */
+static void DmaRun(INT32U flag)
+{
+	INT8U *ptx, *prx;
+	INT16U i;
+
+	CHECK((HostDmaRx.CCR & DMA_CCR1_EN) != 0u && (HostDmaTx.CCR & DMA_CCR1_EN) != 0u);
+	ptx = (INT8U *) (uintptr_t) HostDmaTx.CMAR;
+	prx = (INT8U *) (uintptr_t) HostDmaRx.CMAR;
+	for (i = 0u; i < HostDmaRx.CNDTR; i++) {
+		prx[((HostDmaRx.CCR & DMA_CCR1_MINC) != 0u) ? i : 0u] = ptx[((HostDmaTx.CCR & DMA_CCR1_MINC) != 0u) ? i : 0u];
+	}
+	HostDma.ISR |= flag << 4;
+	OSIntEnter();
+	SPI_Isr(&SPI_Bus1);
+	DmaIfcr();
+	OSIntExit();
+}
+
+static void Idle(void)
+{
+	if ((Stall == OS_FALSE) && ((HostDmaRx.CCR & DMA_CCR1_EN) != 0u)) {
+		DmaRun(IdleFlag);
+	}
+	HostTick();
+	if (OSTime == SubmitAt) {	/* From an ISR, with the interrupt of the active transfer pending */
+		OSIntEnter();
+		SPI_Submit(&SPI_Bus1, &XferX2);
+		OSIntExit();
+		HostDma.ISR |= SPI_DMA_IF_TC << 4;
+	}
+}
+
+static void XferSet(SPI_XFER * pxfer, INT8U ix, INT16U len, INT16U cs_pin)
+{
+	memset(pxfer, 0, sizeof(*pxfer));
+	memset(Rx[ix], 0, sizeof(Rx[ix]));
+	for (pxfer->len = 0u; pxfer->len < len; pxfer->len++) {
+		Tx[ix][pxfer->len] = (INT8U) (ix * 16u + pxfer->len + 1u);
+	}
+	pxfer->ptx = Tx[ix];
+	pxfer->prx = Rx[ix];
+	pxfer->cs_port = &HostCs;
+	pxfer->cs_pin = cs_pin;
+}
+
+static void AuxTask(void *p_arg)
+{
+	INT8U err;
+
+	for (;;) {
+		OSSemPend(AuxGo, 0u, &err);
+		AuxErr = SPI_Transfer(&SPI_Bus1, &XferC, 5u);
+	}
+}
+
+static void MainTask(void *p_arg)
+{
+	OS_EVENT *sem;
+	INT32U t;
+
+	sem = OSSemCreate(0u);
+	CHECK(HostSpi.CR2 == (SPI_I2S_DMAReq_Rx | SPI_I2S_DMAReq_Tx) && HostDmaRx.CPAR == (INT32U) & HostSpi.DR);
+
+	/* A transfer takes chip select, receives what it sent and releases chip select */
+	XferSet(&XferA, 0u, 8u, 0x10u);
+	XferA.sem = sem;
+	CHECK(SPI_Transfer(&SPI_Bus1, &XferA, 10u) == OS_ERR_NONE);
+	CHECK(XferA.stat == SPI_STAT_DONE && memcmp(Rx[0], Tx[0], 8u) == 0 && Rx[0][8] == 0u);
+	CHECK(HostCs.BRR == 0x10u && HostCs.BSRR == 0x10u && SPI_Bus1.cur == (SPI_XFER *) 0);
+	CHECK(sem->OSEventCnt == 0u);
+
+	/* ... and a DMA error ends SPI_Transfer() with OS_ERR_PEND_ABORT */
+	IdleFlag = SPI_DMA_IF_TE;
+	CHECK(SPI_Transfer(&SPI_Bus1, &XferA, 10u) == OS_ERR_PEND_ABORT && XferA.stat == SPI_STAT_ERR);
+	IdleFlag = SPI_DMA_IF_TC;
+
+	/* Transfers run in the order submitted, the next one started from the interrupt */
+	Stall = OS_TRUE;
+	XferSet(&XferX1, 1u, 4u, 0x20u);
+	XferSet(&XferX2, 2u, 3u, 0x40u);
+	SPI_Submit(&SPI_Bus1, &XferX1);
+	SPI_Submit(&SPI_Bus1, &XferX2);
+	CHECK(XferX1.stat == SPI_STAT_ACTIVE && XferX2.stat == SPI_STAT_QUEUED && HostCs.BRR == 0x20u);
+	DmaRun(SPI_DMA_IF_TC);
+	CHECK(Ifcr == (SPI_DMA_IF_TC << 4));
+	CHECK(XferX1.stat == SPI_STAT_DONE && XferX2.stat == SPI_STAT_ACTIVE && SPI_Bus1.cur == &XferX2);
+	CHECK(HostCs.BSRR == 0x20u && HostCs.BRR == 0x40u && HostDmaRx.CMAR == (INT32U) Rx[2]);
+	CHECK(memcmp(Rx[1], Tx[1], 4u) == 0);
+	DmaRun(SPI_DMA_IF_TC);
+	CHECK(XferX2.stat == SPI_STAT_DONE && SPI_Bus1.cur == (SPI_XFER *) 0);
+
+	/* Timeout while queued last: dequeued, the tail moves back */
+	XferSet(&XferX1, 1u, 4u, 0x20u);
+	XferSet(&XferX2, 2u, 4u, 0x20u);
+	XferSet(&XferX3, 3u, 4u, 0x20u);
+	XferSet(&XferB, 0u, 4u, 0x10u);
+	XferB.sem = sem;
+	SPI_Submit(&SPI_Bus1, &XferX1);
+	SPI_Submit(&SPI_Bus1, &XferX2);
+	t = OSTime;
+	CHECK(SPI_Transfer(&SPI_Bus1, &XferB, 5u) == OS_ERR_TIMEOUT && OSTime - t == 5u);
+	CHECK(XferB.stat == SPI_STAT_TIMEOUT && sem->OSEventCnt == 0u);
+	CHECK(SPI_Bus1.cur == &XferX1 && XferX1.stat == SPI_STAT_ACTIVE);
+	CHECK(SPI_Bus1.head == &XferX2 && SPI_Bus1.tail == &XferX2 && XferX2.next == (SPI_XFER *) 0);
+	SPI_Submit(&SPI_Bus1, &XferX3);
+	CHECK(XferX2.next == &XferX3 && SPI_Bus1.tail == &XferX3);
+
+	/* ... in the middle: unlinked, head and tail stay */
+	XferSet(&XferC, 0u, 4u, 0x10u);
+	XferC.sem = OSSemCreate(0u);
+	(void)OSSemPost(AuxGo);
+	CHECK(XferC.stat == SPI_STAT_QUEUED && SPI_Bus1.tail == &XferC);
+	SPI_Submit(&SPI_Bus1, &XferB);
+	OSTimeDly(10u);
+	CHECK(AuxErr == OS_ERR_TIMEOUT && XferC.stat == SPI_STAT_TIMEOUT);
+	CHECK(SPI_Bus1.head == &XferX2 && XferX2.next == &XferX3 && XferX3.next == &XferB && SPI_Bus1.tail == &XferB);
+
+	/* ... first and only: the queue empties */
+	Stall = OS_FALSE;
+	OSTimeDly(10u);
+	CHECK(SPI_Bus1.cur == (SPI_XFER *) 0 && XferX3.stat == SPI_STAT_DONE && XferB.stat == SPI_STAT_DONE);
+	CHECK(OSSemAccept(sem) == 1u);	/* Posted by XferB, which was submitted without SPI_Transfer() */
+	Stall = OS_TRUE;
+	SPI_Submit(&SPI_Bus1, &XferX1);
+	CHECK(SPI_Transfer(&SPI_Bus1, &XferB, 5u) == OS_ERR_TIMEOUT && XferB.stat == SPI_STAT_TIMEOUT);
+	CHECK(SPI_Bus1.head == (SPI_XFER *) 0 && SPI_Bus1.tail == (SPI_XFER *) 0);
+	SPI_Submit(&SPI_Bus1, &XferX2);
+	CHECK(SPI_Bus1.head == &XferX2 && SPI_Bus1.tail == &XferX2);
+	Stall = OS_FALSE;
+	OSTimeDly(10u);
+	CHECK(SPI_Bus1.cur == (SPI_XFER *) 0 && XferX2.stat == SPI_STAT_DONE);
+
+	/* Timeout on the DMA: both channels stopped, chip select released even with SPI_OPT_CS_KEEP, the
+	   pending interrupt discarded and the next transfer started */
+	Stall = OS_TRUE;
+	XferSet(&XferA, 0u, 8u, 0x10u);
+	XferA.sem = sem;
+	XferA.opt = SPI_OPT_CS_KEEP;
+	XferSet(&XferX2, 2u, 3u, 0x40u);
+	SubmitAt = OSTime + 2u;
+	HostCs.BSRR = 0u;
+	CHECK(SPI_Transfer(&SPI_Bus1, &XferA, 5u) == OS_ERR_TIMEOUT && XferA.stat == SPI_STAT_TIMEOUT);
+	CHECK(HostCs.BSRR == 0x10u && HostCs.BRR == 0x40u && sem->OSEventCnt == 0u);
+	DmaIfcr();
+	CHECK(Ifcr == (0x0Fu << 4) && (HostDma.ISR & (0x0Fu << 4)) == 0u);
+	CHECK(SPI_Bus1.cur == &XferX2 && XferX2.stat == SPI_STAT_ACTIVE && SPI_Bus1.head == (SPI_XFER *) 0);
+	CHECK(HostDmaRx.CMAR == (INT32U) Rx[2] && HostDmaRx.CNDTR == 3u && (HostDmaRx.CCR & DMA_CCR1_EN) != 0u);
+	CHECK(HostDmaTx.CMAR == (INT32U) Tx[2] && (HostDmaTx.CCR & DMA_CCR1_EN) != 0u);
+	OSIntEnter();		/* The interrupt that was pending when the transfer was cancelled */
+	SPI_Isr(&SPI_Bus1);
+	OSIntExit();
+	CHECK(XferX2.stat == SPI_STAT_ACTIVE);
+	Stall = OS_FALSE;
+	OSTimeDly(2u);
+	CHECK(XferX2.stat == SPI_STAT_DONE && memcmp(Rx[2], Tx[2], 3u) == 0 && HostCs.BSRR == 0x40u);
+
+	/* The descriptor can be used again */
+	CHECK(SPI_Transfer(&SPI_Bus1, &XferA, 5u) == OS_ERR_NONE && XferA.stat == SPI_STAT_DONE);
+	CHECK(memcmp(Rx[0], Tx[0], 8u) == 0);
+	HostDone("spi");
+}
+
+int main(void)
+{
+	OSInit();
+	SPI_BusInit(&SPI_Bus1, &HostSpi, &HostDma, &HostDmaRx, &HostDmaTx, 2u);
+	AuxGo = OSSemCreate(0u);
+	HostIdleFnct = Idle;
+	OSTaskCreate(MainTask, (void *)0, &MainStk[255], MAIN_PRIO);
+	OSTaskCreate(AuxTask, (void *)0, &AuxStk[255], AUX_PRIO);
+	OSStart();
+	return (1);
+}
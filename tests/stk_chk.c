@@ -0,0 +1,113 @@
+/*
+ * Incremental stack high-water mark (OS_TASK_STK_CHK_GUARD): the scan starts at the deepest entry seen
+ * so far or at the saved stack pointer, and stops after OS_TASK_STK_CHK_GUARD zero entries.
+ */
+
+#include "host.h"
+
+#define  STK_SIZE  64u
+#define  T_PRIO    30u
+
+static struct {
+	OS_STK below[8];	/* Memory under the stack, never scanned        */
+	OS_STK stk[STK_SIZE];
+} TStk;
+static OS_STK MainStk[128];
+
+static void TTask(void *p_arg)
+{
+	(void)p_arg;
+	for (;;) {
+		OSTaskSuspend(OS_PRIO_SELF);
+	}
+}
+
+static INT32U FreeEntries(void)
+{
+	OS_STK_DATA data;
+
+	CHECK(OSTaskStkChk(T_PRIO, &data) == OS_ERR_NONE);
+	CHECK(data.OSFree + data.OSUsed == STK_SIZE * sizeof(OS_STK));
+	return (data.OSFree / sizeof(OS_STK));
+}
+
+static void MainTask(void *p_arg)
+{
+	OS_TCB *ptcb;
+	OS_STK *psp;
+	INT32U i;
+
+	(void)p_arg;
+	CHECK(OSTaskCreateExt(TTask, (void *)0, &TStk.stk[STK_SIZE - 1u], T_PRIO, T_PRIO,
+			      &TStk.stk[0], STK_SIZE, (void *)0,
+			      OS_TASK_OPT_STK_CHK | OS_TASK_OPT_STK_CLR) == OS_ERR_NONE);
+	ptcb = OSTCBPrioTbl[T_PRIO];
+	psp = ptcb->OSTCBStkPtr;
+
+	/* Only the initial frame (16 entries) is in use */
+	CHECK(psp == &TStk.stk[STK_SIZE - 16u]);
+	CHECK(ptcb->OSTCBStkHWM == psp);
+	CHECK(FreeEntries() == STK_SIZE - 16u);
+	CHECK(ptcb->OSTCBStkHWM == psp);
+
+	/* Zero runs shorter than the guard are crossed */
+	TStk.stk[46] = 1u;
+	TStk.stk[43] = 1u;
+	TStk.stk[40] = 1u;
+	CHECK(FreeEntries() == 40u);
+	CHECK(ptcb->OSTCBStkHWM == &TStk.stk[40]);
+
+	/* A saved stack pointer deeper than the mark is the start point */
+	TStk.stk[20] = 0x20u;
+	ptcb->OSTCBStkPtr = &TStk.stk[20];
+	CHECK(FreeEntries() == 20u);
+	CHECK(ptcb->OSTCBStkHWM == &TStk.stk[20]);
+
+	/* Once the task returns to a shallower SP the mark is kept */
+	ptcb->OSTCBStkPtr = psp;
+	CHECK(FreeEntries() == 20u);
+
+	/* The scan goes on below the mark ... */
+	TStk.stk[17] = 0x17u;
+	CHECK(FreeEntries() == 17u);
+
+	/* ... but stops after OS_TASK_STK_CHK_GUARD zeros (see OS_TaskStkChk(), note 2) */
+	TStk.stk[12] = 0x12u;
+	CHECK(FreeEntries() == 17u);
+
+	/* A saved SP outside the stack is ignored */
+	for (i = 0u; i < 8u; i++) {
+		TStk.below[i] = 0xDEADu;
+	}
+	ptcb->OSTCBStkPtr = &TStk.below[4];
+	CHECK(FreeEntries() == 17u);
+	ptcb->OSTCBStkPtr = psp;
+
+	/* Used down to the bottom: no free entry, nothing below is read */
+	for (i = 0u; i < 17u; i++) {
+		TStk.stk[i] = 0x55u;
+	}
+	CHECK(FreeEntries() == 0u);
+	CHECK(ptcb->OSTCBStkHWM == &TStk.stk[0]);
+
+	/* The statistic task's walk stores the same figure in the TCB */
+	OS_TaskStatStkChk();
+	CHECK(ptcb->OSTCBStkUsed == STK_SIZE * sizeof(OS_STK));
+
+	/* Tasks created without OS_TASK_OPT_STK_CHK are refused */
+	{
+		OS_STK_DATA data;
+
+		CHECK(OSTaskStkChk(OS_PRIO_SELF, &data) == OS_ERR_TASK_OPT);
+	}
+	HostDone("stk_chk");
+}
+
+int main(void)
+{
+	OSInit();
+	OSTaskCreateExt(MainTask, (void *)0, &MainStk[127], 5u, 5u, &MainStk[0], 128u, (void *)0,
+			OS_TASK_OPT_NONE);
+	OSStart();
+	return (1);
+}
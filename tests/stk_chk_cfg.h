@@ -0,0 +1,2 @@
+#undef  OS_TASK_STK_CHK_GUARD
+#define OS_TASK_STK_CHK_GUARD     4u
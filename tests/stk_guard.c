@@ -0,0 +1,121 @@
+/*
+ * Task stack guard (OS_TASK_STK_GUARD_EN), built for the software check and, as "stk_guard-mpu", for the
+ * MPU: a stack too small for its guard is refused and a failed create leaves the stack alone, the guard
+ * is reserved below the stack proper, the MPU region and the software check cover the same 32 byte span,
+ * and the cost of OS_CPU_StkGuardSw() per switch in OS_CPU_TS_GET() counts (host nanoseconds).
+ */
+
+#include <stdint.h>
+#include "host.h"
+
+#define  G_PRIO       5u
+#define  MAIN_PRIO   10u
+#define  G_STK_SIZE  80u
+#define  N_CALLS 1000000uL
+
+static OS_STK MainStk[128];
+static struct {
+	OS_STK pad;			/* Stack not on a 32 byte boundary    */
+	OS_STK stk[G_STK_SIZE];
+} __attribute__ ((aligned(32))) GMem;
+static OS_EVENT *GoG;
+static OS_TCB *TcbG;
+static INT32U GRbar, GRasr;
+static OS_STK *GWrite;
+
+static void GTask(void *p_arg)
+{
+	INT8U err;
+
+	(void)p_arg;
+	TcbG = OSTCBCur;
+	for (;;) {
+		GRbar = HostRegMpuRbar;	/* Region as loaded for this task     */
+		GRasr = HostRegMpuRasr;
+		if (GWrite != (OS_STK *) 0) {
+			*GWrite = 0x5555u;	/* Stack overflow                     */
+			GWrite = (OS_STK *) 0;
+		}
+		OSSemPend(GoG, 0u, &err);
+	}
+}
+
+static void MainTask(void *p_arg)
+{
+	OS_STK_DATA data;
+	OS_STK *guard;
+	OS_TCB *pcur;
+	INT32U ts;
+	INT32U i;
+	INT8U err;
+
+	(void)p_arg;
+	GoG = OSSemCreate(0u);
+	for (i = 0u; i < G_STK_SIZE; i++) {
+		GMem.stk[i] = 0xAAAAu;
+	}
+	guard = (OS_STK *) (((uintptr_t) & GMem.stk[0] + 31u) & ~(uintptr_t) 31u);
+	CHECK(guard == &GMem.stk[7]);
+
+	/* Nothing written unless the task is created */
+	CHECK(OSTaskCreateExt(GTask, (void *)0, &GMem.stk[G_STK_SIZE - 1u], G_PRIO, G_PRIO, &GMem.stk[0],
+			      OS_TASK_STK_GUARD_SIZE, (void *)0, OS_TASK_OPT_STK_CHK) == OS_ERR_STK_SIZE_INVALID);
+	CHECK(OSTaskCreateExt(GTask, (void *)0, &GMem.stk[G_STK_SIZE - 1u], MAIN_PRIO, MAIN_PRIO, &GMem.stk[0],
+			      G_STK_SIZE, (void *)0, OS_TASK_OPT_STK_CHK) == OS_ERR_PRIO_EXIST);
+	OSIntNesting++;
+	CHECK(OSTaskCreateExt(GTask, (void *)0, &GMem.stk[G_STK_SIZE - 1u], G_PRIO, G_PRIO, &GMem.stk[0],
+			      G_STK_SIZE, (void *)0, OS_TASK_OPT_STK_CHK) == OS_ERR_TASK_CREATE_ISR);
+	OSIntNesting--;
+	CHECK(GMem.stk[0] == 0xAAAAu && GMem.stk[OS_TASK_STK_GUARD_SIZE - 1u] == 0xAAAAu);
+
+	/* Guard reserved and cleared below the stack proper */
+	CHECK(OSTaskCreateExt(GTask, (void *)0, &GMem.stk[G_STK_SIZE - 1u], G_PRIO, G_PRIO, &GMem.stk[0], G_STK_SIZE,
+			      (void *)0, OS_TASK_OPT_STK_CHK) == OS_ERR_NONE);
+	CHECK(TcbG->OSTCBStkBottom == &GMem.stk[OS_TASK_STK_GUARD_SIZE]);
+	CHECK(TcbG->OSTCBStkSize == G_STK_SIZE - OS_TASK_STK_GUARD_SIZE);
+	CHECK(GMem.stk[0] == 0u && GMem.stk[OS_TASK_STK_GUARD_SIZE - 1u] == 0u);
+	CHECK(guard + OS_CPU_STK_GUARD_SPAN <= &GMem.stk[OS_TASK_STK_GUARD_SIZE]);
+	CHECK(OSTaskStkChk(G_PRIO, &data) == OS_ERR_NONE);
+	CHECK(data.OSFree + data.OSUsed == (G_STK_SIZE - OS_TASK_STK_GUARD_SIZE) * sizeof(OS_STK));
+
+#if OS_CPU_MPU_EN > 0
+	/* Region moved over the guard of the task switched in, no access */
+	CHECK(HostRegMpuCtrl == (OS_CPU_CM3_MPU_CTRL_PRIVDEFENA | OS_CPU_CM3_MPU_CTRL_ENABLE));
+	CHECK(GRbar == (INT32U) (uintptr_t) guard && GRasr == OS_CPU_CM3_MPU_RASR_GUARD);
+	CHECK((GRasr & 0x07000000u) == 0u);	/* AP = 000                           */
+	CHECK(HostRegMpuRnr == OS_CPU_MPU_GUARD_RGN && HostRegMpuRasr == 0u);	/* Main has no guard  */
+#else
+	/* A write into the span is reported when the task is switched out */
+	GWrite = &guard[OS_CPU_STK_GUARD_SPAN - 1u];
+	OSSemPost(GoG);
+	CHECK(HostStkOvfCtr == 1u && HostStkOvfTcb == TcbG);
+	guard[OS_CPU_STK_GUARD_SPAN - 1u] = 0u;
+	GWrite = &guard[OS_CPU_STK_GUARD_SPAN];	/* Reserved, outside the span       */
+	OSSemPost(GoG);
+	CHECK(HostStkOvfCtr == 1u);
+#endif
+
+	/* Cost per switch into (MPU) or out of (software check) a task with a guard */
+	pcur = OSTCBCur;
+	OSTCBCur = TcbG;
+	OSTCBHighRdy = TcbG;
+	ts = OS_CPU_TS_GET();
+	for (i = 0u; i < N_CALLS; i++) {
+		OS_CPU_StkGuardSw();
+	}
+	ts = OS_CPU_TS_GET() - ts;
+	OSTCBCur = pcur;
+	OSTCBHighRdy = pcur;
+	printf("stk_guard: %s check, OS_CPU_StkGuardSw(): %4.1f per switch\n",
+	       (OS_CPU_MPU_EN > 0) ? "MPU" : "software", (double)ts / N_CALLS);
+	(void)err;
+	HostDone("stk_guard");
+}
+
+int main(void)
+{
+	OSInit();
+	OSTaskCreate(MainTask, (void *)0, &MainStk[127], MAIN_PRIO);
+	OSStart();
+	return (1);
+}
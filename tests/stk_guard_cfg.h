@@ -0,0 +1,2 @@
+#undef  OS_TASK_STK_GUARD_EN
+#define OS_TASK_STK_GUARD_EN      1u
@@ -0,0 +1,144 @@
+/*
+ * Preemption thresholds (OS_TASK_THRESHOLD_EN): a task keeps its threshold from dispatch until it blocks,
+ * even across a preemption by a task above the threshold, and the tasks between its threshold and its
+ * priority do not switch in and out of it.
+ */
+
+#include <string.h>
+#include "host.h"
+
+#define  MAIN_PRIO   2u
+#define  H_PRIO      5u
+#define  THRESH     10u
+#define  M_PRIO     20u
+#define  L_PRIO     30u
+#define  N_POSTS    10u
+
+static OS_STK MainStk[128], HStk[128], MStk[128], LStk[128];
+static OS_EVENT *GoH, *GoM, *GoL, *GoMain;
+static INT8U Mode;
+static char Order[32];
+static INT8U OrderLen;
+
+static void Log(char c)
+{
+	Order[OrderLen++] = c;
+}
+
+static void HTask(void *p_arg)
+{
+	INT8U err;
+
+	(void)p_arg;
+	for (;;) {
+		OSSemPend(GoH, 0u, &err);
+		Log('H');
+	}
+}
+
+static void MTask(void *p_arg)
+{
+	INT8U err;
+
+	(void)p_arg;
+	for (;;) {
+		OSSemPend(GoM, 0u, &err);
+		Log('M');
+	}
+}
+
+static void LTask(void *p_arg)
+{
+	INT8U err;
+	INT8U i;
+
+	(void)p_arg;
+	for (;;) {
+		OSSemPend(GoL, 0u, &err);
+		if (Mode == 0u) {	/* M made ready, then H preempts      */
+			Log('l');
+			OSSemPost(GoM);
+			OSSemPost(GoH);
+			Log('L');
+		} else if (Mode == 1u) {	/* M made ready N_POSTS times         */
+			for (i = 0u; i < N_POSTS; i++) {
+				OSSemPost(GoM);
+			}
+		} else {	/* Main deletes L while M waits       */
+			OSSemPost(GoM);
+			OSSemPost(GoMain);
+		}
+	}
+}
+
+static INT32U Run(INT8U threshold)
+{
+	INT32U sw;
+
+	CHECK(OSTaskThresholdSet(L_PRIO, threshold) == OS_ERR_NONE);
+	OrderLen = 0u;
+	HostSwCtr = 0u;
+	OSSemPost(GoL);
+	OSTimeDly(2u);
+	sw = HostSwCtr;
+	return (sw);
+}
+
+static void MainTask(void *p_arg)
+{
+	INT32U sw_thresh;
+	INT32U sw_prio;
+	OS_TCB *ptcb;
+	INT8U err;
+
+	(void)p_arg;
+	GoMain = OSSemCreate(0u);
+	GoH = OSSemCreate(0u);
+	GoM = OSSemCreate(0u);
+	GoL = OSSemCreate(0u);
+	OSTaskCreate(HTask, (void *)0, &HStk[127], H_PRIO);
+	OSTaskCreate(MTask, (void *)0, &MStk[127], M_PRIO);
+	OSTaskCreate(LTask, (void *)0, &LStk[127], L_PRIO);
+	OSTimeDly(1u);
+
+	/* M stays out after H, which is above the threshold, preempted L and blocked */
+	Mode = 0u;
+	Run(THRESH);
+	CHECK(OrderLen == 4u && memcmp(Order, "lHLM", 4u) == 0);
+	CHECK(OSTCBThreshList == (OS_TCB *) 0);	/* L dropped once it blocked */
+	CHECK(OSTCBPrioTbl[L_PRIO]->OSTCBThreshOn == OS_FALSE);
+	Run(L_PRIO);
+	CHECK(OrderLen == 4u && memcmp(Order, "lMHL", 4u) == 0);
+
+	/* Context switches with and without the threshold */
+	Mode = 1u;
+	sw_thresh = Run(THRESH);
+	CHECK(OrderLen == N_POSTS);
+	sw_prio = Run(L_PRIO);
+	CHECK(OrderLen == N_POSTS);
+	printf("threshold: %u posts to a task between threshold and priority: %lu context switches with "
+	       "the threshold, %lu without\n", N_POSTS, (unsigned long)sw_thresh, (unsigned long)sw_prio);
+	CHECK(sw_thresh < sw_prio);
+
+	/* Deleting a task that runs at its threshold */
+	Mode = 2u;
+	ptcb = OSTCBPrioTbl[L_PRIO];
+	CHECK(OSTaskThresholdSet(L_PRIO, THRESH) == OS_ERR_NONE);
+	OrderLen = 0u;
+	OSSemPost(GoL);
+	OSSemPend(GoMain, 0u, &err);
+	CHECK(OSTCBThreshList == ptcb && ptcb->OSTCBThreshOn == OS_TRUE);
+	CHECK(OSTaskDel(L_PRIO) == OS_ERR_NONE);
+	CHECK(OSTCBThreshList == (OS_TCB *) 0 && ptcb->OSTCBThreshOn == OS_FALSE);
+	OSTimeDly(1u);
+	CHECK(OrderLen == 1u && Order[0] == 'M');
+	HostDone("threshold");
+}
+
+int main(void)
+{
+	OSInit();
+	OSTaskCreate(MainTask, (void *)0, &MainStk[127], MAIN_PRIO);
+	OSStart();
+	return (1);
+}
@@ -0,0 +1,2 @@
+#undef  OS_TASK_THRESHOLD_EN
+#define OS_TASK_THRESHOLD_EN      1u
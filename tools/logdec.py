@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+"""Decode the binary log written by srccode/log.c.
+
+usage: logdec.py <image.axf> [capture.bin] [--hz 72000000]
+
+Format strings (and strings passed as %s) are looked up by address in the
+ELF image that was flashed, so the image must match the firmware that
+produced the capture.  The capture is read from stdin when not given.
+"""
+
+import re
+import struct
+import sys
+
+LOG_SYNC = 0xA5
+
+
+class Image:
+    def __init__(self, path):
+        data = open(path, 'rb').read()
+        if data[:4] != b'\x7fELF' or data[4] != 1 or data[5] != 1:
+            raise SystemExit('%s: not a 32-bit little-endian ELF file' % path)
+        shoff, = struct.unpack_from('<I', data, 0x20)
+        shentsize, shnum = struct.unpack_from('<HH', data, 0x2E)
+        self.sections = []
+        for i in range(shnum):
+            (name, stype, flags, addr, off, size) = struct.unpack_from('<IIIIII', data, shoff + i * shentsize)
+            if stype == 1 and (flags & 0x2) and addr != 0:      # SHT_PROGBITS, SHF_ALLOC
+                self.sections.append((addr, data[off:off + size]))
+
+    def string(self, addr):
+        for base, body in self.sections:
+            if base <= addr < base + len(body):
+                end = body.find(b'\0', addr - base)
+                return body[addr - base:end].decode('latin-1')
+        return None
+
+
+CONV = re.compile(r'%([-+ #0]*\d*(?:\.\d+)?)(?:hh|h|ll|l|z|t)?([diuxXcsp%])')
+
+
+def format_record(img, fmt, args):
+    args = list(args)
+
+    def conv(m):
+        flags, c = m.group(1), m.group(2)
+        if c == '%':
+            return '%'
+        v = args.pop(0) if args else 0
+        if c == 's':
+            s = img.string(v)
+            return ('%' + flags + 's') % (s if s is not None else '<0x%08X>' % v)
+        if c == 'p':
+            return '0x%08X' % v
+        if c in 'di' and v & 0x80000000:
+            v -= 1 << 32
+        if c == 'u':
+            c = 'd'
+        return ('%' + flags + c) % v
+
+    return CONV.sub(conv, fmt)
+
+
+def decode(img, stream, hz, out):
+    buf = stream.read()
+    i = 0
+    last = None
+    wraps = 0
+    while i + 12 <= len(buf):
+        hdr, addr, ts = struct.unpack_from('<III', buf, i)
+        nargs = hdr & 0xFF
+        if hdr >> 24 != LOG_SYNC or (hdr >> 16) & 0xFF != 0 or nargs > 4:
+            i += 1                                              # resynchronise
+            continue
+        if i + 12 + 4 * nargs > len(buf):
+            break
+        args = struct.unpack_from('<%dI' % nargs, buf, i + 12)
+        fmt = img.string(addr)
+        if fmt is None:
+            text = '<unknown format 0x%08X> %s' % (addr, ' '.join('0x%X' % a for a in args))
+        else:
+            text = format_record(img, fmt, args)
+        if last is not None and ts < last:                     # DWT counter wrapped
+            wraps += 1
+        last = ts
+        out.write('%12.6f [%2d] %s\n' % ((ts + (wraps << 32)) / hz, (hdr >> 8) & 0xFF, text.strip('\r\n')))
+        i += 12 + 4 * nargs
+
+
+def main(argv):
+    hz = 72000000
+    if '--hz' in argv:
+        k = argv.index('--hz')
+        hz = float(argv[k + 1])
+        del argv[k:k + 2]
+    if len(argv) not in (2, 3):
+        raise SystemExit(__doc__)
+    img = Image(argv[1])
+    stream = open(argv[2], 'rb') if len(argv) == 3 else sys.stdin.buffer
+    decode(img, stream, hz, sys.stdout)
+
+
+if __name__ == '__main__':
+    main(sys.argv)
@@ -0,0 +1,706 @@
+/*
+*********************************************************************************************************
+*                                                uC/OS-II
+*                                          The Real-Time Kernel
+*                                          COROUTINE MANAGEMENT
+*
+* File    : OS_CO.C
+* Version : V2.91
+*
+* A coroutine is a stackless activity hosted by a coroutine scheduler task (see OSCoSchedCreate()).  Its
+* function is written between OS_CO_BEGIN() and OS_CO_END() and is called again each time the coroutine
+* is ready; OS_CO_YIELD(), OS_CO_DLY(), OS_CO_PEND() and OS_CO_FLAG_PEND() save the line to resume from in
+* the OS_CO and return to the scheduler.  Local variables are NOT preserved across these macros, the state
+* of a coroutine is kept in a structure that begins with its OS_CO.
+*
+* A coroutine waits for a semaphore, mailbox or queue by registering the event in its OS_CO.  When no
+* coroutine is ready, the scheduler task pends on all the registered events at once with
+* OSEventPendMulti() (up to OS_CO_PEND_MAX of them, further ones are polled every tick) and hands each
+* event it gets to the first coroutine waiting for it.  Event flag groups can't be multi-pended and are
+* polled every tick.
+*
+* The coroutines of a scheduler live in a table given to OSCoSchedCreate() and are linked by their index in
+* it.  An OS_CO is 20 bytes on a Cortex-M3, i.e. a thousand coroutines take about 20 KB plus their own
+* state, instead of a thousand TCBs and stacks (see tests/bench_co.c).  Like a job (see OS_JOB.C), a
+* coroutine MUST NOT call services that block.
+*********************************************************************************************************
+*/
+
+#ifndef  OS_MASTER_FILE
+#include <ucos_ii.h>
+#endif
+
+#if OS_CO_EN > 0u
+/*
+*********************************************************************************************************
+*                                               LOCAL MACROS
+*********************************************************************************************************
+*/
+
+#define  OS_CO_PTR(psched, ix)  ((OS_CO *)(void *)((psched)->OSCoSchedTbl + (INT32U)(ix) * (psched)->OSCoSchedCoSize))
+
+/*
+*********************************************************************************************************
+*                                          LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static BOOLEAN OS_CoEventAccept(OS_CO * pco);
+
+static void OS_CoGive(OS_CO_SCHED * psched, OS_EVENT * pevent, void *pmsg);
+
+static void OS_CoPoll(OS_CO * pco, INT16U now);
+
+static BOOLEAN OS_CoScan(OS_CO_SCHED * psched, INT32U * ptimeout, INT16U * pnbr_pend);
+
+static void OS_CoSchedTask(void *p_arg);
+
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                           CREATE A COROUTINE
+*
+* Description: This function initializes a coroutine and adds it to a coroutine scheduler.  The
+*              coroutine is ready and runs from OS_CO_BEGIN() the next time the scheduler task runs.
+*
+* Arguments  : psched        is a pointer to the scheduler created by OSCoSchedCreate().
+*
+*              pco           is a pointer to the coroutine, an entry of the table of the scheduler.  It is
+*                            usually the first member of a structure holding the state of the coroutine.
+*
+*              fnct          is the function of the coroutine.  It is called with 'pco'.
+*
+* Returns    : OS_ERR_NONE          if the coroutine was added.
+*              OS_ERR_PDATA_NULL    if 'psched', 'pco' or 'fnct' is a NULL pointer.
+*              OS_ERR_CO_INVALID    if 'pco' is not an entry of the table of the scheduler.
+*
+* Note(s)    : 1) This function may be called from a task, from an ISR or from a coroutine.
+*              2) A coroutine is removed from its scheduler when it reaches OS_CO_END(); its OS_CO may
+*                 then be reused.
+*********************************************************************************************************
+*/
+
+INT8U OSCoCreate(OS_CO_SCHED * psched, OS_CO * pco, OS_CO_FNCT fnct)
+{
+	INT32U offset;
+	INT16U ix;
+#if OS_CRITICAL_METHOD == 3u	/* Allocate storage for CPU status register           */
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+
+#if OS_ARG_CHK_EN > 0u
+	if ((psched == (OS_CO_SCHED *) 0) || (pco == (OS_CO *) 0) || (fnct == (OS_CO_FNCT) 0)) {
+		return (OS_ERR_PDATA_NULL);
+	}
+#endif
+	offset = (INT32U) ((INT8U *) pco - psched->OSCoSchedTbl);
+#if OS_ARG_CHK_EN > 0u
+	if (((INT8U *) pco < psched->OSCoSchedTbl) ||	/* Must be an entry of the table                      */
+	    (offset >= (INT32U) psched->OSCoSchedTblSize * psched->OSCoSchedCoSize) ||
+	    ((offset % psched->OSCoSchedCoSize) != 0u)) {
+		return (OS_ERR_CO_INVALID);
+	}
+#endif
+	ix = (INT16U) (offset / psched->OSCoSchedCoSize);
+	pco->OSCoFnct = fnct;
+	pco->OSCoEventPtr = (void *) 0;
+	pco->OSCoMsg = (void *) 0;
+	pco->OSCoDly = 0u;
+	pco->OSCoLine = 0u;
+	pco->OSCoStat = OS_CO_STAT_RDY;
+	pco->OSCoErr = OS_ERR_NONE;
+	OS_ENTER_CRITICAL();
+	pco->OSCoNext = psched->OSCoSchedList;	/* Link at the head, the scheduler only unlinks       */
+	psched->OSCoSchedList = ix;
+	OS_EXIT_CRITICAL();
+	(void) OSSemPost(psched->OSCoSchedSem);	/* Wake the scheduler task                            */
+	return (OS_ERR_NONE);
+}
+
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                          DELAY A COROUTINE
+*
+* Description: This function is called by OS_CO_DLY() to make the coroutine wait for a number of ticks.
+*
+* Arguments  : pco           is a pointer to the coroutine.
+*
+*              ticks         is the number of ticks to wait.  0 only yields to the other coroutines.  A
+*                            delay longer than OS_CO_DLY_MAX ticks is cut to OS_CO_DLY_MAX.
+*
+* Returns    : none
+*********************************************************************************************************
+*/
+
+void OSCoDly(OS_CO * pco, INT16U ticks)
+{
+#if OS_CRITICAL_METHOD == 3u	/* Allocate storage for CPU status register           */
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+
+	pco->OSCoErr = OS_ERR_NONE;
+	if (ticks > OS_CO_DLY_MAX) {
+		ticks = OS_CO_DLY_MAX;
+	}
+	if (ticks > 0u) {
+		OS_ENTER_CRITICAL();
+		pco->OSCoDly = (INT16U) OSTime + ticks;	/* Tick at which the delay expires                    */
+		OS_EXIT_CRITICAL();
+		pco->OSCoStat = OS_CO_STAT_DLY;
+	}
+}
+
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                  WAIT FOR A SEMAPHORE, MAILBOX OR QUEUE
+*
+* Description: This function is called by OS_CO_PEND() to take a semaphore or a message.  If none is
+*              available, the event is registered in the coroutine, which waits for it.
+*
+* Arguments  : pco           is a pointer to the coroutine.
+*
+*              pevent        is a pointer to the semaphore, mailbox or queue.
+*
+*              timeout       is the maximum number of ticks to wait (at most OS_CO_DLY_MAX).  0 waits
+*                            forever.
+*
+* Returns    : OS_TRUE       if the coroutine may go on, 'pco->OSCoErr' is then:
+*                               OS_ERR_NONE          the semaphore was taken or 'pco->OSCoMsg' holds the
+*                                                    message.
+*                               OS_ERR_PEVENT_NULL   'pevent' is a NULL pointer.
+*                               OS_ERR_EVENT_TYPE    'pevent' is not a semaphore, mailbox or queue.
+*              OS_FALSE      if the coroutine must wait.  When it resumes, 'pco->OSCoErr' is OS_ERR_NONE
+*                            or OS_ERR_TIMEOUT.
+*********************************************************************************************************
+*/
+
+BOOLEAN OSCoPend(OS_CO * pco, OS_EVENT * pevent, INT16U timeout)
+{
+#if OS_CRITICAL_METHOD == 3u	/* Allocate storage for CPU status register           */
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+
+	pco->OSCoMsg = (void *) 0;
+#if OS_ARG_CHK_EN > 0u
+	if (pevent == (OS_EVENT *) 0) {
+		pco->OSCoErr = OS_ERR_PEVENT_NULL;
+		return (OS_TRUE);
+	}
+#endif
+	switch (pevent->OSEventType) {	/* Only these types can be multi-pended               */
+	case OS_EVENT_TYPE_SEM:
+	case OS_EVENT_TYPE_MBOX:
+	case OS_EVENT_TYPE_Q:
+		break;
+
+	default:
+		pco->OSCoErr = OS_ERR_EVENT_TYPE;
+		return (OS_TRUE);
+	}
+	pco->OSCoEventPtr = (void *) pevent;
+	pco->OSCoErr = OS_ERR_NONE;
+	if (OS_CoEventAccept(pco) == OS_TRUE) {	/* Don't wait if the event is available               */
+		return (OS_TRUE);
+	}
+	pco->OSCoStat = OS_CO_STAT_PEND;
+	if (timeout > OS_CO_DLY_MAX) {
+		timeout = OS_CO_DLY_MAX;
+	}
+	if (timeout > 0u) {
+		OS_ENTER_CRITICAL();
+		pco->OSCoDly = (INT16U) OSTime + timeout;
+		OS_EXIT_CRITICAL();
+		pco->OSCoStat |= OS_CO_STAT_DLY;
+	}
+	return (OS_FALSE);
+}
+
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                       WAIT FOR EVENT FLAG(S)
+*
+* Description: This function is called by OS_CO_FLAG_PEND() to wait for a combination of event flags.
+*
+* Arguments  : pco           is a pointer to the coroutine.
+*
+*              pgrp          is a pointer to the event flag group.
+*
+*              flags         is a bit pattern indicating which bit(s) (i.e. flags) to wait for.
+*
+*              wait_type     specifies the wait type as for OSFlagPend(), OS_FLAG_CONSUME included.
+*
+*              timeout       is the maximum number of ticks to wait (at most OS_CO_DLY_MAX).  0 waits
+*                            forever.
+*
+* Returns    : OS_TRUE       if the coroutine may go on, 'pco->OSCoErr' is then OS_ERR_NONE (the flags
+*                            that made the condition true are in 'pco->OSCoMsg') or any error of
+*                            OSFlagAccept() but OS_ERR_FLAG_NOT_RDY.
+*              OS_FALSE      if the coroutine must wait.  When it resumes, 'pco->OSCoErr' is OS_ERR_NONE
+*                            or OS_ERR_TIMEOUT.
+*
+* Note(s)    : 1) The group is polled every tick while the coroutine waits.  'pco->OSCoErr' holds the wait
+*                 type until then.
+*********************************************************************************************************
+*/
+
+#if (OS_FLAG_EN > 0u) && (OS_FLAG_ACCEPT_EN > 0u)
+BOOLEAN OSCoFlagPend(OS_CO * pco, OS_FLAG_GRP * pgrp, OS_FLAGS flags, INT8U wait_type, INT16U timeout)
+{
+	OS_FLAGS flags_rdy;
+#if OS_CRITICAL_METHOD == 3u	/* Allocate storage for CPU status register           */
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+
+	flags_rdy = OSFlagAccept(pgrp, flags, wait_type, &pco->OSCoErr);
+	if (pco->OSCoErr != OS_ERR_FLAG_NOT_RDY) {
+		pco->OSCoMsg = (void *) (INT32U) flags_rdy;
+		return (OS_TRUE);
+	}
+	pco->OSCoEventPtr = (void *) pgrp;
+	pco->OSCoMsg = (void *) (INT32U) flags;	/* Keep the flags to poll for                         */
+	pco->OSCoErr = wait_type;	/* Until the flags are accepted or the wait times out */
+	pco->OSCoStat = OS_CO_STAT_PEND_FLAG;
+	if (timeout > OS_CO_DLY_MAX) {
+		timeout = OS_CO_DLY_MAX;
+	}
+	if (timeout > 0u) {
+		OS_ENTER_CRITICAL();
+		pco->OSCoDly = (INT16U) OSTime + timeout;
+		OS_EXIT_CRITICAL();
+		pco->OSCoStat |= OS_CO_STAT_DLY;
+	}
+	return (OS_FALSE);
+}
+#endif
+
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                     CREATE A COROUTINE SCHEDULER
+*
+* Description: This function creates the task that runs the coroutines added with OSCoCreate().
+*
+* Arguments  : psched        is a pointer to the scheduler to initialize.
+*
+*              prio          is the priority of the scheduler task.  All its coroutines run at this
+*                            priority, on the stack given below.
+*
+*              pstk          is a pointer to the LOWEST address of the stack of the scheduler task.
+*
+*              stk_size      is the size of that stack in OS_STK entries.
+*
+*              pco_tbl       is a pointer to the table of coroutines of the scheduler.  Each entry begins
+*                            with an OS_CO, usually followed by the state of the coroutine.
+*
+*              co_nbr        is the number of entries in the table.
+*
+*              co_size       is the size of an entry in bytes, e.g. sizeof(MY_STATE).
+*
+* Returns    : OS_ERR_NONE              if the scheduler was created.
+*              OS_ERR_CREATE_ISR        if you called this function from an ISR.
+*              OS_ERR_PDATA_NULL        if 'psched', 'pstk' or 'pco_tbl' is a NULL pointer.
+*              OS_ERR_CO_INVALID_SIZE   if 'co_nbr' is 0 or not below OS_CO_NONE, or if 'co_size' is smaller
+*                                       than an OS_CO.
+*              OS_ERR_CO_NO_EVENT       if no event control block was left for the scheduler.
+*              Any of the errors of OSTaskCreateExt() (or OSTaskCreate()), e.g. OS_ERR_PRIO_EXIST.
+*
+* Note(s)    : 1) The scheduler uses one semaphore, i.e. one of the OS_MAX_EVENTS event control blocks,
+*                 to be woken when a coroutine is added.
+*********************************************************************************************************
+*/
+
+INT8U OSCoSchedCreate(OS_CO_SCHED * psched, INT8U prio, OS_STK * pstk, INT32U stk_size,
+		      void *pco_tbl, INT16U co_nbr, INT16U co_size)
+{
+	OS_EVENT *psem;
+	INT8U err;
+#if OS_SEM_DEL_EN > 0u
+	INT8U err_del;
+#endif
+
+
+#ifdef OS_SAFETY_CRITICAL_IEC61508
+	if (OSSafetyCriticalStartFlag == OS_TRUE) {
+		OS_SAFETY_CRITICAL_EXCEPTION();
+	}
+#endif
+
+#if OS_ARG_CHK_EN > 0u
+	if ((psched == (OS_CO_SCHED *) 0) || (pstk == (OS_STK *) 0) || (pco_tbl == (void *) 0)) {
+		return (OS_ERR_PDATA_NULL);
+	}
+	if ((co_nbr == 0u) || (co_nbr >= OS_CO_NONE) || (co_size < sizeof(OS_CO))) {
+		return (OS_ERR_CO_INVALID_SIZE);
+	}
+#endif
+	if (OSIntNesting > 0u) {	/* See if called from ISR ...                         */
+		return (OS_ERR_CREATE_ISR);	/* ... can't CREATE from an ISR                       */
+	}
+	psem = OSSemCreate(0u);
+	if (psem == (OS_EVENT *) 0) {
+		return (OS_ERR_CO_NO_EVENT);
+	}
+	psched->OSCoSchedTbl = (INT8U *) pco_tbl;	/* Initialize the scheduler before its task can run   */
+	psched->OSCoSchedTblSize = co_nbr;
+	psched->OSCoSchedCoSize = co_size;
+	psched->OSCoSchedList = OS_CO_NONE;
+	psched->OSCoSchedSem = psem;
+	psched->OSCoSchedPrio = prio;
+
+#if OS_TASK_CREATE_EXT_EN > 0u
+#if OS_STK_GROWTH == 1u
+	err = OSTaskCreateExt(OS_CoSchedTask, (void *) psched,	/* Pass the scheduler to its task            */
+			      &pstk[stk_size - 1u],	/* Set Top-Of-Stack                           */
+			      prio, prio, &pstk[0],	/* Set Bottom-Of-Stack                        */
+			      stk_size, (void *) 0,	/* No TCB extension                           */
+			      OS_TASK_OPT_STK_CHK | OS_TASK_OPT_STK_CLR);	/* Enable stack checking + clear stack        */
+#else
+	err = OSTaskCreateExt(OS_CoSchedTask, (void *) psched,	/* Pass the scheduler to its task            */
+			      &pstk[0],	/* Set Top-Of-Stack                           */
+			      prio, prio, &pstk[stk_size - 1u],	/* Set Bottom-Of-Stack                        */
+			      stk_size, (void *) 0,	/* No TCB extension                           */
+			      OS_TASK_OPT_STK_CHK | OS_TASK_OPT_STK_CLR);	/* Enable stack checking + clear stack        */
+#endif
+#else
+#if OS_STK_GROWTH == 1u
+	err = OSTaskCreate(OS_CoSchedTask, (void *) psched, &pstk[stk_size - 1u], prio);
+#else
+	err = OSTaskCreate(OS_CoSchedTask, (void *) psched, &pstk[0], prio);
+#endif
+#endif
+	if (err != OS_ERR_NONE) {
+#if OS_SEM_DEL_EN > 0u
+		(void) OSSemDel(psem, OS_DEL_ALWAYS, &err_del);	/* Give the ECB back                 */
+#endif
+		psched->OSCoSchedSem = (OS_EVENT *) 0;
+		return (err);
+	}
+#if OS_TASK_NAME_EN > 0u
+	OSTaskNameSet(prio, (INT8U *) (void *) "uC/OS-II Co", &err);
+#endif
+	return (OS_ERR_NONE);
+}
+
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                TAKE THE EVENT A COROUTINE WAITS FOR
+*
+* Description: This function takes the semaphore or the message registered in a coroutine, if one is
+*              available, the same way OSEventPendMulti() does.
+*
+* Arguments  : pco           is a pointer to the coroutine.
+*
+* Returns    : OS_TRUE       if the event was taken, the message (if any) is in 'pco->OSCoMsg'.
+*              OS_FALSE      if not.
+*********************************************************************************************************
+*/
+
+static BOOLEAN OS_CoEventAccept(OS_CO * pco)
+{
+	OS_EVENT *pevent;
+#if (OS_Q_EN > 0u) && (OS_MAX_QS > 0u)
+	OS_Q *pq;
+#endif
+	BOOLEAN rdy;
+#if OS_CRITICAL_METHOD == 3u	/* Allocate storage for CPU status register           */
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+
+	pevent = (OS_EVENT *) pco->OSCoEventPtr;
+	rdy = OS_FALSE;
+	OS_ENTER_CRITICAL();
+	switch (pevent->OSEventType) {
+	case OS_EVENT_TYPE_SEM:
+		if (pevent->OSEventCnt > 0u) {	/* If semaphore count > 0, resource available         */
+			pevent->OSEventCnt--;
+			rdy = OS_TRUE;
+		}
+		break;
+
+#if OS_MBOX_EN > 0u
+	case OS_EVENT_TYPE_MBOX:
+		if (pevent->OSEventPtr != (void *) 0) {	/* If mailbox NOT empty, take the message             */
+			pco->OSCoMsg = pevent->OSEventPtr;
+			pevent->OSEventPtr = (void *) 0;
+			rdy = OS_TRUE;
+		}
+		break;
+#endif
+
+#if (OS_Q_EN > 0u) && (OS_MAX_QS > 0u)
+	case OS_EVENT_TYPE_Q:
+		pq = (OS_Q *) pevent->OSEventPtr;
+		if (pq->OSQEntries > 0u) {	/* If queue NOT empty, take the oldest message        */
+			pco->OSCoMsg = *pq->OSQOut++;
+			if (pq->OSQOut == pq->OSQEnd) {
+				pq->OSQOut = pq->OSQStart;
+			}
+			pq->OSQEntries--;
+			rdy = OS_TRUE;
+		}
+		break;
+#endif
+
+	default:
+		break;
+	}
+	OS_EXIT_CRITICAL();
+	return (rdy);
+}
+
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                             HAND AN EVENT OVER TO A WAITING COROUTINE
+*
+* Description: This function gives an event returned by OSEventPendMulti() to the first coroutine that
+*              waits for it.
+*
+* Arguments  : psched        is a pointer to the scheduler.
+*
+*              pevent        is a pointer to the event.
+*
+*              pmsg          is the message taken from the event (NULL for a semaphore).
+*
+* Returns    : none
+*
+* Note(s)    : 1) The pend list only holds events that a coroutine waits for, and only the scheduler
+*                 task changes the state of its coroutines, so there is always one to give it to.
+*********************************************************************************************************
+*/
+
+static void OS_CoGive(OS_CO_SCHED * psched, OS_EVENT * pevent, void *pmsg)
+{
+	OS_CO *pco;
+	INT16U ix;
+
+
+	ix = psched->OSCoSchedList;
+	while (ix != OS_CO_NONE) {
+		pco = OS_CO_PTR(psched, ix);
+		if (((pco->OSCoStat & OS_CO_STAT_PEND) != 0u) && (pco->OSCoEventPtr == (void *) pevent)) {
+			pco->OSCoMsg = pmsg;
+			pco->OSCoErr = OS_ERR_NONE;
+			pco->OSCoStat = OS_CO_STAT_RDY;
+			return;
+		}
+		ix = pco->OSCoNext;
+	}
+}
+
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                    SEE IF A COROUTINE CAN RESUME
+*
+* Description: This function readies a waiting coroutine if its event is available or if its delay or
+*              timeout expired.
+*
+* Arguments  : pco           is a pointer to the coroutine.
+*
+*              now           is the current tick count (low 16 bits).
+*
+* Returns    : none
+*********************************************************************************************************
+*/
+
+static void OS_CoPoll(OS_CO * pco, INT16U now)
+{
+#if (OS_FLAG_EN > 0u) && (OS_FLAG_ACCEPT_EN > 0u)
+	OS_FLAGS flags_rdy;
+	INT8U err;
+#endif
+
+
+	if ((pco->OSCoStat & OS_CO_STAT_PEND) != 0u) {
+		if (OS_CoEventAccept(pco) == OS_TRUE) {
+			pco->OSCoErr = OS_ERR_NONE;
+			pco->OSCoStat = OS_CO_STAT_RDY;
+			return;
+		}
+	}
+#if (OS_FLAG_EN > 0u) && (OS_FLAG_ACCEPT_EN > 0u)
+	if ((pco->OSCoStat & OS_CO_STAT_PEND_FLAG) != 0u) {
+		flags_rdy = OSFlagAccept((OS_FLAG_GRP *) pco->OSCoEventPtr, (OS_FLAGS) (INT32U) pco->OSCoMsg,
+					 pco->OSCoErr, &err);
+		if (err == OS_ERR_NONE) {
+			pco->OSCoMsg = (void *) (INT32U) flags_rdy;
+			pco->OSCoErr = OS_ERR_NONE;
+			pco->OSCoStat = OS_CO_STAT_RDY;
+			return;
+		}
+	}
+#endif
+	if ((pco->OSCoStat & OS_CO_STAT_DLY) != 0u) {
+		if ((INT16S) (INT16U) (pco->OSCoDly - now) <= 0) {	/* Delay or timeout expired                           */
+			if ((pco->OSCoStat & (OS_CO_STAT_PEND | OS_CO_STAT_PEND_FLAG)) != 0u) {
+				pco->OSCoMsg = (void *) 0;
+				pco->OSCoErr = OS_ERR_TIMEOUT;
+			}
+			pco->OSCoStat = OS_CO_STAT_RDY;
+		}
+	}
+}
+
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                        RUN THE READY COROUTINES
+*
+* Description: This function makes one pass over the coroutines of a scheduler.  It runs each coroutine
+*              that is or becomes ready, removes the ones that ended and builds the pend list of the
+*              scheduler task from the events the others wait for.
+*
+* Arguments  : psched        is a pointer to the scheduler.
+*
+*              ptimeout      is where the number of ticks until the nearest delay or timeout expires is
+*                            returned (0 if none, 1 if some events must be polled).
+*
+*              pnbr_pend     is where the number of events put in the pend list is returned.
+*
+* Returns    : OS_TRUE       if a coroutine ran, i.e. another pass is needed.
+*              OS_FALSE      if none was ready.
+*********************************************************************************************************
+*/
+
+static BOOLEAN OS_CoScan(OS_CO_SCHED * psched, INT32U * ptimeout, INT16U * pnbr_pend)
+{
+	OS_CO *pco;
+	OS_CO *pco_prev;
+	INT16U ix;
+	INT16U ix_next;
+	INT16U now;
+	INT16U ticks;
+	INT16U i;
+	BOOLEAN ran;
+	BOOLEAN poll;
+#if OS_CRITICAL_METHOD == 3u	/* Allocate storage for CPU status register           */
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+
+	ran = OS_FALSE;
+	poll = OS_FALSE;
+	*ptimeout = 0u;
+	*pnbr_pend = 0u;
+	OS_ENTER_CRITICAL();
+	now = (INT16U) OSTime;
+	ix = psched->OSCoSchedList;	/* Coroutines added during the pass wait for the next */
+	OS_EXIT_CRITICAL();
+	pco_prev = (OS_CO *) 0;
+	while (ix != OS_CO_NONE) {
+		pco = OS_CO_PTR(psched, ix);
+		ix_next = pco->OSCoNext;
+		if (pco->OSCoStat != OS_CO_STAT_RDY) {
+			OS_CoPoll(pco, now);
+		}
+		if (pco->OSCoStat == OS_CO_STAT_RDY) {
+			(*pco->OSCoFnct) (pco);	/* Run the coroutine up to its next wait              */
+			ran = OS_TRUE;
+		}
+		if (pco->OSCoStat == OS_CO_STAT_DONE) {	/* Unlink a coroutine that ended                      */
+			OS_ENTER_CRITICAL();
+			if (pco_prev != (OS_CO *) 0) {
+				pco_prev->OSCoNext = ix_next;
+			} else if (psched->OSCoSchedList == ix) {
+				psched->OSCoSchedList = ix_next;
+			} else {	/* Coroutines were added in front of it         */
+				pco_prev = OS_CO_PTR(psched, psched->OSCoSchedList);
+				while (pco_prev->OSCoNext != ix) {
+					pco_prev = OS_CO_PTR(psched, pco_prev->OSCoNext);
+				}
+				pco_prev->OSCoNext = ix_next;
+				pco_prev = (OS_CO *) 0;
+			}
+			OS_EXIT_CRITICAL();
+		} else {
+			if ((pco->OSCoStat & OS_CO_STAT_DLY) != 0u) {	/* Find the nearest delay or timeout        */
+				ticks = (INT16U) (pco->OSCoDly - now);
+				if ((*ptimeout == 0u) || (ticks < *ptimeout)) {
+					*ptimeout = ticks;
+				}
+			}
+			if ((pco->OSCoStat & OS_CO_STAT_PEND) != 0u) {	/* Add its event to the pend list           */
+				for (i = 0u; i < *pnbr_pend; i++) {
+					if (psched->OSCoSchedPendTbl[i] == (OS_EVENT *) pco->OSCoEventPtr) {
+						break;
+					}
+				}
+				if (i == *pnbr_pend) {
+					if (i < OS_CO_PEND_MAX) {
+						psched->OSCoSchedPendTbl[i] = (OS_EVENT *) pco->OSCoEventPtr;
+						(*pnbr_pend)++;
+					} else {
+						poll = OS_TRUE;	/* No room left, poll it                        */
+					}
+				}
+			}
+			if ((pco->OSCoStat & OS_CO_STAT_PEND_FLAG) != 0u) {
+				poll = OS_TRUE;
+			}
+			pco_prev = pco;
+		}
+		ix = ix_next;
+	}
+	if (poll == OS_TRUE) {
+		*ptimeout = 1u;
+	}
+	return (ran);
+}
+
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                       COROUTINE SCHEDULER TASK
+*
+* Description: This task is created by OSCoSchedCreate().  It runs the ready coroutines until none is
+*              left, then pends on the events they wait for (and on its own semaphore) until one of them
+*              is posted or the nearest delay expires.
+*
+* Arguments  : p_arg         is a pointer to the scheduler.
+*
+* Returns    : none
+*
+* Note(s)    : 1) Coroutines that only yield keep the scheduler task ready, like any task that doesn't
+*                 block; tasks of lower priority then don't run.
+*********************************************************************************************************
+*/
+
+static void OS_CoSchedTask(void *p_arg)
+{
+	OS_CO_SCHED *psched;
+	OS_EVENT *pevent;
+	INT32U timeout;
+	INT16U nbr_pend;
+	INT16U nbr_rdy;
+	INT16U i;
+	INT8U err;
+
+
+	psched = (OS_CO_SCHED *) p_arg;
+	for (;;) {
+		if (OS_CoScan(psched, &timeout, &nbr_pend) == OS_TRUE) {
+			continue;
+		}
+		psched->OSCoSchedPendTbl[nbr_pend] = psched->OSCoSchedSem;
+		psched->OSCoSchedPendTbl[nbr_pend + 1u] = (OS_EVENT *) 0;
+		nbr_rdy = OSEventPendMulti(&psched->OSCoSchedPendTbl[0], &psched->OSCoSchedRdyTbl[0],
+					   &psched->OSCoSchedMsgTbl[0], timeout, &err);
+		for (i = 0u; i < nbr_rdy; i++) {	/* Hand the events over to the coroutines            */
+			pevent = psched->OSCoSchedRdyTbl[i];
+			if (pevent != psched->OSCoSchedSem) {
+				OS_CoGive(psched, pevent, psched->OSCoSchedMsgTbl[i]);
+			}
+		}
+	}
+}
+#endif				/* OS_CO_EN                                 */
@@ -654,6 +654,8 @@ void OSIntEnter(void)
 *                 to OSIntEnter() at the beginning of the ISR you MUST have a call to OSIntExit() at the
 *                 end of the ISR.
 *              2) Rescheduling is prevented when the scheduler is locked (see OS_SchedLock())
+*              3) The search for the highest priority task is skipped unless OSSchedReq indicates that
+*                 the ready list changed in a way that could affect the outcome.
 *********************************************************************************************************
 */
 
@@ -672,10 +674,15 @@ void OSIntExit(void)
 			OSIntNesting--;
 		}
 		if (OSIntNesting == 0u) {	/* жǷǶ Reschedule only if all ISRs complete ... */
-			if (OSLockNesting == 0u) {	/* ҵǷ ... and not locked.                      */
+			if ((OSLockNesting == 0u) && (OSSchedReq == OS_TRUE)) {	/* ҵǷ ... and not locked.                      */
+				OSSchedReq = OS_FALSE;
 				OS_SchedNew();          //ҳ׼ߵȼ
 				OSTCBHighRdy = OSTCBPrioTbl[OSPrioHighRdy]; //ȼӦTCB
+#if OS_TASK_RR_EN > 0u
+				if ((OSPrioHighRdy != OSPrioCur) || (OSTCBHighRdy != OSTCBCur)) {	/* Peer at same prio? */
+#else
 				if (OSPrioHighRdy != OSPrioCur) {	/*ҳTCBǱжϵTCBô No Ctx Sw if current task is highest rdy */
+#endif
 #if OS_TASK_PROFILE_EN > 0u
 					OSTCBHighRdy->OSTCBCtxSwCtr++;	/* Inc. # of context switches to this task  */
 #endif
@@ -823,6 +830,7 @@ void OSStart(void)
 {
 	if (OSRunning == OS_FALSE) {        //ںô
 		OS_SchedNew();	/* ҵ׼ȼ Find highest priority's task priority number   */
+		OSSchedReq = OS_FALSE;
 		OSPrioCur = OSPrioHighRdy;  //Ϊǰȼ
 		OSTCBHighRdy = OSTCBPrioTbl[OSPrioHighRdy];	/*ҵӦTCB Point to highest priority task ready to run    */
 		OSTCBCur = OSTCBHighRdy;    //ΪǰTCB
@@ -893,6 +901,9 @@ void OSTimeTick(void)
 #if OS_TICK_STEP_EN > 0u
 	BOOLEAN step;
 #endif
+#if OS_TASK_BUDGET_EN > 0u
+	INT32U ts;
+#endif
 #if OS_CRITICAL_METHOD == 3u	/* Allocate storage for CPU status register     */
 	OS_CPU_SR cpu_sr = 0u;      //÷ʽжϣҪcpu_srж״̬
 #endif
@@ -931,10 +942,58 @@ void OSTimeTick(void)
 		if (step == OS_FALSE) {	/* Return if waiting for step command           */
 			return;
 		}
+#endif
+#if OS_TASK_BUDGET_EN > 0u
+		OS_ENTER_CRITICAL();
+		ptcb = OSTCBCur;	/* Charge the CPU time of the running task      */
+		if ((ptcb->OSTCBOpt & OS_TASK_OPT_BUDGET) != 0u) {
+			ts = OS_CPU_TS_GET();
+			ptcb->OSTCBBudgetUsed += ts - ptcb->OSTCBBudgetStart;
+			ptcb->OSTCBBudgetStart = ts;
+			if ((ptcb->OSTCBBudgetUsed >= ptcb->OSTCBBudget) && (OSLockNesting == 0u)) {
+				if (OS_RdyListHas(ptcb)) {	/* Budget used up, hold task until replenished  */
+					ptcb->OSTCBStat |= OS_STAT_BUDGET;
+					OS_RdyListRemove(ptcb);
+					ptcb->OSTCBBudgetOverrunCtr++;
+					OSTaskBudgetHook(ptcb);	/* Report the overrun                           */
+				}
+			}
+		}
+		OS_EXIT_CRITICAL();
+#endif
+#if OS_TASK_RR_EN > 0u
+		OS_ENTER_CRITICAL();
+		if (OSLockNesting == 0u) {	/* Charge the time slice of the running task    */
+			ptcb = OSTCBCur;
+			if ((OS_RdyListHas(ptcb)) && (OSTCBPrioTbl[ptcb->OSTCBPrio] == ptcb)) {
+				if (ptcb->OSTCBRRCtr > 1u) {
+					ptcb->OSTCBRRCtr--;
+				} else {	/* Time slice used up, next peer's turn         */
+					OS_TaskRRRotate(ptcb->OSTCBPrio);
+				}
+			}
+		}
+		OS_EXIT_CRITICAL();
 #endif
 		ptcb = OSTCBList;	/*ָһTCB Point at first TCB in TCB list               */
 		while (ptcb->OSTCBPrio != OS_TASK_IDLE_PRIO) {	/*еTCB,ֱ Go through all TCBs in TCB list   */
 			OS_ENTER_CRITICAL();
+#if OS_TASK_BUDGET_EN > 0u
+			if ((ptcb->OSTCBOpt & OS_TASK_OPT_BUDGET) != 0u) {
+				if (ptcb->OSTCBBudgetCtr > 1u) {
+					ptcb->OSTCBBudgetCtr--;
+				} else {	/* Replenish the task's CPU budget              */
+					ptcb->OSTCBBudgetCtr = ptcb->OSTCBBudgetPeriod;
+					ptcb->OSTCBBudgetUsed = 0uL;
+					if ((ptcb->OSTCBStat & OS_STAT_BUDGET) != OS_STAT_RDY) {
+						ptcb->OSTCBStat &= (INT8U) ~ (INT8U) OS_STAT_BUDGET;
+						if (ptcb->OSTCBStat == OS_STAT_RDY) {	/* Release task if not suspended */
+							OS_RdyListInsert(ptcb);
+						}
+					}
+				}
+			}
+#endif
 			if (ptcb->OSTCBDly != 0u) {	/*ʱǷΪ0 No, Delayed or waiting for event with TO     */
 				ptcb->OSTCBDly--;	/* Decrement nbr of ticks to end of delay       */
 				if (ptcb->OSTCBDly == 0u) {	/*ʱһǷΪ0 Check for timeout                            */
@@ -947,8 +1006,7 @@ void OSTimeTick(void)
 					}
 
 					if ((ptcb->OSTCBStat & OS_STAT_SUSPEND) == OS_STAT_RDY) {	/*Ǳ? Is task suspended?       */
-						OSRdyGrp |= ptcb->OSTCBBitY;	/*ȷʵǣΪ̬ No,  Make ready          */
-						OSRdyTbl[ptcb->OSTCBY] |= ptcb->OSTCBBitX;
+						OS_RdyListInsert(ptcb);	/*ȷʵǣΪ̬ No,  Make ready          */
 					}
 				}
 			}
@@ -1039,6 +1097,9 @@ INT8U OS_EventTaskRdy(OS_EVENT * pevent, void *pmsg, INT8U msk, INT8U pend_stat)
 	INT8U y;
 	INT8U x;
 	INT8U prio;
+#if OS_TASK_RR_EN > 0u
+	OS_TCB *pnext;
+#endif
 #if OS_LOWEST_PRIO > 63u
 	OS_PRIO *ptbl;
 #endif
@@ -1063,6 +1124,18 @@ INT8U OS_EventTaskRdy(OS_EVENT * pevent, void *pmsg, INT8U msk, INT8U pend_stat)
 	prio = (INT8U) ((y << 4u) + x);	/* Find priority of task getting the msg       */
 #endif
 	ptcb = OSTCBPrioTbl[prio];	/*ptcbָȼTCB Point to this task's OS_TCB                 */
+#if OS_TASK_RR_EN > 0u
+	pnext = ptcb;	/* Find the task waiting among the tasks at 'prio' */
+	do {
+		if ((pnext->OSTCBPrio == prio) && (pnext->OSTCBEventPtr == pevent)
+		    && ((pnext->OSTCBStat & OS_STAT_PEND_ANY) != OS_STAT_RDY)) {
+			ptcb = pnext;
+			break;
+		}
+		pnext = pnext->OSTCBRRNext;
+	} while (pnext != ptcb);
+	OSTCBEventRdy = ptcb;
+#endif
 
 	ptcb->OSTCBDly = 0u;	/*ֹOSTimeTick()OSTCBDlyеݼֱ0 Prevent OSTimeTick() from readying task     */
 //ϢлϢãôҪӦϢݸHPT
@@ -1076,8 +1149,7 @@ INT8U OS_EventTaskRdy(OS_EVENT * pevent, void *pmsg, INT8U msk, INT8U pend_stat)
 	/* See if task is ready (could be susp'd)      */
     //Ƿ?ǣʶ
 	if ((ptcb->OSTCBStat & OS_STAT_SUSPEND) == OS_STAT_RDY) {
-		OSRdyGrp |= ptcb->OSTCBBitY;	/* Put task in the ready to run list           */
-		OSRdyTbl[y] |= ptcb->OSTCBBitX;
+		OS_RdyListInsert(ptcb);	/* Put task in the ready to run list           */
 	}
     //ȴбɾHPT
 	OS_EventTaskRemove(ptcb, pevent);	/* Remove this task from event   wait list     */
@@ -1111,20 +1183,13 @@ INT8U OS_EventTaskRdy(OS_EVENT * pevent, void *pmsg, INT8U msk, INT8U pend_stat)
 #if (OS_EVENT_EN)
 void OS_EventTaskWait(OS_EVENT * pevent)
 {
-	INT8U y;
-
-
 	OSTCBCur->OSTCBEventPtr = pevent;	/*ECBָTCB Store ptr to ECB in TCB         */
 
 	pevent->OSEventTbl[OSTCBCur->OSTCBY] |= OSTCBCur->OSTCBBitX;	/*¼ƿĵȴб Put task in waiting list        */
 	pevent->OSEventGrp |= OSTCBCur->OSTCBBitY;
 
     //ɾ
-	y = OSTCBCur->OSTCBY;	/* Task no longer ready                              */
-	OSRdyTbl[y] &= (OS_PRIO) ~ OSTCBCur->OSTCBBitX;
-	if (OSRdyTbl[y] == 0u) {	/* Clear event grp bit if this was only task pending */
-		OSRdyGrp &= (OS_PRIO) ~ OSTCBCur->OSTCBBitY;
-	}
+	OS_RdyListRemove(OSTCBCur);	/* Task no longer ready                              */
 }
 #endif
 /*$PAGE*/
@@ -1148,7 +1213,6 @@ void OS_EventTaskWaitMulti(OS_EVENT ** pevents_wait)
 {
 	OS_EVENT **pevents;
 	OS_EVENT *pevent;
-	INT8U y;
 
 
 	OSTCBCur->OSTCBEventPtr = (OS_EVENT *) 0;
@@ -1163,11 +1227,7 @@ void OS_EventTaskWaitMulti(OS_EVENT ** pevents_wait)
 		pevent = *pevents;
 	}
 
-	y = OSTCBCur->OSTCBY;	/* Task no longer ready                              */
-	OSRdyTbl[y] &= (OS_PRIO) ~ OSTCBCur->OSTCBBitX;
-	if (OSRdyTbl[y] == 0u) {	/* Clear event grp bit if this was only task pending */
-		OSRdyGrp &= (OS_PRIO) ~ OSTCBCur->OSTCBBitY;
-	}
+	OS_RdyListRemove(OSTCBCur);	/* Task no longer ready                              */
 }
 #endif
 /*$PAGE*/
@@ -1183,15 +1243,30 @@ void OS_EventTaskWaitMulti(OS_EVENT ** pevents_wait)
 *
 * Returns    : none
 *
-* Note       : This function is INTERNAL to uC/OS-II and your application should not call it.
+* Note       : 1) This function is INTERNAL to uC/OS-II and your application should not call it.
+*              2) With round-robin scheduling, the priority stays in the wait list as long as another
+*                 task sharing the priority is still waiting for the event.
 *********************************************************************************************************
 */
 #if (OS_EVENT_EN)
 void OS_EventTaskRemove(OS_TCB * ptcb, OS_EVENT * pevent)
 {
 	INT8U y;
+#if OS_TASK_RR_EN > 0u
+	OS_TCB *pnext;
+#endif
 
 
+#if OS_TASK_RR_EN > 0u
+	pnext = ptcb->OSTCBRRNext;	/* See if a peer still waits at the same priority */
+	while (pnext != ptcb) {
+		if ((pnext->OSTCBPrio == ptcb->OSTCBPrio) && (pnext->OSTCBEventPtr == pevent)
+		    && ((pnext->OSTCBStat & OS_STAT_PEND_ANY) != OS_STAT_RDY)) {
+			return;
+		}
+		pnext = pnext->OSTCBRRNext;
+	}
+#endif
 	y = ptcb->OSTCBY;
 	pevent->OSEventTbl[y] &= (OS_PRIO) ~ ptcb->OSTCBBitX;	/* Remove task from wait list              */
 	if (pevent->OSEventTbl[y] == 0u) {
@@ -1396,6 +1471,14 @@ static void OS_InitRdyList(void)
 
 	OSTCBHighRdy = (OS_TCB *) 0;
 	OSTCBCur = (OS_TCB *) 0;
+	OSSchedReq = OS_FALSE;
+#if OS_TASK_THRESHOLD_EN > 0u
+	OSTCBThreshList = (OS_TCB *) 0;
+#endif
+#if OS_EDF_EN > 0u
+	OSEdfRdyList = (OS_TCB *) 0;
+	OSEdfMissCtr = 0uL;
+#endif
 }
 
 /*$PAGE*/
@@ -1607,6 +1690,232 @@ void OS_MemCopy(INT8U * pdest, INT8U * psrc, INT16U size)
 	}
 }
 
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                   PLACE A TASK IN THE READY LIST
+*
+* Description: This function is called by other uC/OS-II services to make a task ready to run when
+*              round-robin scheduling is enabled (OS_TASK_RR_EN).  If no other task is ready at the task's
+*              priority, the task becomes the task at the head of that priority (the one OSTCBPrioTbl[]
+*              points to) and is given a new time slice.  Otherwise the task is queued behind the tasks
+*              already ready at that priority.
+*
+* Arguments  : ptcb     is a pointer to the task to make ready.
+*
+* Returns    : none
+*
+* Note(s)    : 1) This function is INTERNAL to uC/OS-II and your application should not call it.
+*              2) Interrupts are assumed to be disabled when this function is called.
+*              3) A mutex owner raised to the PIP is alone at the PIP and is not moved in the list of
+*                 tasks sharing its original priority.
+*********************************************************************************************************
+*/
+
+#if OS_TASK_RR_EN > 0u
+void OS_RdyListInsert(OS_TCB * ptcb)
+{
+	OS_TCB *phead;
+
+
+	if (ptcb->OSTCBRdy == OS_TRUE) {	/* Task is already in the ready list            */
+		return;
+	}
+	ptcb->OSTCBRdy = OS_TRUE;
+	if ((OSRdyTbl[ptcb->OSTCBY] & ptcb->OSTCBBitX) == 0u) {	/* First task ready at this prio?    */
+		OSRdyGrp |= ptcb->OSTCBBitY;	/* Yes, make priority ready                     */
+		OSRdyTbl[ptcb->OSTCBY] |= ptcb->OSTCBBitX;
+		if (ptcb->OSTCBRRPrio == ptcb->OSTCBPrio) {	/*      task is now at the head             */
+			OSTCBPrioTbl[ptcb->OSTCBPrio] = ptcb;
+		}
+		ptcb->OSTCBRRCtr = ptcb->OSTCBRRQuanta;
+		if (ptcb->OSTCBPrio <= OSPrioHighRdy) {	/*      see if a new search is needed       */
+			OSSchedReq = OS_TRUE;
+		}
+		return;
+	}
+	phead = OSTCBPrioTbl[ptcb->OSTCBPrio];	/* No,  queue task behind the ready tasks       */
+	if ((phead != ptcb) && (ptcb->OSTCBRRPrio == ptcb->OSTCBPrio)) {
+		ptcb->OSTCBRRPrev->OSTCBRRNext = ptcb->OSTCBRRNext;	/* Unlink task ...               */
+		ptcb->OSTCBRRNext->OSTCBRRPrev = ptcb->OSTCBRRPrev;
+		ptcb->OSTCBRRNext = phead;	/* ... and insert it at the tail             */
+		ptcb->OSTCBRRPrev = phead->OSTCBRRPrev;
+		phead->OSTCBRRPrev->OSTCBRRNext = ptcb;
+		phead->OSTCBRRPrev = ptcb;
+	}
+}
+#endif
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                  REMOVE A TASK FROM THE READY LIST
+*
+* Description: This function is called by other uC/OS-II services to make a task not ready when round-robin
+*              scheduling is enabled (OS_TASK_RR_EN).  The priority stays ready as long as another task
+*              sharing it is ready.  If the task was at the head of its priority, the next ready task
+*              sharing the priority takes its place.
+*
+* Arguments  : ptcb     is a pointer to the task to remove.
+*
+* Returns    : none
+*
+* Note(s)    : 1) This function is INTERNAL to uC/OS-II and your application should not call it.
+*              2) Interrupts are assumed to be disabled when this function is called.
+*********************************************************************************************************
+*/
+
+#if OS_TASK_RR_EN > 0u
+void OS_RdyListRemove(OS_TCB * ptcb)
+{
+	OS_TCB *pnext;
+
+
+	if (ptcb->OSTCBRdy == OS_FALSE) {	/* Task is not in the ready list                */
+		return;
+	}
+	ptcb->OSTCBRdy = OS_FALSE;
+	if ((ptcb == OSTCBCur) || (ptcb == OSTCBHighRdy)) {	/* See if a new search is needed      */
+		OSSchedReq = OS_TRUE;
+	}
+	if (ptcb->OSTCBRRPrio == ptcb->OSTCBPrio) {
+		pnext = ptcb->OSTCBRRNext;	/* See if a peer is ready at the same priority  */
+		while (pnext != ptcb) {
+			if ((pnext->OSTCBRdy == OS_TRUE) && (pnext->OSTCBPrio == ptcb->OSTCBPrio)) {
+				if (OSTCBPrioTbl[ptcb->OSTCBPrio] == ptcb) {	/* Yes, peer takes the head     */
+					OSTCBPrioTbl[ptcb->OSTCBPrio] = pnext;
+					pnext->OSTCBRRCtr = pnext->OSTCBRRQuanta;
+				}
+				return;
+			}
+			pnext = pnext->OSTCBRRNext;
+		}
+	}
+	OSRdyTbl[ptcb->OSTCBY] &= (OS_PRIO) ~ ptcb->OSTCBBitX;	/* No,  priority is no longer ready  */
+	if (OSRdyTbl[ptcb->OSTCBY] == 0u) {
+		OSRdyGrp &= (OS_PRIO) ~ ptcb->OSTCBBitY;
+	}
+}
+#endif
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                              PLACE A TASK IN THE READY LIST OF THE EDF BAND
+*
+* Description: This function is called by OS_RdyListInsert() when earliest-deadline-first scheduling is
+*              enabled (OS_EDF_EN).  If the task's priority lies within the EDF band, the task is inserted
+*              in OSEdfRdyList in order of absolute deadline.  A task that is released (i.e. made ready
+*              after it blocked) starts a new job whose deadline is OSTime plus its relative deadline.
+*
+* Arguments  : ptcb     is a pointer to the task made ready.
+*
+* Returns    : none
+*
+* Note(s)    : 1) This function is INTERNAL to uC/OS-II and your application should not call it.
+*              2) Interrupts are assumed to be disabled when this function is called.
+*              3) Tasks without a deadline are placed after all tasks with one, by priority.  Tasks
+*                 with the same deadline run in the order they were made ready.
+*********************************************************************************************************
+*/
+
+#if OS_EDF_EN > 0u
+void OS_EdfRdyInsert(OS_TCB * ptcb)
+{
+	OS_TCB *pprev;
+	OS_TCB *pnext;
+
+
+	if ((ptcb->OSTCBPrio < OS_EDF_PRIO_HI) || (ptcb->OSTCBPrio > OS_EDF_PRIO_LO)) {
+		return;		/* Task is scheduled by priority only       */
+	}
+	if (ptcb->OSTCBEdfJob == OS_FALSE) {	/* Task released, start a new job           */
+		ptcb->OSTCBEdfJob = OS_TRUE;
+		ptcb->OSTCBEdfAbs = OSTime + ptcb->OSTCBEdfDeadline;
+	}
+	pprev = (OS_TCB *) 0;
+	pnext = OSEdfRdyList;
+	while (pnext != (OS_TCB *) 0) {	/* Find the first task due after this one   */
+		if (ptcb->OSTCBEdfDeadline != 0u) {
+			if (pnext->OSTCBEdfDeadline == 0u) {
+				break;
+			}
+			if ((INT32S) (ptcb->OSTCBEdfAbs - pnext->OSTCBEdfAbs) < 0) {
+				break;
+			}
+		} else if (pnext->OSTCBEdfDeadline == 0u) {
+			if (ptcb->OSTCBPrio < pnext->OSTCBPrio) {
+				break;
+			}
+		}
+		pprev = pnext;
+		pnext = pnext->OSTCBEdfNext;
+	}
+	ptcb->OSTCBEdfNext = pnext;
+	if (pprev == (OS_TCB *) 0) {
+		OSEdfRdyList = ptcb;
+		OSSchedReq = OS_TRUE;	/* New earliest deadline, search again      */
+	} else {
+		pprev->OSTCBEdfNext = ptcb;
+	}
+}
+#endif
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                             REMOVE A TASK FROM THE READY LIST OF THE EDF BAND
+*
+* Description: This function is called by OS_RdyListRemove() when earliest-deadline-first scheduling is
+*              enabled (OS_EDF_EN).  The task is unlinked from OSEdfRdyList.  If the task is made not
+*              ready because it waits, sleeps or is suspended its job is complete: a job that completes
+*              after its deadline is counted as a miss.
+*
+* Arguments  : ptcb     is a pointer to the task made not ready.
+*
+* Returns    : none
+*
+* Note(s)    : 1) This function is INTERNAL to uC/OS-II and your application should not call it.
+*              2) Interrupts are assumed to be disabled when this function is called.
+*              3) The caller must update OSTCBStat or OSTCBDly BEFORE making the task not ready.  A task
+*                 made not ready only to change its priority (see OSTaskChangePrio() and the mutex
+*                 services) keeps its current job and deadline.
+*********************************************************************************************************
+*/
+
+#if OS_EDF_EN > 0u
+void OS_EdfRdyRemove(OS_TCB * ptcb)
+{
+	OS_TCB *pprev;
+	OS_TCB *pnext;
+
+
+	pprev = (OS_TCB *) 0;
+	pnext = OSEdfRdyList;
+	while (pnext != (OS_TCB *) 0) {	/* Unlink task if it's in the EDF list      */
+		if (pnext == ptcb) {
+			if (pprev == (OS_TCB *) 0) {
+				OSEdfRdyList = ptcb->OSTCBEdfNext;
+			} else {
+				pprev->OSTCBEdfNext = ptcb->OSTCBEdfNext;
+			}
+			ptcb->OSTCBEdfNext = (OS_TCB *) 0;
+			break;
+		}
+		pprev = pnext;
+		pnext = pnext->OSTCBEdfNext;
+	}
+	if ((ptcb->OSTCBStat == OS_STAT_RDY) && (ptcb->OSTCBDly == 0u)) {
+		return;		/* Task doesn't block, job continues        */
+	}
+	if (ptcb->OSTCBEdfJob == OS_TRUE) {	/* Job complete                             */
+		ptcb->OSTCBEdfJob = OS_FALSE;
+		if (ptcb->OSTCBEdfDeadline != 0u) {
+			if ((INT32S) (OSTime - ptcb->OSTCBEdfAbs) > 0) {	/* Deadline missed?            */
+				ptcb->OSTCBEdfMissCtr++;
+				OSEdfMissCtr++;
+			}
+		}
+	}
+}
+#endif
 /*$PAGE*/
 /*
 *********************************************************************************************************
@@ -1622,6 +1931,8 @@ void OS_MemCopy(INT8U * pdest, INT8U * psrc, INT16U size)
 *
 * Notes      : 1) This function is INTERNAL to uC/OS-II and your application should not call it.
 *              2) Rescheduling is prevented when the scheduler is locked (see OS_SchedLock())
+*              3) The search for the highest priority task is skipped unless OSSchedReq indicates that
+*                 the ready list changed in a way that could affect the outcome.
 *********************************************************************************************************
 */
 
@@ -1635,10 +1946,15 @@ void OS_Sched(void)
     //ȫֱж
 	OS_ENTER_CRITICAL();
 	if (OSIntNesting == 0u) {	/* ǰжϷӳ Schedule only if all ISRs done and ...       */
-		if (OSLockNesting == 0u) {	/* Ҳڵ ... scheduler is not locked             */
+		if ((OSLockNesting == 0u) && (OSSchedReq == OS_TRUE)) {	/* Ҳڵ ... scheduler is not locked             */
+			OSSchedReq = OS_FALSE;
 			OS_SchedNew();      //ҳ׼ȼߵ
 			OSTCBHighRdy = OSTCBPrioTbl[OSPrioHighRdy]; //ߵӦTCB
+#if OS_TASK_RR_EN > 0u
+			if ((OSPrioHighRdy != OSPrioCur) || (OSTCBHighRdy != OSTCBCur)) {	/* Peer at same prio?      */
+#else
 			if (OSPrioHighRdy != OSPrioCur) {	/* ǵǰе No Ctx Sw if current task is highest rdy     */
+#endif
 #if OS_TASK_PROFILE_EN > 0u
 				OSTCBHighRdy->OSTCBCtxSwCtr++;	/* ʱ̼1 Inc. # of context switches to this task      */
 #endif
@@ -1664,11 +1980,25 @@ void OS_Sched(void)
 *
 * Notes      : 1) This function is INTERNAL to uC/OS-II and your application should not call it.
 *              2) Interrupts are assumed to be disabled when this function is called.
+*              3) With OS_EDF_EN, the ready task of the EDF band with the earliest deadline is picked
+*                 whenever the band is the highest priority ready (see OS_EdfRdyInsert()).
+*              4) With OS_TASK_THRESHOLD_EN, a task picked here runs at its preemption threshold until it
+*                 blocks: it is kept in OSTCBThreshList, even while preempted, and the highest threshold
+*                 of the tasks in that list that are still ready decides which tasks may preempt.  Tasks
+*                 found not ready are dropped from the list (see OSTaskThresholdSet()).
 *********************************************************************************************************
 */
 
 static void OS_SchedNew(void)
 {
+#if OS_TASK_THRESHOLD_EN > 0u
+	OS_TCB *ptcb;
+	OS_TCB *pprev;
+	OS_TCB *pnext;
+	OS_TCB *phold;
+	INT8U threshold;
+	INT8U thresh;
+#endif
 #if OS_LOWEST_PRIO <= 63u	/* ֧64ȼ See if we support up to 64 tasks                   */
 	INT8U y;
 
@@ -1692,6 +2022,48 @@ static void OS_SchedNew(void)
 		OSPrioHighRdy = (INT8U) ((y << 4u) + OSUnMapTbl[(OS_PRIO) (*ptbl >> 8u) & 0xFFu] + 8u);
 	}
 #endif
+#if OS_EDF_EN > 0u
+	if ((OSPrioHighRdy >= OS_EDF_PRIO_HI) && (OSPrioHighRdy <= OS_EDF_PRIO_LO)) {
+		OSPrioHighRdy = OSEdfRdyList->OSTCBPrio;	/* Earliest deadline first within the band     */
+	}
+#endif
+#if OS_TASK_THRESHOLD_EN > 0u
+	phold = (OS_TCB *) 0;
+	threshold = OS_LOWEST_PRIO;
+	pprev = (OS_TCB *) 0;
+	ptcb = OSTCBThreshList;
+	while (ptcb != (OS_TCB *) 0) {	/* Find the highest threshold still in force     */
+		pnext = ptcb->OSTCBThreshNext;
+		if (OS_RdyListHas(ptcb)) {
+			thresh = ptcb->OSTCBThreshold;
+			if (thresh > ptcb->OSTCBPrio) {	/* Priority may have been raised by a mutex      */
+				thresh = ptcb->OSTCBPrio;
+			}
+			if ((phold == (OS_TCB *) 0) || (thresh < threshold)) {
+				phold = ptcb;
+				threshold = thresh;
+			}
+			pprev = ptcb;
+		} else {	/* Task blocked, its threshold no longer applies */
+			ptcb->OSTCBThreshOn = OS_FALSE;
+			if (pprev == (OS_TCB *) 0) {
+				OSTCBThreshList = pnext;
+			} else {
+				pprev->OSTCBThreshNext = pnext;
+			}
+		}
+		ptcb = pnext;
+	}
+	if ((phold != (OS_TCB *) 0) && (OSPrioHighRdy >= threshold)) {
+		OSPrioHighRdy = phold->OSTCBPrio;	/* Only tasks above the threshold may preempt    */
+	}
+	ptcb = OSTCBPrioTbl[OSPrioHighRdy];	/* Task picked now runs at its threshold         */
+	if ((ptcb->OSTCBThreshOn == OS_FALSE) && (ptcb->OSTCBThreshold < ptcb->OSTCBPrio)) {
+		ptcb->OSTCBThreshOn = OS_TRUE;
+		ptcb->OSTCBThreshNext = OSTCBThreshList;
+		OSTCBThreshList = ptcb;
+	}
+#endif
 }
 
 /*$PAGE*/
@@ -1725,6 +2097,42 @@ INT8U OS_StrLen(INT8U * psrc)
 	return (len);
 }
 #endif
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                    CHARGE THE CPU TIME OF A TASK SWITCH
+*
+* Description: This function is called by OSTaskSwHook() when CPU budgets are enforced (OS_TASK_BUDGET_EN).
+*              The time the task being switched out has run since it was switched in is added to the CPU
+*              time it used in the current budget period, and the task being switched in starts timing.
+*
+* Arguments  : none
+*
+* Returns    : none
+*
+* Note(s)    : 1) This function is INTERNAL to uC/OS-II and your application should not call it.
+*              2) Interrupts are disabled when this function is called.
+*              3) Time is measured with OS_CPU_TS_GET(), see OS_CPU.H.  The budget itself is enforced by
+*                 OSTimeTick(), i.e. a task may overrun its budget by up to one tick.
+*********************************************************************************************************
+*/
+
+#if OS_TASK_BUDGET_EN > 0u
+void OS_TaskBudgetSw(void)
+{
+	INT32U ts;
+
+
+	ts = OS_CPU_TS_GET();
+	if (OSTCBCur != OSTCBHighRdy) {	/* Not the first switch after OSStart()         */
+		if ((OSTCBCur->OSTCBOpt & OS_TASK_OPT_BUDGET) != 0u) {
+			OSTCBCur->OSTCBBudgetUsed += ts - OSTCBCur->OSTCBBudgetStart;
+		}
+	}
+	OSTCBHighRdy->OSTCBBudgetStart = ts;
+}
+#endif
+
 /*$PAGE*/
 /*
 *********************************************************************************************************
@@ -1833,6 +2241,8 @@ void OS_TaskStat(void *p_arg)
 *                                      CHECK ALL TASK STACKS
 *
 * Description: This function is called by OS_TaskStat() to check the stacks of each active task.
+*              With OS_TASK_STK_CHK_GUARD each check is short, so the whole TCB list is walked with the
+*              scheduler locked, which also reaches tasks sharing a priority with OS_TASK_RR_EN.
 *
 * Arguments  : none
 *
@@ -1845,6 +2255,35 @@ void OS_TaskStatStkChk(void)
 {
 	OS_TCB *ptcb;
 	OS_STK_DATA stk_data;
+#if OS_TASK_STK_CHK_GUARD > 0u
+#if OS_CRITICAL_METHOD == 3u	/* Allocate storage for CPU status register     */
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+
+	OS_ENTER_CRITICAL();
+	OSLockNesting++;	/* Tasks can't be created or deleted meanwhile  */
+	OS_EXIT_CRITICAL();
+	ptcb = OSTCBList;
+	while (ptcb != (OS_TCB *) 0) {	/* Every task, including ones sharing a prio    */
+		if ((ptcb->OSTCBOpt & OS_TASK_OPT_STK_CHK) != 0u) {
+			OS_TaskStkChk(ptcb, &stk_data);
+#if OS_TASK_PROFILE_EN > 0u
+#if OS_STK_GROWTH == 1u
+			ptcb->OSTCBStkBase = ptcb->OSTCBStkBottom + ptcb->OSTCBStkSize;
+#else
+			ptcb->OSTCBStkBase = ptcb->OSTCBStkBottom - ptcb->OSTCBStkSize;
+#endif
+			ptcb->OSTCBStkUsed = stk_data.OSUsed;	/* Store the number of bytes used */
+#endif
+		}
+		ptcb = ptcb->OSTCBNext;
+	}
+	OS_ENTER_CRITICAL();
+	OSLockNesting--;
+	OS_EXIT_CRITICAL();
+	OS_Sched();		/* Run tasks readied while locked               */
+#else
 	INT8U err;
 	INT8U prio;
 
@@ -1867,6 +2306,177 @@ void OS_TaskStatStkChk(void)
 			}
 		}
 	}
+#endif
+}
+#endif
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                 LINK A TASK WITH THE TASKS AT ITS PRIORITY
+*
+* Description: This function is called when round-robin scheduling is enabled (OS_TASK_RR_EN) to add a task
+*              to the circular list of tasks sharing its priority.  The first task at a priority becomes the
+*              head of the list and is the one placed in OSTCBPrioTbl[].  Other tasks are added at the tail.
+*
+* Arguments  : ptcb     is a pointer to the task.  'ptcb->OSTCBPrio' must be set.
+*
+* Returns    : none
+*
+* Note(s)    : 1) This function is INTERNAL to uC/OS-II and your application should not call it.
+*              2) Interrupts are assumed to be disabled when this function is called.
+*              3) The task is not made ready, see OS_RdyListInsert().
+*********************************************************************************************************
+*/
+
+#if OS_TASK_RR_EN > 0u
+void OS_TaskRRLink(OS_TCB * ptcb)
+{
+	OS_TCB *phead;
+
+
+	phead = OSTCBPrioTbl[ptcb->OSTCBPrio];
+	ptcb->OSTCBRRPrio = ptcb->OSTCBPrio;
+	ptcb->OSTCBRdy = OS_FALSE;
+	if ((phead == (OS_TCB *) 0) || (phead == OS_TCB_RESERVED)) {	/* First task at this prio?    */
+		ptcb->OSTCBRRNext = ptcb;	/* Yes, task is alone in the list            */
+		ptcb->OSTCBRRPrev = ptcb;
+		OSTCBPrioTbl[ptcb->OSTCBPrio] = ptcb;
+	} else {
+		ptcb->OSTCBRRNext = phead;	/* No,  insert task at the tail              */
+		ptcb->OSTCBRRPrev = phead->OSTCBRRPrev;
+		phead->OSTCBRRPrev->OSTCBRRNext = ptcb;
+		phead->OSTCBRRPrev = ptcb;
+	}
+}
+#endif
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                 GIVE THE CPU TO THE NEXT TASK AT A PRIORITY
+*
+* Description: This function is called when the task at the head of a priority used up its time slice or
+*              yields the CPU.  The next ready task sharing the priority becomes the head and the previous
+*              head goes to the tail.  Nothing changes if no other task is ready at that priority.
+*
+* Arguments  : prio     is the priority to rotate.
+*
+* Returns    : none
+*
+* Note(s)    : 1) This function is INTERNAL to uC/OS-II and your application should not call it.
+*              2) Interrupts are assumed to be disabled when this function is called.
+*              3) The caller is responsible for calling the scheduler.
+*********************************************************************************************************
+*/
+
+#if OS_TASK_RR_EN > 0u
+void OS_TaskRRRotate(INT8U prio)
+{
+	OS_TCB *phead;
+	OS_TCB *pnext;
+
+
+	phead = OSTCBPrioTbl[prio];
+	if ((phead == (OS_TCB *) 0) || (phead == OS_TCB_RESERVED)) {
+		return;
+	}
+	phead->OSTCBRRCtr = phead->OSTCBRRQuanta;	/* Head gets a new time slice ...          */
+	pnext = phead->OSTCBRRNext;
+	while (pnext != phead) {
+		if ((pnext->OSTCBRdy == OS_TRUE) && (pnext->OSTCBPrio == prio)) {
+			OSTCBPrioTbl[prio] = pnext;	/* ... and goes behind the next ready task  */
+			pnext->OSTCBRRCtr = pnext->OSTCBRRQuanta;
+			OSSchedReq = OS_TRUE;
+			return;
+		}
+		pnext = pnext->OSTCBRRNext;
+	}
+}
+#endif
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                               UNLINK A TASK FROM THE TASKS AT ITS PRIORITY
+*
+* Description: This function is called when round-robin scheduling is enabled (OS_TASK_RR_EN) to remove a
+*              task from the circular list of tasks sharing its priority.  If the task was the head of the
+*              list, the next task takes its place in OSTCBPrioTbl[].  The entry is cleared when the task
+*              was the last one at that priority.
+*
+* Arguments  : ptcb     is a pointer to the task.
+*
+* Returns    : none
+*
+* Note(s)    : 1) This function is INTERNAL to uC/OS-II and your application should not call it.
+*              2) Interrupts are assumed to be disabled when this function is called.
+*              3) The task must have been removed from the ready list first, see OS_RdyListRemove().
+*********************************************************************************************************
+*/
+
+#if OS_TASK_RR_EN > 0u
+void OS_TaskRRUnlink(OS_TCB * ptcb)
+{
+	OS_TCB *pnext;
+
+
+	pnext = ptcb->OSTCBRRNext;
+	if (OSTCBPrioTbl[ptcb->OSTCBRRPrio] == ptcb) {	/* Was task at the head of its priority?   */
+		if (pnext == ptcb) {
+			OSTCBPrioTbl[ptcb->OSTCBRRPrio] = (OS_TCB *) 0;	/* Yes, last task at this priority  */
+		} else {
+			OSTCBPrioTbl[ptcb->OSTCBRRPrio] = pnext;	/*      next task takes its place    */
+		}
+	}
+	ptcb->OSTCBRRPrev->OSTCBRRNext = pnext;
+	pnext->OSTCBRRPrev = ptcb->OSTCBRRPrev;
+	ptcb->OSTCBRRNext = ptcb;
+	ptcb->OSTCBRRPrev = ptcb;
+	if (OSTCBPrioTbl[ptcb->OSTCBPrio] == ptcb) {	/* Release priority task was raised to     */
+		OSTCBPrioTbl[ptcb->OSTCBPrio] = (OS_TCB *) 0;
+	}
+}
+#endif
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                   DROP THE PREEMPTION THRESHOLD OF A TASK
+*
+* Description: This function is called when preemption thresholds are enabled (OS_TASK_THRESHOLD_EN) to
+*              remove a task from OSTCBThreshList, i.e. the task no longer runs at its threshold.
+*
+* Arguments  : ptcb     is a pointer to the task.
+*
+* Returns    : none
+*
+* Note(s)    : 1) This function is INTERNAL to uC/OS-II and your application should not call it.
+*              2) Interrupts are assumed to be disabled when this function is called.
+*              3) OS_SchedNew() drops the tasks that blocked by itself.  This function is for a task whose
+*                 TCB is about to be freed (see OSTaskDel()).
+*********************************************************************************************************
+*/
+
+#if OS_TASK_THRESHOLD_EN > 0u
+void OS_TaskThreshDrop(OS_TCB * ptcb)
+{
+	OS_TCB *pprev;
+	OS_TCB *pnext;
+
+
+	if (ptcb->OSTCBThreshOn == OS_FALSE) {
+		return;
+	}
+	ptcb->OSTCBThreshOn = OS_FALSE;
+	pprev = (OS_TCB *) 0;
+	pnext = OSTCBThreshList;
+	while (pnext != ptcb) {
+		pprev = pnext;
+		pnext = pnext->OSTCBThreshNext;
+	}
+	if (pprev == (OS_TCB *) 0) {
+		OSTCBThreshList = ptcb->OSTCBThreshNext;
+	} else {
+		pprev->OSTCBThreshNext = ptcb->OSTCBThreshNext;
+	}
+	ptcb->OSTCBThreshNext = (OS_TCB *) 0;
 }
 #endif
 /*$PAGE*/
@@ -1939,6 +2549,9 @@ INT8U OS_TCBInit(INT8U prio, OS_STK * ptos, OS_STK * pbos, INT16U id, INT32U stk
 		ptcb->OSTCBExtPtr = pext;	/* Store pointer to TCB extension           */
 		ptcb->OSTCBStkSize = stk_size;	/* Store stack size                         */
 		ptcb->OSTCBStkBottom = pbos;	/* Store pointer to bottom of stack         */
+#if OS_TASK_STK_CHK_GUARD > 0u
+		ptcb->OSTCBStkHWM = ptos;	/* Only the initial frame is in use         */
+#endif
 		ptcb->OSTCBOpt = opt;	/* Store task options                       */
 		ptcb->OSTCBId = id;	/* Store task ID                            */
 #else
@@ -1987,6 +2600,43 @@ INT8U OS_TCBInit(INT8U prio, OS_STK * ptos, OS_STK * pbos, INT16U id, INT32U stk
 		ptcb->OSTCBStkUsed = 0uL;
 #endif
 
+#if OS_TASK_RR_EN > 0u
+		ptcb->OSTCBRRQuanta = OS_TASK_RR_QUANTA;	/* Default time slice                       */
+		ptcb->OSTCBRRCtr = OS_TASK_RR_QUANTA;
+		ptcb->OSTCBRdy = OS_FALSE;
+#endif
+
+#if OS_TASK_BUDGET_EN > 0u
+		ptcb->OSTCBBudget = OS_TASK_BUDGET_DFLT;	/* Default CPU budget, enforced only ...    */
+		ptcb->OSTCBBudgetUsed = 0uL;	/* ... with OS_TASK_OPT_BUDGET              */
+		ptcb->OSTCBBudgetStart = 0uL;
+		ptcb->OSTCBBudgetOverrunCtr = 0uL;
+		ptcb->OSTCBBudgetPeriod = OS_TASK_BUDGET_PERIOD;
+		ptcb->OSTCBBudgetCtr = OS_TASK_BUDGET_PERIOD;
+#endif
+
+#if OS_TASK_THRESHOLD_EN > 0u
+		ptcb->OSTCBThreshold = prio;	/* No preemption threshold                  */
+		ptcb->OSTCBThreshOn = OS_FALSE;
+		ptcb->OSTCBThreshNext = (OS_TCB *) 0;
+#endif
+
+#if OS_EDF_EN > 0u
+		ptcb->OSTCBEdfDeadline = 0uL;	/* No deadline until OSTaskDeadlineSet()    */
+		ptcb->OSTCBEdfAbs = 0uL;
+		ptcb->OSTCBEdfMissCtr = 0uL;
+		ptcb->OSTCBEdfJob = OS_FALSE;
+		ptcb->OSTCBEdfNext = (OS_TCB *) 0;
+#endif
+
+#if OS_TASK_PERIOD_EN > 0u
+		ptcb->OSTCBPeriod = 0uL;	/* Task is not periodic until registered    */
+		ptcb->OSTCBPeriodCtr = 0uL;
+		ptcb->OSTCBPeriodOverrun = 0uL;
+		ptcb->OSTCBPeriodJitterMax = 0uL;
+		ptcb->OSTCBPeriodRespMax = 0uL;
+#endif
+
 #if OS_TASK_NAME_EN > 0u
 		ptcb->OSTCBTaskName = (INT8U *) (void *) "?";
 #endif
@@ -2002,15 +2652,18 @@ INT8U OS_TCBInit(INT8U prio, OS_STK * ptos, OS_STK * pbos, INT16U id, INT32U stk
 		OSTaskCreateHook(ptcb);	/* Call user defined hook                   */
 
 		OS_ENTER_CRITICAL();
+#if OS_TASK_RR_EN > 0u
+		OS_TaskRRLink(ptcb);	/* Join the tasks sharing this priority     */
+#else
 		OSTCBPrioTbl[prio] = ptcb;
+#endif
 		ptcb->OSTCBNext = OSTCBList;	/* Link into TCB chain                      */
 		ptcb->OSTCBPrev = (OS_TCB *) 0;
 		if (OSTCBList != (OS_TCB *) 0) {
 			OSTCBList->OSTCBPrev = ptcb;
 		}
 		OSTCBList = ptcb;
-		OSRdyGrp |= ptcb->OSTCBBitY;	/* Make task ready to run                   */
-		OSRdyTbl[ptcb->OSTCBY] |= ptcb->OSTCBBitX;
+		OS_RdyListInsert(ptcb);	/* Make task ready to run                   */
 		OSTaskCtr++;	/* Increment the #tasks counter             */
 		OS_EXIT_CRITICAL();
 		return (OS_ERR_NONE);
@@ -105,6 +105,120 @@ typedef unsigned int   OS_CPU_SR;                /* Define size of CPU status re
 
 #define  OS_TASK_SW()         OSCtxSw()           //ú궨ຯΪCԲֱӴĴ
 
+/*
+*********************************************************************************************************
+*                                          Cortex-M3 Timestamp
+*
+* The DWT cycle counter counts CPU clock cycles and is used to measure the CPU time of tasks (see
+* OS_TASK_BUDGET_EN).  It is started by OS_CPU_TS_Init().
+*********************************************************************************************************
+*/
+
+#define  OS_CPU_CM3_DEM_CR           (*((volatile INT32U *)0xE000EDFC))  /* Debug Exception & Monitor Ctrl */
+#define  OS_CPU_CM3_DWT_CR           (*((volatile INT32U *)0xE0001000))  /* DWT Control Reg.               */
+#define  OS_CPU_CM3_DWT_CYCCNT       (*((volatile INT32U *)0xE0001004))  /* DWT Cycle Count Reg.           */
+
+#define  OS_CPU_CM3_DEM_CR_TRCENA            0x01000000                  /* Enable DWT and ITM.            */
+#define  OS_CPU_CM3_DWT_CR_CYCCNTENA         0x00000001                  /* Enable cycle counter.          */
+
+#define  OS_CPU_TS_GET()      (OS_CPU_CM3_DWT_CYCCNT)  /* Read timestamp (CPU clock cycles)               */
+
+/*
+*********************************************************************************************************
+*                                         Cortex-M3 Stack Guard
+*
+* With OS_TASK_STK_GUARD_EN, OSTaskCreateExt() reserves the lowest OS_CPU_STK_GUARD_SIZE entries (64 bytes)
+* of the stack of each task created with OS_TASK_OPT_STK_CHK: the task's stack proper starts above them.
+* The guard is the 32 byte block at the first 32 byte boundary of that reservation, which always fits in
+* it.  On parts with an MPU, region OS_CPU_MPU_GUARD_RGN is moved over the guard of the task switched in
+* and made no-access, so the first push into it raises a MemManage fault.  The region is reloaded by
+* OSTaskSwHook(), i.e. inside PendSV, before the registers of the new task are restored.  Parts without an
+* MPU (all STM32F10x but the XL-density ones) check instead that the guard of the task switched out is
+* still zero, which reports an overflow at the next switch rather than when it happens.  Either way,
+* OSTaskStkOvfHook() is called with the TCB of the task.
+*********************************************************************************************************
+*/
+
+#if defined(__MPU_PRESENT) && (__MPU_PRESENT == 1)
+#define  OS_CPU_MPU_EN        1
+#else
+#define  OS_CPU_MPU_EN        0
+#endif
+
+#define  OS_CPU_STK_GUARD_SIZE      16u                                  /* Entries reserved for the guard */
+#define  OS_CPU_STK_GUARD_SPAN        8u                                  /* Guard entries (one MPU region) */
+#define  OS_CPU_MPU_GUARD_RGN        7u                                  /* MPU region used as the guard   */
+
+#define  OS_CPU_CM3_SCB_SHCSR        (*((volatile INT32U *)0xE000ED24))  /* System Handler Ctrl & State    */
+#define  OS_CPU_CM3_MPU_CTRL         (*((volatile INT32U *)0xE000ED94))  /* MPU Control Reg.               */
+#define  OS_CPU_CM3_MPU_RNR          (*((volatile INT32U *)0xE000ED98))  /* MPU Region Number Reg.         */
+#define  OS_CPU_CM3_MPU_RBAR         (*((volatile INT32U *)0xE000ED9C))  /* MPU Region Base Address Reg.   */
+#define  OS_CPU_CM3_MPU_RASR         (*((volatile INT32U *)0xE000EDA0))  /* MPU Region Attr & Size Reg.    */
+
+#define  OS_CPU_CM3_SCB_SHCSR_MEMFAULTENA    0x00010000                  /* Enable MemManage fault.        */
+#define  OS_CPU_CM3_MPU_CTRL_ENABLE          0x00000001                  /* Enable the MPU.                */
+#define  OS_CPU_CM3_MPU_CTRL_PRIVDEFENA      0x00000004                  /* Default map for privileged SW. */
+#define  OS_CPU_CM3_MPU_RASR_GUARD           0x10060009                  /* XN, no access, SRAM, 32 bytes. */
+
+/*
+*********************************************************************************************************
+*                                       Cortex-M3 ISR Entry/Exit
+*
+* OS_CPU_INT_ENTER() and OS_CPU_INT_EXIT() replace OSIntEnter() and OSIntExit() at the start and end of
+* kernel aware ISRs.  OSIntNesting is updated inline with LDREX/STREX; an exception taken between the two
+* clears the exclusive monitor so the store is simply retried.  The outermost exit only calls OSIntExit(),
+* and enters its critical section, when OSSchedReq shows that the ISR readied a task that may preempt, in
+* which case OSIntExit() finds OSIntNesting already at 0 and goes straight to the search.  An ISR that
+* readies nothing thus saves one PRIMASK save/restore and two calls (see tests/bench_isr.c).
+*
+* To compare with OSIntEnter()/OSIntExit(), sample OS_CPU_TS_GET() on entry to the handler and in
+* OSTaskSwHook() (or on return from the handler when no switch occurs).
+*
+* Compilers without the exclusive access intrinsics fall back to the out-of-line calls.  A host build
+* may define OS_CPU_EXCL_EN and the three accessors itself before including this file (see tests/port).
+*********************************************************************************************************
+*/
+
+#if defined(__CC_ARM)
+#define  OS_CPU_EXCL_EN       1
+
+#define  OS_CPU_LDREX(p)      __ldrex(p)          /* Load  exclusive (size follows *p)                 */
+#define  OS_CPU_STREX(v, p)   __strex((v), (p))   /* Store exclusive, 0 when the store succeeded       */
+#define  OS_CPU_CLREX()       __clrex()           /* Clear the local exclusive monitor                 */
+#elif !defined(OS_CPU_EXCL_EN)
+#define  OS_CPU_EXCL_EN       0
+#endif
+
+#if OS_CPU_EXCL_EN > 0
+#define  OS_CPU_INT_ENTER()   {INT8U  os_nest;                                                       \
+                               if (OSRunning == OS_TRUE) {                                            \
+                                   do {                                                               \
+                                       os_nest = (INT8U)OS_CPU_LDREX(&OSIntNesting);                  \
+                                       if (os_nest < 255u) {                                          \
+                                           os_nest++;                                                 \
+                                       }                                                              \
+                                   } while (OS_CPU_STREX(os_nest, &OSIntNesting) != 0u);              \
+                               }                                                                      \
+                              }
+
+#define  OS_CPU_INT_EXIT()    {INT8U  os_nest;                                                       \
+                               if (OSRunning == OS_TRUE) {                                            \
+                                   do {                                                               \
+                                       os_nest = (INT8U)OS_CPU_LDREX(&OSIntNesting);                  \
+                                       if (os_nest > 0u) {                                            \
+                                           os_nest--;                                                 \
+                                       }                                                              \
+                                   } while (OS_CPU_STREX(os_nest, &OSIntNesting) != 0u);              \
+                                   if ((os_nest == 0u) && (OSSchedReq == OS_TRUE)) {                  \
+                                       OSIntExit();                                                   \
+                                   }                                                                  \
+                               }                                                                      \
+                              }
+#else
+#define  OS_CPU_INT_ENTER()   {OSIntEnter();}
+#define  OS_CPU_INT_EXIT()    {OSIntExit();}
+#endif
+
 /*
 *********************************************************************************************************
 *                                              PROTOTYPES
@@ -125,6 +239,11 @@ void       OS_CPU_PendSVHandler(void);
                                                   /* See OS_CPU_C.C                                    */
 //void       OS_CPU_SysTickHandler(void);
 //void       OS_CPU_SysTickInit(void);
+void       OS_CPU_TS_Init(void);
+#if OS_TASK_STK_GUARD_EN > 0
+void       OS_CPU_StkGuardInit(void);
+void       OS_CPU_StkGuardSw(void);
+#endif
 
                                                   /* See BSP.C                                         */
 //INT32U     OS_CPU_SysTickClkFreq(void);
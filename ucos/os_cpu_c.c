@@ -94,6 +94,12 @@ void OSInitHookBegin(void)
 #if OS_CPU_HOOKS_EN > 0 && OS_VERSION > 203
 void OSInitHookEnd(void)
 {
+#if OS_TASK_BUDGET_EN > 0
+	OS_CPU_TS_Init();	/* Start the timestamp used to measure CPU time       */
+#endif
+#if OS_TASK_STK_GUARD_EN > 0
+	OS_CPU_StkGuardInit();	/* Arm the task stack guard                          */
+#endif
 }
 #endif
 
@@ -120,6 +126,57 @@ void OSTaskCreateHook(OS_TCB * ptcb)
 #endif
 
 
+/*
+*********************************************************************************************************
+*                                            TASK BUDGET HOOK
+*
+* Description: This function is called when a task has used up its CPU budget and is held until the budget
+*              is replenished (see OSTaskBudgetSet()).  This allows you to log the overrun or to take
+*              corrective action.
+*
+* Arguments  : ptcb   is a pointer to the task control block of the task that used up its budget.
+*
+* Note(s)    : 1) Interrupts are disabled during this call.
+*              2) This function is called from OSTimeTick(), i.e. from the tick ISR.
+*********************************************************************************************************
+*/
+#if (OS_CPU_HOOKS_EN > 0) && (OS_TASK_BUDGET_EN > 0)
+void OSTaskBudgetHook(OS_TCB * ptcb)
+{
+#if OS_APP_HOOKS_EN > 0
+	App_TaskBudgetHook(ptcb);
+#else
+	(void) ptcb;		/* Prevent compiler warning                           */
+#endif
+}
+#endif
+
+/*
+*********************************************************************************************************
+*                                       TASK STACK OVERFLOW HOOK
+*
+* Description: This function is called when a task has run into the guard at the bottom of its stack (see
+*              OS_TASK_STK_GUARD_EN).  The stack of the task, and possibly memory below it, is corrupted;
+*              this allows you to log the fault and to reset the system or delete the task.
+*
+* Arguments  : ptcb   is a pointer to the task control block of the task that overflowed its stack.
+*
+* Note(s)    : 1) Interrupts are disabled during this call.
+*              2) On parts with an MPU this function is called from the MemManage fault handler, else it
+*                 is called from OSTaskSwHook() when the task is switched out.
+*********************************************************************************************************
+*/
+#if (OS_CPU_HOOKS_EN > 0) && (OS_TASK_STK_GUARD_EN > 0)
+void OSTaskStkOvfHook(OS_TCB * ptcb)
+{
+#if OS_APP_HOOKS_EN > 0
+	App_TaskStkOvfHook(ptcb);
+#else
+	(void) ptcb;		/* Prevent compiler warning                           */
+#endif
+}
+#endif
+
 /*
 *********************************************************************************************************
 *                                           TASK DELETION HOOK
@@ -261,6 +318,12 @@ OS_STK *OSTaskStkInit(void (*task) (void *p_arg), void *p_arg, OS_STK * ptos, IN
 #if (OS_CPU_HOOKS_EN > 0) && (OS_TASK_SW_HOOK_EN > 0)
 void OSTaskSwHook(void)
 {
+#if OS_TASK_BUDGET_EN > 0
+	OS_TaskBudgetSw();	/* Charge the CPU time of the task switched out       */
+#endif
+#if OS_TASK_STK_GUARD_EN > 0
+	OS_CPU_StkGuardSw();	/* Move or check the stack guard                     */
+#endif
 #if OS_APP_HOOKS_EN > 0
 	App_TaskSwHook();
 #endif
@@ -371,3 +434,99 @@ void OSTimeTickHook(void)
 //                                                  /* Enable timer interrupt.                            */
 //     OS_CPU_CM3_NVIC_ST_CTRL  |= OS_CPU_CM3_NVIC_ST_CTRL_INTEN;
 // }
+
+/*
+*********************************************************************************************************
+*                                            OS_CPU_TS_Init()
+*
+* Description: Start the DWT cycle counter read by OS_CPU_TS_GET().
+*
+* Arguments  : none.
+*
+* Note(s)    : 1) This function is called by OSInitHookEnd() when CPU budgets are enforced.
+*********************************************************************************************************
+*/
+
+void OS_CPU_TS_Init(void)
+{
+	OS_CPU_CM3_DEM_CR |= OS_CPU_CM3_DEM_CR_TRCENA;	/* Enable the DWT unit                                */
+	OS_CPU_CM3_DWT_CYCCNT = 0u;
+	OS_CPU_CM3_DWT_CR |= OS_CPU_CM3_DWT_CR_CYCCNTENA;	/* Start the cycle counter                            */
+}
+
+/*
+*********************************************************************************************************
+*                                          OS_CPU_StkGuardInit()
+*
+* Description: Enable the MPU and the MemManage fault used to trap task stack overflows.
+*
+* Arguments  : none.
+*
+* Note(s)    : 1) This function is called by OSInitHookEnd() when stack guards are enabled.
+*              2) The guard region stays disabled until the first task switch.  PRIVDEFENA keeps the
+*                 default memory map for everything else; the kernel and its tasks run privileged.
+*              3) Parts without an MPU need no setup, the guard is checked in software.
+*********************************************************************************************************
+*/
+
+#if OS_TASK_STK_GUARD_EN > 0
+void OS_CPU_StkGuardInit(void)
+{
+#if OS_CPU_MPU_EN > 0
+	OS_CPU_CM3_MPU_RNR = OS_CPU_MPU_GUARD_RGN;
+	OS_CPU_CM3_MPU_RASR = 0u;	/* Guard region disabled                              */
+	OS_CPU_CM3_MPU_CTRL = OS_CPU_CM3_MPU_CTRL_PRIVDEFENA | OS_CPU_CM3_MPU_CTRL_ENABLE;
+	OS_CPU_CM3_SCB_SHCSR |= OS_CPU_CM3_SCB_SHCSR_MEMFAULTENA;	/* Else the fault escalates to HardFault */
+#endif
+}
+
+/*
+*********************************************************************************************************
+*                                           OS_CPU_StkGuardSw()
+*
+* Description: Move the stack guard to the task being switched in or, without an MPU, check the guard of
+*              the task being switched out.
+*
+* Arguments  : none.
+*
+* Note(s)    : 1) This function is called by OSTaskSwHook() from PendSV, with interrupts disabled.
+*              2) Only tasks created with OS_TASK_OPT_STK_CHK have a guard, which OSTaskCreateExt()
+*                 clears.  The guard lies below OSTCBStkBottom, so stack checks never read it.
+*              3) The MPU region and the software check cover the same OS_CPU_STK_GUARD_SPAN entries.
+*********************************************************************************************************
+*/
+
+void OS_CPU_StkGuardSw(void)
+{
+	OS_TCB *ptcb;
+	INT32U guard;
+#if OS_CPU_MPU_EN == 0
+	OS_STK *pstk;
+	INT8U i;
+#endif
+
+#if OS_CPU_MPU_EN > 0
+	ptcb = OSTCBHighRdy;
+	OS_CPU_CM3_MPU_RNR = OS_CPU_MPU_GUARD_RGN;
+	if (((ptcb->OSTCBOpt & OS_TASK_OPT_STK_CHK) != 0u) && (ptcb->OSTCBStkBottom != (OS_STK *) 0)) {
+		guard = (INT32U) (ptcb->OSTCBStkBottom - OS_CPU_STK_GUARD_SIZE);
+		OS_CPU_CM3_MPU_RBAR = (guard + 31u) & ~(INT32U) 31u;	/* First 32 byte boundary      */
+		OS_CPU_CM3_MPU_RASR = OS_CPU_CM3_MPU_RASR_GUARD;
+	} else {
+		OS_CPU_CM3_MPU_RASR = 0u;	/* Task has no guard                                  */
+	}
+#else
+	ptcb = OSTCBCur;
+	if (((ptcb->OSTCBOpt & OS_TASK_OPT_STK_CHK) != 0u) && (ptcb->OSTCBStkBottom != (OS_STK *) 0)) {
+		guard = (INT32U) (ptcb->OSTCBStkBottom - OS_CPU_STK_GUARD_SIZE);
+		pstk = (OS_STK *) ((guard + 31u) & ~(INT32U) 31u);	/* Same span as the MPU region */
+		for (i = 0u; i < OS_CPU_STK_GUARD_SPAN; i++) {
+			if (*pstk++ != (OS_STK) 0) {	/* Task has written into its guard            */
+				OSTaskStkOvfHook(ptcb);
+				break;
+			}
+		}
+	}
+#endif
+}
+#endif
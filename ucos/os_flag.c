@@ -1045,7 +1045,6 @@ OS_FLAGS OSFlagQuery(OS_FLAG_GRP * pgrp, INT8U * perr)
 static void OS_FlagBlock(OS_FLAG_GRP * pgrp, OS_FLAG_NODE * pnode, OS_FLAGS flags, INT8U wait_type, INT32U timeout)
 {
 	OS_FLAG_NODE *pnode_next;
-	INT8U y;
 
 
 	OSTCBCur->OSTCBStat |= OS_STAT_FLAG;            //״̬Ϊȴ¼־
@@ -1066,11 +1065,7 @@ static void OS_FlagBlock(OS_FLAG_GRP * pgrp, OS_FLAG_NODE * pnode, OS_FLAGS flag
 	}
 	pgrp->OSFlagWaitList = (void *) pnode;  //¼־ĵȴеĶָ
 
-	y = OSTCBCur->OSTCBY;	/*ǰ񣬴Ӿȥ Suspend current task until flag(s) received   */
-	OSRdyTbl[y] &= (OS_PRIO) ~ OSTCBCur->OSTCBBitX;
-	if (OSRdyTbl[y] == 0x00u) {
-		OSRdyGrp &= (OS_PRIO) ~ OSTCBCur->OSTCBBitY;
-	}
+	OS_RdyListRemove(OSTCBCur);	/*ǰ񣬴Ӿȥ Suspend current task until flag(s) received   */
 }
 
 /*$PAGE*/
@@ -1170,8 +1165,7 @@ static BOOLEAN OS_FlagTaskRdy(OS_FLAG_NODE * pnode, OS_FLAGS flags_rdy)
 	ptcb->OSTCBStat &= (INT8U) ~ (INT8U) OS_STAT_FLAG;//ȡ¼־ĵȴ־
 	ptcb->OSTCBStatPend = OS_STAT_PEND_OK;      //־
 	if (ptcb->OSTCBStat == OS_STAT_RDY) {	/*ǰ̬ô Task now ready?                          */
-		OSRdyGrp |= ptcb->OSTCBBitY;	/*б Put task into ready list                 */
-		OSRdyTbl[ptcb->OSTCBY] |= ptcb->OSTCBBitX;
+		OS_RdyListInsert(ptcb);	/*б Put task into ready list                 */
 		sched = OS_TRUE;                //سɹ־
 	} else {        //ûдھ̬Ϊֹܲڵȴ¼־
 		sched = OS_FALSE;
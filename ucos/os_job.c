@@ -0,0 +1,275 @@
+/*
+*********************************************************************************************************
+*                                                uC/OS-II
+*                                          The Real-Time Kernel
+*                                    RUN-TO-COMPLETION JOB MANAGEMENT
+*
+* File    : OS_JOB.C
+* Version : V2.91
+*
+* A job is an event handler that runs to completion: it is called with one message and returns, it never
+* blocks half way.  Jobs therefore don't need a task (and a stack) of their own.  The jobs of a level
+* share one task, created by OSJobLvlCreate(), and so one stack.  The level task has an ordinary
+* priority, i.e. it is in the ready list like any other task and levels preempt each other and the
+* other tasks as usual.  Within a level, messages are handled one at a time, in the order posted.
+*
+* A job costs an OS_JOB (12 bytes) plus its share of the level's message queue (8 bytes per entry),
+* instead of a TCB and a stack.  A job MUST NOT call services that may block (OSSemPend(), OSTimeDly(),
+* ...); this would hold up all the jobs of its level.
+*********************************************************************************************************
+*/
+
+#ifndef  OS_MASTER_FILE
+#include <ucos_ii.h>
+#endif
+
+#if OS_JOB_EN > 0u
+/*
+*********************************************************************************************************
+*                                          LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static void OS_JobTask(void *p_arg);
+
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                             CREATE A JOB
+*
+* Description: This function initializes a job and attaches it to a level created by OSJobLvlCreate().
+*
+* Arguments  : pjob          is a pointer to the job to initialize.
+*
+*              plvl          is a pointer to the level whose task runs the job.
+*
+*              fnct          is the function called with each message posted to the job.  It is called
+*                            as fnct(p_arg, pmsg) and MUST return without blocking.
+*
+*              p_arg         is the argument passed to 'fnct' (e.g. the state of the job).
+*
+* Returns    : OS_ERR_NONE          if the job was initialized.
+*              OS_ERR_PDATA_NULL    if 'pjob', 'plvl' or 'fnct' is a NULL pointer.
+*********************************************************************************************************
+*/
+
+INT8U OSJobCreate(OS_JOB * pjob, OS_JOB_LVL * plvl, OS_JOB_FNCT fnct, void *p_arg)
+{
+#if OS_ARG_CHK_EN > 0u
+	if ((pjob == (OS_JOB *) 0) || (plvl == (OS_JOB_LVL *) 0) || (fnct == (OS_JOB_FNCT) 0)) {
+		return (OS_ERR_PDATA_NULL);
+	}
+#endif
+	pjob->OSJobFnct = fnct;
+	pjob->OSJobArg = p_arg;
+	pjob->OSJobLvl = plvl;
+	return (OS_ERR_NONE);
+}
+
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                         CREATE A JOB LEVEL
+*
+* Description: This function creates the task and the message queue shared by the jobs of a level.
+*
+* Arguments  : plvl          is a pointer to the level to initialize.
+*
+*              prio          is the priority of the level task.  All the jobs of the level run at this
+*                            priority, on the stack given below.
+*
+*              pstk          is a pointer to the LOWEST address of the stack shared by the jobs.
+*
+*              stk_size      is the size of that stack in OS_STK entries.  It must hold the deepest
+*                            job of the level (plus the context of the task).
+*
+*              pq            is a pointer to the storage of the message queue.
+*
+*              q_size        is the number of entries in 'pq', i.e. the number of messages that may be
+*                            posted to the level and not handled yet.
+*
+* Returns    : OS_ERR_NONE              if the level was created.
+*              OS_ERR_CREATE_ISR        if you called this function from an ISR.
+*              OS_ERR_PDATA_NULL        if 'plvl', 'pstk' or 'pq' is a NULL pointer.
+*              OS_ERR_JOB_INVALID_SIZE  if 'stk_size' or 'q_size' is 0.
+*              OS_ERR_JOB_NO_EVENT      if no event control block was left for the level.
+*              Any of the errors of OSTaskCreateExt() (or OSTaskCreate()), e.g. OS_ERR_PRIO_EXIST.
+*
+* Note(s)    : 1) The level uses one semaphore, i.e. one of the OS_MAX_EVENTS event control blocks.
+*********************************************************************************************************
+*/
+
+INT8U OSJobLvlCreate(OS_JOB_LVL * plvl, INT8U prio, OS_STK * pstk, INT32U stk_size, OS_JOB_MSG * pq, INT16U q_size)
+{
+	OS_EVENT *psem;
+	INT8U err;
+#if OS_SEM_DEL_EN > 0u
+	INT8U err_del;
+#endif
+
+
+#ifdef OS_SAFETY_CRITICAL_IEC61508
+	if (OSSafetyCriticalStartFlag == OS_TRUE) {
+		OS_SAFETY_CRITICAL_EXCEPTION();
+	}
+#endif
+
+#if OS_ARG_CHK_EN > 0u
+	if ((plvl == (OS_JOB_LVL *) 0) || (pstk == (OS_STK *) 0) || (pq == (OS_JOB_MSG *) 0)) {
+		return (OS_ERR_PDATA_NULL);
+	}
+	if ((stk_size == 0u) || (q_size == 0u)) {
+		return (OS_ERR_JOB_INVALID_SIZE);
+	}
+#endif
+	if (OSIntNesting > 0u) {	/* See if called from ISR ...                         */
+		return (OS_ERR_CREATE_ISR);	/* ... can't CREATE from an ISR                       */
+	}
+	psem = OSSemCreate(0u);	/* Counts the messages queued to the level            */
+	if (psem == (OS_EVENT *) 0) {
+		return (OS_ERR_JOB_NO_EVENT);
+	}
+	plvl->OSJobLvlSem = psem;	/* Initialize the level before its task can run       */
+	plvl->OSJobLvlStart = pq;
+	plvl->OSJobLvlEnd = &pq[q_size];
+	plvl->OSJobLvlIn = pq;
+	plvl->OSJobLvlOut = pq;
+	plvl->OSJobLvlSize = q_size;
+	plvl->OSJobLvlEntries = 0u;
+	plvl->OSJobLvlEntriesMax = 0u;
+	plvl->OSJobLvlPrio = prio;
+
+#if OS_TASK_CREATE_EXT_EN > 0u
+#if OS_STK_GROWTH == 1u
+	err = OSTaskCreateExt(OS_JobTask, (void *) plvl,	/* Pass the level to its task                */
+			      &pstk[stk_size - 1u],	/* Set Top-Of-Stack                           */
+			      prio, prio, &pstk[0],	/* Set Bottom-Of-Stack                        */
+			      stk_size, (void *) 0,	/* No TCB extension                           */
+			      OS_TASK_OPT_STK_CHK | OS_TASK_OPT_STK_CLR);	/* Enable stack checking + clear stack        */
+#else
+	err = OSTaskCreateExt(OS_JobTask, (void *) plvl,	/* Pass the level to its task                */
+			      &pstk[0],	/* Set Top-Of-Stack                           */
+			      prio, prio, &pstk[stk_size - 1u],	/* Set Bottom-Of-Stack                        */
+			      stk_size, (void *) 0,	/* No TCB extension                           */
+			      OS_TASK_OPT_STK_CHK | OS_TASK_OPT_STK_CLR);	/* Enable stack checking + clear stack        */
+#endif
+#else
+#if OS_STK_GROWTH == 1u
+	err = OSTaskCreate(OS_JobTask, (void *) plvl, &pstk[stk_size - 1u], prio);
+#else
+	err = OSTaskCreate(OS_JobTask, (void *) plvl, &pstk[0], prio);
+#endif
+#endif
+	if (err != OS_ERR_NONE) {
+#if OS_SEM_DEL_EN > 0u
+		(void) OSSemDel(psem, OS_DEL_ALWAYS, &err_del);	/* Give the ECB back                 */
+#endif
+		plvl->OSJobLvlSem = (OS_EVENT *) 0;
+		return (err);
+	}
+#if OS_TASK_NAME_EN > 0u
+	OSTaskNameSet(prio, (INT8U *) (void *) "uC/OS-II Job", &err);
+#endif
+	return (OS_ERR_NONE);
+}
+
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                         POST A MESSAGE TO A JOB
+*
+* Description: This function queues a message for a job.  The job runs when its level task is the highest
+*              priority task ready to run and all the messages posted to the level before are handled.
+*
+* Arguments  : pjob          is a pointer to the job.
+*
+*              pmsg          is the message passed to the job function.  It may be a NULL pointer.
+*
+* Returns    : OS_ERR_NONE          if the message was queued.
+*              OS_ERR_PDATA_NULL    if 'pjob' is a NULL pointer.
+*              OS_ERR_Q_FULL        if the queue of the level is full.
+*
+* Note(s)    : 1) This function may be called from an ISR.
+*********************************************************************************************************
+*/
+
+INT8U OSJobPost(OS_JOB * pjob, void *pmsg)
+{
+	OS_JOB_LVL *plvl;
+#if OS_CRITICAL_METHOD == 3u	/* Allocate storage for CPU status register           */
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+
+#if OS_ARG_CHK_EN > 0u
+	if (pjob == (OS_JOB *) 0) {
+		return (OS_ERR_PDATA_NULL);
+	}
+#endif
+	plvl = pjob->OSJobLvl;
+	OS_ENTER_CRITICAL();
+	if (plvl->OSJobLvlEntries >= plvl->OSJobLvlSize) {	/* Make sure queue is not full                  */
+		OS_EXIT_CRITICAL();
+		return (OS_ERR_Q_FULL);
+	}
+	plvl->OSJobLvlIn->OSJobMsgJob = pjob;	/* Insert message into queue                          */
+	plvl->OSJobLvlIn->OSJobMsgPtr = pmsg;
+	plvl->OSJobLvlIn++;
+	if (plvl->OSJobLvlIn == plvl->OSJobLvlEnd) {	/* Wrap IN ptr if we are at end of queue              */
+		plvl->OSJobLvlIn = plvl->OSJobLvlStart;
+	}
+	plvl->OSJobLvlEntries++;
+	if (plvl->OSJobLvlEntriesMax < plvl->OSJobLvlEntries) {
+		plvl->OSJobLvlEntriesMax = plvl->OSJobLvlEntries;	/* Keep the peak to size the queue              */
+	}
+	OS_EXIT_CRITICAL();
+	return (OSSemPost(plvl->OSJobLvlSem));	/* Ready the level task (count <= entries <= size)    */
+}
+
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                              LEVEL TASK
+*
+* Description: This task is created by OSJobLvlCreate().  It takes the messages posted to the level in
+*              order and calls the job each one is for.
+*
+* Arguments  : p_arg         is a pointer to the level.
+*
+* Returns    : none
+*
+* Note(s)    : 1) The semaphore of the level counts the messages in its queue, so a successful pend
+*                 guarantees that there is an entry to take.
+*********************************************************************************************************
+*/
+
+static void OS_JobTask(void *p_arg)
+{
+	OS_JOB_LVL *plvl;
+	OS_JOB *pjob;
+	void *pmsg;
+	INT8U err;
+#if OS_CRITICAL_METHOD == 3u	/* Allocate storage for CPU status register           */
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+
+	plvl = (OS_JOB_LVL *) p_arg;
+	for (;;) {
+		OSSemPend(plvl->OSJobLvlSem, 0u, &err);	/* Wait for a message                                 */
+		if (err != OS_ERR_NONE) {
+			continue;
+		}
+		OS_ENTER_CRITICAL();
+		pjob = plvl->OSJobLvlOut->OSJobMsgJob;	/* Extract oldest message from queue                  */
+		pmsg = plvl->OSJobLvlOut->OSJobMsgPtr;
+		plvl->OSJobLvlOut++;
+		if (plvl->OSJobLvlOut == plvl->OSJobLvlEnd) {	/* Wrap OUT ptr if we are at the end of the queue     */
+			plvl->OSJobLvlOut = plvl->OSJobLvlStart;
+		}
+		plvl->OSJobLvlEntries--;
+		OS_EXIT_CRITICAL();
+		(*pjob->OSJobFnct) (pjob->OSJobArg, pmsg);	/* Run the job to completion                          */
+	}
+}
+#endif				/* OS_JOB_EN                                */
@@ -46,6 +46,14 @@
 
 static void OSMutex_RdyAtPrio(OS_TCB * ptcb, INT8U prio);
 
+#if (OS_MUTEX_FAST_EN > 0u) && (OS_CPU_EXCL_EN > 0)
+static BOOLEAN OSMutex_FastPend(OS_EVENT * pevent, INT8U * perr);
+
+static BOOLEAN OSMutex_FastPost(OS_EVENT * pevent);
+
+static void OSMutex_Sync(OS_EVENT * pevent);
+#endif
+
 /*$PAGE*/
 /*
 *********************************************************************************************************
@@ -114,6 +122,9 @@ BOOLEAN OSMutexAccept(OS_EVENT * pevent, INT8U * perr)
 		return (OS_FALSE);
 	}
 	OS_ENTER_CRITICAL();	/* Get value (0 or 1) of Mutex                  */
+#if (OS_MUTEX_FAST_EN > 0u) && (OS_CPU_EXCL_EN > 0)
+	OSMutex_Sync(pevent);	/* Record the owner of a fast-path acquisition */
+#endif
 	pip = (INT8U) (pevent->OSEventCnt >> 8u);	/*ȡźPIP Get PIP from mutex                           */
 	if ((pevent->OSEventCnt & OS_MUTEX_KEEP_LOWER_8) == OS_MUTEX_AVAILABLE) {//ĵͰλΪ0xFF,ζŴ˿̻źûбռ
 		pevent->OSEventCnt &= OS_MUTEX_KEEP_UPPER_8;	/*źͰλ      Mask off LSByte (Acquire Mutex)         */
@@ -312,6 +323,9 @@ OS_EVENT *OSMutexDel(OS_EVENT * pevent, INT8U opt, INT8U * perr)
 		return (pevent);
 	}
 	OS_ENTER_CRITICAL();
+#if (OS_MUTEX_FAST_EN > 0u) && (OS_CPU_EXCL_EN > 0)
+	OSMutex_Sync(pevent);	/* Record the owner of a fast-path acquisition */
+#endif
 	if (pevent->OSEventGrp != 0u) {	/*Ƿڵȴ See if any tasks waiting on mutex        */
 		tasks_waiting = OS_TRUE;	/* Yes                                      */
 	} else {
@@ -418,6 +432,9 @@ OS_EVENT *OSMutexDel(OS_EVENT * pevent, INT8U opt, INT8U * perr)
 * Note(s)    : 1) The task that owns the Mutex MUST NOT pend on any other event while it owns the mutex.
 *
 *              2) You MUST NOT change the priority of the task that owns the mutex
+*
+*              3) With OS_MUTEX_FAST_EN, a free mutex is claimed with LDREX/STREX on '.OSEventPtr' and
+*                 interrupts are only disabled when the task has to wait.
 *********************************************************************************************************
 */
 
@@ -428,7 +445,6 @@ void OSMutexPend(OS_EVENT * pevent, INT32U timeout, INT8U * perr)
 	BOOLEAN rdy;		/* Flag indicating task was ready           */
 	OS_TCB *ptcb;
 	OS_EVENT *pevent2;
-	INT8U y;
 #if OS_CRITICAL_METHOD == 3u	/* Allocate storage for CPU status register */
 	OS_CPU_SR cpu_sr = 0u;      //õַʽжϣҪcpu_srж״̬
 #endif
@@ -458,8 +474,16 @@ void OSMutexPend(OS_EVENT * pevent, INT32U timeout, INT8U * perr)
 		*perr = OS_ERR_PEND_LOCKED;	/* ... can't PEND when locked               */
 		return;
 	}
+#if (OS_MUTEX_FAST_EN > 0u) && (OS_CPU_EXCL_EN > 0)
+	if (OSMutex_FastPend(pevent, perr) == OS_TRUE) {	/* Mutex was free, claimed without locking      */
+		return;
+	}
+#endif
 /*$PAGE*/
 	OS_ENTER_CRITICAL();
+#if (OS_MUTEX_FAST_EN > 0u) && (OS_CPU_EXCL_EN > 0)
+	OSMutex_Sync(pevent);	/* Record the owner of a fast-path acquisition */
+#endif
 	pip = (INT8U) (pevent->OSEventCnt >> 8u);	/*ȡźPIP Get PIP from mutex                       */
 	/* Is Mutex available? źãֵĵͰλӦΪ0xFF                      */
 	if ((INT8U) (pevent->OSEventCnt & OS_MUTEX_KEEP_LOWER_8) == OS_MUTEX_AVAILABLE) {   //źûбռ
@@ -480,21 +504,13 @@ void OSMutexPend(OS_EVENT * pevent, INT32U timeout, INT8U * perr)
 	ptcb = (OS_TCB *) (pevent->OSEventPtr);	/*źӵߵTCB     Point to TCB of mutex owner   */
 	if (ptcb->OSTCBPrio > pip) {	/*źӵߵȼҪPIP     Need to promote prio of owner? */
 		if (mprio > OSTCBCur->OSTCBPrio) {//źӵߵȼȵǰ(ź)Ҫ
-			y = ptcb->OSTCBY;
-			if ((OSRdyTbl[y] & ptcb->OSTCBBitX) != 0u) {	/*źӵǷ     See if mutex owner is ready   */
-				OSRdyTbl[y] &= (OS_PRIO) ~ ptcb->OSTCBBitX;	/*ʹźӵΪҪȼ̳УΪPIP  Yes, Remove owner from Rdy ... */
-				if (OSRdyTbl[y] == 0u) {	/*          ... list at current prio */
-					OSRdyGrp &= (OS_PRIO) ~ ptcb->OSTCBBitY;
-				}
+			if (OS_RdyListHas(ptcb)) {	/*źӵǷ     See if mutex owner is ready   */
+				OS_RdyListRemove(ptcb);	/*ʹźӵΪҪȼ̳УΪPIP  Yes, Remove owner from Rdy ... */
 				rdy = OS_TRUE;                              //Ϊ״̬־
 			} else {                                //źӵ߲Ǿ״̬
 				pevent2 = ptcb->OSTCBEventPtr;      //ȡʹźӵߵȴ¼
 				if (pevent2 != (OS_EVENT *) 0) {	/*¼ڣźӵߴӵȴбɾµȼ Remove from event wait list       */
-					y = ptcb->OSTCBY;
-					pevent2->OSEventTbl[y] &= (OS_PRIO) ~ ptcb->OSTCBBitX;
-					if (pevent2->OSEventTbl[y] == 0u) {
-						pevent2->OSEventGrp &= (OS_PRIO) ~ ptcb->OSTCBBitY;
-					}
+					OS_EventTaskRemove(ptcb, pevent2);
 				}
 				rdy = OS_FALSE;	/* Ϊδ״̬־ No                                       */
 			}
@@ -510,8 +526,7 @@ void OSMutexPend(OS_EVENT * pevent, INT32U timeout, INT8U * perr)
 			ptcb->OSTCBBitX = (OS_PRIO) (1uL << ptcb->OSTCBX);
 
 			if (rdy == OS_TRUE) {	/*źӵȼ̳֮ǰǾ If task was ready at owner's priority ... */
-				OSRdyGrp |= ptcb->OSTCBBitY;	/*ʹ֮µȼ ... make it ready at new priority.       */
-				OSRdyTbl[ptcb->OSTCBY] |= ptcb->OSTCBBitX;
+				OS_RdyListInsert(ptcb);	/*ʹ֮µȼ ... make it ready at new priority.       */
 			} else {                //źӵȼ̳֮ǰǵȴģʹµȼȴ
 				pevent2 = ptcb->OSTCBEventPtr;
 				if (pevent2 != (OS_EVENT *) 0) {	/* Add to event wait list                   */
@@ -577,6 +592,10 @@ void OSMutexPend(OS_EVENT * pevent, INT32U timeout, INT8U * perr)
 *                                      Unfortunately, this is something that could not be
 *                                      detected when the Mutex is created because we don't know
 *                                      what tasks will be using the Mutex.
+*
+* Note(s)    : 1) With OS_MUTEX_FAST_EN, a mutex that no task waits for is released with LDREX/STREX
+*                 and interrupts are only disabled when a waiter has to be readied or the owner's
+*                 priority has to be restored.
 *********************************************************************************************************
 */
 
@@ -601,7 +620,15 @@ INT8U OSMutexPost(OS_EVENT * pevent)
 	if (pevent->OSEventType != OS_EVENT_TYPE_MUTEX) {	/*ȷECBǻź Validate event block type                     */
 		return (OS_ERR_EVENT_TYPE);
 	}
+#if (OS_MUTEX_FAST_EN > 0u) && (OS_CPU_EXCL_EN > 0)
+	if (OSMutex_FastPost(pevent) == OS_TRUE) {	/* No waiters, released without locking         */
+		return (OS_ERR_NONE);
+	}
+#endif
 	OS_ENTER_CRITICAL();
+#if (OS_MUTEX_FAST_EN > 0u) && (OS_CPU_EXCL_EN > 0)
+	OSMutex_Sync(pevent);	/* Record the owner of a fast-path acquisition */
+#endif
 	pip = (INT8U) (pevent->OSEventCnt >> 8u);	/*ȡźPIP Get priority inheritance priority of mutex    */
 	prio = (INT8U) (pevent->OSEventCnt & OS_MUTEX_KEEP_LOWER_8);	/*ȡźӵԭȼ Get owner's original priority      */
 	if (OSTCBCur != (OS_TCB *) pevent->OSEventPtr) {	/*ǰǷǻźӵ See if posting task owns the MUTEX            */
@@ -617,7 +644,11 @@ INT8U OSMutexPost(OS_EVENT * pevent)
 		prio = OS_EventTaskRdy(pevent, (void *) 0, OS_STAT_MUTEX, OS_STAT_PEND_OK); //HPTȡȼ
 		pevent->OSEventCnt &= OS_MUTEX_KEEP_UPPER_8;	/*źͰλ0      Save priority of mutex's new owner       */
 		pevent->OSEventCnt |= prio;                     //µźӵߵԭȼ
+#if OS_TASK_RR_EN > 0u
+		pevent->OSEventPtr = OSTCBEventRdy;	/* Link to new mutex owner's OS_TCB (may share prio) */
+#else
 		pevent->OSEventPtr = OSTCBPrioTbl[prio];	/*źӵָָµӵ      Link to new mutex owner's OS_TCB         */
+#endif
 		if (prio <= pip) {	/*µӵߵȼҪPIP      PIP 'must' have a SMALLER prio ...       */
 			OS_EXIT_CRITICAL();	/*      ... than current task!                   */
 			OS_Sched();	/*      Find highest priority task ready to run  */
@@ -682,6 +713,9 @@ INT8U OSMutexQuery(OS_EVENT * pevent, OS_MUTEX_DATA * p_mutex_data)
 		return (OS_ERR_EVENT_TYPE);
 	}
 	OS_ENTER_CRITICAL();
+#if (OS_MUTEX_FAST_EN > 0u) && (OS_CPU_EXCL_EN > 0)
+	OSMutex_Sync(pevent);	/* Record the owner of a fast-path acquisition */
+#endif
 	p_mutex_data->OSMutexPIP = (INT8U) (pevent->OSEventCnt >> 8u);  //PIP
 	p_mutex_data->OSOwnerPrio = (INT8U) (pevent->OSEventCnt & OS_MUTEX_KEEP_LOWER_8);//źӵԭȼ
 	if (p_mutex_data->OSOwnerPrio == 0xFFu) {   //һĽ0xFF
@@ -713,19 +747,17 @@ INT8U OSMutexQuery(OS_EVENT * pevent, OS_MUTEX_DATA * p_mutex_data)
 *              prio            is the desired priority
 *
 * Returns    : none
+*
+* Note(s)    : With round-robin scheduling (OS_TASK_RR_EN) the task stayed in the list of tasks sharing
+*              'prio' while it was raised to the PIP.  OS_RdyListInsert() makes it the head of that list
+*              only if none of them is ready, so OSTCBPrioTbl[prio] is left to it.
 *********************************************************************************************************
 */
 
 static void OSMutex_RdyAtPrio(OS_TCB * ptcb, INT8U prio)
 {
-	INT8U y;
-
     //ʱptcbPIPȼھеģptcbӾɾ
-	y = ptcb->OSTCBY;	/* Remove owner from ready list at 'pip'    */
-	OSRdyTbl[y] &= (OS_PRIO) ~ ptcb->OSTCBBitX;
-	if (OSRdyTbl[y] == 0u) {
-		OSRdyGrp &= (OS_PRIO) ~ ptcb->OSTCBBitY;
-	}
+	OS_RdyListRemove(ptcb);	/* Remove owner from ready list at 'pip'    */
 
 	ptcb->OSTCBPrio = prio; //ptcbָԭȼ
 	OSPrioCur = prio;	/*ǰȼҲһָ The current task is now at this priority */
@@ -742,12 +774,134 @@ static void OSMutex_RdyAtPrio(OS_TCB * ptcb, INT8U prio)
 	ptcb->OSTCBBitX = (OS_PRIO) (1uL << ptcb->OSTCBX);
 
     //ptcb¼ʱptcbԻָȼھ
-	OSRdyGrp |= ptcb->OSTCBBitY;	/* Make task ready at original priority     */
-	OSRdyTbl[ptcb->OSTCBY] |= ptcb->OSTCBBitX;
+	OS_RdyListInsert(ptcb);	/* Make task ready at original priority     */
+#if OS_TASK_RR_EN == 0u
     //ptcb뵽Ӧȼ
 	OSTCBPrioTbl[prio] = ptcb;
+#endif
+
+}
+
+
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                   CLAIM A FREE MUTEX WITHOUT LOCKING
+*
+* Description: This function claims the mutex for the current task if no task owns it.  '.OSEventPtr' is
+*              the owner word: it is set with LDREX/STREX and only then is the owner's priority stored
+*              in the LSByte of '.OSEventCnt'.
+*
+* Arguments  : pevent          is a pointer to the event control block of the mutex
+*
+*              perr            is where the result is stored when the mutex was claimed
+*
+* Returns    : OS_TRUE         if the mutex was claimed
+*              OS_FALSE        if the mutex is owned and the caller must take the slow path
+*
+* Note(s)    : 1) The priority is read before the mutex is claimed: a task that blocks on the mutex in
+*                 between may already have raised the owner to the PIP.
+*********************************************************************************************************
+*/
+
+#if (OS_MUTEX_FAST_EN > 0u) && (OS_CPU_EXCL_EN > 0)
+static BOOLEAN OSMutex_FastPend(OS_EVENT * pevent, INT8U * perr)
+{
+	INT16U cnt;
+	INT8U prio;
+
 
+	prio = OSTCBCur->OSTCBPrio;	/* Priority to restore on release              */
+	while (OS_CPU_LDREX(&pevent->OSEventPtr) == (void *) 0) {	/* Mutex is free ...          */
+		if (OS_CPU_STREX((INT32U) OSTCBCur, &pevent->OSEventPtr) == 0u) {	/* ... claim it       */
+			do {
+				cnt = (INT16U) OS_CPU_LDREX(&pevent->OSEventCnt);
+			} while (OS_CPU_STREX((cnt & OS_MUTEX_KEEP_UPPER_8) | prio, &pevent->OSEventCnt) != 0u);
+			if (prio <= (INT8U) (cnt >> 8u)) {	/* PIP 'must' have a SMALLER prio ...        */
+				*perr = OS_ERR_PIP_LOWER;	/* ... than current task!                     */
+			} else {
+				*perr = OS_ERR_NONE;
+			}
+			return (OS_TRUE);
+		}
+	}
+	OS_CPU_CLREX();		/* Owned by a task, wait on the slow path       */
+	return (OS_FALSE);
 }
 
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                 RELEASE AN UNCONTENDED MUTEX WITHOUT LOCKING
+*
+* Description: This function releases the mutex if the current task owns it, no task waits for it and the
+*              owner's priority was not raised.  The owner's priority is cleared from '.OSEventCnt' first
+*              and the owner word second, so a task that blocks in between finds the owner's priority
+*              recorded by OSMutex_Sync() and is handed the mutex by the slow path.
+*
+* Arguments  : pevent          is a pointer to the event control block of the mutex
+*
+* Returns    : OS_TRUE         if the mutex was released
+*              OS_FALSE        if the caller must take the slow path
+*********************************************************************************************************
+*/
+
+static BOOLEAN OSMutex_FastPost(OS_EVENT * pevent)
+{
+	INT16U cnt;
+
+
+	do {
+		cnt = (INT16U) OS_CPU_LDREX(&pevent->OSEventCnt);
+		if ((pevent->OSEventGrp != 0u)	/* Any task waiting,                          */
+		    || ((OS_TCB *) pevent->OSEventPtr != OSTCBCur)	/* not the owner            */
+		    || (OSTCBCur->OSTCBPrio == (INT8U) (cnt >> 8u))) {	/* or running at PIP?     */
+			OS_CPU_CLREX();
+			return (OS_FALSE);
+		}
+	} while (OS_CPU_STREX(cnt | OS_MUTEX_AVAILABLE, &pevent->OSEventCnt) != 0u);
+	do {
+		(void) OS_CPU_LDREX(&pevent->OSEventPtr);
+		if (pevent->OSEventGrp != 0u) {	/* A task blocked meanwhile                   */
+			OS_CPU_CLREX();
+			return (OS_FALSE);
+		}
+	} while (OS_CPU_STREX(0u, &pevent->OSEventPtr) != 0u);
+	return (OS_TRUE);
+}
+
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                  RECORD THE OWNER OF A FAST-PATH MUTEX
+*
+* Description: This function brings '.OSEventCnt' in line with the owner word before the slow paths use
+*              it: the LSByte holds OS_MUTEX_AVAILABLE when no task owns the mutex, else the owner's
+*              original priority.
+*
+* Arguments  : pevent          is a pointer to the event control block of the mutex
+*
+* Returns    : none
+*
+* Note(s)    : 1) This function MUST be called with interrupts disabled.
+*              2) An owner that has not stored its priority yet can't have been raised to the PIP, so
+*                 its current priority is its original one.
+*********************************************************************************************************
+*/
+
+static void OSMutex_Sync(OS_EVENT * pevent)
+{
+	OS_TCB *ptcb;
+
+
+	ptcb = (OS_TCB *) pevent->OSEventPtr;
+	if (ptcb == (OS_TCB *) 0) {	/* No owner                                     */
+		pevent->OSEventCnt |= OS_MUTEX_AVAILABLE;
+	} else if ((pevent->OSEventCnt & OS_MUTEX_KEEP_LOWER_8) == OS_MUTEX_AVAILABLE) {
+		pevent->OSEventCnt &= OS_MUTEX_KEEP_UPPER_8;	/* Owner didn't store its priority yet */
+		pevent->OSEventCnt |= ptcb->OSTCBPrio;
+	}
+}
+#endif
 
 #endif				/* OS_MUTEX_EN                              */
@@ -289,6 +289,9 @@ OS_EVENT *OSSemDel(OS_EVENT * pevent, INT8U opt, INT8U * perr)
 *                            OS_ERR_PEND_LOCKED  If you called this function when the scheduler is locked
 *
 * Returns    : none
+*
+* Note(s)    : 1) With OS_SEM_FAST_EN, a positive count is taken with LDREX/STREX and interrupts are only
+*                 disabled when the task has to wait.
 *********************************************************************************************************
 */
 /*$PAGE*/
@@ -297,6 +300,9 @@ void OSSemPend(OS_EVENT * pevent, INT32U timeout, INT8U * perr)
 #if OS_CRITICAL_METHOD == 3u	/* Allocate storage for CPU status register      */
 	OS_CPU_SR cpu_sr = 0u;      //õַʽжϣҪcpu_srж״̬
 #endif
+#if (OS_SEM_FAST_EN > 0u) && (OS_CPU_EXCL_EN > 0)
+	INT16U cnt;
+#endif
 
 
 
@@ -324,6 +330,17 @@ void OSSemPend(OS_EVENT * pevent, INT32U timeout, INT8U * perr)
 		*perr = OS_ERR_PEND_LOCKED;	/* ... can't PEND when locked                    */
 		return;
 	}
+#if (OS_SEM_FAST_EN > 0u) && (OS_CPU_EXCL_EN > 0)
+	cnt = (INT16U) OS_CPU_LDREX(&pevent->OSEventCnt);	/* Take a positive count without masking ints  */
+	while (cnt > 0u) {
+		if (OS_CPU_STREX(cnt - 1u, &pevent->OSEventCnt) == 0u) {
+			*perr = OS_ERR_NONE;
+			return;
+		}
+		cnt = (INT16U) OS_CPU_LDREX(&pevent->OSEventCnt);	/* Interrupted, count may have changed         */
+	}
+	OS_CPU_CLREX();		/* Count is 0, block on the slow path            */
+#endif
 	OS_ENTER_CRITICAL();
 	if (pevent->OSEventCnt > 0u) {	/*ʱź If sem. is positive, resource available ...   */
 		pevent->OSEventCnt--;	/* ȡһź ... decrement semaphore only if positive.     */
@@ -474,6 +491,9 @@ INT8U OSSemPendAbort(OS_EVENT * pevent, INT8U opt, INT8U * perr)
 *                                  OSSemAccept() or OSSemPend().
 *              OS_ERR_EVENT_TYPE   If you didn't pass a pointer to a semaphore
 *              OS_ERR_PEVENT_NULL  If 'pevent' is a NULL pointer.
+*
+* Note(s)    : 1) With OS_SEM_FAST_EN, the count is incremented with LDREX/STREX when no task is waiting,
+*                 so interrupts are only disabled when a waiting task has to be readied.
 *********************************************************************************************************
 */
 
@@ -482,6 +502,9 @@ INT8U OSSemPost(OS_EVENT * pevent)
 #if OS_CRITICAL_METHOD == 3u	/* Allocate storage for CPU status register      */
 	OS_CPU_SR cpu_sr = 0u;      //õַʽжϣҪcpu_srж״̬
 #endif
+#if (OS_SEM_FAST_EN > 0u) && (OS_CPU_EXCL_EN > 0)
+	INT16U cnt;
+#endif
 
 
 
@@ -493,6 +516,18 @@ INT8U OSSemPost(OS_EVENT * pevent)
 	if (pevent->OSEventType != OS_EVENT_TYPE_SEM) {	/*ȷECBź Validate event block type                     */
 		return (OS_ERR_EVENT_TYPE);
 	}
+#if (OS_SEM_FAST_EN > 0u) && (OS_CPU_EXCL_EN > 0)
+	for (;;) {		/* Bump the count without masking interrupts     */
+		cnt = (INT16U) OS_CPU_LDREX(&pevent->OSEventCnt);
+		if ((pevent->OSEventGrp != 0u) || (cnt == 65535u)) {
+			OS_CPU_CLREX();	/* Waiter to ready or overflow, use slow path    */
+			break;
+		}
+		if (OS_CPU_STREX(cnt + 1u, &pevent->OSEventCnt) == 0u) {
+			return (OS_ERR_NONE);
+		}
+	}
+#endif
 	OS_ENTER_CRITICAL();
 	if (pevent->OSEventGrp != 0u) {	/*ڵȴ See if any task waiting for semaphore         */
 		/* Ready HPT waiting on event                    */
@@ -25,6 +25,94 @@
 #include <ucos_ii.h>
 #endif
 
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                     SET THE CPU BUDGET OF A TASK
+*
+* Description: This function is used to limit the CPU time a task may use in each replenishment period.
+*              A task that uses up its budget is held (OS_STAT_BUDGET) until its budget is replenished at
+*              the start of the next period.  Each overrun is counted in the task's OSTCBBudgetOverrunCtr,
+*              which OSTaskQuery() returns, and OSTaskBudgetHook() is called to report it.
+*
+* Arguments  : prio      is the priority of the task.  If you specify OS_PRIO_SELF, the budget of the
+*                        calling task is changed.
+*
+*              budget    is the CPU time the task may use per period, in OS_CPU_TS_GET() counts (CPU clock
+*                        cycles on this port).  0 stops enforcing a budget on the task.
+*
+*              period    is the replenishment period in clock ticks.  0 selects OS_TASK_BUDGET_PERIOD.
+*
+* Returns    : OS_ERR_NONE            if the call was successful
+*              OS_ERR_PRIO_INVALID    if you specified an invalid priority or tried to limit the idle task
+*              OS_ERR_TASK_NOT_EXIST  if the task has not been created or is assigned to a Mutex PIP
+*
+* Note(s)    : 1) Tasks created by OSTaskCreateExt() with the OS_TASK_OPT_BUDGET option start with a budget
+*                 of OS_TASK_BUDGET_DFLT per OS_TASK_BUDGET_PERIOD ticks.
+*              2) Changing the budget starts a new period.  A task held for using up its budget is
+*                 released.
+*********************************************************************************************************
+*/
+
+#if OS_TASK_BUDGET_EN > 0u
+INT8U OSTaskBudgetSet(INT8U prio, INT32U budget, INT16U period)
+{
+	OS_TCB *ptcb;
+#if OS_CRITICAL_METHOD == 3u	/* Allocate storage for CPU status register       */
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+
+
+#if OS_ARG_CHK_EN > 0u
+	if (prio == OS_TASK_IDLE_PRIO) {	/* Not allowed to limit the idle task             */
+		return (OS_ERR_PRIO_INVALID);
+	}
+	if (prio >= OS_LOWEST_PRIO) {	/* Task priority valid ?                          */
+		if (prio != OS_PRIO_SELF) {
+			return (OS_ERR_PRIO_INVALID);
+		}
+	}
+#endif
+	if (period == 0u) {	/* Use the default period                         */
+		period = OS_TASK_BUDGET_PERIOD;
+	}
+	OS_ENTER_CRITICAL();
+	if (prio == OS_PRIO_SELF) {	/* See if caller desires to change its budget     */
+		ptcb = OSTCBCur;
+	} else {
+		ptcb = OSTCBPrioTbl[prio];
+	}
+	if (ptcb == (OS_TCB *) 0) {	/* Does task exist?                               */
+		OS_EXIT_CRITICAL();
+		return (OS_ERR_TASK_NOT_EXIST);
+	}
+	if (ptcb == OS_TCB_RESERVED) {	/* Task assigned to a Mutex?                      */
+		OS_EXIT_CRITICAL();
+		return (OS_ERR_TASK_NOT_EXIST);
+	}
+	if (budget == 0u) {	/* Stop enforcing a budget                        */
+		ptcb->OSTCBOpt &= (INT16U) ~ (INT16U) OS_TASK_OPT_BUDGET;
+	} else {
+		ptcb->OSTCBOpt |= OS_TASK_OPT_BUDGET;
+		ptcb->OSTCBBudget = budget;
+	}
+	ptcb->OSTCBBudgetPeriod = period;	/* Start a new period                             */
+	ptcb->OSTCBBudgetCtr = period;
+	ptcb->OSTCBBudgetUsed = 0uL;
+	if ((ptcb->OSTCBStat & OS_STAT_BUDGET) != OS_STAT_RDY) {	/* Release a held task            */
+		ptcb->OSTCBStat &= (INT8U) ~ (INT8U) OS_STAT_BUDGET;
+		if (ptcb->OSTCBStat == OS_STAT_RDY) {
+			OS_RdyListInsert(ptcb);
+		}
+	}
+	OS_EXIT_CRITICAL();
+	if (OSRunning == OS_TRUE) {
+		OS_Sched();	/* Find new highest priority task                 */
+	}
+	return (OS_ERR_NONE);
+}
+#endif
 /*$PAGE*/
 /*
 *********************************************************************************************************
@@ -59,11 +147,15 @@ INT8U OSTaskChangePrio(INT8U oldprio, INT8U newprio)
 	OS_TCB *ptcb;
 	INT8U y_new;
 	INT8U x_new;
-	INT8U y_old;
 	OS_PRIO bity_new;
 	OS_PRIO bitx_new;
+#if OS_TASK_RR_EN > 0u
+	BOOLEAN rdy;
+#else
+	INT8U y_old;
 	OS_PRIO bity_old;
 	OS_PRIO bitx_old;
+#endif
 #if OS_CRITICAL_METHOD == 3u //õַʽж
 	OS_CPU_SR cpu_sr = 0u;	/* Storage for CPU status register         */
 #endif
@@ -107,6 +199,12 @@ INT8U OSTaskChangePrio(INT8U oldprio, INT8U newprio)
 	bity_new = (OS_PRIO) (1uL << y_new);
 	bitx_new = (OS_PRIO) (1uL << x_new);
 
+#if OS_TASK_RR_EN > 0u
+	rdy = OS_RdyListHas(ptcb);
+	if (rdy == OS_TRUE) {	/* If task is ready make it not            */
+		OS_RdyListRemove(ptcb);
+	}
+#else
 	OSTCBPrioTbl[oldprio] = (OS_TCB *) 0;	/*ɾȼоȼλõTCB Remove TCB from old priority            */
 	OSTCBPrioTbl[newprio] = ptcb;	/*ӵȼλ Place pointer to TCB @ new priority     */
 	y_old = ptcb->OSTCBY;
@@ -120,13 +218,11 @@ INT8U OSTaskChangePrio(INT8U oldprio, INT8U newprio)
 		OSRdyGrp |= bity_new;	/*ȼľ Make new priority ready to run          */
 		OSRdyTbl[y_new] |= bitx_new;
 	}
+#endif
 #if (OS_EVENT_EN)
 	pevent = ptcb->OSTCBEventPtr;
 	if (pevent != (OS_EVENT *) 0) {
-		pevent->OSEventTbl[y_old] &= (OS_PRIO) ~ bitx_old;	/*ڵȴнȼƳ Remove old task prio from wait list     */
-		if (pevent->OSEventTbl[y_old] == 0u) {
-			pevent->OSEventGrp &= (OS_PRIO) ~ bity_old;
-		}
+		OS_EventTaskRemove(ptcb, pevent);	/*ڵȴнȼƳ Remove old task prio from wait list     */
 		pevent->OSEventGrp |= bity_new;	/*ȴȼλ Add    new task prio to   wait list     */
 		pevent->OSEventTbl[y_new] |= bitx_new;
 	}
@@ -147,12 +243,33 @@ INT8U OSTaskChangePrio(INT8U oldprio, INT8U newprio)
 	}
 #endif
 #endif
+#if OS_TASK_RR_EN > 0u
+	OS_TaskRRUnlink(ptcb);	/* Leave the tasks at the old priority,    */
+#endif				/* after the wait list looked for peers    */
 
 	ptcb->OSTCBPrio = newprio;	/*ȼ Set new task priority                   */
 	ptcb->OSTCBY = y_new;
 	ptcb->OSTCBX = x_new;
 	ptcb->OSTCBBitY = bity_new;
 	ptcb->OSTCBBitX = bitx_new;
+#if OS_TASK_THRESHOLD_EN > 0u
+	if ((ptcb->OSTCBThreshold == oldprio) || (ptcb->OSTCBThreshold > newprio)) {
+		ptcb->OSTCBThreshold = newprio;	/* Threshold follows the task's priority   */
+	}
+#endif
+#if OS_EDF_EN > 0u
+	if (OS_RdyListHas(ptcb)) {	/* Move task in or out of the EDF band     */
+		OS_EdfRdyRemove(ptcb);
+		OS_EdfRdyInsert(ptcb);
+	}
+#endif
+#if OS_TASK_RR_EN > 0u
+	OS_TaskRRLink(ptcb);	/* Join the tasks at the new priority      */
+	if (rdy == OS_TRUE) {
+		OS_RdyListInsert(ptcb);	/* Make new priority ready to run          */
+	}
+#endif
+	OSSchedReq = OS_TRUE;	/* Priorities changed, search again        */
 	OS_EXIT_CRITICAL();
 	if (OSRunning == OS_TRUE) {
 		OS_Sched();	/*µ Find new highest priority task          */
@@ -191,10 +308,12 @@ INT8U OSTaskChangePrio(INT8U oldprio, INT8U newprio)
 *                       ջջָ
 *              prio     is the task's priority.  A unique priority MUST be assigned to each task and the
 *                       lower the number, the higher the priority.
+*                       When OS_TASK_RR_EN is set, several tasks may share a priority and are
+*                       time sliced round-robin (see OSTaskQuantaSet()).
 *                       ȼ
 * Returns    : OS_ERR_NONE             if the function was successful.ɹ
 *              OS_PRIO_EXIT            if the task priority already exist ָȼѾռ
-*                                      (each task MUST have a unique priority).
+*                                      (each task MUST have a unique priority, see OS_TASK_RR_EN).
 *              OS_ERR_PRIO_INVALID     if the priority you specify is higher that the maximum allowed
 *                                      (i.e. >= OS_LOWEST_PRIO)ָȼOS_LOWEST_PRIO
 *              OS_ERR_TASK_CREATE_ISR  if you tried to create a task from an ISR.жϷд
@@ -206,6 +325,9 @@ INT8U OSTaskCreate(void (*task) (void *p_arg), void *p_arg, OS_STK * ptos, INT8U
 {
 	OS_STK *psp;
 	INT8U err;
+#if OS_TASK_RR_EN > 0u
+	OS_TCB *ptcb;
+#endif
 #if OS_CRITICAL_METHOD == 3u	/* Allocate storage for CPU status register               */
 	OS_CPU_SR cpu_sr = 0u;      //õַʽжϣҪcpu_srж״̬
 #endif
@@ -245,6 +367,21 @@ INT8U OSTaskCreate(void (*task) (void *p_arg), void *p_arg, OS_STK * ptos, INT8U
 		}
 		return (err);
 	}
+#if OS_TASK_RR_EN > 0u
+	ptcb = OSTCBPrioTbl[prio];
+	if ((ptcb != (OS_TCB *) 0) && (ptcb != OS_TCB_RESERVED)	/* Round-robin: see if tasks already  ...   */
+	    && (ptcb->OSTCBRRPrio == prio) && (prio != OS_TASK_IDLE_PRIO)) {	/* ... share 'prio'       */
+		OS_EXIT_CRITICAL();
+		psp = OSTaskStkInit(task, p_arg, ptos, 0u);	/* Initialize the task's stack          */
+		err = OS_TCBInit(prio, psp, (OS_STK *) 0, 0u, 0u, (void *) 0, 0u);	/* Join them at 'prio'  */
+		if (err == OS_ERR_NONE) {
+			if (OSRunning == OS_TRUE) {	/* Find highest priority task if multitasking has started */
+				OS_Sched();
+			}
+		}
+		return (err);
+	}
+#endif
 	OS_EXIT_CRITICAL();
 	return (OS_ERR_PRIO_EXIST);
 }
@@ -281,6 +418,8 @@ INT8U OSTaskCreate(void (*task) (void *p_arg), void *p_arg, OS_STK * ptos, INT8U
 *
 *              prio      is the task's priority.  A unique priority MUST be assigned to each task and the
 *                        lower the number, the higher the priority.
+*                        When OS_TASK_RR_EN is set, several tasks may share a priority and are
+*                        time sliced round-robin (see OSTaskQuantaSet()).
 *
 *              id        is the task's ID (0..65535),չֵ֧Ŀ64
 *
@@ -313,13 +452,20 @@ INT8U OSTaskCreate(void (*task) (void *p_arg), void *p_arg, OS_STK * ptos, INT8U
 *                        OS_TASK_OPT_STK_CLR      Clear the stack when the task is created ջ
 *                        OS_TASK_OPT_SAVE_FP      If the CPU has floating-point registers, save them
 *                                                 during a context switch.  
+*                        OS_TASK_OPT_BUDGET       Enforce a CPU budget on the task, see OSTaskBudgetSet()
 *
 * Returns    : OS_ERR_NONE             if the function was successful.
 *              OS_PRIO_EXIT            if the task priority already exist
-*                                      (each task MUST have a unique priority).
+*                                      (each task MUST have a unique priority, see OS_TASK_RR_EN).
 *              OS_ERR_PRIO_INVALID     if the priority you specify is higher that the maximum allowed
 *                                      (i.e. > OS_LOWEST_PRIO)
 *              OS_ERR_TASK_CREATE_ISR  if you tried to create a task from an ISR.
+*              OS_ERR_STK_SIZE_INVALID if the stack has no room above its guard (see note 1).
+*
+* Note(s)    : 1) With OS_TASK_STK_GUARD_EN, the lowest OS_TASK_STK_GUARD_SIZE entries of a stack created
+*                 with OS_TASK_OPT_STK_CHK hold the stack guard (see OS_CPU.H).  They are included in
+*                 'stk_size' but are not available to the task, and are only written once the task's
+*                 priority has been reserved.
 *********************************************************************************************************
 */
 /*$PAGE*/
@@ -330,6 +476,9 @@ INT8U OSTaskCreateExt(void (*task) (void *p_arg),
 {
 	OS_STK *psp;
 	INT8U err;
+#if OS_TASK_RR_EN > 0u
+	OS_TCB *ptcb;
+#endif
 #if OS_CRITICAL_METHOD == 3u	/* Allocate storage for CPU status register               */
 	OS_CPU_SR cpu_sr = 0u;      //õַʽʵֿж,Ҫcpu_sr洢ж״̬
 #endif
@@ -346,6 +495,15 @@ INT8U OSTaskCreateExt(void (*task) (void *p_arg),
 	if (prio > OS_LOWEST_PRIO) {	/*ȼĺϷ Make sure priority is within allowable range           */
 		return (OS_ERR_PRIO_INVALID);
 	}
+#endif
+#if (OS_TASK_STK_GUARD_EN > 0u) && (OS_STK_GROWTH == 1u)
+	if ((opt & OS_TASK_OPT_STK_CHK) != 0u) {	/* Stack proper starts above the guard         */
+		if (stk_size <= OS_TASK_STK_GUARD_SIZE) {	/* Room for the guard and the stack?  */
+			return (OS_ERR_STK_SIZE_INVALID);
+		}
+		pbos += OS_TASK_STK_GUARD_SIZE;
+		stk_size -= OS_TASK_STK_GUARD_SIZE;
+	}
 #endif
 	OS_ENTER_CRITICAL();
 	if (OSIntNesting > 0u) {	/*ǷжϷ Make sure we don't create the task from within an ISR  */
@@ -357,6 +515,9 @@ INT8U OSTaskCreateExt(void (*task) (void *p_arg),
 		/* ... the same thing until task is created.              */
 		OS_EXIT_CRITICAL();
 
+#if (OS_TASK_STK_GUARD_EN > 0u) && (OS_STK_GROWTH == 1u)
+		OS_TaskStkGuardClr(pbos, opt);	/* Priority is ours, clear the guard    */
+#endif
 #if (OS_TASK_STAT_STK_CHK_EN > 0u)
 		OS_TaskStkClr(pbos, stk_size, opt);	/*ջ Clear the task stack (if needed)     */
 #endif
@@ -374,6 +535,29 @@ INT8U OSTaskCreateExt(void (*task) (void *p_arg),
 		}
 		return (err);
 	}
+#if OS_TASK_RR_EN > 0u
+	ptcb = OSTCBPrioTbl[prio];
+	if ((ptcb != (OS_TCB *) 0) && (ptcb != OS_TCB_RESERVED)	/* Round-robin: see if tasks already  ...   */
+	    && (ptcb->OSTCBRRPrio == prio) && (prio != OS_TASK_IDLE_PRIO)) {	/* ... share 'prio'       */
+		OS_EXIT_CRITICAL();
+
+#if (OS_TASK_STK_GUARD_EN > 0u) && (OS_STK_GROWTH == 1u)
+		OS_TaskStkGuardClr(pbos, opt);	/* Priority is ours, clear the guard    */
+#endif
+#if (OS_TASK_STAT_STK_CHK_EN > 0u)
+		OS_TaskStkClr(pbos, stk_size, opt);	/* Clear the task stack (if needed)     */
+#endif
+
+		psp = OSTaskStkInit(task, p_arg, ptos, opt);	/* Initialize the task's stack          */
+		err = OS_TCBInit(prio, psp, pbos, id, stk_size, pext, opt);	/* Join them at 'prio'        */
+		if (err == OS_ERR_NONE) {
+			if (OSRunning == OS_TRUE) {	/* Find HPT if multitasking has started */
+				OS_Sched();
+			}
+		}
+		return (err);
+	}
+#endif
 	OS_EXIT_CRITICAL();
 	return (OS_ERR_PRIO_EXIST);
 }
@@ -458,10 +642,10 @@ INT8U OSTaskDel(INT8U prio)
 		return (OS_ERR_TASK_DEL);
 	}
 
-	OSRdyTbl[ptcb->OSTCBY] &= (OS_PRIO) ~ ptcb->OSTCBBitX;
-	if (OSRdyTbl[ptcb->OSTCBY] == 0u) {	/*ھ(һ佫临λ) Make task not ready                         */
-		OSRdyGrp &= (OS_PRIO) ~ ptcb->OSTCBBitY;    //Ƴ
-	}
+	OS_RdyListRemove(ptcb);	/* Make task not ready                         */
+#if OS_TASK_THRESHOLD_EN > 0u
+	OS_TaskThreshDrop(ptcb);	/* TCB is freed below                          */
+#endif
 #if (OS_EVENT_EN)
 	if (ptcb->OSTCBEventPtr != (OS_EVENT *) 0) {//ڵȴϢźȣӵȴбɾ
 		OS_EventTaskRemove(ptcb, ptcb->OSTCBEventPtr);	/* Remove this task from any event   wait list */
@@ -498,7 +682,11 @@ INT8U OSTaskDel(INT8U prio)
 
 	OSTaskDelHook(ptcb);	/* չӺ,ɾͷԶTCBݽṹ Call user defined hook                      */
 	OSTaskCtr--;		/*һ One less task being managed                 */
+#if OS_TASK_RR_EN > 0u
+	OS_TaskRRUnlink(ptcb);	/* Hand the priority over to the next task sharing it */
+#else
 	OSTCBPrioTbl[prio] = (OS_TCB *) 0;	/*ȼбɾOS_TCB Clear old priority entry                    */
+#endif
 	if (ptcb->OSTCBPrev == (OS_TCB *) 0) {	/*˫ɾTCB Remove from TCB chain                       */
 		ptcb->OSTCBNext->OSTCBPrev = (OS_TCB *) 0; //ǰûTCB
 		OSTCBList = ptcb->OSTCBNext;
@@ -765,6 +953,293 @@ void OSTaskNameSet(INT8U prio, INT8U * pname, INT8U * perr)
 }
 #endif
 
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                       REGISTER A PERIODIC TASK
+*
+* Description: This function is used to declare a task as periodic.  Once registered, every call the task
+*              makes to OSTimeDlyUntil() marks the end of one job and updates the periodic statistics kept
+*              in the task's OS_TCB:
+*
+*                  OSTCBPeriodCtr          number of jobs completed
+*                  OSTCBPeriodOverrun      number of release points missed (job ran past its period)
+*                  OSTCBPeriodJitterMax    worst-case delay between a release point and the task waking up
+*                  OSTCBPeriodRespMax      worst-case time between a release point and job completion
+*
+*              These statistics can be read back with OSTaskQuery().
+*
+* Arguments  : prio      is the priority of the task to register.  If you specify OS_PRIO_SELF, the
+*                        calling task is registered.
+*
+*              period    is the period of the task in clock ticks.  Specifying 0 turns statistics off.
+*
+* Returns    : OS_ERR_NONE            if the call was successful
+*              OS_ERR_PRIO_INVALID    if you specified an invalid priority
+*              OS_ERR_TASK_NOT_EXIST  if the task has not been created or is assigned to a Mutex PIP
+*
+* Note(s)    : 1) The statistics are cleared every time this function is called.
+*********************************************************************************************************
+*/
+
+#if OS_TASK_PERIOD_EN > 0u
+INT8U OSTaskPeriodSet(INT8U prio, INT32U period)
+{
+	OS_TCB *ptcb;
+#if OS_CRITICAL_METHOD == 3u	/* Allocate storage for CPU status register       */
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+
+
+#if OS_ARG_CHK_EN > 0u
+	if (prio > OS_LOWEST_PRIO) {	/* Task priority valid ?                          */
+		if (prio != OS_PRIO_SELF) {
+			return (OS_ERR_PRIO_INVALID);
+		}
+	}
+#endif
+	OS_ENTER_CRITICAL();
+	if (prio == OS_PRIO_SELF) {	/* See if caller desires to register itself       */
+		prio = OSTCBCur->OSTCBPrio;
+	}
+	ptcb = OSTCBPrioTbl[prio];
+	if (ptcb == (OS_TCB *) 0) {	/* Does task exist?                               */
+		OS_EXIT_CRITICAL();
+		return (OS_ERR_TASK_NOT_EXIST);
+	}
+	if (ptcb == OS_TCB_RESERVED) {	/* Task assigned to a Mutex?                      */
+		OS_EXIT_CRITICAL();
+		return (OS_ERR_TASK_NOT_EXIST);
+	}
+	ptcb->OSTCBPeriod = period;
+	ptcb->OSTCBPeriodCtr = 0uL;	/* Start with fresh statistics                    */
+	ptcb->OSTCBPeriodOverrun = 0uL;
+	ptcb->OSTCBPeriodJitterMax = 0uL;
+	ptcb->OSTCBPeriodRespMax = 0uL;
+	OS_EXIT_CRITICAL();
+	return (OS_ERR_NONE);
+}
+#endif
+
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                   SET THE TIME SLICE OF A ROUND-ROBIN TASK
+*
+* Description: This function is used to change the number of clock ticks a task may run before the CPU is
+*              given to the next ready task sharing its priority (see OS_TASK_RR_EN).
+*
+* Arguments  : prio      is the priority of the task.  If you specify OS_PRIO_SELF, the time slice of the
+*                        calling task is changed.  When several tasks share 'prio', the task at the head
+*                        of that priority (the one running or next to run) is changed.
+*
+*              quanta    is the length of the time slice in clock ticks.  Specifying 0 restores the
+*                        default, OS_TASK_RR_QUANTA.
+*
+* Returns    : OS_ERR_NONE            if the call was successful
+*              OS_ERR_PRIO_INVALID    if you specified an invalid priority
+*              OS_ERR_TASK_NOT_EXIST  if the task has not been created or is assigned to a Mutex PIP
+*
+* Note(s)    : 1) The new length applies to the current time slice if it is shorter than what is left.
+*********************************************************************************************************
+*/
+
+#if OS_TASK_RR_EN > 0u
+INT8U OSTaskQuantaSet(INT8U prio, INT16U quanta)
+{
+	OS_TCB *ptcb;
+#if OS_CRITICAL_METHOD == 3u	/* Allocate storage for CPU status register       */
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+
+
+#if OS_ARG_CHK_EN > 0u
+	if (prio > OS_LOWEST_PRIO) {	/* Task priority valid ?                          */
+		if (prio != OS_PRIO_SELF) {
+			return (OS_ERR_PRIO_INVALID);
+		}
+	}
+#endif
+	if (quanta == 0u) {	/* Use the default time slice                     */
+		quanta = OS_TASK_RR_QUANTA;
+	}
+	OS_ENTER_CRITICAL();
+	if (prio == OS_PRIO_SELF) {	/* See if caller desires to change its own slice  */
+		ptcb = OSTCBCur;
+	} else {
+		ptcb = OSTCBPrioTbl[prio];
+	}
+	if (ptcb == (OS_TCB *) 0) {	/* Does task exist?                               */
+		OS_EXIT_CRITICAL();
+		return (OS_ERR_TASK_NOT_EXIST);
+	}
+	if (ptcb == OS_TCB_RESERVED) {	/* Task assigned to a Mutex?                      */
+		OS_EXIT_CRITICAL();
+		return (OS_ERR_TASK_NOT_EXIST);
+	}
+	ptcb->OSTCBRRQuanta = quanta;
+	if (ptcb->OSTCBRRCtr > quanta) {	/* Shorten what is left of the current slice      */
+		ptcb->OSTCBRRCtr = quanta;
+	}
+	OS_EXIT_CRITICAL();
+	return (OS_ERR_NONE);
+}
+#endif
+
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                    SET THE RELATIVE DEADLINE OF A TASK
+*
+* Description: This function is used to register the relative deadline of a task of the EDF band (see
+*              OS_EDF_EN).  Each time the task is made ready after it waited, slept or was suspended, its
+*              absolute deadline becomes the current time plus 'deadline'.  Within the band the ready task
+*              with the earliest absolute deadline runs first; priorities above and below the band are
+*              scheduled as usual.
+*
+* Arguments  : prio      is the priority of the task.  If you specify OS_PRIO_SELF, the deadline of the
+*                        calling task is changed.
+*
+*              deadline  is the relative deadline in clock ticks.  0 removes the deadline: the task then
+*                        runs after all tasks of the band that have one, in priority order.
+*
+* Returns    : OS_ERR_NONE            if the call was successful
+*              OS_ERR_PRIO_INVALID    if you specified an invalid priority or the task is not in the EDF
+*                                     band (OS_EDF_PRIO_HI .. OS_EDF_PRIO_LO)
+*              OS_ERR_TASK_NOT_EXIST  if the task has not been created or is assigned to a Mutex PIP
+*
+* Note(s)    : 1) The deadline also applies to the task's current job, counted from this call.
+*              2) Deadline misses are counted in OSTCBEdfMissCtr and OSEdfMissCtr when a job completes.
+*********************************************************************************************************
+*/
+
+#if OS_EDF_EN > 0u
+INT8U OSTaskDeadlineSet(INT8U prio, INT32U deadline)
+{
+	OS_TCB *ptcb;
+#if OS_CRITICAL_METHOD == 3u	/* Allocate storage for CPU status register       */
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+
+
+#if OS_ARG_CHK_EN > 0u
+	if (prio > OS_LOWEST_PRIO) {	/* Task priority valid ?                          */
+		if (prio != OS_PRIO_SELF) {
+			return (OS_ERR_PRIO_INVALID);
+		}
+	}
+#endif
+	OS_ENTER_CRITICAL();
+	if (prio == OS_PRIO_SELF) {	/* See if caller desires to change its deadline   */
+		ptcb = OSTCBCur;
+	} else {
+		ptcb = OSTCBPrioTbl[prio];
+	}
+	if (ptcb == (OS_TCB *) 0) {	/* Does task exist?                               */
+		OS_EXIT_CRITICAL();
+		return (OS_ERR_TASK_NOT_EXIST);
+	}
+	if (ptcb == OS_TCB_RESERVED) {	/* Task assigned to a Mutex?                      */
+		OS_EXIT_CRITICAL();
+		return (OS_ERR_TASK_NOT_EXIST);
+	}
+	if ((ptcb->OSTCBPrio < OS_EDF_PRIO_HI) || (ptcb->OSTCBPrio > OS_EDF_PRIO_LO)) {
+		OS_EXIT_CRITICAL();	/* Task must belong to the EDF band               */
+		return (OS_ERR_PRIO_INVALID);
+	}
+	ptcb->OSTCBEdfDeadline = deadline;
+	ptcb->OSTCBEdfAbs = OSTime + deadline;	/* Current job is due from now on                 */
+	if (OS_RdyListHas(ptcb)) {	/* Re-sort the EDF ready list                     */
+		OS_EdfRdyRemove(ptcb);
+		OS_EdfRdyInsert(ptcb);
+	}
+	OSSchedReq = OS_TRUE;
+	OS_EXIT_CRITICAL();
+	if (OSRunning == OS_TRUE) {
+		OS_Sched();	/* Another task may now have an earlier deadline  */
+	}
+	return (OS_ERR_NONE);
+}
+#endif
+
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                  SET THE PREEMPTION THRESHOLD OF A TASK
+*
+* Description: This function is used to change the preemption threshold of a task.  Once the task is
+*              dispatched, until it blocks, it can only be preempted by a task whose priority is higher
+*              than its threshold (i.e. a lower number), not merely higher than its own priority.  Tasks whose priorities
+*              fall between the threshold and the task's priority thus never preempt each other.
+*
+* Arguments  : prio      is the priority of the task.  If you specify OS_PRIO_SELF, the threshold of the
+*                        calling task is changed.
+*
+*              threshold is the new preemption threshold.  It must be higher than or equal to the
+*                        task's priority (i.e. 'threshold' <= 'prio').  Specifying the task's priority
+*                        restores normal preemptive scheduling.
+*
+* Returns    : OS_ERR_NONE            if the call was successful
+*              OS_ERR_PRIO_INVALID    if you specified an invalid priority or 'threshold' is lower than
+*                                     the task's priority
+*              OS_ERR_TASK_NOT_EXIST  if the task has not been created or is assigned to a Mutex PIP
+*
+* Note(s)    : 1) The threshold applies from the time the task is dispatched until it pends, sleeps or is
+*                 suspended, including while a task above the threshold preempts it.  It applies again
+*                 from the next time the task is dispatched.
+*              2) A task whose priority is raised by a mutex is never protected less than its raised
+*                 priority.
+*********************************************************************************************************
+*/
+
+#if OS_TASK_THRESHOLD_EN > 0u
+INT8U OSTaskThresholdSet(INT8U prio, INT8U threshold)
+{
+	OS_TCB *ptcb;
+#if OS_CRITICAL_METHOD == 3u	/* Allocate storage for CPU status register       */
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+
+
+#if OS_ARG_CHK_EN > 0u
+	if (prio > OS_LOWEST_PRIO) {	/* Task priority valid ?                          */
+		if (prio != OS_PRIO_SELF) {
+			return (OS_ERR_PRIO_INVALID);
+		}
+	}
+#endif
+	OS_ENTER_CRITICAL();
+	if (prio == OS_PRIO_SELF) {	/* See if caller desires to change its threshold  */
+		ptcb = OSTCBCur;
+	} else {
+		ptcb = OSTCBPrioTbl[prio];
+	}
+	if (ptcb == (OS_TCB *) 0) {	/* Does task exist?                               */
+		OS_EXIT_CRITICAL();
+		return (OS_ERR_TASK_NOT_EXIST);
+	}
+	if (ptcb == OS_TCB_RESERVED) {	/* Task assigned to a Mutex?                      */
+		OS_EXIT_CRITICAL();
+		return (OS_ERR_TASK_NOT_EXIST);
+	}
+	if (threshold > ptcb->OSTCBPrio) {	/* Threshold can't be below the task's priority   */
+		OS_EXIT_CRITICAL();
+		return (OS_ERR_PRIO_INVALID);
+	}
+	ptcb->OSTCBThreshold = threshold;
+	OSSchedReq = OS_TRUE;
+	OS_EXIT_CRITICAL();
+	if (OSRunning == OS_TRUE) {
+		OS_Sched();	/* Lowering the threshold may allow preemption    */
+	}
+	return (OS_ERR_NONE);
+}
+#endif
+
 /*$PAGE*/
 /*
 *********************************************************************************************************
@@ -782,6 +1257,9 @@ void OSTaskNameSet(INT8U prio, INT8U * pname, INT8U * perr)
 *              OS_ERR_TASK_RESUME_PRIO    if the task to resume does not exist
 *              OS_ERR_TASK_NOT_EXIST      if the task is assigned to a Mutex PIP
 *              OS_ERR_TASK_NOT_SUSPENDED  if the task to resume has not been suspended
+*
+* Note(s)    : 1) With round-robin scheduling (OS_TASK_RR_EN), the first suspended task found among the
+*                 tasks sharing 'prio' is resumed.
 *********************************************************************************************************
 */
 
@@ -789,6 +1267,9 @@ void OSTaskNameSet(INT8U prio, INT8U * pname, INT8U * perr)
 INT8U OSTaskResume(INT8U prio)
 {
 	OS_TCB *ptcb;
+#if OS_TASK_RR_EN > 0u
+	OS_TCB *pnext;
+#endif
 #if OS_CRITICAL_METHOD == 3u	/* Storage for CPU status register       */
 	OS_CPU_SR cpu_sr = 0u;      //ַʽʵֵĿж,Ҫcpu_sr洢ж״̬
 #endif
@@ -810,12 +1291,21 @@ INT8U OSTaskResume(INT8U prio)
 		OS_EXIT_CRITICAL();
 		return (OS_ERR_TASK_NOT_EXIST);
 	}
+#if OS_TASK_RR_EN > 0u
+	pnext = ptcb;	/* Look for a suspended task among the tasks at 'prio' */
+	do {
+		if ((pnext->OSTCBPrio == prio) && ((pnext->OSTCBStat & OS_STAT_SUSPEND) != OS_STAT_RDY)) {
+			ptcb = pnext;
+			break;
+		}
+		pnext = pnext->OSTCBRRNext;
+	} while (pnext != ptcb);
+#endif
 	if ((ptcb->OSTCBStat & OS_STAT_SUSPEND) != OS_STAT_RDY) {	/*ǲǱ Task must be suspended                */
 		ptcb->OSTCBStat &= (INT8U) ~ (INT8U) OS_STAT_SUSPEND;	/*־ Remove suspension                     */
 		if (ptcb->OSTCBStat == OS_STAT_RDY) {	/*־Ƿ See if task is now ready              */
 			if (ptcb->OSTCBDly == 0u) {         //ûʱ
-				OSRdyGrp |= ptcb->OSTCBBitY;	/* Yes, Make task ready to run           */
-				OSRdyTbl[ptcb->OSTCBY] |= ptcb->OSTCBBitX;
+				OS_RdyListInsert(ptcb);	/* Yes, Make task ready to run           */
 				OS_EXIT_CRITICAL();
 				if (OSRunning == OS_TRUE) {
 					OS_Sched();	/* Find new highest priority task        */
@@ -859,9 +1349,6 @@ INT8U OSTaskResume(INT8U prio)
 INT8U OSTaskStkChk(INT8U prio, OS_STK_DATA * p_stk_data)
 {
 	OS_TCB *ptcb;
-	OS_STK *pchk;
-	INT32U nfree;
-	INT32U size;
 #if OS_CRITICAL_METHOD == 3u	/* Allocate storage for CPU status register     */
 	OS_CPU_SR cpu_sr = 0u;      //ַʽжϣҪcpu_srж״̬
 #endif
@@ -897,22 +1384,8 @@ INT8U OSTaskStkChk(INT8U prio, OS_STK_DATA * p_stk_data)
 		OS_EXIT_CRITICAL();
 		return (OS_ERR_TASK_OPT);
 	}
-	nfree = 0u;
-	size = ptcb->OSTCBStkSize;      //ջ
-	pchk = ptcb->OSTCBStkBottom;    //ջָ
 	OS_EXIT_CRITICAL();
-#if OS_STK_GROWTH == 1u             //
-	while (*pchk++ == (OS_STK) 0) {	/* Compute the number of zero entries on the stk */
-		nfree++;                    //ͳƶջд洢ֵΪռ
-	}
-#else
-	while (*pchk-- == (OS_STK) 0) {
-		nfree++;
-	}
-#endif
-    //õݶǶջָΪλĳ,4ָֽΪλ
-	p_stk_data->OSFree = nfree * sizeof(OS_STK);	/* Compute number of free bytes on the stack */
-	p_stk_data->OSUsed = (size - nfree) * sizeof(OS_STK);	/* Compute number of bytes used on the stack */
+	OS_TaskStkChk(ptcb, p_stk_data);	/* Compute free and used bytes of the stack    */
 	return (OS_ERR_NONE);
 }
 #endif
@@ -946,7 +1419,6 @@ INT8U OSTaskSuspend(INT8U prio)
 {
 	BOOLEAN self;
 	OS_TCB *ptcb;
-	INT8U y;
 #if OS_CRITICAL_METHOD == 3u	/* Allocate storage for CPU status register           */
 	OS_CPU_SR cpu_sr = 0u;      //õַʽж,Ҫcpu_srж״̬
 #endif
@@ -981,12 +1453,8 @@ INT8U OSTaskSuspend(INT8U prio)
 		OS_EXIT_CRITICAL();
 		return (OS_ERR_TASK_NOT_EXIST);
 	}
-	y = ptcb->OSTCBY;           //,Ӿɾ
-	OSRdyTbl[y] &= (OS_PRIO) ~ ptcb->OSTCBBitX;	/* Make task not ready                 */
-	if (OSRdyTbl[y] == 0u) {
-		OSRdyGrp &= (OS_PRIO) ~ ptcb->OSTCBBitY;
-	}
 	ptcb->OSTCBStat |= OS_STAT_SUSPEND;	/*ñ־,ʾ Status of task is 'SUSPENDED'       */
+	OS_RdyListRemove(ptcb);	/* Make task not ready                 */
 	OS_EXIT_CRITICAL();
 	if (self == OS_TRUE) {	/*,һ Context switch only if SELF         */
 		OS_Sched();	/* Find new highest priority task      */
@@ -1181,6 +1649,49 @@ void OSTaskRegSet(INT8U prio, INT8U id, INT32U value, INT8U * perr)
 }
 #endif
 
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                   YIELD TO TASKS AT THE SAME PRIORITY
+*
+* Description: This function is called by a task to give up the rest of its time slice.  The next ready
+*              task sharing the caller's priority runs and the caller goes behind the tasks already ready
+*              at that priority (see OS_TASK_RR_EN).  The caller keeps running if no other task is ready
+*              at its priority.
+*
+* Arguments  : none
+*
+* Returns    : none
+*
+* Note(s)    : 1) This function does nothing when called from an ISR or with the scheduler locked.
+*              2) Tasks at a higher priority are not affected, they preempt the caller as usual.
+*********************************************************************************************************
+*/
+
+#if OS_TASK_RR_EN > 0u
+void OSTaskYield(void)
+{
+#if OS_CRITICAL_METHOD == 3u	/* Allocate storage for CPU status register           */
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+
+
+	if (OSIntNesting > 0u) {	/* See if trying to call from an ISR                  */
+		return;
+	}
+	if (OSLockNesting > 0u) {	/* See if called with scheduler locked                */
+		return;
+	}
+	OS_ENTER_CRITICAL();
+	if (OSTCBPrioTbl[OSTCBCur->OSTCBPrio] == OSTCBCur) {	/* Give the CPU to the next peer ... */
+		OS_TaskRRRotate(OSTCBCur->OSTCBPrio);
+	}
+	OS_EXIT_CRITICAL();
+	OS_Sched();		/* ... if there is one                                */
+}
+#endif
+
 /*$PAGE*/
 /*
 *********************************************************************************************************
@@ -1213,6 +1724,103 @@ void OS_TaskReturn(void)
 #endif
 }
 
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                        CHECK A TASK'S STACK
+*
+* Description: This function computes the free and used bytes of a task's stack.  With
+*              OS_TASK_STK_CHK_GUARD, the scan resumes from the deepest entry found by the previous check
+*              (or the task's last saved stack pointer, if deeper) and stops after OS_TASK_STK_CHK_GUARD
+*              zero entries, so a check costs about OS_TASK_STK_CHK_GUARD reads once the stack stops
+*              growing.  Otherwise the stack is scanned from its bottom up to the first non-zero entry.
+*
+* Arguments  : ptcb          is a pointer to the task's OS_TCB
+*
+*              p_stk_data    is a pointer to the OS_STK_DATA that receives the result
+*
+* Returns    : none
+*
+* Note(s)    : 1) This function is INTERNAL to uC/OS-II and your application should not call it.
+*              2) The guard band must be larger than any block of zeros the task keeps on its stack
+*                 (e.g. a cleared local array), or usage below that block is not seen.
+*********************************************************************************************************
+*/
+#if (OS_TASK_STAT_STK_CHK_EN > 0u) && (OS_TASK_CREATE_EXT_EN > 0u)
+void OS_TaskStkChk(OS_TCB * ptcb, OS_STK_DATA * p_stk_data)
+{
+	OS_STK *pchk;
+	INT32U nfree;
+#if OS_TASK_STK_CHK_GUARD > 0u
+	OS_STK *pused;
+	INT32U nzero;
+#if OS_CRITICAL_METHOD == 3u	/* Allocate storage for CPU status register     */
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+#endif
+
+
+
+#if OS_TASK_STK_CHK_GUARD > 0u
+	OS_ENTER_CRITICAL();
+	pused = ptcb->OSTCBStkHWM;	/* Deepest entry seen so far ...                */
+#if OS_STK_GROWTH == 1u
+	if ((ptcb->OSTCBStkPtr < pused) && (ptcb->OSTCBStkPtr >= ptcb->OSTCBStkBottom)) {
+		pused = ptcb->OSTCBStkPtr;	/* ... or the saved stack pointer if deeper     */
+	}
+#else
+	if ((ptcb->OSTCBStkPtr > pused) && (ptcb->OSTCBStkPtr <= ptcb->OSTCBStkBottom)) {
+		pused = ptcb->OSTCBStkPtr;
+	}
+#endif
+	OS_EXIT_CRITICAL();
+	pchk = pused;
+	nzero = 0u;
+#if OS_STK_GROWTH == 1u
+	while ((pchk > ptcb->OSTCBStkBottom) && (nzero < OS_TASK_STK_CHK_GUARD)) {
+		pchk--;		/* Look for used entries below the mark         */
+		if (*pchk != (OS_STK) 0) {
+			pused = pchk;
+			nzero = 0u;
+		} else {
+			nzero++;
+		}
+	}
+	nfree = (INT32U) (pused - ptcb->OSTCBStkBottom);
+#else
+	while ((pchk < ptcb->OSTCBStkBottom) && (nzero < OS_TASK_STK_CHK_GUARD)) {
+		pchk++;
+		if (*pchk != (OS_STK) 0) {
+			pused = pchk;
+			nzero = 0u;
+		} else {
+			nzero++;
+		}
+	}
+	nfree = (INT32U) (ptcb->OSTCBStkBottom - pused);
+#endif
+	OS_ENTER_CRITICAL();
+	ptcb->OSTCBStkHWM = pused;	/* Resume from here next time                   */
+	OS_EXIT_CRITICAL();
+#else
+	nfree = 0u;
+	pchk = ptcb->OSTCBStkBottom;    //ջָ
+#if OS_STK_GROWTH == 1u             //
+	while (*pchk++ == (OS_STK) 0) {	/* Compute the number of zero entries on the stk */
+		nfree++;                    //ͳƶջд洢ֵΪռ
+	}
+#else
+	while (*pchk-- == (OS_STK) 0) {
+		nfree++;
+	}
+#endif
+#endif
+    //õݶǶջָΪλĳ,4ָֽΪλ
+	p_stk_data->OSFree = nfree * sizeof(OS_STK);	/* Compute number of free bytes on the stack */
+	p_stk_data->OSUsed = (ptcb->OSTCBStkSize - nfree) * sizeof(OS_STK);	/* Compute number of bytes used on the stack */
+}
+#endif
+
 /*$PAGE*/
 /*
 *********************************************************************************************************
@@ -1258,3 +1866,32 @@ void OS_TaskStkClr(OS_STK * pbos, INT32U size, INT16U opt)
 }
 
 #endif
+
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                        CLEAR TASK STACK GUARD
+*
+* Description: This function clears the OS_TASK_STK_GUARD_SIZE entries reserved for the stack guard of a
+*              task created with OS_TASK_OPT_STK_CHK (see OS_CPU.H).
+*
+* Arguments  : pbos     is a pointer to the bottom of the task's stack proper, just above the guard.
+*
+*              opt      contains the options the task is created with.
+*
+* Returns    : none
+*********************************************************************************************************
+*/
+#if (OS_TASK_STK_GUARD_EN > 0u) && (OS_STK_GROWTH == 1u)
+void OS_TaskStkGuardClr(OS_STK * pbos, INT16U opt)
+{
+	INT8U i;
+
+
+	if ((opt & OS_TASK_OPT_STK_CHK) != 0x0000u) {	/* Only stacks created with a guard           */
+		for (i = 0u; i < OS_TASK_STK_GUARD_SIZE; i++) {
+			*--pbos = (OS_STK) 0;	/* Guard starts out clear                       */
+		}
+	}
+}
+#endif
@@ -43,7 +43,6 @@
 
 void OSTimeDly(INT32U ticks)
 {
-	INT8U y;
 #if OS_CRITICAL_METHOD == 3u	/* Allocate storage for CPU status register           */
 	OS_CPU_SR cpu_sr = 0u;      //ʹ÷жϣҪcpu_srж״̬
 #endif
@@ -58,13 +57,9 @@ void OSTimeDly(INT32U ticks)
 	}
 	if (ticks > 0u) {	/* Ϊ0,ʾʱ 0 means no delay!                                  */
 		OS_ENTER_CRITICAL();
-		y = OSTCBCur->OSTCBY;	/* Delay current task                                 */
-        //ӾƳǰ
-		OSRdyTbl[y] &= (OS_PRIO) ~ OSTCBCur->OSTCBBitX;
-		if (OSRdyTbl[y] == 0u) {
-			OSRdyGrp &= (OS_PRIO) ~ OSTCBCur->OSTCBBitY;
-		}
 		OSTCBCur->OSTCBDly = ticks;	/*ʱ  Load ticks in TCB                */
+        //ӾƳǰ
+		OS_RdyListRemove(OSTCBCur);	/* Delay current task                                 */
 		OS_EXIT_CRITICAL();
 		OS_Sched();	/*л Find next task to run!                             */
 	}
@@ -156,6 +151,9 @@ INT8U OSTimeDlyHMSM(INT8U hours, INT8U minutes, INT8U seconds, INT16U ms)
 *                                        (i.e. >= OS_LOWEST_PRIO)
 *              OS_ERR_TIME_NOT_DLY       Task is not waiting for time to expire
 *              OS_ERR_TASK_NOT_EXIST     The desired task has not been created or has been assigned to a Mutex.
+*
+* Note(s)    : 1) With round-robin scheduling (OS_TASK_RR_EN), the first delayed task found among the tasks
+*                 sharing 'prio' is resumed.
 *********************************************************************************************************
 */
 
@@ -163,6 +161,9 @@ INT8U OSTimeDlyHMSM(INT8U hours, INT8U minutes, INT8U seconds, INT16U ms)
 INT8U OSTimeDlyResume(INT8U prio)
 {
 	OS_TCB *ptcb;
+#if OS_TASK_RR_EN > 0u
+	OS_TCB *pnext;
+#endif
 #if OS_CRITICAL_METHOD == 3u	/* Storage for CPU status register      */
 	OS_CPU_SR cpu_sr = 0u;      //ʹõַʽжϣҪcpu_srж״̬
 #endif
@@ -182,6 +183,16 @@ INT8U OSTimeDlyResume(INT8U prio)
 		OS_EXIT_CRITICAL();
 		return (OS_ERR_TASK_NOT_EXIST);	/* The task does not exist              */
 	}
+#if OS_TASK_RR_EN > 0u
+	pnext = ptcb;	/* Look for a delayed task among the tasks at 'prio' */
+	do {
+		if ((pnext->OSTCBPrio == prio) && (pnext->OSTCBDly != 0u)) {
+			ptcb = pnext;
+			break;
+		}
+		pnext = pnext->OSTCBRRNext;
+	} while (pnext != ptcb);
+#endif
 	if (ptcb->OSTCBDly == 0u) {	/* ȷʱ See if task is delayed               */
 		OS_EXIT_CRITICAL();
 		return (OS_ERR_TIME_NOT_DLY);	/* Indicate that task was not delayed   */
@@ -195,8 +206,7 @@ INT8U OSTimeDlyResume(INT8U prio)
 		ptcb->OSTCBStatPend = OS_STAT_PEND_OK;
 	}
 	if ((ptcb->OSTCBStat & OS_STAT_SUSPEND) == OS_STAT_RDY) {	/*񱻹? Is task suspended?                   */
-		OSRdyGrp |= ptcb->OSTCBBitY;	/*ûУھ̬ No,  Make ready                      */
-		OSRdyTbl[ptcb->OSTCBY] |= ptcb->OSTCBBitX;
+		OS_RdyListInsert(ptcb);	/*ûУھ̬ No,  Make ready                      */
 		OS_EXIT_CRITICAL();
 		OS_Sched();	/*ִ See if this is new highest priority  */
 	} else {
@@ -208,6 +218,107 @@ INT8U OSTimeDlyResume(INT8U prio)
 /*$PAGE*/
 /*
 *********************************************************************************************************
+*                                    DELAY TASK UNTIL AN ABSOLUTE TIME
+*
+* Description: This function is called to delay execution of the currently running task until the next
+*              release point of a periodic activity.  Unlike OSTimeDly(), the wake up time is computed
+*              from the previous release point and not from the time of the call, so the period does not
+*              drift by however long the body of the task took to execute.
+*
+* Arguments  : p_next_wake   is a pointer to the release time (in ticks) of the job that just completed.
+*                            Initialize it with OSTimeGet() before entering the loop.  On return it holds
+*                            the release time of the next job.
+*
+*              period        is the period of the task in clock ticks.
+*
+* Returns    : OS_ERR_NONE           if the task was delayed until its next release point
+*              OS_ERR_TIME_OVERRUN   if one or more release points were missed.  *p_next_wake is moved to
+*                                    the next release point still in the future so that the task keeps its
+*                                    phase, and the task is delayed until then.
+*              OS_ERR_TIME_DLY_ISR   if you called this function from an ISR
+*              OS_ERR_SCHED_LOCKED   if you called this function with the scheduler locked
+*              OS_ERR_PDATA_NULL     if 'p_next_wake' is a NULL pointer
+*              OS_ERR_TIME_ZERO_DLY  if 'period' is 0
+*
+* Note(s)    : 1) If the task was registered with OSTaskPeriodSet(), the overrun count, the release jitter
+*                 and the worst-case response time are recorded in its OS_TCB.
+*********************************************************************************************************
+*/
+
+#if OS_TIME_DLY_UNTIL_EN > 0u
+INT8U OSTimeDlyUntil(INT32U * p_next_wake, INT32U period)
+{
+	INT32U release;
+	INT32U next;
+	INT32U now;
+	INT32U missed;
+#if OS_TASK_PERIOD_EN > 0u
+	INT32U late;
+#endif
+#if OS_CRITICAL_METHOD == 3u	/* Allocate storage for CPU status register           */
+	OS_CPU_SR cpu_sr = 0u;
+#endif
+
+
+
+	if (OSIntNesting > 0u) {	/* See if trying to call from an ISR                  */
+		return (OS_ERR_TIME_DLY_ISR);
+	}
+	if (OSLockNesting > 0u) {	/* See if called with scheduler locked                */
+		return (OS_ERR_SCHED_LOCKED);
+	}
+#if OS_ARG_CHK_EN > 0u
+	if (p_next_wake == (INT32U *) 0) {
+		return (OS_ERR_PDATA_NULL);
+	}
+	if (period == 0u) {
+		return (OS_ERR_TIME_ZERO_DLY);
+	}
+#endif
+	OS_ENTER_CRITICAL();
+	now = OSTime;
+	release = *p_next_wake;	/* Release time of the job that just completed        */
+	next = release + period;
+	missed = 0u;
+	if ((INT32S) (next - now) < 0) {	/* Did the job run past its next release point?       */
+		missed = (now - next) / period + 1u;	/* Yes, skip the release points already missed        */
+		next += missed * period;
+	}
+	*p_next_wake = next;
+#if OS_TASK_PERIOD_EN > 0u
+	if (OSTCBCur->OSTCBPeriod != 0u) {	/* Update statistics of registered periodic tasks     */
+		OSTCBCur->OSTCBPeriodCtr++;
+		OSTCBCur->OSTCBPeriodOverrun += missed;
+		if ((now - release) > OSTCBCur->OSTCBPeriodRespMax) {
+			OSTCBCur->OSTCBPeriodRespMax = now - release;
+		}
+	}
+#endif
+	if (next != now) {	/* Delay current task until its next release point    */
+		OSTCBCur->OSTCBDly = next - now;	/* Load ticks in TCB                                  */
+		OS_RdyListRemove(OSTCBCur);
+		OS_EXIT_CRITICAL();
+		OS_Sched();	/* Find next task to run!                             */
+		OS_ENTER_CRITICAL();
+	}
+#if OS_TASK_PERIOD_EN > 0u
+	late = OSTime - next;	/* Measure how late the task woke up                  */
+	if ((OSTCBCur->OSTCBPeriod != 0u) && ((INT32S) late > 0)) {
+		if (late > OSTCBCur->OSTCBPeriodJitterMax) {
+			OSTCBCur->OSTCBPeriodJitterMax = late;
+		}
+	}
+#endif
+	OS_EXIT_CRITICAL();
+	if (missed > 0u) {
+		return (OS_ERR_TIME_OVERRUN);
+	}
+	return (OS_ERR_NONE);
+}
+#endif
+/*$PAGE*/
+/*
+*********************************************************************************************************
 *                                         GET CURRENT SYSTEM TIME
 *
 * Description: This function is used by your application to obtain the current value of the 32-bit
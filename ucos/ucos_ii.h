@@ -107,6 +107,7 @@ extern "C" {
 #define  OS_STAT_SUSPEND             0x08u  /* Task is suspended                                       */
 #define  OS_STAT_MUTEX               0x10u  /* Pending on mutual exclusion semaphore                   */
 #define  OS_STAT_FLAG                0x20u  /* Pending on event flag group                             */
+#define  OS_STAT_BUDGET              0x40u  /* CPU budget used up, held until replenished              */
 #define  OS_STAT_MULTI               0x80u  /* Pending on multiple events                              */
 
 #define  OS_STAT_PEND_ANY         (OS_STAT_SEM | OS_STAT_MBOX | OS_STAT_Q | OS_STAT_MUTEX | OS_STAT_FLAG)
@@ -212,8 +213,15 @@ extern "C" {
 #define  OS_TASK_OPT_STK_CHK       0x0001u  /* ʱջ Enable stack checking for the task*/
 #define  OS_TASK_OPT_STK_CLR       0x0002u  /* ʱվ0 Clear the stack when the task is create*/
 #define  OS_TASK_OPT_SAVE_FP       0x0004u  /* ֪ͨOSTaskCreateExtҪ,лʱ渡Ĵе*/
+#define  OS_TASK_OPT_BUDGET        0x0008u  /* Enforce a CPU budget on the task (see OSTaskBudgetSet()) */
                                             /* Save the contents of any floating-point registers*/
 
+#if OS_TASK_STK_GUARD_EN > 0u               /* Entries taken from stacks created with OS_TASK_OPT_STK_CHK */
+#define  OS_TASK_STK_GUARD_SIZE    OS_CPU_STK_GUARD_SIZE
+#else
+#define  OS_TASK_STK_GUARD_SIZE    0u
+#endif
+
 /*
 *********************************************************************************************************
 *                            TIMER OPTIONS (see OSTmrStart() and OSTmrStop())
@@ -291,6 +299,7 @@ extern "C" {
 #define OS_ERR_TASK_SUSPEND_IDLE       71u
 #define OS_ERR_TASK_SUSPEND_PRIO       72u
 #define OS_ERR_TASK_WAITING            73u
+#define OS_ERR_STK_SIZE_INVALID        74u
 
 #define OS_ERR_TIME_NOT_DLY            80u
 #define OS_ERR_TIME_INVALID_MINUTES    81u
@@ -298,6 +307,7 @@ extern "C" {
 #define OS_ERR_TIME_INVALID_MS         83u
 #define OS_ERR_TIME_ZERO_DLY           84u
 #define OS_ERR_TIME_DLY_ISR            85u
+#define OS_ERR_TIME_OVERRUN            86u
 
 #define OS_ERR_MEM_INVALID_PART        90u
 #define OS_ERR_MEM_INVALID_BLKS        91u
@@ -336,6 +346,13 @@ extern "C" {
 #define OS_ERR_TMR_STOPPED            142u
 #define OS_ERR_TMR_NO_CALLBACK        143u
 
+#define OS_ERR_JOB_INVALID_SIZE       150u
+#define OS_ERR_JOB_NO_EVENT           151u
+
+#define OS_ERR_CO_NO_EVENT            160u
+#define OS_ERR_CO_INVALID_SIZE        161u
+#define OS_ERR_CO_INVALID             162u
+
 /*$PAGE*/
 /*
 *********************************************************************************************************
@@ -410,6 +427,125 @@ typedef struct os_flag_node {               /*
 } OS_FLAG_NODE;
 #endif
 
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                      RUN-TO-COMPLETION JOB DATA
+*********************************************************************************************************
+*/
+
+#if OS_JOB_EN > 0u
+typedef  void (*OS_JOB_FNCT)(void *p_arg, void *pmsg);
+
+typedef struct os_job_msg {                 /* MESSAGE QUEUED TO A JOB LEVEL                                 */
+    struct os_job *OSJobMsgJob;             /* Job the message is for                                        */
+    void          *OSJobMsgPtr;             /* Message passed to the job function                            */
+} OS_JOB_MSG;
+
+typedef struct os_job_lvl {                 /* JOB LEVEL (one task, one stack shared by its jobs)            */
+    OS_EVENT      *OSJobLvlSem;             /* Counts the messages in the queue, the level task pends on it  */
+    OS_JOB_MSG    *OSJobLvlStart;           /* Pointer to start of queue data                                */
+    OS_JOB_MSG    *OSJobLvlEnd;             /* Pointer to end   of queue data                                */
+    OS_JOB_MSG    *OSJobLvlIn;              /* Pointer to where next message will be inserted  in   the Q    */
+    OS_JOB_MSG    *OSJobLvlOut;             /* Pointer to where next message will be extracted from the Q    */
+    INT16U         OSJobLvlSize;            /* Size of queue (maximum number of entries)                     */
+    INT16U         OSJobLvlEntries;         /* Current number of entries in the queue                        */
+    INT16U         OSJobLvlEntriesMax;      /* Peak number of entries in the queue                           */
+    INT8U          OSJobLvlPrio;            /* Priority of the level task                                    */
+} OS_JOB_LVL;
+
+typedef struct os_job {                     /* RUN-TO-COMPLETION JOB                                         */
+    OS_JOB_FNCT    OSJobFnct;               /* Function called with each message                             */
+    void          *OSJobArg;                /* Argument passed to the function                               */
+    OS_JOB_LVL    *OSJobLvl;                /* Level whose task runs the job                                 */
+} OS_JOB;
+#endif
+
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                            COROUTINE DATA
+*
+* A coroutine function has the form:
+*
+*     void  MyCo (OS_CO *pco)
+*     {
+*         MY_STATE  *p_state = (MY_STATE *)pco;        (OS_CO is the first member of MY_STATE, an entry of
+*                                                       the table given to OSCoSchedCreate())
+*
+*         OS_CO_BEGIN(pco);
+*         while (...) {
+*             OS_CO_PEND(pco, MySem, 100u);             (pco->OSCoErr is OS_ERR_NONE or OS_ERR_TIMEOUT)
+*             ...
+*         }
+*         OS_CO_END(pco);
+*     }
+*
+* The wait macros return from the function and resume after the macro, so they may only be used in the
+* function itself, outside of any switch statement.
+*
+* An OS_CO is three pointers and eight bytes (20 bytes on a Cortex-M3): the coroutines of a scheduler are
+* linked by their index in its table and a delay holds the low 16 bits of the tick it expires at, so a
+* delay or timeout is limited to OS_CO_DLY_MAX ticks.
+*********************************************************************************************************
+*/
+
+#if OS_CO_EN > 0u
+#define  OS_CO_STAT_RDY               0x00u  /* Ready to run                                            */
+#define  OS_CO_STAT_DLY               0x01u  /* Delayed, or timeout on a wait                           */
+#define  OS_CO_STAT_PEND              0x02u  /* Waiting for a semaphore, mailbox or queue               */
+#define  OS_CO_STAT_PEND_FLAG         0x04u  /* Waiting for event flags                                 */
+#define  OS_CO_STAT_DONE              0x80u  /* Reached OS_CO_END()                                     */
+
+#define  OS_CO_NONE                 0xFFFFu  /* End of the list of coroutines of a scheduler            */
+#define  OS_CO_DLY_MAX              0x7FFFu  /* Longest delay or timeout, in ticks                      */
+
+#define  OS_CO_BEGIN(pco)             switch ((pco)->OSCoLine) { case 0u:
+#define  OS_CO_END(pco)               } (pco)->OSCoLine = 0u; (pco)->OSCoStat = OS_CO_STAT_DONE; return
+#define  OS_CO_YIELD(pco)             do { (pco)->OSCoLine = (INT16U)__LINE__; return; case __LINE__: ; } while (0)
+#define  OS_CO_DLY(pco, ticks)        do { OSCoDly((pco), (ticks)); OS_CO_YIELD(pco); } while (0)
+#define  OS_CO_PEND(pco, pevent, timeout)                                                             \
+                                      do {                                                            \
+                                          if (OSCoPend((pco), (pevent), (timeout)) == OS_FALSE) {     \
+                                              OS_CO_YIELD(pco);                                       \
+                                          }                                                           \
+                                      } while (0)
+#define  OS_CO_FLAG_PEND(pco, pgrp, flags, wait_type, timeout)                                        \
+                                      do {                                                            \
+                                          if (OSCoFlagPend((pco), (pgrp), (flags), (wait_type),       \
+                                                           (timeout)) == OS_FALSE) {                  \
+                                              OS_CO_YIELD(pco);                                       \
+                                          }                                                           \
+                                      } while (0)
+
+struct os_co;
+
+typedef  void (*OS_CO_FNCT)(struct os_co *pco);
+
+typedef struct os_co {                      /* COROUTINE                                                     */
+    OS_CO_FNCT     OSCoFnct;                /* Function of the coroutine                                     */
+    void          *OSCoEventPtr;            /* Event (or event flag group) waited for                        */
+    void          *OSCoMsg;                 /* Message received (flags for an event flag group)              */
+    INT16U         OSCoNext;                /* Index of the next coroutine of the scheduler (or OS_CO_NONE)  */
+    INT16U         OSCoLine;                /* Line to resume from (0 = OS_CO_BEGIN())                       */
+    INT16U         OSCoDly;                 /* Tick (low 16 bits) at which the delay or timeout expires      */
+    INT8U          OSCoStat;                /* OS_CO_STAT_xxx                                                */
+    INT8U          OSCoErr;                 /* Result of the last wait, wait type while waiting for flags    */
+} OS_CO;
+
+typedef struct os_co_sched {                /* COROUTINE SCHEDULER                                           */
+    INT8U         *OSCoSchedTbl;            /* Table of coroutines (and their state)                         */
+    INT16U         OSCoSchedTblSize;        /* Number of entries in the table                                */
+    INT16U         OSCoSchedCoSize;         /* Size of an entry in bytes                                     */
+    INT16U         OSCoSchedList;           /* Index of the first coroutine (or OS_CO_NONE)                  */
+    OS_EVENT      *OSCoSchedSem;            /* Posted when a coroutine is added                              */
+    OS_EVENT      *OSCoSchedPendTbl[OS_CO_PEND_MAX + 2u];  /* Events pended on by the scheduler task         */
+    OS_EVENT      *OSCoSchedRdyTbl[OS_CO_PEND_MAX + 2u];   /* Events returned by OSEventPendMulti()          */
+    void          *OSCoSchedMsgTbl[OS_CO_PEND_MAX + 2u];   /* Messages returned by OSEventPendMulti()        */
+    INT8U          OSCoSchedPrio;           /* Priority of the scheduler task                                */
+} OS_CO_SCHED;
+#endif
+
 /*$PAGE*/
 /*
 *********************************************************************************************************
@@ -549,6 +685,9 @@ typedef struct os_tcb {
     void            *OSTCBExtPtr;           /* ָûTCBչָ Pointer to user definable data for TCB extension */
     OS_STK          *OSTCBStkBottom;        /* ָջ׵ָ Pointer to bottom of stack               */
     INT32U           OSTCBStkSize;          /* ջ(ԶջָΪλ)Size of task stack (in number of stack elements)*/
+#if OS_TASK_STK_CHK_GUARD > 0u
+    OS_STK          *OSTCBStkHWM;           /* Deepest stack entry found in use so far  */
+#endif
     INT16U           OSTCBOpt;              /* ݸOSTaskCreateExt()ѡ Task options as passed by OSTaskCreateExt() */
     INT16U           OSTCBId;               /* ʶ(0~65535) Task ID (0..65535)                  */
 #endif
@@ -585,6 +724,38 @@ typedef struct os_tcb {
     OS_PRIO          OSTCBBitX;             /* Bit mask to access bit position in ready table          */
     OS_PRIO          OSTCBBitY;             /* Bit mask to access bit position in ready group          */
 
+#if OS_TASK_RR_EN > 0u
+    struct os_tcb   *OSTCBRRNext;           /* Next     task sharing the same priority (circular list)  */
+    struct os_tcb   *OSTCBRRPrev;           /* Previous task sharing the same priority (circular list)  */
+    INT16U           OSTCBRRQuanta;         /* Length of the task's time slice (in ticks)              */
+    INT16U           OSTCBRRCtr;            /* Ticks left in the current time slice                    */
+    INT8U            OSTCBRRPrio;           /* Priority of the list the task is linked in              */
+    BOOLEAN          OSTCBRdy;              /* Task is in the ready list                               */
+#endif
+
+#if OS_EDF_EN > 0u
+    INT32U           OSTCBEdfDeadline;      /* Relative deadline (in ticks), 0 if the task has none    */
+    INT32U           OSTCBEdfAbs;           /* Absolute deadline of the current job (in ticks)         */
+    INT32U           OSTCBEdfMissCtr;       /* Number of jobs completed after their deadline           */
+    BOOLEAN          OSTCBEdfJob;           /* Task has a job in progress (OSTCBEdfAbs is valid)       */
+    struct os_tcb   *OSTCBEdfNext;          /* Next ready task of the EDF band, in deadline order      */
+#endif
+
+#if OS_TASK_BUDGET_EN > 0u
+    INT32U           OSTCBBudget;           /* CPU time allowed per period (in OS_CPU_TS_GET() counts) */
+    INT32U           OSTCBBudgetUsed;       /* CPU time used in the current period                     */
+    INT32U           OSTCBBudgetStart;      /* Timestamp of the last time the task was switched in     */
+    INT32U           OSTCBBudgetOverrunCtr; /* Number of times the task used up its budget             */
+    INT16U           OSTCBBudgetPeriod;     /* Budget replenishment period (in ticks)                  */
+    INT16U           OSTCBBudgetCtr;        /* Ticks left until the budget is replenished              */
+#endif
+
+#if OS_TASK_THRESHOLD_EN > 0u
+    INT8U            OSTCBThreshold;        /* Preemption threshold: only tasks above it may preempt   */
+    BOOLEAN          OSTCBThreshOn;         /* Task runs at its threshold (dispatched, not blocked)    */
+    struct os_tcb   *OSTCBThreshNext;       /* Next task in OSTCBThreshList                            */
+#endif
+
 #if OS_TASK_DEL_EN > 0u
     INT8U            OSTCBDelReq;           /* ָʾǷҪɾ Indicates whether a task needs to delete itself */
 #endif
@@ -597,6 +768,14 @@ typedef struct os_tcb {
     INT32U           OSTCBStkUsed;          /* ջѾʹõֽڳ Number of bytes used from the stack                   */
 #endif
 
+#if OS_TASK_PERIOD_EN > 0u
+    INT32U           OSTCBPeriod;           /* Period of a periodic task in ticks (0 if not periodic)           */
+    INT32U           OSTCBPeriodCtr;        /* Number of jobs (periods) completed                               */
+    INT32U           OSTCBPeriodOverrun;    /* Number of release points missed because a job ran too long       */
+    INT32U           OSTCBPeriodJitterMax;  /* Worst-case release jitter (ticks between release and wake up)    */
+    INT32U           OSTCBPeriodRespMax;    /* Worst-case response time (ticks between release and completion)  */
+#endif
+
 #if OS_TASK_NAME_EN > 0u
     INT8U           *OSTCBTaskName;         /**/
 #endif
@@ -683,6 +862,7 @@ OS_EXT  OS_PRIO           OSRdyGrp;                        /* Ready list group
 OS_EXT  OS_PRIO           OSRdyTbl[OS_RDY_TBL_SIZE];       /* Table of tasks which are ready to run    */
 
 OS_EXT  BOOLEAN           OSRunning;                       /* Flag indicating that kernel is running   */
+OS_EXT  BOOLEAN           OSSchedReq;                      /* Ready list changed since last search     */
 
 OS_EXT  INT8U             OSTaskCtr;                       /* Number of tasks created                  */
 
@@ -702,6 +882,19 @@ OS_EXT  OS_TCB           *OSTCBList;                       /* Pointer to doubly
 OS_EXT  OS_TCB           *OSTCBPrioTbl[OS_LOWEST_PRIO + 1u];    /* Table of pointers to created TCBs   */
 OS_EXT  OS_TCB            OSTCBTbl[OS_MAX_TASKS + OS_N_SYS_TASKS];   /* Table of TCBs                  */
 
+#if (OS_TASK_RR_EN > 0u) && (OS_EVENT_EN)
+OS_EXT  OS_TCB           *OSTCBEventRdy;            /* Task made ready by the last OS_EventTaskRdy()   */
+#endif
+
+#if OS_TASK_THRESHOLD_EN > 0u
+OS_EXT  OS_TCB           *OSTCBThreshList;          /* Tasks running at their threshold, last first    */
+#endif
+
+#if OS_EDF_EN > 0u
+OS_EXT  OS_TCB           *OSEdfRdyList;             /* Ready EDF tasks, earliest deadline first        */
+OS_EXT  INT32U            OSEdfMissCtr;             /* Number of deadlines missed by EDF tasks         */
+#endif
+
 #if OS_TICK_STEP_EN > 0u
 OS_EXT  INT8U             OSTickStepState;          /* Indicates the state of the tick step feature    */
 #endif
@@ -825,6 +1018,64 @@ OS_FLAGS      OSFlagQuery             (OS_FLAG_GRP     *pgrp,
 #endif
 #endif
 
+/*
+*********************************************************************************************************
+*                                    RUN-TO-COMPLETION JOB MANAGEMENT
+*********************************************************************************************************
+*/
+
+#if OS_JOB_EN > 0u
+INT8U         OSJobCreate             (OS_JOB          *pjob,
+                                       OS_JOB_LVL      *plvl,
+                                       OS_JOB_FNCT      fnct,
+                                       void            *p_arg);
+
+INT8U         OSJobLvlCreate          (OS_JOB_LVL      *plvl,
+                                       INT8U            prio,
+                                       OS_STK          *pstk,
+                                       INT32U           stk_size,
+                                       OS_JOB_MSG      *pq,
+                                       INT16U           q_size);
+
+INT8U         OSJobPost               (OS_JOB          *pjob,
+                                       void            *pmsg);
+#endif
+
+/*
+*********************************************************************************************************
+*                                         COROUTINE MANAGEMENT
+*********************************************************************************************************
+*/
+
+#if OS_CO_EN > 0u
+INT8U         OSCoCreate              (OS_CO_SCHED     *psched,
+                                       OS_CO           *pco,
+                                       OS_CO_FNCT       fnct);
+
+void          OSCoDly                 (OS_CO           *pco,
+                                       INT16U           ticks);
+
+#if (OS_FLAG_EN > 0u) && (OS_FLAG_ACCEPT_EN > 0u)
+BOOLEAN       OSCoFlagPend            (OS_CO           *pco,
+                                       OS_FLAG_GRP     *pgrp,
+                                       OS_FLAGS         flags,
+                                       INT8U            wait_type,
+                                       INT16U           timeout);
+#endif
+
+BOOLEAN       OSCoPend                (OS_CO           *pco,
+                                       OS_EVENT        *pevent,
+                                       INT16U           timeout);
+
+INT8U         OSCoSchedCreate         (OS_CO_SCHED     *psched,
+                                       INT8U            prio,
+                                       OS_STK          *pstk,
+                                       INT32U           stk_size,
+                                       void            *pco_tbl,
+                                       INT16U           co_nbr,
+                                       INT16U           co_size);
+#endif
+
 /*
 *********************************************************************************************************
 *                                        MESSAGE MAILBOX MANAGEMENT
@@ -1052,6 +1303,12 @@ void          OSSemSet                (OS_EVENT        *pevent,
 *                                            TASK MANAGEMENT
 *********************************************************************************************************
 */
+#if OS_TASK_BUDGET_EN > 0u
+INT8U         OSTaskBudgetSet         (INT8U            prio,
+                                       INT32U           budget,
+                                       INT16U           period);
+#endif
+
 #if OS_TASK_CHANGE_PRIO_EN > 0u
 INT8U         OSTaskChangePrio        (INT8U            oldprio,
                                        INT8U            newprio);
@@ -1091,6 +1348,28 @@ void          OSTaskNameSet           (INT8U            prio,
                                        INT8U           *perr);
 #endif
 
+#if OS_TASK_PERIOD_EN > 0u
+INT8U         OSTaskPeriodSet         (INT8U            prio,
+                                       INT32U           period);
+#endif
+
+#if OS_TASK_RR_EN > 0u
+INT8U         OSTaskQuantaSet         (INT8U            prio,
+                                       INT16U           quanta);
+
+void          OSTaskYield             (void);
+#endif
+
+#if OS_EDF_EN > 0u
+INT8U         OSTaskDeadlineSet       (INT8U            prio,
+                                       INT32U           deadline);
+#endif
+
+#if OS_TASK_THRESHOLD_EN > 0u
+INT8U         OSTaskThresholdSet      (INT8U            prio,
+                                       INT8U            threshold);
+#endif
+
 #if OS_TASK_SUSPEND_EN > 0u
 INT8U         OSTaskResume            (INT8U            prio);
 INT8U         OSTaskSuspend           (INT8U            prio);
@@ -1139,6 +1418,11 @@ INT8U         OSTimeDlyHMSM           (INT8U            hours,
 INT8U         OSTimeDlyResume         (INT8U            prio);
 #endif
 
+#if OS_TIME_DLY_UNTIL_EN > 0u
+INT8U         OSTimeDlyUntil          (INT32U          *p_next_wake,
+                                       INT32U           period);
+#endif
+
 #if OS_TIME_GET_SET_EN > 0u
 INT32U        OSTimeGet               (void);
 void          OSTimeSet               (INT32U           ticks);
@@ -1265,8 +1549,73 @@ void          OS_MemInit              (void);
 void          OS_QInit                (void);
 #endif
 
+#if OS_EDF_EN > 0u
+void          OS_EdfRdyInsert         (OS_TCB          *ptcb);
+
+void          OS_EdfRdyRemove         (OS_TCB          *ptcb);
+#endif
+
+#if OS_TASK_RR_EN > 0u
+void          OS_RdyListInsert        (OS_TCB          *ptcb);
+
+void          OS_RdyListRemove        (OS_TCB          *ptcb);
+
+#define  OS_RdyListHas(ptcb)          ((ptcb)->OSTCBRdy == OS_TRUE)
+#elif OS_EDF_EN > 0u
+                                            /* Bitmap plus the deadline ordered list of the EDF band       */
+#define  OS_RdyListInsert(ptcb)       do {                                                          \
+                                           OSRdyGrp |= (ptcb)->OSTCBBitY;                           \
+                                           OSRdyTbl[(ptcb)->OSTCBY] |= (ptcb)->OSTCBBitX;           \
+                                           if ((ptcb)->OSTCBPrio <= OSPrioHighRdy) {                \
+                                               OSSchedReq = OS_TRUE;                                \
+                                           }                                                        \
+                                           OS_EdfRdyInsert(ptcb);                                   \
+                                       } while (0)
+
+#define  OS_RdyListRemove(ptcb)       do {                                                          \
+                                           OSRdyTbl[(ptcb)->OSTCBY] &= (OS_PRIO)~(ptcb)->OSTCBBitX; \
+                                           if (OSRdyTbl[(ptcb)->OSTCBY] == 0u) {                    \
+                                               OSRdyGrp &= (OS_PRIO)~(ptcb)->OSTCBBitY;             \
+                                           }                                                        \
+                                           if (((ptcb) == OSTCBCur) || ((ptcb) == OSTCBHighRdy)) {  \
+                                               OSSchedReq = OS_TRUE;                                \
+                                           }                                                        \
+                                           OS_EdfRdyRemove(ptcb);                                   \
+                                       } while (0)
+
+#define  OS_RdyListHas(ptcb)          ((OSRdyTbl[(ptcb)->OSTCBY] & (ptcb)->OSTCBBitX) != 0u)
+#else
+                                            /* Only one task per priority: the ready list is the bitmap.   */
+                                            /* OSSchedReq is set when a task at or above the task picked   */
+                                            /* by the last search is made ready, or when the task running  */
+                                            /* or picked to run is made not ready                          */
+#define  OS_RdyListInsert(ptcb)       do {                                                          \
+                                           OSRdyGrp |= (ptcb)->OSTCBBitY;                           \
+                                           OSRdyTbl[(ptcb)->OSTCBY] |= (ptcb)->OSTCBBitX;           \
+                                           if ((ptcb)->OSTCBPrio <= OSPrioHighRdy) {                \
+                                               OSSchedReq = OS_TRUE;                                \
+                                           }                                                        \
+                                       } while (0)
+
+#define  OS_RdyListRemove(ptcb)       do {                                                          \
+                                           OSRdyTbl[(ptcb)->OSTCBY] &= (OS_PRIO)~(ptcb)->OSTCBBitX; \
+                                           if (OSRdyTbl[(ptcb)->OSTCBY] == 0u) {                    \
+                                               OSRdyGrp &= (OS_PRIO)~(ptcb)->OSTCBBitY;             \
+                                           }                                                        \
+                                           if (((ptcb) == OSTCBCur) || ((ptcb) == OSTCBHighRdy)) {  \
+                                               OSSchedReq = OS_TRUE;                                \
+                                           }                                                        \
+                                       } while (0)
+
+#define  OS_RdyListHas(ptcb)          ((OSRdyTbl[(ptcb)->OSTCBY] & (ptcb)->OSTCBBitX) != 0u)
+#endif
+
 void          OS_Sched                (void);
 
+#if OS_TASK_BUDGET_EN > 0u
+void          OS_TaskBudgetSw         (void);
+#endif
+
 #if (OS_EVENT_NAME_EN > 0u) || (OS_FLAG_NAME_EN > 0u) || (OS_MEM_NAME_EN > 0u) || (OS_TASK_NAME_EN > 0u)
 INT8U         OS_StrLen               (INT8U           *psrc);
 #endif
@@ -1280,15 +1629,35 @@ void          OS_TaskStat             (void            *p_arg);
 #endif
 
 #if (OS_TASK_STAT_STK_CHK_EN > 0u) && (OS_TASK_CREATE_EXT_EN > 0u)
+void          OS_TaskStkChk           (OS_TCB          *ptcb,
+                                       OS_STK_DATA     *p_stk_data);
+
 void          OS_TaskStkClr           (OS_STK          *pbos,
                                        INT32U           size,
                                        INT16U           opt);
 #endif
 
+#if (OS_TASK_STK_GUARD_EN > 0u) && (OS_STK_GROWTH == 1u)
+void          OS_TaskStkGuardClr      (OS_STK          *pbos,
+                                       INT16U           opt);
+#endif
+
 #if (OS_TASK_STAT_STK_CHK_EN > 0u) && (OS_TASK_CREATE_EXT_EN > 0u)
 void          OS_TaskStatStkChk       (void);
 #endif
 
+#if OS_TASK_RR_EN > 0u
+void          OS_TaskRRLink           (OS_TCB          *ptcb);
+
+void          OS_TaskRRRotate         (INT8U            prio);
+
+void          OS_TaskRRUnlink         (OS_TCB          *ptcb);
+#endif
+
+#if OS_TASK_THRESHOLD_EN > 0u
+void          OS_TaskThreshDrop       (OS_TCB          *ptcb);
+#endif
+
 INT8U         OS_TCBInit              (INT8U            prio,
                                        OS_STK          *ptos,
                                        OS_STK          *pbos,
@@ -1316,6 +1685,10 @@ void          OSDebugInit             (void);
 void          OSInitHookBegin         (void);
 void          OSInitHookEnd           (void);
 
+#if OS_TASK_BUDGET_EN > 0u
+void          OSTaskBudgetHook        (OS_TCB          *ptcb);
+#endif
+
 void          OSTaskCreateHook        (OS_TCB          *ptcb);
 void          OSTaskDelHook           (OS_TCB          *ptcb);
 
@@ -1324,6 +1697,11 @@ void          OSTaskIdleHook          (void);
 void          OSTaskReturnHook        (OS_TCB          *ptcb);
 
 void          OSTaskStatHook          (void);
+
+#if OS_TASK_STK_GUARD_EN > 0u
+void          OSTaskStkOvfHook        (OS_TCB          *ptcb);
+#endif
+
 OS_STK       *OSTaskStkInit           (void           (*task)(void *p_arg),
                                        void            *p_arg,
                                        OS_STK          *ptos,
@@ -1348,6 +1726,10 @@ void          OSTimeTickHook          (void);
 */
 
 #if OS_APP_HOOKS_EN > 0u
+#if OS_TASK_BUDGET_EN > 0u
+void          App_TaskBudgetHook      (OS_TCB          *ptcb);
+#endif
+
 void          App_TaskCreateHook      (OS_TCB          *ptcb);
 void          App_TaskDelHook         (OS_TCB          *ptcb);
 void          App_TaskIdleHook        (void);
@@ -1356,6 +1738,10 @@ void          App_TaskReturnHook      (OS_TCB          *ptcb);
 
 void          App_TaskStatHook        (void);
 
+#if OS_TASK_STK_GUARD_EN > 0u
+void          App_TaskStkOvfHook      (OS_TCB          *ptcb);
+#endif
+
 #if OS_TASK_SW_HOOK_EN > 0u
 void          App_TaskSwHook          (void);
 #endif
@@ -1436,6 +1822,46 @@ void          OSCtxSw                 (void);
     #endif
 #endif
 
+/*
+*********************************************************************************************************
+*                                         RUN-TO-COMPLETION JOBS
+*********************************************************************************************************
+*/
+
+#ifndef OS_JOB_EN
+#error  "OS_CFG.H, Missing OS_JOB_EN: Enable (1) or Disable (0) code generation for JOBS"
+#elif   OS_JOB_EN > 0u
+    #if     OS_SEM_EN == 0u
+    #error  "OS_CFG.H,         OS_SEM_EN must be 1 when enabling OS_JOB_EN"
+    #endif
+
+    #if     (OS_TASK_CREATE_EN == 0u) && (OS_TASK_CREATE_EXT_EN == 0u)
+    #error  "OS_CFG.H,         OS_TASK_CREATE_EN or OS_TASK_CREATE_EXT_EN must be 1 when enabling OS_JOB_EN"
+    #endif
+#endif
+
+/*
+*********************************************************************************************************
+*                                              COROUTINES
+*********************************************************************************************************
+*/
+
+#ifndef OS_CO_EN
+#error  "OS_CFG.H, Missing OS_CO_EN: Enable (1) or Disable (0) code generation for COROUTINES"
+#elif   OS_CO_EN > 0u
+    #ifndef OS_CO_PEND_MAX
+    #error  "OS_CFG.H, Missing OS_CO_PEND_MAX: Max. number of events pended on by a coroutine scheduler"
+    #endif
+
+    #if     (OS_SEM_EN == 0u) || (OS_EVENT_MULTI_EN == 0u)
+    #error  "OS_CFG.H,         OS_SEM_EN and OS_EVENT_MULTI_EN must be 1 when enabling OS_CO_EN"
+    #endif
+
+    #if     (OS_TASK_CREATE_EN == 0u) && (OS_TASK_CREATE_EXT_EN == 0u)
+    #error  "OS_CFG.H,         OS_TASK_CREATE_EN or OS_TASK_CREATE_EXT_EN must be 1 when enabling OS_CO_EN"
+    #endif
+#endif
+
 /*
 *********************************************************************************************************
 *                                           MESSAGE MAILBOXES
@@ -1513,6 +1939,10 @@ void          OSCtxSw                 (void);
     #error  "OS_CFG.H, Missing OS_MUTEX_DEL_EN: Include code for OSMutexDel()"
     #endif
 
+    #ifndef OS_MUTEX_FAST_EN
+    #error  "OS_CFG.H, Missing OS_MUTEX_FAST_EN: Lock-free Pend/Post of an uncontended mutex"
+    #endif
+
     #ifndef OS_MUTEX_QUERY_EN
     #error  "OS_CFG.H, Missing OS_MUTEX_QUERY_EN: Include code for OSMutexQuery()"
     #endif
@@ -1585,6 +2015,10 @@ void          OSCtxSw                 (void);
     #error  "OS_CFG.H, Missing OS_SEM_DEL_EN: Include code for OSSemDel()"
     #endif
 
+    #ifndef OS_SEM_FAST_EN
+    #error  "OS_CFG.H, Missing OS_SEM_FAST_EN: Lock-free Pend/Post when no task must block or be readied"
+    #endif
+
     #ifndef OS_SEM_PEND_ABORT_EN
     #error  "OS_CFG.H, Missing OS_SEM_PEND_ABORT_EN: Include code for OSSemPendAbort()"
     #endif
@@ -1611,10 +2045,14 @@ void          OSCtxSw                 (void);
     #error  "OS_CFG.H,         OS_MAX_TASKS must be >= 2"
     #endif
 
-    #if     OS_MAX_TASKS >  ((OS_LOWEST_PRIO - OS_N_SYS_TASKS) + 1u)
+    #if     (OS_MAX_TASKS >  ((OS_LOWEST_PRIO - OS_N_SYS_TASKS) + 1u)) && (OS_TASK_RR_EN == 0u)
     #error  "OS_CFG.H,         OS_MAX_TASKS must be <= OS_LOWEST_PRIO - OS_N_SYS_TASKS + 1"
     #endif
 
+    #if     (OS_MAX_TASKS + OS_N_SYS_TASKS) > 255u
+    #error  "OS_CFG.H,         OS_MAX_TASKS must be <= 255 - OS_N_SYS_TASKS"
+    #endif
+
 #endif
 
 #if     OS_LOWEST_PRIO >  254u
@@ -1637,6 +2075,32 @@ void          OSCtxSw                 (void);
 #error  "OS_CFG.H, Missing OS_TASK_STAT_STK_CHK_EN: Check task stacks from statistics task"
 #endif
 
+#ifndef OS_TASK_STK_CHK_GUARD
+#error  "OS_CFG.H, Missing OS_TASK_STK_CHK_GUARD: Zero entries ending a stack check (0 = full stack scan)"
+#endif
+
+#ifndef OS_TASK_STK_GUARD_EN
+#error  "OS_CFG.H, Missing OS_TASK_STK_GUARD_EN: Trap task stack overflows at each switch (MPU or canary)"
+#elif   OS_TASK_STK_GUARD_EN > 0u
+    #if     (OS_TASK_CREATE_EXT_EN == 0u) || (OS_TASK_SW_HOOK_EN == 0u)
+    #error  "OS_CFG.H,         OS_TASK_CREATE_EXT_EN and OS_TASK_SW_HOOK_EN must be 1 when enabling OS_TASK_STK_GUARD_EN"
+    #endif
+#endif
+
+#ifndef OS_TASK_BUDGET_EN
+#error  "OS_CFG.H, Missing OS_TASK_BUDGET_EN: Enforce CPU budgets of tasks created with OS_TASK_OPT_BUDGET"
+#elif   OS_TASK_BUDGET_EN > 0u
+    #if     !defined(OS_TASK_BUDGET_DFLT) || !defined(OS_TASK_BUDGET_PERIOD)
+    #error  "OS_CFG.H, Missing OS_TASK_BUDGET_DFLT or OS_TASK_BUDGET_PERIOD: Default CPU budget of a task"
+    #elif   OS_TASK_BUDGET_PERIOD == 0u
+    #error  "OS_CFG.H,         OS_TASK_BUDGET_PERIOD must be > 0"
+    #endif
+
+    #if     (OS_TASK_CREATE_EXT_EN == 0u) || (OS_TASK_SW_HOOK_EN == 0u)
+    #error  "OS_CFG.H,         OS_TASK_CREATE_EXT_EN and OS_TASK_SW_HOOK_EN must be 1 when enabling OS_TASK_BUDGET_EN"
+    #endif
+#endif
+
 #ifndef OS_TASK_CHANGE_PRIO_EN
 #error  "OS_CFG.H, Missing OS_TASK_CHANGE_PRIO_EN: Include code for OSTaskChangePrio()"
 #endif
@@ -1665,6 +2129,50 @@ void          OSCtxSw                 (void);
 #error  "OS_CFG.H, Missing OS_TASK_QUERY_EN: Include code for OSTaskQuery()"
 #endif
 
+#ifndef OS_TASK_PERIOD_EN
+#error  "OS_CFG.H, Missing OS_TASK_PERIOD_EN: Include code for OSTaskPeriodSet() and periodic task statistics"
+#elif   OS_TASK_PERIOD_EN > 0u
+    #if     OS_TIME_DLY_UNTIL_EN == 0u
+    #error  "OS_CFG.H, OSTimeDlyUntil() is required (set OS_TIME_DLY_UNTIL_EN to 1) when enabling OS_TASK_PERIOD_EN"
+    #endif
+#endif
+
+#ifndef OS_TASK_RR_EN
+#error  "OS_CFG.H, Missing OS_TASK_RR_EN: Allow several tasks per priority, time sliced round-robin"
+#elif   OS_TASK_RR_EN > 0u
+    #ifndef OS_TASK_RR_QUANTA
+    #error  "OS_CFG.H, Missing OS_TASK_RR_QUANTA: Default time slice of round-robin tasks (in ticks)"
+    #elif   OS_TASK_RR_QUANTA == 0u
+    #error  "OS_CFG.H,         OS_TASK_RR_QUANTA must be > 0"
+    #endif
+
+    #if     OS_EVENT_MULTI_EN > 0u
+    #error  "OS_CFG.H,         OS_EVENT_MULTI_EN must be 0 when enabling OS_TASK_RR_EN"
+    #endif
+#endif
+
+#ifndef OS_EDF_EN
+#error  "OS_CFG.H, Missing OS_EDF_EN: Enable (1) earliest-deadline-first scheduling in a prio band"
+#elif   OS_EDF_EN > 0u
+    #if     !defined(OS_EDF_PRIO_HI) || !defined(OS_EDF_PRIO_LO)
+    #error  "OS_CFG.H, Missing OS_EDF_PRIO_HI or OS_EDF_PRIO_LO: Priority band of the EDF tasks"
+    #elif   (OS_EDF_PRIO_HI > OS_EDF_PRIO_LO) || (OS_EDF_PRIO_LO >= (OS_LOWEST_PRIO - 1u))
+    #error  "OS_CFG.H,         OS_EDF_PRIO_HI must be <= OS_EDF_PRIO_LO < OS_LOWEST_PRIO - 1"
+    #endif
+
+    #if     OS_TIME_GET_SET_EN == 0u
+    #error  "OS_CFG.H, OSTime is required (set OS_TIME_GET_SET_EN to 1) when enabling OS_EDF_EN"
+    #endif
+
+    #if     OS_TASK_RR_EN > 0u
+    #error  "OS_CFG.H,         OS_TASK_RR_EN must be 0 when enabling OS_EDF_EN"
+    #endif
+#endif
+
+#ifndef OS_TASK_THRESHOLD_EN
+#error  "OS_CFG.H, Missing OS_TASK_THRESHOLD_EN: Enable preemption thresholds (see OSTaskThresholdSet())"
+#endif
+
 #ifndef OS_TASK_REG_TBL_SIZE
 #error  "OS_CFG.H, Missing OS_TASK_REG_TBL_SIZE: Include code for task specific registers"
 #else
@@ -1695,6 +2203,14 @@ void          OSCtxSw                 (void);
 #error  "OS_CFG.H, Missing OS_TIME_GET_SET_EN: Include code for OSTimeGet() and OSTimeSet()"
 #endif
 
+#ifndef OS_TIME_DLY_UNTIL_EN
+#error  "OS_CFG.H, Missing OS_TIME_DLY_UNTIL_EN: Include code for OSTimeDlyUntil()"
+#elif   OS_TIME_DLY_UNTIL_EN > 0u
+    #if     OS_TIME_GET_SET_EN == 0u
+    #error  "OS_CFG.H, OSTime is required (set OS_TIME_GET_SET_EN to 1) when enabling OS_TIME_DLY_UNTIL_EN"
+    #endif
+#endif
+
 /*
 *********************************************************************************************************
 *                                             TIMER MANAGEMENT